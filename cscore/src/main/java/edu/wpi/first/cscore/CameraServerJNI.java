@@ -335,7 +335,11 @@ public class CameraServerJNI {
   //
   public enum TelemetryKind {
     kSourceBytesReceived(1),
-    kSourceFramesReceived(2);
+    kSourceFramesReceived(2),
+    kSourceCaptureLatency(3),
+    kSinkGrabLatency(4),
+    kSinkProcessingLatency(5),
+    kSinkFramesDropped(6);
 
     private final int value;
 
@@ -364,6 +368,12 @@ public class CameraServerJNI {
     return getTelemetryAverageValue(handle, kind.getValue());
   }
 
+  public static native long[] getTelemetryHistogram(int handle, int kind);
+
+  public static long[] getTelemetryHistogram(int handle, TelemetryKind kind) {
+    return getTelemetryHistogram(handle, kind.getValue());
+  }
+
   //
   // Logging Functions
   //
@@ -71,4 +71,16 @@ public class UsbCamera extends VideoCamera {
     CameraServerJNI.setProperty(
         CameraServerJNI.getSourceProperty(m_handle, "connect_verbose"), level);
   }
+
+  /**
+   * Set whether frames use the camera's capture buffers directly instead of copying them (Linux
+   * only). Each buffer is returned to the camera when the last sink releases the frame; if too few
+   * buffers are available, frames are copied as usual.
+   *
+   * @param enabled true to enable zero-copy capture
+   */
+  public void setZeroCopy(boolean enabled) {
+    CameraServerJNI.setProperty(
+        CameraServerJNI.getSourceProperty(m_handle, "zero_copy"), enabled ? 1 : 0);
+  }
 }
@@ -4,6 +4,8 @@
 
 #include "CvSinkImpl.h"
 
+#include <memory>
+
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
@@ -13,6 +15,7 @@
 #include "Instance.h"
 #include "Log.h"
 #include "Notifier.h"
+#include "PropertyImpl.h"
 #include "c_util.h"
 #include "cscore_cpp.h"
 
@@ -22,18 +25,47 @@ CvSinkImpl::CvSinkImpl(std::string_view name, wpi::Logger& logger,
                        Notifier& notifier, Telemetry& telemetry)
     : SinkImpl{name, logger, notifier, telemetry} {
   m_active = true;
+  CreateProperties();
   // m_thread = std::thread(&CvSinkImpl::ThreadMain, this);
 }
 
 CvSinkImpl::CvSinkImpl(std::string_view name, wpi::Logger& logger,
                        Notifier& notifier, Telemetry& telemetry,
                        std::function<void(uint64_t time)> processFrame)
-    : SinkImpl{name, logger, notifier, telemetry} {}
+    : SinkImpl{name, logger, notifier, telemetry} {
+  CreateProperties();
+}
 
 CvSinkImpl::~CvSinkImpl() {
   Stop();
 }
 
+void CvSinkImpl::CreateProperties() {
+  CreateQueueProperties();
+
+  // Requested image size; 0 means use the source size.  Smaller sizes let
+  // MJPEG frames be decoded at reduced scale.
+  m_widthProp = CreateProperty("width", [] {
+    return std::make_unique<PropertyImpl>("width", CS_PROP_INTEGER, 1, 0, 0);
+  });
+  m_heightProp = CreateProperty("height", [] {
+    return std::make_unique<PropertyImpl>("height", CS_PROP_INTEGER, 1, 0, 0);
+  });
+}
+
+bool CvSinkImpl::GetCv(Frame& frame, cv::Mat& image) const {
+  CS_Status status = 0;
+  int width = GetProperty(m_widthProp, &status);
+  int height = GetProperty(m_heightProp, &status);
+  if (width <= 0) {
+    width = frame.GetOriginalWidth();
+  }
+  if (height <= 0) {
+    height = frame.GetOriginalHeight();
+  }
+  return frame.GetCv(image, width, height);
+}
+
 void CvSinkImpl::Stop() {
   m_active = false;
 
@@ -50,6 +82,7 @@ void CvSinkImpl::Stop() {
 
 uint64_t CvSinkImpl::GrabFrame(cv::Mat& image) {
   SetEnabled(true);
+  RecordGrabStart();
 
   auto source = GetSource();
   if (!source) {
@@ -58,24 +91,26 @@ uint64_t CvSinkImpl::GrabFrame(cv::Mat& image) {
     return 0;
   }
 
-  auto frame = source->GetNextFrame();  // blocks
+  auto frame = GetNextFrame(*source, -1);  // blocks
   if (!frame) {
     // Bad frame; sleep for 20 ms so we don't consume all processor time.
     std::this_thread::sleep_for(std::chrono::milliseconds(20));
     return 0;  // signal error
   }
 
-  if (!frame.GetCv(image)) {
+  if (!GetCv(frame, image)) {
     // Shouldn't happen, but just in case...
     std::this_thread::sleep_for(std::chrono::milliseconds(20));
     return 0;
   }
 
+  RecordGrabDone(frame);
   return frame.GetTime();
 }
 
 uint64_t CvSinkImpl::GrabFrame(cv::Mat& image, double timeout) {
   SetEnabled(true);
+  RecordGrabStart();
 
   auto source = GetSource();
   if (!source) {
@@ -84,19 +119,20 @@ uint64_t CvSinkImpl::GrabFrame(cv::Mat& image, double timeout) {
     return 0;
   }
 
-  auto frame = source->GetNextFrame(timeout);  // blocks
+  auto frame = GetNextFrame(*source, timeout);  // blocks
   if (!frame) {
     // Bad frame; sleep for 20 ms so we don't consume all processor time.
     std::this_thread::sleep_for(std::chrono::milliseconds(20));
     return 0;  // signal error
   }
 
-  if (!frame.GetCv(image)) {
+  if (!GetCv(frame, image)) {
     // Shouldn't happen, but just in case...
     std::this_thread::sleep_for(std::chrono::milliseconds(20));
     return 0;
   }
 
+  RecordGrabDone(frame);
   return frame.GetTime();
 }
 
@@ -37,8 +37,13 @@ class CvSinkImpl : public SinkImpl {
   uint64_t GrabFrame(cv::Mat& image, double timeout);
 
  private:
+  void CreateProperties();
+  bool GetCv(Frame& frame, cv::Mat& image) const;
   void ThreadMain();
 
+  int m_widthProp;
+  int m_heightProp;
+
   std::atomic_bool m_active;  // set to false to terminate threads
   std::thread m_thread;
   std::function<void(uint64_t time)> m_processFrame;
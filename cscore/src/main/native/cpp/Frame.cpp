@@ -4,12 +4,14 @@
 
 #include "Frame.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
+#include "ImageKernels.h"
 #include "Instance.h"
 #include "Log.h"
 #include "SourceImpl.h"
@@ -21,6 +23,7 @@ Frame::Frame(SourceImpl& source, std::string_view error, Time time)
   m_impl->refcount = 1;
   m_impl->error = error;
   m_impl->time = time;
+  m_impl->putTime = 0;
 }
 
 Frame::Frame(SourceImpl& source, std::unique_ptr<Image> image, Time time)
@@ -28,6 +31,7 @@ Frame::Frame(SourceImpl& source, std::unique_ptr<Image> image, Time time)
   m_impl->refcount = 1;
   m_impl->error.resize(0);
   m_impl->time = time;
+  m_impl->putTime = 0;
   m_impl->images.push_back(image.release());
 }
 
@@ -103,6 +107,13 @@ Image* Frame::GetNearestImage(int width, int height,
     }
   }
 
+  // Smaller images (e.g. from a reduced size JPEG decode for another sink)
+  // would need to be scaled up, so prefer decoding a large enough JPEG.
+  bool haveLargerJPEG =
+      std::any_of(m_impl->images.begin(), m_impl->images.end(), [&](auto i) {
+        return i->pixelFormat == VideoMode::kMJPEG && i->IsLarger(width, height);
+      });
+
   // 3) Different width, height, same pixelFormat (only if non-JPEG) (resample)
   if (pixelFormat != VideoMode::kMJPEG) {
     // 3a) Smallest image at least width/height in size
@@ -118,7 +129,8 @@ Image* Frame::GetNearestImage(int width, int height,
 
     // 3b) Largest image (less than width/height)
     for (auto i : m_impl->images) {
-      if (i->pixelFormat == pixelFormat && (!found || (i->IsLarger(*found)))) {
+      if (!haveLargerJPEG && i->pixelFormat == pixelFormat &&
+          (!found || (i->IsLarger(*found)))) {
         found = i;
       }
     }
@@ -142,7 +154,7 @@ Image* Frame::GetNearestImage(int width, int height,
 
   // 4b) Largest image (less than width/height)
   for (auto i : m_impl->images) {
-    if (i->pixelFormat != VideoMode::kMJPEG &&
+    if (!haveLargerJPEG && i->pixelFormat != VideoMode::kMJPEG &&
         (!found || (i->IsLarger(*found)))) {
       found = i;
     }
@@ -209,7 +221,7 @@ Image* Frame::ConvertImpl(Image* image, VideoMode::PixelFormat pixelFormat,
   // would have returned above).
   if (cur->pixelFormat == VideoMode::kMJPEG) {
     cur = ConvertMJPEGToBGR(cur);
-    if (pixelFormat == VideoMode::kBGR) {
+    if (!cur || pixelFormat == VideoMode::kBGR) {
       return cur;
     }
   }
@@ -237,15 +249,10 @@ Image* Frame::ConvertImpl(Image* image, VideoMode::PixelFormat pixelFormat,
       }
       return ConvertBGRToRGB565(cur);
     case VideoMode::kGray:
-      // If source is YUYV or RGB565, need to convert to BGR first
+      // YUYV can be converted directly; if source is RGB565, need to convert
+      // to BGR first
       if (cur->pixelFormat == VideoMode::kYUYV) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else {
-          cur = ConvertYUYVToBGR(cur);
-        }
+        return ConvertYUYVToGray(cur);
       } else if (cur->pixelFormat == VideoMode::kRGB565) {
         // Check to see if BGR version already exists...
         if (Image* newImage =
@@ -283,19 +290,90 @@ Image* Frame::ConvertImpl(Image* image, VideoMode::PixelFormat pixelFormat,
   return cur;
 }
 
-Image* Frame::ConvertMJPEGToBGR(Image* image) {
+// Picks the largest libjpeg DCT-domain scaling (1/8, 1/4, or 1/2) that still
+// decodes to at least width x height.  Returns the scale denominator.
+static int GetJpegScale(const Image& image, int width, int height) {
+  for (int denom : {8, 4, 2}) {
+    if (image.width / denom >= width && image.height / denom >= height) {
+      return denom;
+    }
+  }
+  return 1;
+}
+
+Image* Frame::DecodeMJPEG(Image* image, VideoMode::PixelFormat pixelFormat,
+                          int width, int height) {
   if (!image || image->pixelFormat != VideoMode::kMJPEG) {
     return nullptr;
   }
 
-  // Allocate an BGR image
+  // Decoding a reduced size image is much cheaper than decoding at full size
+  // and resizing, so scale down as far as possible while still being at
+  // least as large as the requested size.
+  int scale = GetJpegScale(*image, width, height);
+  int flags;
+  int channels;
+  if (pixelFormat == VideoMode::kGray) {
+    channels = 1;
+    switch (scale) {
+      case 8:
+        flags = cv::IMREAD_REDUCED_GRAYSCALE_8;
+        break;
+      case 4:
+        flags = cv::IMREAD_REDUCED_GRAYSCALE_4;
+        break;
+      case 2:
+        flags = cv::IMREAD_REDUCED_GRAYSCALE_2;
+        break;
+      default:
+        flags = cv::IMREAD_GRAYSCALE;
+        break;
+    }
+  } else {
+    channels = 3;
+    switch (scale) {
+      case 8:
+        flags = cv::IMREAD_REDUCED_COLOR_8;
+        break;
+      case 4:
+        flags = cv::IMREAD_REDUCED_COLOR_4;
+        break;
+      case 2:
+        flags = cv::IMREAD_REDUCED_COLOR_2;
+        break;
+      default:
+        flags = cv::IMREAD_COLOR;
+        break;
+    }
+  }
+
+  // Check to see if this decode has already been done (e.g. by another sink)
+  // libjpeg rounds scaled dimensions up.
+  int newWidth = (image->width + scale - 1) / scale;
+  int newHeight = (image->height + scale - 1) / scale;
+  if (Image* existing = GetExistingImage(newWidth, newHeight, pixelFormat)) {
+    return existing;
+  }
+
+  // Allocate an image
   auto newImage =
-      m_impl->source.AllocImage(VideoMode::kBGR, image->width, image->height,
-                                image->width * image->height * 3);
+      m_impl->source.AllocImage(pixelFormat, newWidth, newHeight,
+                                newWidth * newHeight * channels);
 
   // Decode
   cv::Mat newMat = newImage->AsMat();
-  cv::imdecode(image->AsInputArray(), cv::IMREAD_COLOR, &newMat);
+  cv::imdecode(image->AsInputArray(), flags, &newMat);
+  if (newMat.empty()) {
+    return nullptr;  // Corrupt image
+  }
+  if (newMat.data != reinterpret_cast<uchar*>(newImage->data())) {
+    // The decoder reallocated, so the actual size differs from what we
+    // expected; copy into an image of the right size.
+    newImage = m_impl->source.AllocImage(pixelFormat, newMat.cols, newMat.rows,
+                                         newMat.total() * channels);
+    cv::Mat dstMat = newImage->AsMat();
+    newMat.copyTo(dstMat);
+  }
 
   // Save the result
   Image* rv = newImage.release();
@@ -306,19 +384,26 @@ Image* Frame::ConvertMJPEGToBGR(Image* image) {
   return rv;
 }
 
-Image* Frame::ConvertMJPEGToGray(Image* image) {
-  if (!image || image->pixelFormat != VideoMode::kMJPEG) {
+Image* Frame::ConvertMJPEGToBGR(Image* image, int width, int height) {
+  return DecodeMJPEG(image, VideoMode::kBGR, width, height);
+}
+
+Image* Frame::ConvertMJPEGToGray(Image* image, int width, int height) {
+  return DecodeMJPEG(image, VideoMode::kGray, width, height);
+}
+
+Image* Frame::ConvertYUYVToBGR(Image* image) {
+  if (!image || image->pixelFormat != VideoMode::kYUYV) {
     return nullptr;
   }
 
-  // Allocate an grayscale image
+  // Allocate a BGR image
   auto newImage =
-      m_impl->source.AllocImage(VideoMode::kGray, image->width, image->height,
-                                image->width * image->height);
+      m_impl->source.AllocImage(VideoMode::kBGR, image->width, image->height,
+                                image->width * image->height * 3);
 
-  // Decode
-  cv::Mat newMat = newImage->AsMat();
-  cv::imdecode(image->AsInputArray(), cv::IMREAD_GRAYSCALE, &newMat);
+  // Convert
+  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_YUV2BGR_YUYV);
 
   // Save the result
   Image* rv = newImage.release();
@@ -329,18 +414,49 @@ Image* Frame::ConvertMJPEGToGray(Image* image) {
   return rv;
 }
 
-Image* Frame::ConvertYUYVToBGR(Image* image) {
+Image* Frame::ConvertYUYVToBGR(Image* image, int width, int height) {
   if (!image || image->pixelFormat != VideoMode::kYUYV) {
     return nullptr;
   }
+  if (image->Is(width, height)) {
+    return ConvertYUYVToBGR(image);
+  }
 
   // Allocate a BGR image
-  auto newImage =
-      m_impl->source.AllocImage(VideoMode::kBGR, image->width, image->height,
-                                image->width * image->height * 3);
+  auto newImage = m_impl->source.AllocImage(VideoMode::kBGR, width, height,
+                                            width * height * 3);
 
-  // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_YUV2BGR_YUYV);
+  // Convert and resize in one pass
+  ResizeYUYVToBGR(reinterpret_cast<const uint8_t*>(image->data()),
+                  image->width, image->height,
+                  reinterpret_cast<uint8_t*>(newImage->data()), width, height);
+
+  // Save the result
+  Image* rv = newImage.release();
+  if (m_impl) {
+    std::scoped_lock lock(m_impl->mutex);
+    m_impl->images.push_back(rv);
+  }
+  return rv;
+}
+
+Image* Frame::ConvertYUYVToGray(Image* image, int width, int height) {
+  if (!image || image->pixelFormat != VideoMode::kYUYV) {
+    return nullptr;
+  }
+
+  // Allocate a Grayscale image
+  auto newImage = m_impl->source.AllocImage(VideoMode::kGray, width, height,
+                                            width * height);
+
+  // Convert (and resize) in one pass
+  auto src = reinterpret_cast<const uint8_t*>(image->data());
+  auto dst = reinterpret_cast<uint8_t*>(newImage->data());
+  if (image->Is(width, height)) {
+    cs::ConvertYUYVToGray(src, dst, width, height);
+  } else {
+    ResizeYUYVToGray(src, image->width, image->height, dst, width, height);
+  }
 
   // Save the result
   Image* rv = newImage.release();
@@ -417,6 +533,32 @@ Image* Frame::ConvertBGRToGray(Image* image) {
   return rv;
 }
 
+Image* Frame::ConvertBGRToGray(Image* image, int width, int height) {
+  if (!image || image->pixelFormat != VideoMode::kBGR) {
+    return nullptr;
+  }
+  if (image->Is(width, height)) {
+    return ConvertBGRToGray(image);
+  }
+
+  // Allocate a Grayscale image
+  auto newImage = m_impl->source.AllocImage(VideoMode::kGray, width, height,
+                                            width * height);
+
+  // Convert and resize in one pass
+  ResizeBGRToGray(reinterpret_cast<const uint8_t*>(image->data()),
+                  image->width, image->height,
+                  reinterpret_cast<uint8_t*>(newImage->data()), width, height);
+
+  // Save the result
+  Image* rv = newImage.release();
+  if (m_impl) {
+    std::scoped_lock lock(m_impl->mutex);
+    m_impl->images.push_back(rv);
+  }
+  return rv;
+}
+
 Image* Frame::ConvertGrayToBGR(Image* image) {
   if (!image || image->pixelFormat != VideoMode::kGray) {
     return nullptr;
@@ -528,9 +670,32 @@ Image* Frame::GetImageImpl(int width, int height,
   // If the source image is a JPEG, we need to decode it before we can do
   // anything else with it.  Note that if the destination format is JPEG, we
   // still need to do this (unless the width/height/compression were the same,
-  // in which case we already returned the existing JPEG above).
+  // in which case we already returned the existing JPEG above).  Decoding
+  // only happens here, when a sink asks for the image, and is done at the
+  // smallest scale that covers the requested size.
   if (cur->pixelFormat == VideoMode::kMJPEG) {
-    cur = ConvertMJPEGToBGR(cur);
+    if (pixelFormat == VideoMode::kGray) {
+      cur = ConvertMJPEGToGray(cur, width, height);
+    } else {
+      cur = ConvertMJPEGToBGR(cur, width, height);
+    }
+    if (!cur) {
+      return nullptr;
+    }
+  }
+
+  // Where possible, color convert and resize in a single pass rather than
+  // going through an intermediate full size image.
+  if (cur->pixelFormat == VideoMode::kYUYV) {
+    if (pixelFormat == VideoMode::kGray) {
+      return ConvertYUYVToGray(cur, width, height);
+    }
+    if (pixelFormat != VideoMode::kYUYV && !cur->Is(width, height)) {
+      cur = ConvertYUYVToBGR(cur, width, height);
+    }
+  } else if (cur->pixelFormat == VideoMode::kBGR &&
+             pixelFormat == VideoMode::kGray && !cur->Is(width, height)) {
+    return ConvertBGRToGray(cur, width, height);
   }
 
   // Resize
@@ -23,6 +23,7 @@ namespace cs {
 class SourceImpl;
 
 class Frame {
+  friend class FrameQueue;
   friend class SourceImpl;
 
  public:
@@ -35,6 +36,7 @@ class Frame {
     wpi::recursive_mutex mutex;
     std::atomic_int refcount{0};
     Time time{0};
+    Time putTime{0};  // when the source made the frame available
     SourceImpl& source;
     std::string error;
     wpi::SmallVector<Image*, 4> images;
@@ -72,6 +74,8 @@ class Frame {
 
   Time GetTime() const { return m_impl ? m_impl->time : 0; }
 
+  Time GetPutTime() const { return m_impl ? m_impl->putTime : 0; }
+
   std::string_view GetError() const {
     if (!m_impl) {
       return {};
@@ -192,12 +196,27 @@ class Frame {
     return ConvertImpl(image, VideoMode::kMJPEG, requiredQuality,
                        defaultQuality);
   }
-  Image* ConvertMJPEGToBGR(Image* image);
-  Image* ConvertMJPEGToGray(Image* image);
+  Image* ConvertMJPEGToBGR(Image* image) {
+    return image ? ConvertMJPEGToBGR(image, image->width, image->height)
+                 : nullptr;
+  }
+  Image* ConvertMJPEGToBGR(Image* image, int width, int height);
+  Image* ConvertMJPEGToGray(Image* image) {
+    return image ? ConvertMJPEGToGray(image, image->width, image->height)
+                 : nullptr;
+  }
+  Image* ConvertMJPEGToGray(Image* image, int width, int height);
   Image* ConvertYUYVToBGR(Image* image);
+  Image* ConvertYUYVToBGR(Image* image, int width, int height);
+  Image* ConvertYUYVToGray(Image* image) {
+    return image ? ConvertYUYVToGray(image, image->width, image->height)
+                 : nullptr;
+  }
+  Image* ConvertYUYVToGray(Image* image, int width, int height);
   Image* ConvertBGRToRGB565(Image* image);
   Image* ConvertRGB565ToBGR(Image* image);
   Image* ConvertBGRToGray(Image* image);
+  Image* ConvertBGRToGray(Image* image, int width, int height);
   Image* ConvertGrayToBGR(Image* image);
   Image* ConvertBGRToMJPEG(Image* image, int quality);
   Image* ConvertGrayToMJPEG(Image* image, int quality);
@@ -224,6 +243,8 @@ class Frame {
                      int requiredJpegQuality, int defaultJpegQuality);
   Image* GetImageImpl(int width, int height, VideoMode::PixelFormat pixelFormat,
                       int requiredJpegQuality, int defaultJpegQuality);
+  Image* DecodeMJPEG(Image* image, VideoMode::PixelFormat pixelFormat,
+                     int width, int height);
   void DecRef() {
     if (m_impl && --(m_impl->refcount) == 0) {
       ReleaseFrame();
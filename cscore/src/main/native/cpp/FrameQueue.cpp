@@ -0,0 +1,160 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "FrameQueue.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace cs;
+
+FrameQueue::FrameQueue(int depth, Policy policy)
+    : m_depth{depth},
+      m_policy{policy},
+      m_capacity{static_cast<uint64_t>(depth) + 1},
+      m_slots{new std::atomic<Frame::Impl*>[m_capacity]} {
+  for (uint64_t i = 0; i < m_capacity; ++i) {
+    m_slots[i] = nullptr;
+  }
+}
+
+FrameQueue::~FrameQueue() {
+  for (uint64_t i = 0; i < m_capacity; ++i) {
+    Adopt(m_slots[i].exchange(nullptr));
+  }
+}
+
+void FrameQueue::Push(const Frame& frame) {
+  Frame::Impl* impl = AddRef(frame);
+  if (!impl) {
+    return;
+  }
+
+  std::scoped_lock pushLock{m_pushMutex};
+  if (m_closed) {
+    Adopt(impl);
+    return;
+  }
+  uint64_t depth = m_depth;
+  uint64_t tail = m_tail.load(std::memory_order_relaxed);
+
+  if (m_policy == kBlock) {
+    if (tail - m_head.load() >= depth) {
+      unsigned int wakeups = m_wakeups;
+      std::unique_lock lock{m_mutex};
+      ++m_waiters;
+      m_cond.wait(lock, [&] {
+        return tail - m_head.load() < depth || m_wakeups != wakeups ||
+               m_closed;
+      });
+      --m_waiters;
+      if (tail - m_head.load() >= depth) {
+        // woken up without space
+        lock.unlock();
+        Adopt(impl);
+        ++m_dropped;
+        return;
+      }
+    }
+  } else {
+    // Make room by claiming the oldest slots ourselves
+    for (;;) {
+      uint64_t head = m_head.load();
+      if (tail - head < depth) {
+        break;
+      }
+      if (m_head.compare_exchange_weak(head, head + 1)) {
+        Adopt(m_slots[head % m_capacity].exchange(nullptr));
+        ++m_dropped;
+      }
+    }
+  }
+
+  // The slot can only still be occupied if the consumer has claimed it but
+  // not yet taken the frame out, which is a few instructions away.
+  auto& slot = m_slots[tail % m_capacity];
+  Frame::Impl* empty = nullptr;
+  while (!slot.compare_exchange_weak(empty, impl)) {
+    empty = nullptr;
+    std::this_thread::yield();
+  }
+  m_tail.store(tail + 1);
+  NotifyWaiters();
+}
+
+Frame FrameQueue::Pop(double timeout) {
+  unsigned int wakeups = m_wakeups;
+  Frame frame;
+  bool popped = TryPop(&frame);
+  if (!popped) {
+    std::unique_lock lock{m_mutex};
+    ++m_waiters;
+    auto ready = [&] {
+      popped = TryPop(&frame);
+      return popped || m_wakeups != wakeups;
+    };
+    if (timeout < 0) {
+      m_cond.wait(lock, ready);
+    } else {
+      m_cond.wait_for(lock, std::chrono::duration<double>(timeout), ready);
+    }
+    --m_waiters;
+  }
+  if (popped) {
+    // a blocked producer may be waiting for space
+    NotifyWaiters();
+  }
+  return frame;
+}
+
+void FrameQueue::Wakeup() {
+  ++m_wakeups;
+  {
+    std::scoped_lock lock{m_mutex};
+  }
+  m_cond.notify_all();
+}
+
+void FrameQueue::Close() {
+  m_closed = true;
+  Wakeup();
+}
+
+bool FrameQueue::TryPop(Frame* frame) {
+  uint64_t head = m_head.load();
+  for (;;) {
+    if (head == m_tail.load()) {
+      return false;
+    }
+    // Claiming the head index gives us ownership of the slot contents
+    if (m_head.compare_exchange_weak(head, head + 1)) {
+      *frame = Adopt(m_slots[head % m_capacity].exchange(nullptr));
+      return true;
+    }
+  }
+}
+
+void FrameQueue::NotifyWaiters() {
+  if (m_waiters == 0) {
+    return;
+  }
+  {
+    std::scoped_lock lock{m_mutex};
+  }
+  m_cond.notify_all();
+}
+
+Frame::Impl* FrameQueue::AddRef(const Frame& frame) {
+  if (!frame.m_impl) {
+    return nullptr;
+  }
+  ++frame.m_impl->refcount;
+  return frame.m_impl;
+}
+
+Frame FrameQueue::Adopt(Frame::Impl* impl) {
+  Frame frame;
+  frame.m_impl = impl;
+  return frame;
+}
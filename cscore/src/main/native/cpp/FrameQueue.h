@@ -0,0 +1,90 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_FRAMEQUEUE_H_
+#define CSCORE_FRAMEQUEUE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+
+#include <wpi/condition_variable.h>
+#include <wpi/mutex.h>
+
+#include "Frame.h"
+
+namespace cs {
+
+// Bounded frame queue between a source and a single sink, used instead of
+// the source's "current frame" when a sink needs to see every frame.
+//
+// The ring holds references to pooled Frame::Impl objects; the producer
+// (source) and consumer (sink) claim slots with atomic operations and only
+// take the mutex when they need to sleep.  Pushes are serialized, as some
+// sources put frames from more than one thread.
+class FrameQueue {
+ public:
+  enum Policy {
+    kDropOldest = 0,  // when full, drop the oldest frame to make room
+    kBlock = 1        // when full, wait for the sink to catch up
+  };
+
+  FrameQueue(int depth, Policy policy);
+  ~FrameQueue();
+  FrameQueue(const FrameQueue&) = delete;
+  FrameQueue& operator=(const FrameQueue&) = delete;
+
+  int GetDepth() const { return m_depth; }
+  Policy GetPolicy() const { return m_policy; }
+
+  // Adds a frame to the queue.  With kBlock this waits until there is space
+  // (or until Wakeup() is called, in which case the frame is dropped).
+  void Push(const Frame& frame);
+
+  // Removes the oldest frame from the queue, waiting up to timeout seconds
+  // (forever if negative) for one to arrive.  Returns an empty frame on
+  // timeout or Wakeup().
+  Frame Pop(double timeout);
+
+  // Releases all threads waiting in Push() or Pop().
+  void Wakeup();
+
+  // Wakes up waiters and makes all later pushes drop their frame; used when
+  // the queue is detached from its source.
+  void Close();
+
+  // Gets the number of frames dropped since the last call.
+  int64_t TakeDropped() { return m_dropped.exchange(0); }
+
+ private:
+  bool TryPop(Frame* frame);
+  void NotifyWaiters();
+
+  static Frame::Impl* AddRef(const Frame& frame);
+  static Frame Adopt(Frame::Impl* impl);
+
+  const int m_depth;
+  const Policy m_policy;
+  // one more slot than the depth, so the producer doesn't have to wait for
+  // the consumer to empty the slot it has just claimed
+  const uint64_t m_capacity;
+  std::unique_ptr<std::atomic<Frame::Impl*>[]> m_slots;
+  std::atomic<uint64_t> m_head{0};  // next slot to pop
+  std::atomic<uint64_t> m_tail{0};  // next slot to push
+  std::atomic<int64_t> m_dropped{0};
+  std::atomic_bool m_closed{false};
+
+  wpi::mutex m_pushMutex;
+
+  // for sleeping only
+  std::atomic_int m_waiters{0};
+  std::atomic<unsigned int> m_wakeups{0};
+  wpi::mutex m_mutex;
+  wpi::condition_variable m_cond;
+};
+
+}  // namespace cs
+
+#endif  // CSCORE_FRAMEQUEUE_H_
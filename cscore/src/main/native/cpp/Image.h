@@ -5,7 +5,9 @@
 #ifndef CSCORE_IMAGE_H_
 #define CSCORE_IMAGE_H_
 
+#include <functional>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include <opencv2/core/core.hpp>
@@ -30,6 +32,18 @@ class Image {
   }
 #endif
 
+  // Wraps data owned elsewhere (e.g. a mapped driver buffer) without copying
+  // it.  release is called when the image is destroyed; these images are
+  // never returned to the source's image pool.
+  Image(uchar* data, size_t size, std::function<void()> release)
+      : m_external{data}, m_externalSize{size}, m_release{std::move(release)} {}
+
+  ~Image() {
+    if (m_release) {
+      m_release();
+    }
+  }
+
   Image(const Image&) = delete;
   Image& operator=(const Image&) = delete;
 
@@ -38,11 +52,16 @@ class Image {
   std::string_view str() const { return {data(), size()}; }
   size_t capacity() const { return m_data.capacity(); }
   const char* data() const {
-    return reinterpret_cast<const char*>(m_data.data());
+    return reinterpret_cast<const char*>(m_external ? m_external
+                                                    : m_data.data());
   }
-  char* data() { return reinterpret_cast<char*>(m_data.data()); }
-  size_t size() const { return m_data.size(); }
+  char* data() {
+    return reinterpret_cast<char*>(m_external ? m_external : m_data.data());
+  }
+  size_t size() const { return m_external ? m_externalSize : m_data.size(); }
+  bool IsExternal() const { return m_external != nullptr; }
 
+  // Buffer access; only valid for images that are not external
   const std::vector<uchar>& vec() const { return m_data; }
   std::vector<uchar>& vec() { return m_data; }
 
@@ -65,10 +84,15 @@ class Image {
         type = CV_8UC1;
         break;
     }
-    return cv::Mat{height, width, type, m_data.data()};
+    return cv::Mat{height, width, type, data()};
   }
 
-  cv::_InputArray AsInputArray() { return cv::_InputArray{m_data}; }
+  cv::_InputArray AsInputArray() {
+    if (m_external) {
+      return cv::_InputArray{m_external, static_cast<int>(m_externalSize)};
+    }
+    return cv::_InputArray{m_data};
+  }
 
   bool Is(int width_, int height_) {
     return width == width_ && height == height_;
@@ -95,6 +119,9 @@ class Image {
 
  private:
   std::vector<uchar> m_data;
+  uchar* m_external{nullptr};
+  size_t m_externalSize{0};
+  std::function<void()> m_release;
 
  public:
   VideoMode::PixelFormat pixelFormat{VideoMode::kUnknown};
@@ -0,0 +1,418 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ImageKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#define CSCORE_SIMD_AVX2
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSCORE_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CSCORE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace cs;
+
+namespace {
+
+// Bilinear weights are fixed point with this many fractional bits (as in
+// cv::resize).  Source rows are first blended vertically into int16 after
+// dropping kVertShift bits, and the horizontal interpolation drops the rest.
+constexpr int kWeightBits = 11;
+constexpr int kWeightOne = 1 << kWeightBits;
+constexpr int kVertShift = 4;
+constexpr int kHorizShift = 2 * kWeightBits - kVertShift;
+
+// BT.601 YUV to RGB coefficients, as used by cv::cvtColor() but reduced to
+// 13 fractional bits so they fit in 16 bits for SIMD multiplies.
+constexpr int kYuvShift = 13;
+constexpr int kCY = 9535;
+constexpr int kCUB = 16531;
+constexpr int kCUG = -3203;
+constexpr int kCVG = -6660;
+constexpr int kCVR = 13074;
+
+// RGB to gray coefficients, fixed point with 14 fractional bits.
+constexpr int kGrayShift = 14;
+constexpr int kGrayB = 1868;
+constexpr int kGrayG = 9617;
+constexpr int kGrayR = 4899;
+
+inline uint8_t Saturate(int v) {
+  return static_cast<uint8_t>((std::min)((std::max)(v, 0), 255));
+}
+
+// Gray value of a YUYV pixel.  When converting YUV to BGR to gray, the
+// chroma terms cancel out, leaving only the scaled luma: 1.164 * (Y - 16),
+// approximated here as 149/128 so it can be computed in 16 bits.
+inline uint8_t LumaToGray(int y) {
+  return Saturate(((std::max)(y - 16, 0) * 149 + 64) >> 7);
+}
+
+// LumaToGray() for every possible luma value.
+struct LumaToGrayTable {
+  LumaToGrayTable() {
+    for (int i = 0; i < 256; ++i) {
+      values[i] = LumaToGray(i);
+    }
+  }
+
+  uint8_t values[256];
+};
+
+// Gray value of a vertically blended BGR pixel (at the same scale).
+inline int BGRToGray(const int16_t* p) {
+  return (p[0] * kGrayB + p[1] * kGrayG + p[2] * kGrayR +
+          (1 << (kGrayShift - 1))) >>
+         kGrayShift;
+}
+
+inline void YUVToBGR(int y, int u, int v, uint8_t* dst) {
+  int yy = (std::max)(y - 16, 0) * kCY;
+  u -= 128;
+  v -= 128;
+  constexpr int round = 1 << (kYuvShift - 1);
+  dst[0] = Saturate((yy + kCUB * u + round) >> kYuvShift);
+  dst[1] = Saturate((yy + kCUG * u + kCVG * v + round) >> kYuvShift);
+  dst[2] = Saturate((yy + kCVR * v + round) >> kYuvShift);
+}
+
+// Horizontal interpolation of two vertically blended values, to 8 bits.
+inline int Lerp(int a, int b, int w) {
+  return (a * (kWeightOne - w) + b * w + (1 << (kHorizShift - 1))) >>
+         kHorizShift;
+}
+
+// Sample positions and weights along one axis.  Sample d is
+// src[index0[d]] * (1 - weight[d]) + src[index1[d]] * weight[d].
+struct Taps {
+  Taps(int srcSize, int dstSize)
+      : index0(dstSize), index1(dstSize), weight(dstSize) {
+    double scale = static_cast<double>(srcSize) / dstSize;
+    for (int d = 0; d < dstSize; ++d) {
+      double s = (d + 0.5) * scale - 0.5;
+      int i = static_cast<int>(std::floor(s));
+      double f = s - i;
+      if (i < 0) {
+        i = 0;
+        f = 0;
+      }
+      if (i >= srcSize - 1) {
+        i = srcSize - 1;
+        f = 0;
+      }
+      index0[d] = i;
+      index1[d] = (std::min)(i + 1, srcSize - 1);
+      weight[d] = static_cast<int>(std::lround(f * kWeightOne));
+    }
+  }
+
+  std::vector<int> index0;
+  std::vector<int> index1;
+  std::vector<int> weight;
+};
+
+// Vertical blend of two source rows.
+void BlendRows(const uint8_t* a, const uint8_t* b, int w, int16_t* dst,
+               int n) {
+  int i = 0;
+#if defined(CSCORE_SIMD_AVX2)
+  {
+    __m256i weights = _mm256_set1_epi32((w << 16) | (kWeightOne - w));
+    for (; i + 16 <= n; i += 16) {
+      __m256i va = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+      __m256i vb = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+      __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(va, vb), weights);
+      __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(va, vb), weights);
+      lo = _mm256_srai_epi32(lo, kVertShift);
+      hi = _mm256_srai_epi32(hi, kVertShift);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                          _mm256_packs_epi32(lo, hi));
+    }
+  }
+#endif
+#if defined(CSCORE_SIMD_SSE2)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i weights = _mm_set1_epi32((w << 16) | (kWeightOne - w));
+    for (; i + 8 <= n; i += 8) {
+      __m128i va = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + i)), zero);
+      __m128i vb = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b + i)), zero);
+      __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(va, vb), weights);
+      __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(va, vb), weights);
+      lo = _mm_srai_epi32(lo, kVertShift);
+      hi = _mm_srai_epi32(hi, kVertShift);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                       _mm_packs_epi32(lo, hi));
+    }
+  }
+#elif defined(CSCORE_SIMD_NEON)
+  {
+    uint16_t w0 = kWeightOne - w;
+    uint16_t w1 = w;
+    for (; i + 8 <= n; i += 8) {
+      uint16x8_t va = vmovl_u8(vld1_u8(a + i));
+      uint16x8_t vb = vmovl_u8(vld1_u8(b + i));
+      uint32x4_t lo = vmull_n_u16(vget_low_u16(va), w0);
+      lo = vmlal_n_u16(lo, vget_low_u16(vb), w1);
+      uint32x4_t hi = vmull_n_u16(vget_high_u16(va), w0);
+      hi = vmlal_n_u16(hi, vget_high_u16(vb), w1);
+      vst1q_s16(dst + i, vreinterpretq_s16_u16(
+                             vcombine_u16(vshrn_n_u32(lo, kVertShift),
+                                          vshrn_n_u32(hi, kVertShift))));
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = (a[i] * (kWeightOne - w) + b[i] * w) >> kVertShift;
+  }
+}
+
+// Converts planar Y, U, V rows to a BGR row.
+void ConvertRowYUVToBGR(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                        uint8_t* dst, int n) {
+  int i = 0;
+#if defined(CSCORE_SIMD_SSE2)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i offset = _mm_set1_epi16(16);
+    const __m128i center = _mm_set1_epi16(128);
+    // coefficients for (y, u), (y, v), and (u, v) pairs
+    const __m128i cYUB = _mm_set_epi16(kCUB, kCY, kCUB, kCY, kCUB, kCY, kCUB,
+                                       kCY);
+    const __m128i cYU0 = _mm_set_epi16(0, kCY, 0, kCY, 0, kCY, 0, kCY);
+    const __m128i cUVG = _mm_set_epi16(kCVG, kCUG, kCVG, kCUG, kCVG, kCUG,
+                                       kCVG, kCUG);
+    const __m128i cYVR = _mm_set_epi16(kCVR, kCY, kCVR, kCY, kCVR, kCY, kCVR,
+                                       kCY);
+    const __m128i round = _mm_set1_epi32(1 << (kYuvShift - 1));
+    alignas(16) uint8_t bgr[3][16];
+
+    auto finish = [&](__m128i lo, __m128i hi) {
+      lo = _mm_srai_epi32(_mm_add_epi32(lo, round), kYuvShift);
+      hi = _mm_srai_epi32(_mm_add_epi32(hi, round), kYuvShift);
+      __m128i packed = _mm_packs_epi32(lo, hi);
+      return _mm_packus_epi16(packed, packed);
+    };
+
+    for (; i + 8 <= n; i += 8) {
+      __m128i yv = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i)), zero);
+      __m128i uv = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + i)), zero);
+      __m128i vv = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + i)), zero);
+      yv = _mm_subs_epu16(yv, offset);
+      uv = _mm_sub_epi16(uv, center);
+      vv = _mm_sub_epi16(vv, center);
+
+      __m128i yuLo = _mm_unpacklo_epi16(yv, uv);
+      __m128i yuHi = _mm_unpackhi_epi16(yv, uv);
+      __m128i yvLo = _mm_unpacklo_epi16(yv, vv);
+      __m128i yvHi = _mm_unpackhi_epi16(yv, vv);
+      __m128i uvLo = _mm_unpacklo_epi16(uv, vv);
+      __m128i uvHi = _mm_unpackhi_epi16(uv, vv);
+
+      _mm_store_si128(reinterpret_cast<__m128i*>(bgr[0]),
+                      finish(_mm_madd_epi16(yuLo, cYUB),
+                             _mm_madd_epi16(yuHi, cYUB)));
+      _mm_store_si128(reinterpret_cast<__m128i*>(bgr[1]),
+                      finish(_mm_add_epi32(_mm_madd_epi16(yuLo, cYU0),
+                                           _mm_madd_epi16(uvLo, cUVG)),
+                             _mm_add_epi32(_mm_madd_epi16(yuHi, cYU0),
+                                           _mm_madd_epi16(uvHi, cUVG))));
+      _mm_store_si128(reinterpret_cast<__m128i*>(bgr[2]),
+                      finish(_mm_madd_epi16(yvLo, cYVR),
+                             _mm_madd_epi16(yvHi, cYVR)));
+
+      // SSE2 has no byte shuffle, so interleave in scalar code
+      uint8_t* d = dst + i * 3;
+      for (int k = 0; k < 8; ++k) {
+        d[k * 3] = bgr[0][k];
+        d[k * 3 + 1] = bgr[1][k];
+        d[k * 3 + 2] = bgr[2][k];
+      }
+    }
+  }
+#elif defined(CSCORE_SIMD_NEON)
+  {
+    const int16x8_t center = vdupq_n_s16(128);
+    for (; i + 8 <= n; i += 8) {
+      int16x8_t yv = vreinterpretq_s16_u16(
+          vmovl_u8(vqsub_u8(vld1_u8(y + i), vdup_n_u8(16))));
+      int16x8_t uv =
+          vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u + i))), center);
+      int16x8_t vv =
+          vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v + i))), center);
+      int32x4_t yLo = vmull_n_s16(vget_low_s16(yv), kCY);
+      int32x4_t yHi = vmull_n_s16(vget_high_s16(yv), kCY);
+
+      int32x4_t bLo = vmlal_n_s16(yLo, vget_low_s16(uv), kCUB);
+      int32x4_t bHi = vmlal_n_s16(yHi, vget_high_s16(uv), kCUB);
+      int32x4_t gLo = vmlal_n_s16(yLo, vget_low_s16(uv), kCUG);
+      int32x4_t gHi = vmlal_n_s16(yHi, vget_high_s16(uv), kCUG);
+      gLo = vmlal_n_s16(gLo, vget_low_s16(vv), kCVG);
+      gHi = vmlal_n_s16(gHi, vget_high_s16(vv), kCVG);
+      int32x4_t rLo = vmlal_n_s16(yLo, vget_low_s16(vv), kCVR);
+      int32x4_t rHi = vmlal_n_s16(yHi, vget_high_s16(vv), kCVR);
+
+      uint8x8x3_t bgr;
+      bgr.val[0] = vqmovun_s16(vcombine_s16(vqrshrn_n_s32(bLo, kYuvShift),
+                                            vqrshrn_n_s32(bHi, kYuvShift)));
+      bgr.val[1] = vqmovun_s16(vcombine_s16(vqrshrn_n_s32(gLo, kYuvShift),
+                                            vqrshrn_n_s32(gHi, kYuvShift)));
+      bgr.val[2] = vqmovun_s16(vcombine_s16(vqrshrn_n_s32(rLo, kYuvShift),
+                                            vqrshrn_n_s32(rHi, kYuvShift)));
+      vst3_u8(dst + i * 3, bgr);
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    YUVToBGR(y[i], u[i], v[i], dst + i * 3);
+  }
+}
+
+// Produces each destination row by blending the two nearest source rows
+// (of rowSize bytes) into a buffer, then calling horiz(dstRow, buf) to
+// interpolate horizontally.  Vertical blending is the bulk of the work and
+// is vectorized; the horizontal pass only touches destination pixels.
+template <typename Horiz>
+void Resample(const uint8_t* src, int srcHeight, int dstHeight, int rowSize,
+              Horiz&& horiz) {
+  Taps taps{srcHeight, dstHeight};
+  std::vector<int16_t> buf(rowSize);
+  for (int y = 0; y < dstHeight; ++y) {
+    BlendRows(src + taps.index0[y] * rowSize, src + taps.index1[y] * rowSize,
+              taps.weight[y], buf.data(), rowSize);
+    horiz(y, buf.data());
+  }
+}
+
+}  // namespace
+
+void cs::ConvertYUYVToGray(const uint8_t* src, uint8_t* dst, int width,
+                           int height) {
+  int n = width * height;
+  int i = 0;
+#if defined(CSCORE_SIMD_AVX2)
+  {
+    const __m256i mask = _mm256_set1_epi16(0x00ff);
+    const __m256i offset = _mm256_set1_epi16(16);
+    const __m256i scale = _mm256_set1_epi16(149);
+    const __m256i round = _mm256_set1_epi16(64);
+    for (; i + 32 <= n; i += 32) {
+      const __m256i* p = reinterpret_cast<const __m256i*>(src + i * 2);
+      __m256i y0 = _mm256_and_si256(_mm256_loadu_si256(p), mask);
+      __m256i y1 = _mm256_and_si256(_mm256_loadu_si256(p + 1), mask);
+      y0 = _mm256_mullo_epi16(_mm256_subs_epu16(y0, offset), scale);
+      y1 = _mm256_mullo_epi16(_mm256_subs_epu16(y1, offset), scale);
+      y0 = _mm256_srli_epi16(_mm256_add_epi16(y0, round), 7);
+      y1 = _mm256_srli_epi16(_mm256_add_epi16(y1, round), 7);
+      __m256i packed = _mm256_packus_epi16(y0, y1);
+      packed = _mm256_permute4x64_epi64(packed, 0xd8);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+  }
+#endif
+#if defined(CSCORE_SIMD_SSE2)
+  {
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    const __m128i offset = _mm_set1_epi16(16);
+    const __m128i scale = _mm_set1_epi16(149);
+    const __m128i round = _mm_set1_epi16(64);
+    for (; i + 16 <= n; i += 16) {
+      const __m128i* p = reinterpret_cast<const __m128i*>(src + i * 2);
+      __m128i y0 = _mm_and_si128(_mm_loadu_si128(p), mask);
+      __m128i y1 = _mm_and_si128(_mm_loadu_si128(p + 1), mask);
+      y0 = _mm_mullo_epi16(_mm_subs_epu16(y0, offset), scale);
+      y1 = _mm_mullo_epi16(_mm_subs_epu16(y1, offset), scale);
+      y0 = _mm_srli_epi16(_mm_add_epi16(y0, round), 7);
+      y1 = _mm_srli_epi16(_mm_add_epi16(y1, round), 7);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                       _mm_packus_epi16(y0, y1));
+    }
+  }
+#elif defined(CSCORE_SIMD_NEON)
+  {
+    const uint8x16_t offset = vdupq_n_u8(16);
+    const uint8x8_t scale = vdup_n_u8(149);
+    for (; i + 16 <= n; i += 16) {
+      uint8x16_t y = vqsubq_u8(vld2q_u8(src + i * 2).val[0], offset);
+      uint16x8_t lo = vmull_u8(vget_low_u8(y), scale);
+      uint16x8_t hi = vmull_u8(vget_high_u8(y), scale);
+      vst1q_u8(dst + i,
+               vcombine_u8(vqrshrn_n_u16(lo, 7), vqrshrn_n_u16(hi, 7)));
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = LumaToGray(src[i * 2]);
+  }
+}
+
+void cs::ResizeYUYVToGray(const uint8_t* src, int srcWidth, int srcHeight,
+                          uint8_t* dst, int dstWidth, int dstHeight) {
+  static const LumaToGrayTable table;
+  Taps xt{srcWidth, dstWidth};
+  Resample(src, srcHeight, dstHeight, srcWidth * 2,
+           [&](int y, const int16_t* row) {
+             uint8_t* d = dst + y * dstWidth;
+             for (int x = 0; x < dstWidth; ++x) {
+               d[x] = table.values[Lerp(row[xt.index0[x] * 2],
+                                        row[xt.index1[x] * 2], xt.weight[x])];
+             }
+           });
+}
+
+void cs::ResizeYUYVToBGR(const uint8_t* src, int srcWidth, int srcHeight,
+                         uint8_t* dst, int dstWidth, int dstHeight) {
+  Taps xt{srcWidth, dstWidth};
+  // planar Y, U, V rows; chroma is shared by each pair of pixels
+  std::vector<uint8_t> yuv(dstWidth * 3);
+  uint8_t* yRow = yuv.data();
+  uint8_t* uRow = yRow + dstWidth;
+  uint8_t* vRow = uRow + dstWidth;
+  Resample(src, srcHeight, dstHeight, srcWidth * 2,
+           [&](int y, const int16_t* row) {
+             for (int x = 0; x < dstWidth; ++x) {
+               int i0 = xt.index0[x];
+               int i1 = xt.index1[x];
+               int w = xt.weight[x];
+               const int16_t* c0 = row + (i0 & ~1) * 2;
+               const int16_t* c1 = row + (i1 & ~1) * 2;
+               yRow[x] = Lerp(row[i0 * 2], row[i1 * 2], w);
+               uRow[x] = Lerp(c0[1], c1[1], w);
+               vRow[x] = Lerp(c0[3], c1[3], w);
+             }
+             ConvertRowYUVToBGR(yRow, uRow, vRow, dst + y * dstWidth * 3,
+                                dstWidth);
+           });
+}
+
+void cs::ResizeBGRToGray(const uint8_t* src, int srcWidth, int srcHeight,
+                         uint8_t* dst, int dstWidth, int dstHeight) {
+  Taps xt{srcWidth, dstWidth};
+  Resample(src, srcHeight, dstHeight, srcWidth * 3,
+           [&](int y, const int16_t* row) {
+             uint8_t* d = dst + y * dstWidth;
+             for (int x = 0; x < dstWidth; ++x) {
+               d[x] = Lerp(BGRToGray(row + xt.index0[x] * 3),
+                           BGRToGray(row + xt.index1[x] * 3), xt.weight[x]);
+             }
+           });
+}
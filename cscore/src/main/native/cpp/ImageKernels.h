@@ -0,0 +1,39 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_IMAGEKERNELS_H_
+#define CSCORE_IMAGEKERNELS_H_
+
+#include <stdint.h>
+
+namespace cs {
+
+// Fused color conversion and resampling kernels.  Each makes a single pass
+// over the source image and writes the destination directly, rather than
+// going through intermediate full-frame BGR and/or resized images.
+//
+// All images are tightly packed (no row padding).  YUYV images must have an
+// even width.  Resampling is bilinear, with the same pixel center alignment
+// as cv::resize() with INTER_LINEAR.  Color conversions produce the same
+// results (within rounding) as the equivalent cv::cvtColor() chain.
+
+// YUYV to grayscale, same size (equivalent to YUYV to BGR to gray).
+void ConvertYUYVToGray(const uint8_t* src, uint8_t* dst, int width,
+                       int height);
+
+// YUYV to grayscale with resampling.
+void ResizeYUYVToGray(const uint8_t* src, int srcWidth, int srcHeight,
+                      uint8_t* dst, int dstWidth, int dstHeight);
+
+// YUYV to BGR with resampling.
+void ResizeYUYVToBGR(const uint8_t* src, int srcWidth, int srcHeight,
+                     uint8_t* dst, int dstWidth, int dstHeight);
+
+// BGR to grayscale with resampling.
+void ResizeBGRToGray(const uint8_t* src, int srcWidth, int srcHeight,
+                     uint8_t* dst, int dstWidth, int dstHeight);
+
+}  // namespace cs
+
+#endif  // CSCORE_IMAGEKERNELS_H_
@@ -4,7 +4,15 @@
 
 #include "MjpegServerImpl.h"
 
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+
+#include <algorithm>
 #include <chrono>
+#include <utility>
 
 #include <fmt/format.h>
 #include <wpi/HttpUtil.h>
@@ -90,7 +98,7 @@ class MjpegServerImpl::ConnThread : public wpi::SafeThread {
 
   std::unique_ptr<wpi::NetworkStream> m_stream;
   std::shared_ptr<SourceImpl> m_source;
-  bool m_streaming = false;
+  std::weak_ptr<Broadcaster> m_broadcaster;
   bool m_noStreaming = false;
   int m_width = 0;
   int m_height = 0;
@@ -102,28 +110,97 @@ class MjpegServerImpl::ConnThread : public wpi::SafeThread {
   std::string m_name;
   wpi::Logger& m_logger;
 
+  // set by SendStream() when the stream should go to the broadcaster
+  bool m_handoff = false;
+
   std::string_view GetName() { return m_name; }
 
   std::shared_ptr<SourceImpl> GetSource() {
     std::scoped_lock lock(m_mutex);
     return m_source;
   }
+};
 
-  void StartStream() {
-    std::scoped_lock lock(m_mutex);
-    if (m_source) {
-      m_source->EnableSink();
+// Serves all streaming clients from a single thread.  Each frame is encoded
+// once per distinct set of stream settings and the same buffer is written to
+// every client with those settings.  Sockets are non-blocking; a client that
+// can't keep up skips intermediate frames rather than stalling the others.
+class MjpegServerImpl::Broadcaster : public wpi::SafeThread {
+ public:
+  struct Settings {
+    int width;
+    int height;
+    int compression;
+    int defaultCompression;
+
+    bool operator==(const Settings& oth) const {
+      return width == oth.width && height == oth.height &&
+             compression == oth.compression &&
+             defaultCompression == oth.defaultCompression;
     }
-    m_streaming = true;
-  }
+  };
 
-  void StopStream() {
-    std::scoped_lock lock(m_mutex);
-    if (m_source) {
-      m_source->DisableSink();
-    }
-    m_streaming = false;
-  }
+  Broadcaster(std::string_view name, wpi::Logger& logger)
+      : m_name(name), m_logger(logger) {}
+
+  void Main() override;
+
+  // Takes ownership of a stream whose HTTP header has already been sent.
+  // Must be called with m_mutex held.
+  void AddClient(std::unique_ptr<wpi::NetworkStream> stream,
+                 const Settings& settings, int fps);
+
+  std::shared_ptr<SourceImpl> m_source;
+  size_t m_numClients = 0;
+
+ private:
+  using Part = std::shared_ptr<const std::string>;
+
+  class Client {
+   public:
+    Client(std::unique_ptr<wpi::NetworkStream> stream, const Settings& settings,
+           int fps);
+
+    // Frame rate limiting; returns false if the frame should be dropped.
+    bool WantFrame(Frame::Time time);
+
+    // Queues a part for sending.  If a part is partially written, this
+    // replaces any part waiting behind it, so only the latest is kept.
+    void Queue(Part part);
+
+    // Writes as much as possible without blocking.  Returns false on error.
+    bool Write();
+
+    bool IsWriting() const { return m_part != nullptr; }
+
+    std::unique_ptr<wpi::NetworkStream> m_stream;
+    Settings m_settings;
+
+   private:
+    Frame::Time m_timePerFrame = 0;
+    Frame::Time m_averagePeriod = 1000000;  // 1 second window
+    Frame::Time m_averageFrameTime = 0;
+    Frame::Time m_lastFrameTime = 0;
+    Part m_part;
+    Part m_nextPart;
+    size_t m_offset = 0;
+  };
+
+  std::string m_name;
+  wpi::Logger& m_logger;
+
+  // clients not yet picked up by the thread; protected by m_mutex
+  std::vector<std::unique_ptr<Client>> m_newClients;
+
+  // source with a sink enabled; only accessed by the thread
+  std::shared_ptr<SourceImpl> m_enabledSource;
+
+  std::string_view GetName() { return m_name; }
+
+  void SetEnabledSource(std::shared_ptr<SourceImpl> source);
+  Part EncodePart(Frame& frame, const Settings& settings);
+  static void WaitWritable(const std::vector<std::unique_ptr<Client>>& clients,
+                           int timeoutMs);
 };
 
 // Standard header to send along with other header information like mimetype.
@@ -641,13 +718,19 @@ void MjpegServerImpl::Stop() {
     connThread.Stop();
   }
 
-  // wake up connection threads by forcing an empty frame to be sent
+  // The broadcaster logs through this server, so wait for it to exit.  It
+  // may be waiting for a frame; waking the source ends that wait early.
+  if (auto broadcaster = m_broadcaster.GetThread()) {
+    broadcaster->m_active = false;
+  }
   if (auto source = GetSource()) {
     source->Wakeup();
   }
+  m_broadcaster.Join();
 }
 
-// Send HTTP response and a stream of JPG-frames
+// Send HTTP response header for a stream of JPG-frames.  The frames
+// themselves are sent by the broadcaster.
 void MjpegServerImpl::ConnThread::SendStream(wpi::raw_socket_ostream& os) {
   if (m_noStreaming) {
     SERROR("{}", "Too many simultaneous client streams");
@@ -655,129 +738,272 @@ void MjpegServerImpl::ConnThread::SendStream(wpi::raw_socket_ostream& os) {
     return;
   }
 
-  os.SetUnbuffered();
+  SendHeader(os, 200, "OK", "multipart/x-mixed-replace;boundary=" BOUNDARY);
+  os.flush();
+  if (os.has_error()) {
+    return;
+  }
 
-  wpi::SmallString<256> header;
-  wpi::raw_svector_ostream oss{header};
+  SDEBUG("{}", "Headers send, handing off stream");
+  m_handoff = true;
+}
 
-  SendHeader(oss, 200, "OK", "multipart/x-mixed-replace;boundary=" BOUNDARY);
-  os << oss.str();
+MjpegServerImpl::Broadcaster::Client::Client(
+    std::unique_ptr<wpi::NetworkStream> stream, const Settings& settings,
+    int fps)
+    : m_stream{std::move(stream)}, m_settings{settings} {
+  if (fps != 0) {
+    m_timePerFrame = 1000000.0 / fps;
+  }
+  if (m_averagePeriod < m_timePerFrame) {
+    m_averagePeriod = m_timePerFrame * 10;
+  }
+}
 
-  SDEBUG("{}", "Headers send, sending stream now");
+bool MjpegServerImpl::Broadcaster::Client::WantFrame(Frame::Time time) {
+  if (time != 0 && m_timePerFrame != 0 && m_lastFrameTime != 0) {
+    Frame::Time deltaTime = time - m_lastFrameTime;
 
-  Frame::Time lastFrameTime = 0;
-  Frame::Time timePerFrame = 0;
-  if (m_fps != 0) {
-    timePerFrame = 1000000.0 / m_fps;
+    // drop frame if it is early compared to the desired frame rate AND
+    // the current average is higher than the desired average
+    if (deltaTime < m_timePerFrame && m_averageFrameTime < m_timePerFrame) {
+      return false;
+    }
+
+    // update average
+    if (m_averageFrameTime != 0) {
+      m_averageFrameTime = m_averageFrameTime *
+                               (m_averagePeriod - m_timePerFrame) /
+                               m_averagePeriod +
+                           deltaTime * m_timePerFrame / m_averagePeriod;
+    } else {
+      m_averageFrameTime = deltaTime;
+    }
   }
-  Frame::Time averageFrameTime = 0;
-  Frame::Time averagePeriod = 1000000;  // 1 second window
-  if (averagePeriod < timePerFrame) {
-    averagePeriod = timePerFrame * 10;
+  m_lastFrameTime = time;
+  return true;
+}
+
+void MjpegServerImpl::Broadcaster::Client::Queue(Part part) {
+  if (m_part) {
+    m_nextPart = std::move(part);
+  } else {
+    m_part = std::move(part);
+    m_offset = 0;
   }
+}
 
-  StartStream();
-  while (m_active && !os.has_error()) {
-    auto source = GetSource();
-    if (!source) {
-      // Source disconnected; sleep so we don't consume all processor time.
-      os << "\r\n";  // Keep connection alive
-      std::this_thread::sleep_for(std::chrono::milliseconds(200));
-      continue;
+bool MjpegServerImpl::Broadcaster::Client::Write() {
+  while (m_part) {
+    wpi::NetworkStream::Error err = wpi::NetworkStream::kConnectionClosed;
+    size_t count = m_stream->send(m_part->data() + m_offset,
+                                  m_part->size() - m_offset, &err);
+    if (count == 0) {
+      return err == wpi::NetworkStream::kWouldBlock;
     }
-    SDEBUG4("{}", "waiting for frame");
-    Frame frame = source->GetNextFrame(0.225);  // blocks
-    if (!m_active) {
-      break;
+    m_offset += count;
+    if (m_offset == m_part->size()) {
+      m_part = std::move(m_nextPart);
+      m_offset = 0;
+    }
+  }
+  return true;
+}
+
+void MjpegServerImpl::Broadcaster::AddClient(
+    std::unique_ptr<wpi::NetworkStream> stream, const Settings& settings,
+    int fps) {
+  stream->setBlocking(false);
+  m_newClients.emplace_back(
+      std::make_unique<Client>(std::move(stream), settings, fps));
+  ++m_numClients;
+  m_cond.notify_one();
+}
+
+void MjpegServerImpl::Broadcaster::SetEnabledSource(
+    std::shared_ptr<SourceImpl> source) {
+  if (source == m_enabledSource) {
+    return;
+  }
+  if (m_enabledSource) {
+    m_enabledSource->DisableSink();
+  }
+  if (source) {
+    source->EnableSink();
+  }
+  m_enabledSource = std::move(source);
+}
+
+// Build the multipart boundary, part headers, and JPEG data for a frame.
+MjpegServerImpl::Broadcaster::Part MjpegServerImpl::Broadcaster::EncodePart(
+    Frame& frame, const Settings& settings) {
+  int width = settings.width != 0 ? settings.width : frame.GetOriginalWidth();
+  int height =
+      settings.height != 0 ? settings.height : frame.GetOriginalHeight();
+  Image* image = frame.GetImageMJPEG(width, height, settings.compression,
+                                     settings.compression == -1
+                                         ? settings.defaultCompression
+                                         : settings.compression);
+  if (!image || image->pixelFormat != VideoMode::kMJPEG) {
+    return nullptr;
+  }
+
+  // Determine if we need to add DHT to it
+  const char* data = image->data();
+  size_t size = image->size();
+  size_t locSOF = size;
+  bool addDHT = JpegNeedsDHT(data, &size, &locSOF);
+
+  SDEBUG4("encoded frame size={} addDHT={}", size, addDHT);
+
+  // print the individual mimetype and the length
+  // sending the content-length fixes random stream disruption observed
+  // with firefox
+  auto part = std::make_shared<std::string>();
+  part->reserve(size + 128);
+  wpi::raw_string_ostream oss{*part};
+  oss << "\r\n--" BOUNDARY "\r\n"
+      << "Content-Type: image/jpeg\r\n";
+  fmt::print(oss, "Content-Length: {}\r\n", size);
+  fmt::print(oss, "X-Timestamp: {}\r\n", frame.GetTime() / 1000000.0);
+  oss << "\r\n";
+  if (addDHT) {
+    // Insert DHT data immediately before SOF
+    oss << std::string_view(data, locSOF);
+    oss << JpegGetDHT();
+    oss << std::string_view(data + locSOF, image->size() - locSOF);
+  } else {
+    oss << std::string_view(data, size);
+  }
+  oss.flush();
+  return part;
+}
+
+// Wait for any client with data pending to become writable.
+void MjpegServerImpl::Broadcaster::WaitWritable(
+    const std::vector<std::unique_ptr<Client>>& clients, int timeoutMs) {
+  fd_set writefds;
+  FD_ZERO(&writefds);
+  int maxfd = -1;
+  for (auto&& client : clients) {
+    if (!client->IsWriting()) {
+      continue;
     }
-    if (!frame) {
-      // Bad frame; sleep for 20 ms so we don't consume all processor time.
-      os << "\r\n";  // Keep connection alive
-      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    int fd = client->m_stream->getNativeHandle();
+#ifdef _WIN32
+    if (fd < 0) {
+#else
+    if (fd < 0 || fd >= FD_SETSIZE) {
+#endif
       continue;
     }
+    FD_SET(fd, &writefds);
+    maxfd = (std::max)(maxfd, fd);
+  }
+  if (maxfd < 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+    return;
+  }
+  struct timeval tv;
+  tv.tv_sec = 0;
+  tv.tv_usec = timeoutMs * 1000;
+  select(maxfd + 1, nullptr, &writefds, nullptr, &tv);
+}
 
-    auto thisFrameTime = frame.GetTime();
-    if (thisFrameTime != 0 && timePerFrame != 0 && lastFrameTime != 0) {
-      Frame::Time deltaTime = thisFrameTime - lastFrameTime;
+void MjpegServerImpl::Broadcaster::Main() {
+  static const auto keepAlive = std::make_shared<const std::string>("\r\n");
+  std::vector<std::unique_ptr<Client>> clients;
+  std::vector<std::pair<Settings, Part>> parts;
+  Frame::Time lastFrameTime = 0;
 
-      // drop frame if it is early compared to the desired frame rate AND
-      // the current average is higher than the desired average
-      if (deltaTime < timePerFrame && averageFrameTime < timePerFrame) {
-        // sleep for 1 ms so we don't consume all processor time
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        continue;
-      }
+  std::unique_lock lock(m_mutex);
+  while (m_active) {
+    for (auto&& client : m_newClients) {
+      clients.emplace_back(std::move(client));
+    }
+    m_newClients.clear();
+    m_numClients = clients.size();
+    if (clients.empty()) {
+      SetEnabledSource(nullptr);
+      m_cond.wait(lock);
+      continue;
+    }
+    auto source = m_source;
+    SetEnabledSource(source);
+    lock.unlock();
 
-      // update average
-      if (averageFrameTime != 0) {
-        averageFrameTime =
-            averageFrameTime * (averagePeriod - timePerFrame) / averagePeriod +
-            deltaTime * timePerFrame / averagePeriod;
-      } else {
-        averageFrameTime = deltaTime;
+    bool writing = std::any_of(clients.begin(), clients.end(),
+                               [](const auto& c) { return c->IsWriting(); });
+    Frame frame;
+    if (writing) {
+      // Let the sockets drain, then pick up the latest frame (if any).
+      WaitWritable(clients, 10);
+      if (source) {
+        frame = source->GetCurFrame();
       }
+    } else if (source) {
+      SDEBUG4("{}", "waiting for frame");
+      frame = source->GetNextFrame(0.225);  // blocks
     }
-
-    int width = m_width != 0 ? m_width : frame.GetOriginalWidth();
-    int height = m_height != 0 ? m_height : frame.GetOriginalHeight();
-    Image* image = frame.GetImageMJPEG(
-        width, height, m_compression,
-        m_compression == -1 ? m_defaultCompression : m_compression);
-    if (!image) {
-      // Shouldn't happen, but just in case...
-      std::this_thread::sleep_for(std::chrono::milliseconds(20));
-      continue;
+    if (!m_active) {
+      break;
     }
 
-    const char* data = image->data();
-    size_t size = image->size();
-    bool addDHT = false;
-    size_t locSOF = size;
-    switch (image->pixelFormat) {
-      case VideoMode::kMJPEG:
-        // Determine if we need to add DHT to it, and allocate enough space
-        // for adding it if required.
-        addDHT = JpegNeedsDHT(data, &size, &locSOF);
-        break;
-      case VideoMode::kYUYV:
-      case VideoMode::kRGB565:
-      default:
-        // Bad frame; sleep for 10 ms so we don't consume all processor time.
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        continue;
+    bool idle = false;
+    if (frame && frame.GetTime() != lastFrameTime) {
+      // Encode once for each distinct set of settings
+      lastFrameTime = frame.GetTime();
+      parts.clear();
+      for (auto&& client : clients) {
+        if (!client->WantFrame(lastFrameTime)) {
+          continue;
+        }
+        auto it = std::find_if(parts.begin(), parts.end(), [&](auto& p) {
+          return p.first == client->m_settings;
+        });
+        if (it == parts.end()) {
+          parts.emplace_back(client->m_settings,
+                             EncodePart(frame, client->m_settings));
+          it = std::prev(parts.end());
+        }
+        if (it->second) {
+          client->Queue(it->second);
+        }
+      }
+      parts.clear();
+    } else if (!writing) {
+      // No source or bad frame; keep connections alive
+      for (auto&& client : clients) {
+        client->Queue(keepAlive);
+      }
+      idle = true;
     }
 
-    SDEBUG4("sending frame size={} addDHT={}", size, addDHT);
-
-    // print the individual mimetype and the length
-    // sending the content-length fixes random stream disruption observed
-    // with firefox
-    lastFrameTime = thisFrameTime;
-    double timestamp = lastFrameTime / 1000000.0;
-    header.clear();
-    oss << "\r\n--" BOUNDARY "\r\n"
-        << "Content-Type: image/jpeg\r\n";
-    fmt::print(oss, "Content-Length: {}\r\n", size);
-    fmt::print(oss, "X-Timestamp: {}\r\n", timestamp);
-    oss << "\r\n";
-    os << oss.str();
-    if (addDHT) {
-      // Insert DHT data immediately before SOF
-      os << std::string_view(data, locSOF);
-      os << JpegGetDHT();
-      os << std::string_view(data + locSOF, image->size() - locSOF);
-    } else {
-      os << std::string_view(data, size);
+    // Drop clients with write errors
+    clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                 [&](const auto& c) {
+                                   if (c->Write()) {
+                                     return false;
+                                   }
+                                   SDEBUG("{}", "client stream closed");
+                                   return true;
+                                 }),
+                  clients.end());
+
+    if (idle) {
+      // Sleep so we don't consume all processor time.
+      std::this_thread::sleep_for(std::chrono::milliseconds(source ? 20 : 200));
     }
-    // os.flush();
+
+    lock.lock();
   }
-  StopStream();
+
+  SetEnabledSource(nullptr);
 }
 
 void MjpegServerImpl::ConnThread::ProcessRequest() {
   wpi::raw_socket_istream is{*m_stream};
-  wpi::raw_socket_ostream os{*m_stream, true};
+  wpi::raw_socket_ostream os{*m_stream, false};
 
   // Read the request string from the stream
   wpi::SmallString<128> reqBuf;
@@ -916,6 +1142,19 @@ void MjpegServerImpl::ConnThread::Main() {
     lock.unlock();
     ProcessRequest();
     lock.lock();
+    if (m_handoff) {
+      // Frames are sent by the broadcaster from here on
+      m_handoff = false;
+      if (auto broadcaster = m_broadcaster.lock()) {
+        std::scoped_lock broadcasterLock(broadcaster->m_mutex);
+        broadcaster->AddClient(
+            std::move(m_stream),
+            {m_width, m_height, m_compression, m_defaultCompression}, m_fps);
+      }
+    }
+    if (m_stream) {
+      m_stream->close();
+    }
     m_stream = nullptr;
   }
 }
@@ -954,20 +1193,23 @@ void MjpegServerImpl::ServerThreadMain() {
       it = std::prev(m_connThreads.end());
     }
 
-    // Start it if not already started
+    // Start it and the broadcaster if not already started
     it->Start(GetName(), m_logger);
+    m_broadcaster.Start(GetName(), m_logger);
 
-    auto nstreams =
-        std::count_if(m_connThreads.begin(), m_connThreads.end(),
-                      [](const wpi::SafeThreadOwner<ConnThread>& owner) {
-                        auto thr = owner.GetThread();
-                        return thr && thr->m_streaming;
-                      });
+    size_t nstreams = 0;
+    if (auto broadcaster = m_broadcaster.GetThread()) {
+      if (!broadcaster->m_source) {
+        broadcaster->m_source = source;
+      }
+      nstreams = broadcaster->m_numClients;
+    }
 
     // Hand off connection to it
     auto thr = it->GetThread();
     thr->m_stream = std::move(stream);
     thr->m_source = source;
+    thr->m_broadcaster = m_broadcaster.GetThreadSharedPtr();
     thr->m_noStreaming = nstreams >= 10;
     thr->m_width = GetProperty(m_widthProp)->value;
     thr->m_height = GetProperty(m_heightProp)->value;
@@ -984,18 +1226,13 @@ void MjpegServerImpl::SetSourceImpl(std::shared_ptr<SourceImpl> source) {
   std::scoped_lock lock(m_mutex);
   for (auto& connThread : m_connThreads) {
     if (auto thr = connThread.GetThread()) {
-      if (thr->m_source != source) {
-        bool streaming = thr->m_streaming;
-        if (thr->m_source && streaming) {
-          thr->m_source->DisableSink();
-        }
-        thr->m_source = source;
-        if (source && streaming) {
-          thr->m_source->EnableSink();
-        }
-      }
+      thr->m_source = source;
     }
   }
+  // the broadcaster moves the enabled sink over to the new source
+  if (auto broadcaster = m_broadcaster.GetThread()) {
+    broadcaster->m_source = source;
+  }
 }
 
 namespace cs {
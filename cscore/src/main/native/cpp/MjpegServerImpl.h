@@ -44,6 +44,7 @@ class MjpegServerImpl : public SinkImpl {
   void ServerThreadMain();
 
   class ConnThread;
+  class Broadcaster;
 
   // Never changed, so not protected by mutex
   std::string m_listenAddress;
@@ -55,6 +56,9 @@ class MjpegServerImpl : public SinkImpl {
 
   std::vector<wpi::SafeThreadOwner<ConnThread>> m_connThreads;
 
+  // Encodes and sends frames to all streaming clients
+  wpi::SafeThreadOwner<Broadcaster> m_broadcaster;
+
   // property indices
   int m_widthProp;
   int m_heightProp;
@@ -14,13 +14,16 @@ RawSinkImpl::RawSinkImpl(std::string_view name, wpi::Logger& logger,
                          Notifier& notifier, Telemetry& telemetry)
     : SinkImpl{name, logger, notifier, telemetry} {
   m_active = true;
+  CreateQueueProperties();
   // m_thread = std::thread(&RawSinkImpl::ThreadMain, this);
 }
 
 RawSinkImpl::RawSinkImpl(std::string_view name, wpi::Logger& logger,
                          Notifier& notifier, Telemetry& telemetry,
                          std::function<void(uint64_t time)> processFrame)
-    : SinkImpl{name, logger, notifier, telemetry} {}
+    : SinkImpl{name, logger, notifier, telemetry} {
+  CreateQueueProperties();
+}
 
 RawSinkImpl::~RawSinkImpl() {
   Stop();
@@ -42,6 +45,7 @@ void RawSinkImpl::Stop() {
 
 uint64_t RawSinkImpl::GrabFrame(CS_RawFrame& image) {
   SetEnabled(true);
+  RecordGrabStart();
 
   auto source = GetSource();
   if (!source) {
@@ -50,7 +54,7 @@ uint64_t RawSinkImpl::GrabFrame(CS_RawFrame& image) {
     return 0;
   }
 
-  auto frame = source->GetNextFrame();  // blocks
+  auto frame = GetNextFrame(*source, -1);  // blocks
   if (!frame) {
     // Bad frame; sleep for 20 ms so we don't consume all processor time.
     std::this_thread::sleep_for(std::chrono::milliseconds(20));
@@ -62,6 +66,7 @@ uint64_t RawSinkImpl::GrabFrame(CS_RawFrame& image) {
 
 uint64_t RawSinkImpl::GrabFrame(CS_RawFrame& image, double timeout) {
   SetEnabled(true);
+  RecordGrabStart();
 
   auto source = GetSource();
   if (!source) {
@@ -70,7 +75,7 @@ uint64_t RawSinkImpl::GrabFrame(CS_RawFrame& image, double timeout) {
     return 0;
   }
 
-  auto frame = source->GetNextFrame(timeout);  // blocks
+  auto frame = GetNextFrame(*source, timeout);  // blocks
   if (!frame) {
     // Bad frame; sleep for 20 ms so we don't consume all processor time.
     std::this_thread::sleep_for(std::chrono::milliseconds(20));
@@ -114,6 +119,7 @@ uint64_t RawSinkImpl::GrabFrameImpl(CS_RawFrame& rawFrame,
   std::copy(newImage->data(), newImage->data() + rawFrame.totalData,
             rawFrame.data);
 
+  RecordGrabDone(incomingFrame);
   return incomingFrame.GetTime();
 }
 
@@ -5,10 +5,14 @@
 #include "SinkImpl.h"
 
 #include <wpi/json.h>
+#include <wpi/timestamp.h>
 
+#include "FrameQueue.h"
 #include "Instance.h"
 #include "Notifier.h"
+#include "PropertyImpl.h"
 #include "SourceImpl.h"
+#include "Telemetry.h"
 
 using namespace cs;
 
@@ -21,6 +25,9 @@ SinkImpl::SinkImpl(std::string_view name, wpi::Logger& logger,
 
 SinkImpl::~SinkImpl() {
   if (m_source) {
+    if (m_queue) {
+      m_source->RemoveFrameQueue(m_queue.get());
+    }
     if (m_enabledCount > 0) {
       m_source->DisableSink();
     }
@@ -86,6 +93,10 @@ void SinkImpl::SetSource(std::shared_ptr<SourceImpl> source) {
       return;
     }
     if (m_source) {
+      if (m_queue) {
+        m_source->RemoveFrameQueue(m_queue.get());
+        m_queue.reset();
+      }
       if (m_enabledCount > 0) {
         m_source->DisableSink();
       }
@@ -195,3 +206,75 @@ void SinkImpl::UpdatePropertyValue(int property, bool setString, int value,
 }
 
 void SinkImpl::SetSourceImpl(std::shared_ptr<SourceImpl> source) {}
+
+void SinkImpl::CreateQueueProperties() {
+  m_queueDepthProp = CreateProperty("queue_depth", [] {
+    return std::make_unique<PropertyImpl>("queue_depth", CS_PROP_INTEGER, 0,
+                                          64, 1, 0, 0);
+  });
+  m_queuePolicyProp = CreateProperty("queue_policy", [] {
+    auto prop = std::make_unique<PropertyImpl>("queue_policy", CS_PROP_ENUM, 0,
+                                               1, 1, FrameQueue::kDropOldest,
+                                               FrameQueue::kDropOldest);
+    prop->enumChoices = {"drop oldest", "block"};
+    return prop;
+  });
+}
+
+Frame SinkImpl::GetNextFrame(SourceImpl& source, double timeout) {
+  auto queue = GetFrameQueue(source);
+  if (!queue) {
+    return timeout < 0 ? source.GetNextFrame() : source.GetNextFrame(timeout);
+  }
+
+  Frame frame = queue->Pop(timeout);
+  if (int64_t dropped = queue->TakeDropped()) {
+    m_telemetry.RecordSinkFramesDropped(*this, dropped);
+  }
+  if (!frame && timeout >= 0) {
+    return Frame{source, "timed out getting frame", wpi::Now()};
+  }
+  return frame;
+}
+
+std::shared_ptr<FrameQueue> SinkImpl::GetFrameQueue(SourceImpl& source) {
+  if (m_queueDepthProp < 0) {
+    return nullptr;
+  }
+  CS_Status status = 0;
+  int depth = GetProperty(m_queueDepthProp, &status);
+  auto policy = static_cast<FrameQueue::Policy>(
+      GetProperty(m_queuePolicyProp, &status));
+
+  std::scoped_lock lock(m_mutex);
+  if (m_queue &&
+      (m_queue->GetDepth() != depth || m_queue->GetPolicy() != policy)) {
+    // settings changed; queued frames are dropped with the old queue
+    if (m_source) {
+      m_source->RemoveFrameQueue(m_queue.get());
+    }
+    m_queue.reset();
+  }
+  if (!m_queue && depth > 0 && m_source.get() == &source) {
+    m_queue = std::make_shared<FrameQueue>(depth, policy);
+    source.AddFrameQueue(m_queue);
+  }
+  return m_queue;
+}
+
+void SinkImpl::RecordGrabStart() {
+  uint64_t grabDoneTime = m_grabDoneTime.exchange(0);
+  if (grabDoneTime != 0) {
+    m_telemetry.RecordSinkLatency(*this, CS_SINK_PROCESSING_LATENCY,
+                                  wpi::Now() - grabDoneTime);
+  }
+}
+
+void SinkImpl::RecordGrabDone(const Frame& frame) {
+  uint64_t now = wpi::Now();
+  Frame::Time putTime = frame.GetPutTime();
+  if (putTime != 0 && now > putTime) {
+    m_telemetry.RecordSinkLatency(*this, CS_SINK_GRAB_LATENCY, now - putTime);
+  }
+  m_grabDoneTime = now;
+}
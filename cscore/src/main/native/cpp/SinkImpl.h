@@ -5,6 +5,9 @@
 #ifndef CSCORE_SINKIMPL_H_
 #define CSCORE_SINKIMPL_H_
 
+#include <stdint.h>
+
+#include <atomic>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -21,6 +24,7 @@ class json;
 namespace cs {
 
 class Frame;
+class FrameQueue;
 class Notifier;
 class Telemetry;
 
@@ -64,16 +68,38 @@ class SinkImpl : public PropertyContainer {
 
   virtual void SetSourceImpl(std::shared_ptr<SourceImpl> source);
 
+  // Creates the "queue_depth" and "queue_policy" properties, which let users
+  // of sinks that grab frames opt in to a frame queue (see FrameQueue).  A
+  // depth of 0 (the default) gets only the latest frame.
+  void CreateQueueProperties();
+
+  // Waits for the next frame from the source; from the frame queue if one is
+  // enabled.  Waits forever if timeout is negative.
+  Frame GetNextFrame(SourceImpl& source, double timeout);
+
+  // Latency telemetry for sinks that hand frames to user code: call
+  // RecordGrabStart() when a grab starts and RecordGrabDone() when it returns
+  // a frame.  The time between the two calls is the user's processing time.
+  void RecordGrabStart();
+  void RecordGrabDone(const Frame& frame);
+
  protected:
   wpi::Logger& m_logger;
   Notifier& m_notifier;
   Telemetry& m_telemetry;
 
  private:
+  std::shared_ptr<FrameQueue> GetFrameQueue(SourceImpl& source);
+
   std::string m_name;
   std::string m_description;
   std::shared_ptr<SourceImpl> m_source;
   int m_enabledCount{0};
+  std::atomic<uint64_t> m_grabDoneTime{0};
+
+  int m_queueDepthProp{-1};
+  int m_queuePolicyProp{-1};
+  std::shared_ptr<FrameQueue> m_queue;  // attached to m_source
 };
 
 }  // namespace cs
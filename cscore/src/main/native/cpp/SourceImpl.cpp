@@ -12,6 +12,7 @@
 #include <wpi/json.h>
 #include <wpi/timestamp.h>
 
+#include "FrameQueue.h"
 #include "Log.h"
 #include "Notifier.h"
 #include "Telemetry.h"
@@ -92,11 +93,54 @@ Frame SourceImpl::GetNextFrame(double timeout) {
 }
 
 void SourceImpl::Wakeup() {
+  std::shared_ptr<const FrameQueueList> queues;
   {
     std::scoped_lock lock{m_frameMutex};
     m_frame = Frame{*this, std::string_view{}, 0};
+    queues = m_frameQueues;
   }
   m_frameCv.notify_all();
+  if (queues) {
+    for (auto&& queue : *queues) {
+      queue->Wakeup();
+    }
+  }
+}
+
+void SourceImpl::AddFrameQueue(std::shared_ptr<FrameQueue> queue) {
+  std::scoped_lock lock{m_frameMutex};
+  auto queues = std::make_shared<FrameQueueList>();
+  if (m_frameQueues) {
+    *queues = *m_frameQueues;
+  }
+  queues->emplace_back(std::move(queue));
+  m_frameQueues = std::move(queues);
+}
+
+void SourceImpl::RemoveFrameQueue(const FrameQueue* queue) {
+  std::shared_ptr<FrameQueue> removed;
+  {
+    std::scoped_lock lock{m_frameMutex};
+    if (!m_frameQueues) {
+      return;
+    }
+    auto queues = std::make_shared<FrameQueueList>();
+    for (auto&& q : *m_frameQueues) {
+      if (q.get() == queue) {
+        removed = q;
+      } else {
+        queues->emplace_back(q);
+      }
+    }
+    if (queues->empty()) {
+      queues.reset();
+    }
+    m_frameQueues = std::move(queues);
+  }
+  // release a producer blocked on it
+  if (removed) {
+    removed->Close();
+  }
 }
 
 void SourceImpl::SetBrightness(int brightness, CS_Status* status) {
@@ -451,29 +495,59 @@ void SourceImpl::PutFrame(VideoMode::PixelFormat pixelFormat, int width,
 }
 
 void SourceImpl::PutFrame(std::unique_ptr<Image> image, Frame::Time time) {
+  Frame::Time now = wpi::Now();
+
   // Update telemetry
   m_telemetry.RecordSourceFrames(*this, 1);
   m_telemetry.RecordSourceBytes(*this, static_cast<int>(image->size()));
+  m_telemetry.RecordSourceLatency(*this, CS_SOURCE_CAPTURE_LATENCY,
+                                  now > time ? now - time : 0);
 
   // Update frame
+  Frame frame;
+  std::shared_ptr<const FrameQueueList> queues;
   {
     std::scoped_lock lock{m_frameMutex};
     m_frame = Frame{*this, std::move(image), time};
+    m_frame.m_impl->putTime = now;
+    if (m_frameQueues) {
+      frame = m_frame;
+      queues = m_frameQueues;
+    }
   }
 
   // Signal listeners
   m_frameCv.notify_all();
+  PushFrameQueues(queues, frame);
 }
 
 void SourceImpl::PutError(std::string_view msg, Frame::Time time) {
   // Update frame
+  Frame frame;
+  std::shared_ptr<const FrameQueueList> queues;
   {
     std::scoped_lock lock{m_frameMutex};
     m_frame = Frame{*this, msg, time};
+    if (m_frameQueues) {
+      frame = m_frame;
+      queues = m_frameQueues;
+    }
   }
 
   // Signal listeners
   m_frameCv.notify_all();
+  PushFrameQueues(queues, frame);
+}
+
+void SourceImpl::PushFrameQueues(
+    const std::shared_ptr<const FrameQueueList>& queues, const Frame& frame) {
+  if (!queues) {
+    return;
+  }
+  // done outside m_frameMutex, as pushes may block
+  for (auto&& queue : *queues) {
+    queue->Push(frame);
+  }
 }
 
 void SourceImpl::NotifyPropertyCreated(int propIndex, PropertyImpl& prop) {
@@ -510,6 +584,10 @@ void SourceImpl::UpdatePropertyValue(int property, bool setString, int value,
 }
 
 void SourceImpl::ReleaseImage(std::unique_ptr<Image> image) {
+  // External images release their data when destroyed (outside the lock)
+  if (image->IsExternal()) {
+    return;
+  }
   std::scoped_lock lock{m_poolMutex};
   if (m_destroyFrames) {
     return;
@@ -28,6 +28,7 @@ class json;
 
 namespace cs {
 
+class FrameQueue;
 class Notifier;
 class Telemetry;
 
@@ -103,8 +104,14 @@ class SourceImpl : public PropertyContainer {
   Frame GetNextFrame(double timeout);
 
   // Force a wakeup of all GetNextFrame() callers by sending an empty frame.
+  // Also wakes up all frame queue consumers.
   void Wakeup();
 
+  // Frame queues for sinks that need every frame rather than the latest.
+  // Frames are pushed to each queue as well as becoming the current frame.
+  void AddFrameQueue(std::shared_ptr<FrameQueue> queue);
+  void RemoveFrameQueue(const FrameQueue* queue);
+
   // Standard common camera properties
   virtual void SetBrightness(int brightness, CS_Status* status);
   virtual int GetBrightness(CS_Status* status) const;
@@ -163,6 +170,10 @@ class SourceImpl : public PropertyContainer {
   Telemetry& m_telemetry;
 
  private:
+  using FrameQueueList = std::vector<std::shared_ptr<FrameQueue>>;
+
+  void PushFrameQueues(const std::shared_ptr<const FrameQueueList>& queues,
+                       const Frame& frame);
   void ReleaseImage(std::unique_ptr<Image> image);
   std::unique_ptr<Frame::Impl> AllocFrameImpl();
   void ReleaseFrameImpl(std::unique_ptr<Frame::Impl> data);
@@ -190,6 +201,11 @@ class SourceImpl : public PropertyContainer {
   // MUST be located below m_poolMutex as the Frame destructor calls back
   // into SourceImpl::ReleaseImage, which locks m_poolMutex.
   Frame m_frame;
+
+  // Frame queues (copied on write so frames can be pushed without holding
+  // m_frameMutex).  Access protected by m_frameMutex; same location
+  // requirement as m_frame.
+  std::shared_ptr<const FrameQueueList> m_frameQueues;
 };
 
 }  // namespace cs
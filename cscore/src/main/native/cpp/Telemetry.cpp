@@ -4,6 +4,8 @@
 
 #include "Telemetry.h"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <limits>
 
@@ -13,11 +15,45 @@
 #include "Handle.h"
 #include "Instance.h"
 #include "Notifier.h"
+#include "SinkImpl.h"
 #include "SourceImpl.h"
 #include "cscore_cpp.h"
 
 using namespace cs;
 
+namespace {
+struct Histogram {
+  void Add(uint64_t latency);
+  int64_t GetMean() const { return count == 0 ? 0 : sum / count; }
+
+  int64_t count = 0;
+  int64_t sum = 0;
+  std::array<int64_t, CS_TELEMETRY_HISTOGRAM_BUCKETS> buckets{};
+};
+}  // namespace
+
+void Histogram::Add(uint64_t latency) {
+  ++buckets[Telemetry::GetHistogramBucket(latency)];
+  ++count;
+  sum += latency;
+}
+
+int Telemetry::GetHistogramBucket(uint64_t latency) {
+  // doubling buckets: <100us, <200us, ... with the last one unbounded
+  int bucket = 0;
+  for (uint64_t limit = 100;
+       latency >= limit && bucket < CS_TELEMETRY_HISTOGRAM_BUCKETS - 1;
+       limit *= 2) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+static bool IsLatencyKind(CS_TelemetryKind kind) {
+  return kind == CS_SOURCE_CAPTURE_LATENCY || kind == CS_SINK_GRAB_LATENCY ||
+         kind == CS_SINK_PROCESSING_LATENCY;
+}
+
 class Telemetry::Thread : public wpi::SafeThread {
  public:
   explicit Thread(Notifier& notifier) : m_notifier(notifier) {}
@@ -27,14 +63,23 @@ class Telemetry::Thread : public wpi::SafeThread {
   Notifier& m_notifier;
   wpi::DenseMap<std::pair<CS_Handle, int>, int64_t> m_user;
   wpi::DenseMap<std::pair<CS_Handle, int>, int64_t> m_current;
+  wpi::DenseMap<std::pair<CS_Handle, int>, Histogram> m_userLatency;
+  wpi::DenseMap<std::pair<CS_Handle, int>, Histogram> m_currentLatency;
   double m_period = 0.0;
   double m_elapsed = 0.0;
   bool m_updated = false;
   int64_t GetValue(CS_Handle handle, CS_TelemetryKind kind, CS_Status* status);
+  const Histogram* GetLatency(CS_Handle handle, CS_TelemetryKind kind,
+                              CS_Status* status);
 };
 
 int64_t Telemetry::Thread::GetValue(CS_Handle handle, CS_TelemetryKind kind,
                                     CS_Status* status) {
+  if (IsLatencyKind(kind)) {
+    // mean latency rather than the total
+    auto hist = GetLatency(handle, kind, status);
+    return hist ? hist->GetMean() : 0;
+  }
   auto it = m_user.find(std::make_pair(handle, static_cast<int>(kind)));
   if (it == m_user.end()) {
     *status = CS_EMPTY_VALUE;
@@ -43,6 +88,17 @@ int64_t Telemetry::Thread::GetValue(CS_Handle handle, CS_TelemetryKind kind,
   return it->getSecond();
 }
 
+const Histogram* Telemetry::Thread::GetLatency(CS_Handle handle,
+                                               CS_TelemetryKind kind,
+                                               CS_Status* status) {
+  auto it = m_userLatency.find(std::make_pair(handle, static_cast<int>(kind)));
+  if (it == m_userLatency.end()) {
+    *status = CS_EMPTY_VALUE;
+    return nullptr;
+  }
+  return &it->getSecond();
+}
+
 Telemetry::~Telemetry() = default;
 
 void Telemetry::Start() {
@@ -78,6 +134,8 @@ void Telemetry::Thread::Main() {
     // move to user and clear current, as we don't keep around old values
     m_user = std::move(m_current);
     m_current.clear();
+    m_userLatency = std::move(m_currentLatency);
+    m_currentLatency.clear();
     auto curTime = std::chrono::steady_clock::now();
     m_elapsed = std::chrono::duration<double>(curTime - prevTime).count();
     prevTime = curTime;
@@ -125,12 +183,33 @@ double Telemetry::GetAverageValue(CS_Handle handle, CS_TelemetryKind kind,
     *status = CS_TELEMETRY_NOT_ENABLED;
     return 0;
   }
+  if (IsLatencyKind(kind)) {
+    // a rate isn't meaningful for latencies; use the mean instead
+    auto hist = thr->GetLatency(handle, kind, status);
+    if (!hist || hist->count == 0) {
+      return 0.0;
+    }
+    return static_cast<double>(hist->sum) / hist->count;
+  }
   if (thr->m_elapsed == 0) {
     return 0.0;
   }
   return thr->GetValue(handle, kind, status) / thr->m_elapsed;
 }
 
+void Telemetry::GetHistogram(CS_Handle handle, CS_TelemetryKind kind,
+                             int64_t* buckets, CS_Status* status) {
+  std::fill_n(buckets, CS_TELEMETRY_HISTOGRAM_BUCKETS, 0);
+  auto thr = m_owner.GetThread();
+  if (!thr) {
+    *status = CS_TELEMETRY_NOT_ENABLED;
+    return;
+  }
+  if (auto hist = thr->GetLatency(handle, kind, status)) {
+    std::copy(hist->buckets.begin(), hist->buckets.end(), buckets);
+  }
+}
+
 void Telemetry::RecordSourceBytes(const SourceImpl& source, int quantity) {
   auto thr = m_owner.GetThread();
   if (!thr) {
@@ -152,3 +231,40 @@ void Telemetry::RecordSourceFrames(const SourceImpl& source, int quantity) {
                                 static_cast<int>(CS_SOURCE_FRAMES_RECEIVED))] +=
       quantity;
 }
+
+void Telemetry::RecordSinkFramesDropped(const SinkImpl& sink,
+                                        int64_t quantity) {
+  auto thr = m_owner.GetThread();
+  if (!thr) {
+    return;
+  }
+  auto handleData = Instance::GetInstance().FindSink(sink);
+  thr->m_current[std::make_pair(Handle{handleData.first, Handle::kSink},
+                                static_cast<int>(CS_SINK_FRAMES_DROPPED))] +=
+      quantity;
+}
+
+void Telemetry::RecordSourceLatency(const SourceImpl& source,
+                                    CS_TelemetryKind kind, uint64_t latency) {
+  auto thr = m_owner.GetThread();
+  if (!thr) {
+    return;
+  }
+  auto handleData = Instance::GetInstance().FindSource(source);
+  thr->m_currentLatency[std::make_pair(Handle{handleData.first,
+                                              Handle::kSource},
+                                       static_cast<int>(kind))]
+      .Add(latency);
+}
+
+void Telemetry::RecordSinkLatency(const SinkImpl& sink, CS_TelemetryKind kind,
+                                  uint64_t latency) {
+  auto thr = m_owner.GetThread();
+  if (!thr) {
+    return;
+  }
+  auto handleData = Instance::GetInstance().FindSink(sink);
+  thr->m_currentLatency[std::make_pair(Handle{handleData.first, Handle::kSink},
+                                       static_cast<int>(kind))]
+      .Add(latency);
+}
@@ -12,6 +12,7 @@
 namespace cs {
 
 class Notifier;
+class SinkImpl;
 class SourceImpl;
 
 class Telemetry {
@@ -30,10 +31,21 @@ class Telemetry {
   int64_t GetValue(CS_Handle handle, CS_TelemetryKind kind, CS_Status* status);
   double GetAverageValue(CS_Handle handle, CS_TelemetryKind kind,
                          CS_Status* status);
+  void GetHistogram(CS_Handle handle, CS_TelemetryKind kind, int64_t* buckets,
+                    CS_Status* status);
+
+  // Gets the histogram bucket for a latency in microseconds.
+  static int GetHistogramBucket(uint64_t latency);
 
   // Telemetry events
   void RecordSourceBytes(const SourceImpl& source, int quantity);
   void RecordSourceFrames(const SourceImpl& source, int quantity);
+  void RecordSinkFramesDropped(const SinkImpl& sink, int64_t quantity);
+  // latency is in microseconds
+  void RecordSourceLatency(const SourceImpl& source, CS_TelemetryKind kind,
+                           uint64_t latency);
+  void RecordSinkLatency(const SinkImpl& sink, CS_TelemetryKind kind,
+                         uint64_t latency);
 
  private:
   Notifier& m_notifier;
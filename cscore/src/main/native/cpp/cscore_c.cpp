@@ -436,6 +436,13 @@ double CS_GetTelemetryAverageValue(CS_Handle handle, CS_TelemetryKind kind,
   return cs::GetTelemetryAverageValue(handle, kind, status);
 }
 
+void CS_GetTelemetryHistogram(CS_Handle handle, CS_TelemetryKind kind,
+                              int64_t* buckets, CS_Status* status) {
+  wpi::SmallVector<int64_t, CS_TELEMETRY_HISTOGRAM_BUCKETS> buf;
+  auto hist = cs::GetTelemetryHistogram(handle, kind, buf, status);
+  std::copy(hist.begin(), hist.end(), buckets);
+}
+
 void CS_SetLogger(CS_LogFunc func, unsigned int min_level) {
   cs::SetLogger(func, min_level);
 }
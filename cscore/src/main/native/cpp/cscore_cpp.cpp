@@ -835,6 +835,16 @@ double GetTelemetryAverageValue(CS_Handle handle, CS_TelemetryKind kind,
                                                            status);
 }
 
+wpi::span<int64_t> GetTelemetryHistogram(CS_Handle handle,
+                                         CS_TelemetryKind kind,
+                                         wpi::SmallVectorImpl<int64_t>& buckets,
+                                         CS_Status* status) {
+  buckets.resize(CS_TELEMETRY_HISTOGRAM_BUCKETS);
+  Instance::GetInstance().telemetry.GetHistogram(handle, kind, buckets.data(),
+                                                 status);
+  return buckets;
+}
+
 //
 // Logging Functions
 //
@@ -2041,6 +2041,32 @@ Java_edu_wpi_first_cscore_CameraServerJNI_getTelemetryAverageValue
   return val;
 }
 
+/*
+ * Class:     edu_wpi_first_cscore_CameraServerJNI
+ * Method:    getTelemetryHistogram
+ * Signature: (II)[J
+ */
+JNIEXPORT jlongArray JNICALL
+Java_edu_wpi_first_cscore_CameraServerJNI_getTelemetryHistogram
+  (JNIEnv* env, jclass, jint handle, jint kind)
+{
+  CS_Status status = 0;
+  wpi::SmallVector<int64_t, CS_TELEMETRY_HISTOGRAM_BUCKETS> buf;
+  auto hist = cs::GetTelemetryHistogram(
+      handle, static_cast<CS_TelemetryKind>(kind), buf, &status);
+  if (!CheckStatus(env, status)) {
+    return nullptr;
+  }
+  wpi::SmallVector<jlong, CS_TELEMETRY_HISTOGRAM_BUCKETS> arr(hist.begin(),
+                                                             hist.end());
+  jlongArray jarr = env->NewLongArray(arr.size());
+  if (!jarr) {
+    return nullptr;
+  }
+  env->SetLongArrayRegion(jarr, 0, arr.size(), arr.data());
+  return jarr;
+}
+
 /*
  * Class:     edu_wpi_first_cscore_CameraServerJNI
  * Method:    enumerateUsbCameras
@@ -179,9 +179,24 @@ enum CS_EventKind {
  */
 enum CS_TelemetryKind {
   CS_SOURCE_BYTES_RECEIVED = 1,
-  CS_SOURCE_FRAMES_RECEIVED = 2
+  CS_SOURCE_FRAMES_RECEIVED = 2,
+  /** Capture (exposure) to frame available in the source, microseconds */
+  CS_SOURCE_CAPTURE_LATENCY = 3,
+  /** Frame available in the source to frame grabbed by the sink */
+  CS_SINK_GRAB_LATENCY = 4,
+  /** Time taken by the sink to process a grabbed frame */
+  CS_SINK_PROCESSING_LATENCY = 5,
+  /** Frames dropped from the sink's frame queue */
+  CS_SINK_FRAMES_DROPPED = 6
 };
 
+/**
+ * Number of buckets in latency telemetry histograms.  Bucket i counts
+ * latencies less than 100 << i microseconds (and at least the previous
+ * bucket's limit); the last bucket counts all larger latencies.
+ */
+enum { CS_TELEMETRY_HISTOGRAM_BUCKETS = 12 };
+
 /** Connection strategy */
 enum CS_ConnectionStrategy {
   /**
@@ -461,6 +476,8 @@ int64_t CS_GetTelemetryValue(CS_Handle handle, enum CS_TelemetryKind kind,
                              CS_Status* status);
 double CS_GetTelemetryAverageValue(CS_Handle handle, enum CS_TelemetryKind kind,
                                    CS_Status* status);
+void CS_GetTelemetryHistogram(CS_Handle handle, enum CS_TelemetryKind kind,
+                              int64_t* buckets, CS_Status* status);
 /** @} */
 
 /**
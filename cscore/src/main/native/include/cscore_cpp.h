@@ -405,6 +405,10 @@ int64_t GetTelemetryValue(CS_Handle handle, CS_TelemetryKind kind,
                           CS_Status* status);
 double GetTelemetryAverageValue(CS_Handle handle, CS_TelemetryKind kind,
                                 CS_Status* status);
+wpi::span<int64_t> GetTelemetryHistogram(CS_Handle handle,
+                                         CS_TelemetryKind kind,
+                                         wpi::SmallVectorImpl<int64_t>& buckets,
+                                         CS_Status* status);
 /** @} */
 
 /**
@@ -113,6 +113,16 @@ class CvSource : public ImageSource {
  * These sinks require the WPILib OpenCV builds.
  * For an alternate OpenCV, include "cscore_raw_cv.h" instead, and
  * include your Mat header before that header.
+ *
+ * The "width" and "height" properties set the size of grabbed images (0, the
+ * default, uses the source size).  Requesting a smaller size allows MJPEG
+ * frames to be decoded directly at reduced scale.
+ *
+ * By default GrabFrame() returns the latest frame, so frames are skipped if
+ * the sink is slower than the source.  Setting the "queue_depth" property
+ * queues up to that many frames for the sink instead; the "queue_policy"
+ * property selects whether the oldest frame is dropped when the queue is
+ * full ("drop oldest") or the source waits for the sink ("block").
  */
 class CvSink : public ImageSink {
  public:
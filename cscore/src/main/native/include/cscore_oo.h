@@ -465,6 +465,16 @@ class UsbCamera : public VideoCamera {
    * @param level 0=don't display Connecting message, 1=do display message
    */
   void SetConnectVerbose(int level);
+
+  /**
+   * Set whether frames use the camera's capture buffers directly instead of
+   * copying them (Linux only).  Each buffer is returned to the camera when
+   * the last sink releases the frame; if too few buffers are available,
+   * frames are copied as usual.
+   *
+   * @param enabled true to enable zero-copy capture
+   */
+  void SetZeroCopy(bool enabled);
 };
 
 /**
@@ -17,9 +17,11 @@
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
 
 #include <fmt/format.h>
@@ -56,6 +58,8 @@ static constexpr char const* kPropExValue = "exposure_absolute";
 static constexpr char const* kPropBrValue = "brightness";
 static constexpr char const* kPropConnectVerbose = "connect_verbose";
 static constexpr unsigned kPropConnectVerboseId = 0;
+static constexpr char const* kPropZeroCopy = "zero_copy";
+static constexpr unsigned kPropZeroCopyId = 1;
 
 // Conversions v4l2_fract time per frame from/to frames per second (fps)
 static inline int FractToFPS(const struct v4l2_fract& timeperframe) {
@@ -69,6 +73,32 @@ static inline struct v4l2_fract FPSToFract(int fps) {
   return timeperframe;
 }
 
+// Converts the driver's capture timestamp to the wpi::Now() time base.  The
+// driver stamps buffers with CLOCK_MONOTONIC, which may differ from the
+// wpi::Now() clock, so apply the age of the buffer to the current time
+// instead of using the timestamp directly.  Falls back to the current time if
+// the driver doesn't provide a usable timestamp.
+static Frame::Time GetCaptureTime(const struct v4l2_buffer& buf) {
+  Frame::Time now = wpi::Now();
+  if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) !=
+          V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC ||
+      (buf.timestamp.tv_sec == 0 && buf.timestamp.tv_usec == 0)) {
+    return now;
+  }
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+    return now;
+  }
+  int64_t age = (static_cast<int64_t>(ts.tv_sec) - buf.timestamp.tv_sec) *
+                    1000000 +
+                ts.tv_nsec / 1000 - buf.timestamp.tv_usec;
+  // ignore implausible values (e.g. from broken drivers)
+  if (age < 0 || age > 1000000 || static_cast<uint64_t>(age) > now) {
+    return now;
+  }
+  return now - age;
+}
+
 // Conversion from v4l2_format pixelformat to VideoMode::PixelFormat
 static VideoMode::PixelFormat ToPixelFormat(__u32 pixelFormat) {
   switch (pixelFormat) {
@@ -324,6 +354,12 @@ UsbCameraImpl::UsbCameraImpl(std::string_view name, wpi::Logger& logger,
                                                kPropConnectVerboseId,
                                                CS_PROP_INTEGER, 0, 1, 1, 1, 1);
   });
+  CreateProperty(kPropZeroCopy, [] {
+    return std::make_unique<UsbCameraProperty>(kPropZeroCopy, kPropZeroCopyId,
+                                               CS_PROP_BOOLEAN, 0, 1, 1, 0, 0);
+  });
+
+  m_lent->wakeup_fd = m_command_fd;
 }
 
 UsbCameraImpl::~UsbCameraImpl() {
@@ -341,7 +377,11 @@ UsbCameraImpl::~UsbCameraImpl() {
     m_cameraThread.join();
   }
 
-  // close command fd
+  // close command fd (after making sure no frame release can write to it)
+  {
+    std::scoped_lock lock(m_lent->mutex);
+    m_lent->wakeup_fd = -1;
+  }
   int fd = m_command_fd.exchange(-1);
   if (fd >= 0) {
     close(fd);
@@ -487,6 +527,7 @@ void UsbCameraImpl::CameraThreadMain() {
       // Read it to clear
       eventfd_t val;
       eventfd_read(command_fd, &val);
+      DeviceRequeueBuffers();
       DeviceProcessCommands();
       continue;
     }
@@ -512,14 +553,16 @@ void UsbCameraImpl::CameraThreadMain() {
       if ((buf.flags & V4L2_BUF_FLAG_ERROR) == 0) {
         SDEBUG4("got image size={} index={}", buf.bytesused, buf.index);
 
-        if (buf.index >= kNumBuffers || !m_buffers[buf.index].m_data) {
+        if (buf.index >= kNumBuffers || !m_buffers[buf.index] ||
+            !m_buffers[buf.index]->m_data) {
           SWARNING("invalid buffer {}", buf.index);
           continue;
         }
 
         std::string_view image{
-            static_cast<const char*>(m_buffers[buf.index].m_data),
+            static_cast<const char*>(m_buffers[buf.index]->m_data),
             static_cast<size_t>(buf.bytesused)};
+        Frame::Time captureTime = GetCaptureTime(buf);
         int width = m_mode.width;
         int height = m_mode.height;
         bool good = true;
@@ -528,9 +571,51 @@ void UsbCameraImpl::CameraThreadMain() {
           SWARNING("{}", "invalid JPEG image received from camera");
           good = false;
         }
+        if (good && m_zeroCopy) {
+          // lend the buffer to the frame unless that would leave the driver
+          // too few buffers to capture into
+          int index = buf.index;
+          unsigned generation = 0;
+          bool lend = false;
+          {
+            std::scoped_lock lock(m_lent->mutex);
+            if (m_lent->count < kNumBuffers - kMinQueuedBuffers) {
+              ++m_lent->count;
+              generation = m_lent->generation;
+              lend = true;
+            }
+          }
+          if (lend) {
+            m_bufferLent[index] = true;
+            SDEBUG4("lending buffer {}", index);
+            auto frameImage = std::make_unique<Image>(
+                static_cast<uchar*>(m_buffers[index]->m_data), image.size(),
+                // buffer keeps the memory mapped until the frame is released
+                [lent = m_lent, buffer = m_buffers[index], index, generation] {
+                  {
+                    std::scoped_lock lock(lent->mutex);
+                    if (lent->generation != generation) {
+                      return;  // buffers were unmapped and remapped
+                    }
+                    --lent->count;
+                    lent->returned.push_back(index);
+                    if (lent->wakeup_fd >= 0) {
+                      eventfd_write(lent->wakeup_fd, 1);
+                    }
+                  }
+                  lent->cv.notify_all();
+                });
+            frameImage->pixelFormat =
+                static_cast<VideoMode::PixelFormat>(m_mode.pixelFormat);
+            frameImage->width = width;
+            frameImage->height = height;
+            PutFrame(std::move(frameImage), captureTime);
+            continue;  // requeued when the frame is released
+          }
+        }
         if (good) {
           PutFrame(static_cast<VideoMode::PixelFormat>(m_mode.pixelFormat),
-                   width, height, image, wpi::Now());  // TODO: time
+                   width, height, image, captureTime);
         }
       }
 
@@ -557,9 +642,18 @@ void UsbCameraImpl::DeviceDisconnect() {
     return;  // already disconnected
   }
 
-  // Unmap buffers
+  // Unmap buffers.  Any still lent to frames stay mapped until released, but
+  // are not requeued.
+  DeviceWaitForLentBuffers();
+  {
+    std::scoped_lock lock(m_lent->mutex);
+    ++m_lent->generation;
+    m_lent->count = 0;
+    m_lent->returned.clear();
+  }
+  m_bufferLent.fill(false);
   for (int i = 0; i < kNumBuffers; ++i) {
-    m_buffers[i] = UsbCameraBuffer{};
+    m_buffers[i].reset();
   }
 
   // Close device
@@ -654,19 +748,20 @@ void UsbCameraImpl::DeviceConnect() {
     }
     SDEBUG4("buf {} length={} offset={}", i, buf.length, buf.m.offset);
 
-    m_buffers[i] = UsbCameraBuffer(fd, buf.length, buf.m.offset);
-    if (!m_buffers[i].m_data) {
+    m_buffers[i] =
+        std::make_shared<UsbCameraBuffer>(fd, buf.length, buf.m.offset);
+    if (!m_buffers[i]->m_data) {
       SWARNING("could not map buffer {}", i);
       // release other buffers
-      for (int j = 0; j < i; ++j) {
-        m_buffers[j] = UsbCameraBuffer{};
+      for (int j = 0; j <= i; ++j) {
+        m_buffers[j].reset();
       }
       close(fd);
       m_fd = -1;
       return;
     }
 
-    SDEBUG4("buf {} address={}", i, m_buffers[i].m_data);
+    SDEBUG4("buf {} address={}", i, m_buffers[i]->m_data);
   }
 
   // Update description (as it may have changed)
@@ -688,9 +783,12 @@ bool UsbCameraImpl::DeviceStreamOn() {
     return false;
   }
 
-  // Queue buffers
+  // Queue buffers (except those lent to frames, which are queued on release)
   SDEBUG3("{}", "queuing buffers");
   for (int i = 0; i < kNumBuffers; ++i) {
+    if (m_bufferLent[i]) {
+      continue;
+    }
     struct v4l2_buffer buf;
     std::memset(&buf, 0, sizeof(buf));
     buf.index = i;
@@ -740,6 +838,49 @@ bool UsbCameraImpl::DeviceStreamOff() {
   return true;
 }
 
+void UsbCameraImpl::DeviceRequeueBuffers() {
+  wpi::SmallVector<int, kNumBuffers> returned;
+  {
+    std::scoped_lock lock(m_lent->mutex);
+    returned.swap(m_lent->returned);
+  }
+  int fd = m_fd.load();
+  for (int index : returned) {
+    m_bufferLent[index] = false;
+    // if not streaming, DeviceStreamOn() queues it
+    if (!m_streaming || fd < 0) {
+      continue;
+    }
+    SDEBUG4("requeuing lent buffer {}", index);
+    struct v4l2_buffer buf;
+    std::memset(&buf, 0, sizeof(buf));
+    buf.index = index;
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (DoIoctl(fd, VIDIOC_QBUF, &buf) != 0) {
+      SWARNING("could not requeue buffer {}", index);
+    }
+  }
+}
+
+void UsbCameraImpl::DeviceWaitForLentBuffers() {
+  std::unique_lock lock(m_lent->mutex);
+  if (m_lent->count == 0) {
+    return;
+  }
+
+  // The device can't reallocate its buffers while they are mapped, so drop
+  // the source's reference to the latest frame and give sinks a moment to
+  // release theirs.
+  lock.unlock();
+  Wakeup();
+  lock.lock();
+  if (!m_lent->cv.wait_for(lock, std::chrono::milliseconds(200),
+                           [&] { return m_lent->count == 0; })) {
+    SDEBUG("{} buffers still in use by frames", m_lent->count);
+  }
+}
+
 CS_StatusValue UsbCameraImpl::DeviceCmdSetMode(
     std::unique_lock<wpi::mutex>& lock, const Message& msg) {
   VideoMode newMode;
@@ -850,6 +991,8 @@ CS_StatusValue UsbCameraImpl::DeviceCmdSetProperty(
   if (!prop->device) {
     if (prop->id == kPropConnectVerboseId) {
       m_connectVerbose = value;
+    } else if (prop->id == kPropZeroCopyId) {
+      m_zeroCopy = value != 0;
     }
   } else {
     if (!prop->DeviceSet(lock, m_fd, value, valueStr)) {
@@ -7,6 +7,7 @@
 
 #include <linux/videodev2.h>
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <string>
@@ -115,6 +116,8 @@ class UsbCameraImpl : public SourceImpl {
   void DeviceConnect();
   bool DeviceStreamOn();
   bool DeviceStreamOff();
+  void DeviceRequeueBuffers();
+  void DeviceWaitForLentBuffers();
   void DeviceProcessCommands();
   void DeviceSetMode();
   void DeviceSetFPS();
@@ -150,7 +153,32 @@ class UsbCameraImpl : public SourceImpl {
   unsigned m_capabilities = 0;
   // Number of buffers to ask OS for
   static constexpr int kNumBuffers = 4;
-  std::array<UsbCameraBuffer, kNumBuffers> m_buffers;
+  // Shared so a zero-copy frame keeps its buffer mapped until released
+  std::array<std::shared_ptr<UsbCameraBuffer>, kNumBuffers> m_buffers;
+  // Zero-copy mode: frames use the mapped buffers directly, and each buffer
+  // is requeued when the frame using it is released.  Falls back to copying
+  // when lending another buffer would leave fewer than kMinQueuedBuffers
+  // queued to the driver.
+  static constexpr int kMinQueuedBuffers = 2;
+  bool m_zeroCopy{false};
+  // Buffers lent to frames and not yet requeued
+  std::array<bool, kNumBuffers> m_bufferLent{};
+
+  // State shared with the release callbacks of zero-copy frames, which may
+  // run on any thread and may outlive the camera.
+  struct LentBuffers {
+    wpi::mutex mutex;
+    wpi::condition_variable cv;
+    // Incremented when the buffers are unmapped; stale returns are ignored
+    unsigned generation{0};
+    // Number of buffers currently lent
+    int count{0};
+    // Buffers released by their frames, waiting to be requeued
+    wpi::SmallVector<int, kNumBuffers> returned;
+    // Wakes the camera thread to requeue returned buffers
+    int wakeup_fd{-1};
+  };
+  std::shared_ptr<LentBuffers> m_lent = std::make_shared<LentBuffers>();
 
   std::atomic_int m_fd;
   std::atomic_int m_command_fd;  // for command eventfd
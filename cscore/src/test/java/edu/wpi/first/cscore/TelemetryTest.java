@@ -0,0 +1,52 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+package edu.wpi.first.cscore;
+
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.nio.ByteBuffer;
+import java.util.Arrays;
+import org.junit.jupiter.api.Test;
+
+class TelemetryTest {
+  private static final int kHistogramBuckets = 12;
+
+  @Test
+  void histogramTest() throws InterruptedException {
+    CameraServerJNI.setTelemetryPeriod(0.05);
+    int gray = VideoMode.PixelFormat.kGray.getValue();
+    int source = CameraServerJNI.createRawSource("telemetry", gray, 4, 1, 30);
+    try {
+      // put frames until a telemetry period has seen some
+      ByteBuffer data = ByteBuffer.allocateDirect(4);
+      long count = 0;
+      for (int i = 0; i < 200 && count == 0; i++) {
+        CameraServerJNI.putRawSourceFrameBB(source, data, 4, 1, gray, 4);
+        Thread.sleep(10);
+        try {
+          long[] hist =
+              CameraServerJNI.getTelemetryHistogram(
+                  source, CameraServerJNI.TelemetryKind.kSourceCaptureLatency);
+          assertEquals(kHistogramBuckets, hist.length);
+          count = Arrays.stream(hist).sum();
+        } catch (VideoException ex) {
+          // nothing recorded in the last period yet
+        }
+      }
+      assertTrue(count > 0);
+
+      // sink latencies aren't recorded for a source
+      assertThrows(
+          VideoException.class,
+          () ->
+              CameraServerJNI.getTelemetryHistogram(
+                  source, CameraServerJNI.TelemetryKind.kSinkGrabLatency));
+    } finally {
+      CameraServerJNI.releaseSource(source);
+    }
+  }
+}
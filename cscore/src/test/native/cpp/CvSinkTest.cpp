@@ -0,0 +1,177 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "cscore.h"
+#include "cscore_cv.h"
+#include "cscore_raw.h"
+#include "gtest/gtest.h"
+
+namespace cs {
+
+// Feeds a 640x480 JPEG through a raw MJPEG source.
+class CvSinkTest : public ::testing::Test {
+ protected:
+  static constexpr int kWidth = 640;
+  static constexpr int kHeight = 480;
+
+  CvSinkTest() {
+    // 4x4 pixel blocks of noise, so decodes at different scales differ
+    cv::Mat noise{kHeight / 4, kWidth / 4, CV_8UC3};
+    cv::randu(noise, 0, 256);
+    cv::Mat bgr;
+    cv::resize(noise, bgr, cv::Size{kWidth, kHeight}, 0, 0, cv::INTER_NEAREST);
+    cv::imencode(".jpg", bgr, jpeg);
+
+    // The raw source copies width * height bytes for a JPEG; the decoder
+    // ignores the padding after the end of the image.
+    EXPECT_LT(jpeg.size(), static_cast<size_t>(kWidth * kHeight));
+    CS_AllocateRawFrameData(&frame, kWidth * kHeight);
+    std::fill_n(frame.data, kWidth * kHeight, 0);
+    std::copy(jpeg.begin(), jpeg.end(), frame.data);
+    frame.pixelFormat = VideoMode::kMJPEG;
+    frame.width = kWidth;
+    frame.height = kHeight;
+    frame.totalData = kWidth * kHeight;
+  }
+
+  void Put() {
+    CS_Status status = 0;
+    PutSourceFrame(source.GetHandle(), frame, &status);
+  }
+
+  // Queues frames for the sink so each put frame is grabbed exactly once.
+  void Attach(CvSink& sink) {
+    sink.SetSource(source);
+    sink.GetProperty("queue_depth").Set(2);
+    // the queue is attached on the next grab
+    cv::Mat image;
+    EXPECT_EQ(0u, sink.GrabFrame(image, 0.1));
+  }
+
+  // What the JPEG decodes to when libjpeg scales it by 1/denom.
+  cv::Mat Decode(int denom) {
+    int flags = cv::IMREAD_COLOR;
+    switch (denom) {
+      case 8:
+        flags = cv::IMREAD_REDUCED_COLOR_8;
+        break;
+      case 4:
+        flags = cv::IMREAD_REDUCED_COLOR_4;
+        break;
+      case 2:
+        flags = cv::IMREAD_REDUCED_COLOR_2;
+        break;
+    }
+    return cv::imdecode(jpeg, flags);
+  }
+
+  static double MaxDiff(const cv::Mat& a, const cv::Mat& b) {
+    double maxVal = 0;
+    cv::Mat diff;
+    cv::absdiff(a, b, diff);
+    cv::minMaxLoc(diff.reshape(1), nullptr, &maxVal);
+    return maxVal;
+  }
+
+  RawSource source{"source", VideoMode::kMJPEG, kWidth, kHeight, 30};
+  RawFrame frame;
+  std::vector<uchar> jpeg;
+};
+
+TEST_F(CvSinkTest, SizeProperties) {
+  CvSink sink{"sink"};
+  for (auto name : {"width", "height"}) {
+    auto prop = sink.GetProperty(name);
+    EXPECT_EQ(VideoProperty::kInteger, prop.GetKind()) << name;
+    EXPECT_EQ(0, prop.Get()) << name;
+    EXPECT_EQ(0, prop.GetDefault()) << name;
+  }
+
+  // 0 is the source size
+  Attach(sink);
+  Put();
+  cv::Mat image;
+  ASSERT_NE(0u, sink.GrabFrame(image, 1.0));
+  EXPECT_EQ(kWidth, image.cols);
+  EXPECT_EQ(kHeight, image.rows);
+  EXPECT_EQ(0, MaxDiff(Decode(1), image));
+
+  sink.GetProperty("width").Set(320);
+  sink.GetProperty("height").Set(240);
+  EXPECT_EQ(320, sink.GetProperty("width").Get());
+  EXPECT_EQ(240, sink.GetProperty("height").Get());
+  Put();
+  ASSERT_NE(0u, sink.GrabFrame(image, 1.0));
+  EXPECT_EQ(320, image.cols);
+  EXPECT_EQ(240, image.rows);
+}
+
+TEST_F(CvSinkTest, DecodeReducedScale) {
+  CvSink sink{"sink"};
+  sink.GetProperty("width").Set(kWidth / 4);
+  sink.GetProperty("height").Set(kHeight / 4);
+  Attach(sink);
+  Put();
+  cv::Mat image;
+  ASSERT_NE(0u, sink.GrabFrame(image, 1.0));
+  ASSERT_EQ(kWidth / 4, image.cols);
+  ASSERT_EQ(kHeight / 4, image.rows);
+  // decoded directly at 1/4 scale rather than decoded and resized
+  EXPECT_EQ(0, MaxDiff(Decode(4), image));
+}
+
+TEST_F(CvSinkTest, DecodeReducedScaleThenResize) {
+  // not a power of two, so decoded at 1/2 and resized down
+  CvSink sink{"sink"};
+  sink.GetProperty("width").Set(200);
+  sink.GetProperty("height").Set(150);
+  Attach(sink);
+  Put();
+  cv::Mat image;
+  ASSERT_NE(0u, sink.GrabFrame(image, 1.0));
+  ASSERT_EQ(200, image.cols);
+  ASSERT_EQ(150, image.rows);
+
+  cv::Mat expected;
+  cv::resize(Decode(2), expected, cv::Size{200, 150});
+  EXPECT_LE(MaxDiff(expected, image), 3);
+}
+
+TEST_F(CvSinkTest, LargerJPEGPreferredOverSmallerImage) {
+  CvSink small{"small"};
+  small.GetProperty("width").Set(kWidth / 8);
+  small.GetProperty("height").Set(kHeight / 8);
+  Attach(small);
+  CvSink large{"large"};
+  large.GetProperty("width").Set(kWidth / 2);
+  large.GetProperty("height").Set(kHeight / 2);
+  Attach(large);
+
+  // Both sinks get the same frame.  The small sink's decode is cached on the
+  // frame first, but the large sink decodes the JPEG again at 1/2 scale
+  // rather than scaling the small image up.
+  Put();
+  cv::Mat smallImage;
+  ASSERT_NE(0u, small.GrabFrame(smallImage, 1.0));
+  EXPECT_EQ(0, MaxDiff(Decode(8), smallImage));
+
+  cv::Mat largeImage;
+  ASSERT_NE(0u, large.GrabFrame(largeImage, 1.0));
+  ASSERT_EQ(kWidth / 2, largeImage.cols);
+  ASSERT_EQ(kHeight / 2, largeImage.rows);
+  EXPECT_EQ(0, MaxDiff(Decode(2), largeImage));
+
+  cv::Mat upscaled;
+  cv::resize(smallImage, upscaled, largeImage.size());
+  EXPECT_GT(MaxDiff(upscaled, largeImage), 16);
+}
+
+}  // namespace cs
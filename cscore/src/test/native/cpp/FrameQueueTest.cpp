@@ -0,0 +1,93 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <thread>
+
+#include "cscore.h"
+#include "cscore_raw.h"
+#include "gtest/gtest.h"
+
+namespace cs {
+
+class FrameQueueTest : public ::testing::Test {
+ protected:
+  FrameQueueTest() {
+    sink.SetSource(source);
+    CS_AllocateRawFrameData(&frame, 4);
+    frame.pixelFormat = VideoMode::kGray;
+    frame.width = 4;
+    frame.height = 1;
+    frame.totalData = 4;
+  }
+
+  void SetQueue(int depth, int policy) {
+    sink.GetProperty("queue_depth").Set(depth);
+    sink.GetProperty("queue_policy").Set(policy);
+    // the queue is attached on the next grab
+    EXPECT_EQ(-1, Grab());
+  }
+
+  // RawSource/RawSink frame functions are protected, so these use the handle
+  // functions.
+
+  // Puts a frame numbered n.
+  void Put(int n) {
+    frame.data[0] = static_cast<char>(n);
+    CS_Status status = 0;
+    PutSourceFrame(source.GetHandle(), frame, &status);
+  }
+
+  // Grabs a frame and returns its number, or -1 on timeout.
+  int Grab() {
+    RawFrame image;
+    CS_Status status = 0;
+    if (GrabSinkFrameTimeout(sink.GetHandle(), image, 0.1, &status) == 0) {
+      return -1;
+    }
+    return static_cast<unsigned char>(image.data[0]);
+  }
+
+  RawSource source{"source", VideoMode::kGray, 4, 1, 30};
+  RawSink sink{"sink"};
+  RawFrame frame;
+};
+
+TEST_F(FrameQueueTest, KeepsEveryFrame) {
+  SetQueue(8, 0);
+  for (int i = 1; i <= 5; ++i) {
+    Put(i);
+  }
+  for (int i = 1; i <= 5; ++i) {
+    EXPECT_EQ(i, Grab());
+  }
+  EXPECT_EQ(-1, Grab());
+}
+
+TEST_F(FrameQueueTest, DropOldest) {
+  SetQueue(2, 0);
+  for (int i = 1; i <= 5; ++i) {
+    Put(i);
+  }
+  EXPECT_EQ(4, Grab());
+  EXPECT_EQ(5, Grab());
+  EXPECT_EQ(-1, Grab());
+}
+
+TEST_F(FrameQueueTest, Block) {
+  SetQueue(2, 1);
+  std::thread producer{[&] {
+    for (int i = 1; i <= 5; ++i) {
+      Put(i);
+    }
+  }};
+  // let the producer fill the queue and block
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  for (int i = 1; i <= 5; ++i) {
+    EXPECT_EQ(i, Grab());
+  }
+  producer.join();
+}
+
+}  // namespace cs
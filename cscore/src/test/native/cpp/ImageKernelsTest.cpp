@@ -0,0 +1,162 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdint.h>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "ImageKernels.h"
+#include "gtest/gtest.h"
+
+namespace cs {
+
+// Smooth test image in YUYV format.  Colors stay away from the edges of the
+// gamut so that clamping in the OpenCV reference conversion doesn't matter.
+static cv::Mat MakeYUYV(int width, int height) {
+  cv::Mat image{height, width, CV_8UC2};
+  for (int y = 0; y < height; ++y) {
+    uint8_t* row = image.ptr<uint8_t>(y);
+    for (int x = 0; x < width; x += 2) {
+      row[x * 2] = 40 + (x * 7 + y * 3) % 160;
+      row[x * 2 + 1] = 108 + (x + y) % 40;
+      row[x * 2 + 2] = 40 + ((x + 1) * 7 + y * 3) % 160;
+      row[x * 2 + 3] = 148 - (x * 2 + y) % 40;
+    }
+  }
+  cv::GaussianBlur(image, image, cv::Size{5, 5}, 0);
+  return image;
+}
+
+static cv::Mat MakeBGR(int width, int height) {
+  cv::Mat image;
+  cv::cvtColor(MakeYUYV(width, height), image, cv::COLOR_YUV2BGR_YUYV);
+  return image;
+}
+
+static double MaxDiff(const cv::Mat& a, const cv::Mat& b) {
+  double maxVal = 0;
+  cv::Mat diff;
+  cv::absdiff(a, b, diff);
+  cv::minMaxLoc(diff.reshape(1), nullptr, &maxVal);
+  return maxVal;
+}
+
+TEST(ImageKernelsTest, YUYVToGray) {
+  // odd number of pixels per row to exercise the scalar tail
+  cv::Mat src = MakeYUYV(642, 7);
+  cv::Mat bgr, expected;
+  cv::cvtColor(src, bgr, cv::COLOR_YUV2BGR_YUYV);
+  cv::cvtColor(bgr, expected, cv::COLOR_BGR2GRAY);
+
+  cv::Mat actual{src.rows, src.cols, CV_8UC1};
+  ConvertYUYVToGray(src.data, actual.data, src.cols, src.rows);
+  EXPECT_LE(MaxDiff(expected, actual), 2);
+}
+
+TEST(ImageKernelsTest, ResizeYUYVToGray) {
+  cv::Mat src = MakeYUYV(640, 480);
+  cv::Mat bgr, gray, expected;
+  cv::cvtColor(src, bgr, cv::COLOR_YUV2BGR_YUYV);
+  cv::cvtColor(bgr, gray, cv::COLOR_BGR2GRAY);
+  cv::resize(gray, expected, cv::Size{213, 160});
+
+  cv::Mat actual{160, 213, CV_8UC1};
+  ResizeYUYVToGray(src.data, src.cols, src.rows, actual.data, actual.cols,
+                   actual.rows);
+  EXPECT_LE(MaxDiff(expected, actual), 3);
+}
+
+TEST(ImageKernelsTest, ResizeYUYVToBGR) {
+  cv::Mat src = MakeYUYV(640, 480);
+  cv::Mat bgr, expected;
+  cv::cvtColor(src, bgr, cv::COLOR_YUV2BGR_YUYV);
+  cv::resize(bgr, expected, cv::Size{320, 240});
+
+  cv::Mat actual{240, 320, CV_8UC3};
+  ResizeYUYVToBGR(src.data, src.cols, src.rows, actual.data, actual.cols,
+                  actual.rows);
+  // chroma is interpolated before conversion rather than after
+  EXPECT_LE(MaxDiff(expected, actual), 4);
+}
+
+TEST(ImageKernelsTest, ResizeBGRToGray) {
+  cv::Mat src = MakeBGR(640, 480);
+  cv::Mat gray, expected;
+  cv::cvtColor(src, gray, cv::COLOR_BGR2GRAY);
+  cv::resize(gray, expected, cv::Size{160, 120});
+
+  cv::Mat actual{120, 160, CV_8UC1};
+  ResizeBGRToGray(src.data, src.cols, src.rows, actual.data, actual.cols,
+                  actual.rows);
+  EXPECT_LE(MaxDiff(expected, actual), 2);
+}
+
+// Returns the average time in microseconds of a function.
+static double Time(const std::function<void()>& func) {
+  static constexpr int kIterations = 50;
+  func();  // warm up
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    func();
+  }
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / kIterations;
+}
+
+// Compares the fused kernels with the equivalent OpenCV conversion chains
+// (as previously used by Frame).  Downscaled outputs are half size.
+TEST(ImageKernelsTest, Benchmark) {
+  static constexpr int kSizes[][2] = {
+      {320, 240}, {640, 480}, {1280, 720}, {1920, 1080}};
+
+  for (auto [width, height] : kSizes) {
+    cv::Mat yuyv = MakeYUYV(width, height);
+    cv::Mat bgr = MakeBGR(width, height);
+    cv::Size half{width / 2, height / 2};
+    cv::Mat tmp, tmp2;
+    cv::Mat gray{height, width, CV_8UC1};
+    cv::Mat halfGray{half, CV_8UC1};
+    cv::Mat halfBGR{half, CV_8UC3};
+
+    double cvYUYVToGray = Time([&] {
+      cv::cvtColor(yuyv, tmp, cv::COLOR_YUV2BGR_YUYV);
+      cv::cvtColor(tmp, gray, cv::COLOR_BGR2GRAY);
+    });
+    double fusedYUYVToGray =
+        Time([&] { ConvertYUYVToGray(yuyv.data, gray.data, width, height); });
+
+    double cvYUYVToHalfBGR = Time([&] {
+      cv::cvtColor(yuyv, tmp, cv::COLOR_YUV2BGR_YUYV);
+      cv::resize(tmp, halfBGR, half);
+    });
+    double fusedYUYVToHalfBGR = Time([&] {
+      ResizeYUYVToBGR(yuyv.data, width, height, halfBGR.data, half.width,
+                      half.height);
+    });
+
+    double cvBGRToHalfGray = Time([&] {
+      cv::resize(bgr, tmp2, half);
+      cv::cvtColor(tmp2, halfGray, cv::COLOR_BGR2GRAY);
+    });
+    double fusedBGRToHalfGray = Time([&] {
+      ResizeBGRToGray(bgr.data, width, height, halfGray.data, half.width,
+                      half.height);
+    });
+
+    std::cout << width << "x" << height << " (us, opencv/fused):"
+              << " YUYV->Gray " << cvYUYVToGray << "/" << fusedYUYVToGray
+              << ", YUYV->1/2 BGR " << cvYUYVToHalfBGR << "/"
+              << fusedYUYVToHalfBGR << ", BGR->1/2 Gray " << cvBGRToHalfGray
+              << "/" << fusedBGRToHalfGray << "\n";
+  }
+}
+
+}  // namespace cs
@@ -0,0 +1,173 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <wpi/Logger.h>
+#include <wpi/NetworkStream.h>
+#include <wpi/TCPConnector.h>
+
+#include "cscore.h"
+#include "cscore_raw.h"
+#include "gtest/gtest.h"
+
+namespace cs {
+
+class MjpegServerTest : public ::testing::Test {
+ protected:
+  static constexpr int kPort = 11850;
+
+  // Puts a new frame every 10 ms until the test ends.
+  MjpegServerTest() {
+    CS_AllocateRawFrameData(&frame, 64);
+    frame.pixelFormat = VideoMode::kGray;
+    frame.width = 8;
+    frame.height = 8;
+    frame.totalData = 64;
+    producer = std::thread{[this] {
+      int n = 0;
+      while (running) {
+        for (int i = 0; i < 64; ++i) {
+          frame.data[i] = static_cast<char>(n + i);
+        }
+        ++n;
+        CS_Status status = 0;
+        PutSourceFrame(source.GetHandle(), frame, &status);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }};
+  }
+
+  ~MjpegServerTest() override {
+    running = false;
+    producer.join();
+  }
+
+  // Connects to the server and requests the stream.
+  std::unique_ptr<wpi::NetworkStream> Connect() {
+    std::unique_ptr<wpi::NetworkStream> stream;
+    // the server starts listening on its own thread
+    for (int i = 0; i < 100 && !stream; ++i) {
+      stream = wpi::TCPConnector::connect("127.0.0.1", kPort, logger, 1);
+      if (!stream) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }
+    }
+    if (stream) {
+      std::string_view request = "GET /stream.mjpg HTTP/1.0\r\n\r\n";
+      wpi::NetworkStream::Error err;
+      stream->send(request.data(), request.size(), &err);
+    }
+    return stream;
+  }
+
+  // Reads from the stream until n JPEG parts have arrived.  Returns false if
+  // the stream closed or stalled first.
+  static bool ReadParts(wpi::NetworkStream& stream, int n) {
+    static constexpr std::string_view kPart = "Content-Type: image/jpeg";
+    std::string data;
+    int count = 0;
+    size_t pos = 0;
+    char buf[4096];
+    while (count < n) {
+      wpi::NetworkStream::Error err;
+      size_t len = stream.receive(buf, sizeof(buf), &err, 2);
+      if (len == 0) {
+        return false;
+      }
+      data.append(buf, len);
+      size_t found;
+      while ((found = data.find(kPart, pos)) != std::string::npos) {
+        ++count;
+        pos = found + kPart.size();
+      }
+      // keep only enough of the tail to match a header split across reads
+      if (data.size() >= kPart.size()) {
+        data.erase(0, (std::max)(pos, data.size() - kPart.size() + 1));
+        pos = 0;
+      }
+    }
+    return true;
+  }
+
+  // Reads what's left in the stream.  Returns true if the server closed it,
+  // false if it stalled.
+  static bool WaitClosed(wpi::NetworkStream& stream) {
+    char buf[4096];
+    for (;;) {
+      wpi::NetworkStream::Error err = wpi::NetworkStream::kConnectionClosed;
+      if (stream.receive(buf, sizeof(buf), &err, 2) == 0) {
+        return err != wpi::NetworkStream::kConnectionTimedOut;
+      }
+    }
+  }
+
+  wpi::Logger logger;
+  RawSource source{"source", VideoMode::kGray, 8, 8, 30};
+  RawFrame frame;
+  std::atomic_bool running{true};
+  std::thread producer;
+};
+
+TEST_F(MjpegServerTest, MultipleClients) {
+  MjpegServer server{"server", kPort};
+  server.SetSource(source);
+
+  std::vector<std::unique_ptr<wpi::NetworkStream>> clients;
+  for (int i = 0; i < 3; ++i) {
+    clients.emplace_back(Connect());
+    ASSERT_TRUE(clients.back());
+  }
+  // every client gets frames from the one broadcaster
+  for (int round = 0; round < 3; ++round) {
+    for (auto&& client : clients) {
+      EXPECT_TRUE(ReadParts(*client, 2));
+    }
+  }
+
+  // a client leaving doesn't disturb the others
+  clients.front()->close();
+  clients.erase(clients.begin());
+  for (auto&& client : clients) {
+    EXPECT_TRUE(ReadParts(*client, 3));
+  }
+}
+
+TEST_F(MjpegServerTest, StopRestart) {
+  std::vector<std::unique_ptr<wpi::NetworkStream>> clients;
+  {
+    MjpegServer server{"server", kPort};
+    server.SetSource(source);
+    for (int i = 0; i < 2; ++i) {
+      clients.emplace_back(Connect());
+      ASSERT_TRUE(clients.back());
+      EXPECT_TRUE(ReadParts(*clients.back(), 1));
+    }
+  }
+
+  // stopping the server waits for the broadcaster, which closes the streams
+  for (auto&& client : clients) {
+    EXPECT_TRUE(WaitClosed(*client));
+  }
+  clients.clear();
+
+  MjpegServer server{"server", kPort};
+  server.SetSource(source);
+  for (int i = 0; i < 2; ++i) {
+    clients.emplace_back(Connect());
+    ASSERT_TRUE(clients.back());
+  }
+  for (auto&& client : clients) {
+    EXPECT_TRUE(ReadParts(*client, 3));
+  }
+}
+
+}  // namespace cs
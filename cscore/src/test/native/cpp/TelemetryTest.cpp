@@ -0,0 +1,193 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdint.h>
+
+#include <chrono>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include <wpi/SmallVector.h>
+#include <wpi/condition_variable.h>
+#include <wpi/mutex.h>
+
+#include "Instance.h"
+#include "SinkImpl.h"
+#include "Telemetry.h"
+#include "cscore.h"
+#include "cscore_raw.h"
+#include "gtest/gtest.h"
+
+namespace cs {
+
+class TelemetryTest : public ::testing::Test {
+ protected:
+  TelemetryTest() {
+    SetTelemetryPeriod(0.2);
+    sink.SetSource(source);
+    CS_AllocateRawFrameData(&frame, 4);
+    frame.pixelFormat = VideoMode::kGray;
+    frame.width = 4;
+    frame.height = 1;
+    frame.totalData = 4;
+  }
+
+  // Waits for the telemetry thread to start a new period.  Returns false on
+  // timeout.
+  bool WaitForUpdate() {
+    std::unique_lock lock(mutex);
+    int target = updates + 1;
+    return cond.wait_for(lock, std::chrono::seconds(2),
+                         [&] { return updates >= target; });
+  }
+
+  std::vector<int64_t> GetHistogram(CS_Handle handle, CS_TelemetryKind kind,
+                                    CS_Status* status) {
+    wpi::SmallVector<int64_t, CS_TELEMETRY_HISTOGRAM_BUCKETS> buf;
+    auto hist = GetTelemetryHistogram(handle, kind, buf, status);
+    return {hist.begin(), hist.end()};
+  }
+
+  static int64_t Count(const std::vector<int64_t>& hist) {
+    int64_t count = 0;
+    for (auto n : hist) {
+      count += n;
+    }
+    return count;
+  }
+
+  // Frames go through a queue so each put frame is grabbed exactly once.
+  void AttachQueue() {
+    sink.GetProperty("queue_depth").Set(2);
+    // the queue is attached on the next grab
+    EXPECT_FALSE(Grab());
+  }
+
+  void Put() {
+    CS_Status status = 0;
+    PutSourceFrame(source.GetHandle(), frame, &status);
+  }
+
+  bool Grab() {
+    RawFrame image;
+    CS_Status status = 0;
+    return GrabSinkFrameTimeout(sink.GetHandle(), image, 0.1, &status) != 0;
+  }
+
+  wpi::mutex mutex;
+  wpi::condition_variable cond;
+  int updates = 0;
+  VideoListener listener{[this](const VideoEvent&) {
+                           {
+                             std::scoped_lock lock(mutex);
+                             ++updates;
+                           }
+                           cond.notify_all();
+                         },
+                         CS_TELEMETRY_UPDATED, false};
+
+  RawSource source{"source", VideoMode::kGray, 4, 1, 30};
+  RawSink sink{"sink"};
+  RawFrame frame;
+};
+
+TEST_F(TelemetryTest, HistogramBuckets) {
+  EXPECT_EQ(0, Telemetry::GetHistogramBucket(0));
+  EXPECT_EQ(0, Telemetry::GetHistogramBucket(99));
+  EXPECT_EQ(1, Telemetry::GetHistogramBucket(100));
+  EXPECT_EQ(1, Telemetry::GetHistogramBucket(199));
+  EXPECT_EQ(2, Telemetry::GetHistogramBucket(200));
+  EXPECT_EQ(5, Telemetry::GetHistogramBucket(3199));
+  EXPECT_EQ(6, Telemetry::GetHistogramBucket(3200));
+  int last = CS_TELEMETRY_HISTOGRAM_BUCKETS - 1;
+  EXPECT_EQ(last - 1, Telemetry::GetHistogramBucket((100u << last) - 1));
+  // the last bucket takes everything larger
+  EXPECT_EQ(last, Telemetry::GetHistogramBucket(100u << last));
+  EXPECT_EQ(last, Telemetry::GetHistogramBucket(UINT64_MAX));
+}
+
+TEST_F(TelemetryTest, RecordedLatencies) {
+  auto sinkImpl = Instance::GetInstance().GetSink(sink.GetHandle())->sink;
+  ASSERT_TRUE(WaitForUpdate());
+  auto& telemetry = Instance::GetInstance().telemetry;
+  for (uint64_t latency :
+       {0u, 99u, 100u, 199u, 200u, 3199u, 3200u, (100u << 10) - 1,
+        100u << 10, 100u << 20}) {
+    telemetry.RecordSinkLatency(*sinkImpl, CS_SINK_GRAB_LATENCY, latency);
+  }
+  ASSERT_TRUE(WaitForUpdate());
+
+  CS_Status status = 0;
+  auto hist = GetHistogram(sink.GetHandle(), CS_SINK_GRAB_LATENCY, &status);
+  EXPECT_EQ(CS_OK, status);
+  std::vector<int64_t> expected{2, 2, 1, 0, 0, 1, 1, 0, 0, 0, 1, 2};
+  EXPECT_EQ(expected, hist);
+
+  // values are the mean
+  int64_t sum = 0 + 99 + 100 + 199 + 200 + 3199 + 3200 + (100 << 10) - 1 +
+                (100 << 10) + (100 << 20);
+  EXPECT_EQ(sum / 10,
+            GetTelemetryValue(sink.GetHandle(), CS_SINK_GRAB_LATENCY, &status));
+  EXPECT_DOUBLE_EQ(sum / 10.0, GetTelemetryAverageValue(sink.GetHandle(),
+                                                        CS_SINK_GRAB_LATENCY,
+                                                        &status));
+
+  // the C API gives the same buckets
+  int64_t buckets[CS_TELEMETRY_HISTOGRAM_BUCKETS];
+  CS_GetTelemetryHistogram(sink.GetHandle(), CS_SINK_GRAB_LATENCY, buckets,
+                           &status);
+  EXPECT_EQ(CS_OK, status);
+  EXPECT_EQ(expected,
+            std::vector<int64_t>(buckets, buckets + std::size(buckets)));
+
+  // the next period starts empty
+  ASSERT_TRUE(WaitForUpdate());
+  hist = GetHistogram(sink.GetHandle(), CS_SINK_GRAB_LATENCY, &status);
+  EXPECT_EQ(CS_EMPTY_VALUE, status);
+  EXPECT_EQ(std::vector<int64_t>(CS_TELEMETRY_HISTOGRAM_BUCKETS, 0), hist);
+}
+
+TEST_F(TelemetryTest, LatencyKinds) {
+  AttachQueue();
+  ASSERT_TRUE(WaitForUpdate());
+  Put();
+  EXPECT_TRUE(Grab());
+  // processing time is measured from one grab to the next
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  Put();
+  EXPECT_TRUE(Grab());
+  ASSERT_TRUE(WaitForUpdate());
+
+  CS_Status status = 0;
+  auto capture =
+      GetHistogram(source.GetHandle(), CS_SOURCE_CAPTURE_LATENCY, &status);
+  EXPECT_EQ(CS_OK, status);
+  EXPECT_EQ(2, Count(capture));
+
+  status = 0;
+  auto grab = GetHistogram(sink.GetHandle(), CS_SINK_GRAB_LATENCY, &status);
+  EXPECT_EQ(CS_OK, status);
+  EXPECT_EQ(2, Count(grab));
+
+  status = 0;
+  auto processing =
+      GetHistogram(sink.GetHandle(), CS_SINK_PROCESSING_LATENCY, &status);
+  EXPECT_EQ(CS_OK, status);
+  ASSERT_EQ(1, Count(processing));
+  // at least 10 ms, so past the [3.2 ms, 6.4 ms) bucket
+  for (int i = 0; i <= 6; ++i) {
+    EXPECT_EQ(0, processing[i]) << i;
+  }
+  EXPECT_GE(
+      GetTelemetryValue(sink.GetHandle(), CS_SINK_PROCESSING_LATENCY, &status),
+      10000);
+
+  // latencies are only kept for the kinds that apply
+  status = 0;
+  GetHistogram(source.GetHandle(), CS_SINK_GRAB_LATENCY, &status);
+  EXPECT_EQ(CS_EMPTY_VALUE, status);
+}
+
+}  // namespace cs
@@ -0,0 +1,60 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+#include <wpi/fs.h>
+
+#include "cscore.h"
+#include "cscore_cv.h"
+#include "gtest/gtest.h"
+
+namespace cs {
+
+#ifdef __linux__
+// Compares CPU time per frame with and without zero-copy capture.  Needs a
+// V4L2 device such as vivid or v4l2loopback; set CSCORE_TEST_DEVICE to use
+// something other than /dev/video0.
+TEST(UsbCameraTest, ZeroCopyBenchmark) {
+  static constexpr int kNumFrames = 300;
+
+  const char* env = std::getenv("CSCORE_TEST_DEVICE");
+  std::string path = env ? env : "/dev/video0";
+  if (!fs::exists(path)) {
+    GTEST_SKIP() << "no camera at " << path;
+  }
+
+  for (bool zeroCopy : {false, true}) {
+    UsbCamera camera{"bench", path};
+    camera.SetZeroCopy(zeroCopy);
+    ASSERT_EQ(0, camera.GetLastStatus());
+    CvSink sink{"sink"};
+    sink.SetSource(camera);
+
+    cv::Mat image;
+    ASSERT_NE(0u, sink.GrabFrame(image, 5.0)) << sink.GetError();
+
+    std::clock_t cpuStart = std::clock();
+    auto start = std::chrono::steady_clock::now();
+    int frames = 0;
+    while (frames < kNumFrames && sink.GrabFrame(image, 1.0) != 0) {
+      ++frames;
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    double cpu = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    ASSERT_GT(frames, 0);
+
+    std::cout << (zeroCopy ? "zero-copy" : "copy") << ": " << image.cols
+              << "x" << image.rows << " " << frames / elapsed.count()
+              << " fps, " << cpu * 1e6 / frames << " us CPU/frame\n";
+  }
+}
+#endif
+
+}  // namespace cs
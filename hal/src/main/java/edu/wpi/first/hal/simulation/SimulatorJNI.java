@@ -27,5 +27,11 @@ public class SimulatorJNI extends JNIWrapper {
 
   public static native void stepTimingAsync(long delta);
 
+  public static native void setSimValueBatchNotify(boolean enable);
+
+  public static native boolean getSimValueBatchNotify();
+
+  public static native void flushSimValueBatchNotify();
+
   public static native void resetHandles();
 }
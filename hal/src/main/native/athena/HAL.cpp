@@ -225,6 +225,8 @@ const char* HAL_GetErrorMessage(int32_t code) {
       return HAL_INVALID_DMA_ADDITION_MESSAGE;
     case HAL_USE_LAST_ERROR:
       return HAL_USE_LAST_ERROR_MESSAGE;
+    case HAL_THREAD_AFFINITY_ERROR:
+      return HAL_THREAD_AFFINITY_ERROR_MESSAGE;
     default:
       return "Unknown error status";
   }
@@ -18,7 +18,7 @@
 #include "hal/Errors.h"
 #include "hal/HAL.h"
 #include "hal/Threads.h"
-#include "hal/handles/UnlimitedHandleResource.h"
+#include "hal/handles/ConcurrentUnlimitedHandleResource.h"
 
 using namespace hal;
 
@@ -48,8 +48,8 @@ static std::atomic_bool notifierRunning{false};
 using namespace hal;
 
 class NotifierHandleContainer
-    : public UnlimitedHandleResource<HAL_NotifierHandle, Notifier,
-                                     HAL_HandleEnum::Notifier> {
+    : public ConcurrentUnlimitedHandleResource<HAL_NotifierHandle, Notifier,
+                                               HAL_HandleEnum::Notifier> {
  public:
   ~NotifierHandleContainer() {
     ForEach([](HAL_NotifierHandle handle, Notifier* notifier) {
@@ -86,4 +86,37 @@ HAL_Bool HAL_SetCurrentThreadPriority(HAL_Bool realTime, int32_t priority,
   return HAL_SetThreadPriority(&thread, realTime, priority, status);
 }
 
+HAL_Bool HAL_SetThreadAffinity(NativeThreadHandle handle, int32_t cpuMask,
+                               int32_t* status) {
+  if (handle == nullptr) {
+    *status = NULL_PARAMETER;
+    return false;
+  }
+  if (cpuMask == 0) {
+    *status = PARAMETER_OUT_OF_RANGE;
+    return false;
+  }
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (int cpu = 0; cpu < 32; ++cpu) {
+    if (cpuMask & (1u << cpu)) {
+      CPU_SET(cpu, &cpus);
+    }
+  }
+  if (pthread_setaffinity_np(*reinterpret_cast<const pthread_t*>(handle),
+                             sizeof(cpus), &cpus)) {
+    *status = HAL_THREAD_AFFINITY_ERROR;
+    return false;
+  } else {
+    *status = 0;
+    return true;
+  }
+}
+
+HAL_Bool HAL_SetCurrentThreadAffinity(int32_t cpuMask, int32_t* status) {
+  auto thread = pthread_self();
+  return HAL_SetThreadAffinity(&thread, cpuMask, status);
+}
+
 }  // extern "C"
@@ -30,6 +30,20 @@ void HALSIM_StepTiming(uint64_t delta) {}
 
 void HALSIM_StepTimingAsync(uint64_t delta) {}
 
+void HALSIM_SetDeterministicScheduling(HAL_Bool enable) {}
+
+HAL_Bool HALSIM_GetDeterministicScheduling(void) {
+  return false;
+}
+
+void HALSIM_SetSimValueBatchNotify(HAL_Bool enable) {}
+
+HAL_Bool HALSIM_GetSimValueBatchNotify(void) {
+  return false;
+}
+
+void HALSIM_FlushSimValueBatchNotify(void) {}
+
 void HALSIM_SetSendError(HALSIM_SendErrorHandler handler) {}
 
 void HALSIM_SetSendConsoleLine(HALSIM_SendConsoleLineHandler handler) {}
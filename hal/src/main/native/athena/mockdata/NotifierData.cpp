@@ -6,6 +6,10 @@
 
 extern "C" {
 
+void HALSIM_SetNotifierAlarmCallback(HAL_NotifierHandle handle,
+                                     HALSIM_NotifierAlarmCallback callback,
+                                     void* param) {}
+
 uint64_t HALSIM_GetNextNotifierTimeout(void) {
   return 0;
 }
@@ -253,6 +253,42 @@ Java_edu_wpi_first_hal_simulation_SimulatorJNI_stepTimingAsync
   HALSIM_StepTimingAsync(delta);
 }
 
+/*
+ * Class:     edu_wpi_first_hal_simulation_SimulatorJNI
+ * Method:    setSimValueBatchNotify
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL
+Java_edu_wpi_first_hal_simulation_SimulatorJNI_setSimValueBatchNotify
+  (JNIEnv*, jclass, jboolean enable)
+{
+  HALSIM_SetSimValueBatchNotify(enable);
+}
+
+/*
+ * Class:     edu_wpi_first_hal_simulation_SimulatorJNI
+ * Method:    getSimValueBatchNotify
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL
+Java_edu_wpi_first_hal_simulation_SimulatorJNI_getSimValueBatchNotify
+  (JNIEnv*, jclass)
+{
+  return HALSIM_GetSimValueBatchNotify();
+}
+
+/*
+ * Class:     edu_wpi_first_hal_simulation_SimulatorJNI
+ * Method:    flushSimValueBatchNotify
+ * Signature: ()V
+ */
+JNIEXPORT void JNICALL
+Java_edu_wpi_first_hal_simulation_SimulatorJNI_flushSimValueBatchNotify
+  (JNIEnv*, jclass)
+{
+  HALSIM_FlushSimValueBatchNotify();
+}
+
 /*
  * Class:     edu_wpi_first_hal_simulation_SimulatorJNI
  * Method:    resetHandles
@@ -74,6 +74,26 @@ HAL_Bool HAL_SetThreadPriority(NativeThreadHandle handle, HAL_Bool realTime,
 HAL_Bool HAL_SetCurrentThreadPriority(HAL_Bool realTime, int32_t priority,
                                       int32_t* status);
 
+/**
+ * Sets the CPUs the specified thread is allowed to run on.
+ *
+ * @param handle  Native handle pointer to the thread to set the affinity of.
+ * @param cpuMask Bit mask of allowed CPUs; bit 0 is CPU 0. Must not be 0.
+ * @param status  Error status variable. 0 on success.
+ * @return        True on success.
+ */
+HAL_Bool HAL_SetThreadAffinity(NativeThreadHandle handle, int32_t cpuMask,
+                               int32_t* status);
+
+/**
+ * Sets the CPUs the current thread is allowed to run on.
+ *
+ * @param cpuMask Bit mask of allowed CPUs; bit 0 is CPU 0. Must not be 0.
+ * @param status  Error status variable. 0 on success.
+ * @return        True on success.
+ */
+HAL_Bool HAL_SetCurrentThreadAffinity(int32_t cpuMask, int32_t* status);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
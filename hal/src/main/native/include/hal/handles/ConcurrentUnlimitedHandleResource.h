@@ -0,0 +1,245 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include <wpi/mutex.h>
+
+#include "hal/Types.h"
+#include "hal/handles/HandlesInternal.h"
+
+namespace hal {
+
+namespace impl {
+/**
+ * Reader counts used to wait for concurrent Get() calls to finish before a
+ * freed structure is released.  Readers register on the counter for the
+ * current epoch parity; writers flip the epoch and wait for the counters of
+ * both parities in turn to drain, so new readers can't hold a writer up.
+ * Counters are striped by thread to keep readers off each other's cache
+ * lines.
+ */
+class HandleReaders {
+ public:
+  static constexpr int kStripes = 16;
+
+  int Enter() {
+    int idx = (m_epoch.load() & 1) * kStripes + GetStripe();
+    m_counts[idx].value.fetch_add(1);
+    return idx;
+  }
+
+  void Exit(int idx) {
+    m_counts[idx].value.fetch_sub(1, std::memory_order_release);
+  }
+
+  /* Waits for all Get() calls that may have seen a value before this call
+   * to finish.  Must only be called by one thread at a time.
+   */
+  void Synchronize() {
+    for (int i = 0; i < 2; ++i) {
+      unsigned int parity = m_epoch.fetch_add(1) & 1;
+      for (int j = 0; j < kStripes; ++j) {
+        while (m_counts[parity * kStripes + j].value.load() != 0) {
+          std::this_thread::yield();
+        }
+      }
+    }
+  }
+
+ private:
+  // Hashes the thread id rather than using a thread_local, which is slow to
+  // access from a shared library.
+  static int GetStripe() {
+    uint64_t id = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return static_cast<int>((id * 0x9E3779B97F4A7C15ull) >> 60);
+  }
+
+  struct alignas(64) Count {
+    std::atomic_int value{0};
+  };
+
+  std::atomic<unsigned int> m_epoch{0};
+  Count m_counts[2 * kStripes];
+};
+}  // namespace impl
+
+/**
+ * The ConcurrentUnlimitedHandleResource class is a version of
+ * UnlimitedHandleResource with wait-free lookups, for resources that are
+ * looked up frequently from multiple threads.  Handles are encoded the same
+ * way, and indices are reused the same way.
+ *
+ * Structures are stored in fixed-size chunks that are never moved or freed
+ * while the resource exists, so Get() can find a slot without locking.
+ * Allocate(), Free(), ResetHandles(), and ForEach() take a global mutex; Free()
+ * and ResetHandles() additionally wait for any concurrent Get() calls to
+ * finish copying the structure pointer before releasing it.
+ *
+ * @tparam THandle The Handle Type (Must be typedefed from HAL_Handle)
+ * @tparam TStruct The struct type held by this resource
+ * @tparam enumValue The type value stored in the handle
+ *
+ */
+template <typename THandle, typename TStruct, HAL_HandleEnum enumValue>
+class ConcurrentUnlimitedHandleResource : public HandleBase {
+ public:
+  ConcurrentUnlimitedHandleResource() = default;
+  ~ConcurrentUnlimitedHandleResource();
+  ConcurrentUnlimitedHandleResource(const ConcurrentUnlimitedHandleResource&) =
+      delete;
+  ConcurrentUnlimitedHandleResource& operator=(
+      const ConcurrentUnlimitedHandleResource&) = delete;
+
+  THandle Allocate(std::shared_ptr<TStruct> structure);
+  int16_t GetIndex(THandle handle) {
+    return getHandleTypedIndex(handle, enumValue, m_version);
+  }
+  std::shared_ptr<TStruct> Get(THandle handle);
+  /* Returns structure previously at that handle (or nullptr if none) */
+  std::shared_ptr<TStruct> Free(THandle handle);
+  void ResetHandles() override;
+
+  /* Calls func(THandle, TStruct*) for each handle.  Note this holds the
+   * global lock for the entirety of execution.
+   */
+  template <typename Functor>
+  void ForEach(Functor func);
+
+ private:
+  static constexpr int kChunkShift = 6;
+  static constexpr int kChunkSize = 1 << kChunkShift;
+  static constexpr int kNumChunks = (INT16_MAX + kChunkSize) / kChunkSize;
+
+  struct Slot {
+    // non-null while allocated; value is only written by the mutex holder
+    // while present is null and no readers can be copying it
+    std::atomic<TStruct*> present{nullptr};
+    std::shared_ptr<TStruct> value;
+  };
+
+  Slot* GetSlot(int16_t index) const {
+    if (index < 0 || index >= m_size.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    Slot* chunk =
+        m_chunks[index >> kChunkShift].load(std::memory_order_acquire);
+    return &chunk[index & (kChunkSize - 1)];
+  }
+
+  std::atomic<Slot*> m_chunks[kNumChunks] = {};
+  std::atomic_int m_size{0};
+  impl::HandleReaders m_readers;
+  wpi::mutex m_handleMutex;
+};
+
+template <typename THandle, typename TStruct, HAL_HandleEnum enumValue>
+ConcurrentUnlimitedHandleResource<
+    THandle, TStruct, enumValue>::~ConcurrentUnlimitedHandleResource() {
+  for (auto&& chunk : m_chunks) {
+    delete[] chunk.load();
+  }
+}
+
+template <typename THandle, typename TStruct, HAL_HandleEnum enumValue>
+THandle
+ConcurrentUnlimitedHandleResource<THandle, TStruct, enumValue>::Allocate(
+    std::shared_ptr<TStruct> structure) {
+  std::scoped_lock lock(m_handleMutex);
+  int size = m_size.load(std::memory_order_relaxed);
+  int i;
+  for (i = 0; i < size; i++) {
+    Slot* slot = GetSlot(i);
+    if (slot->present.load(std::memory_order_relaxed) == nullptr) {
+      break;
+    }
+  }
+  if (i >= INT16_MAX) {
+    return HAL_kInvalidHandle;
+  }
+
+  if (i == size) {
+    auto& chunk = m_chunks[i >> kChunkShift];
+    if (!chunk.load(std::memory_order_relaxed)) {
+      chunk.store(new Slot[kChunkSize], std::memory_order_release);
+    }
+    m_size.store(size + 1, std::memory_order_release);
+  }
+  Slot* slot = GetSlot(i);
+  slot->value = std::move(structure);
+  slot->present.store(slot->value.get(), std::memory_order_release);
+  return static_cast<THandle>(
+      createHandle(static_cast<int16_t>(i), enumValue, m_version));
+}
+
+template <typename THandle, typename TStruct, HAL_HandleEnum enumValue>
+std::shared_ptr<TStruct>
+ConcurrentUnlimitedHandleResource<THandle, TStruct, enumValue>::Get(
+    THandle handle) {
+  Slot* slot = GetSlot(GetIndex(handle));
+  if (!slot) {
+    return nullptr;
+  }
+  std::shared_ptr<TStruct> rv;
+  int reader = m_readers.Enter();
+  if (slot->present.load() != nullptr) {
+    rv = slot->value;
+  }
+  m_readers.Exit(reader);
+  return rv;
+}
+
+template <typename THandle, typename TStruct, HAL_HandleEnum enumValue>
+std::shared_ptr<TStruct>
+ConcurrentUnlimitedHandleResource<THandle, TStruct, enumValue>::Free(
+    THandle handle) {
+  std::scoped_lock lock(m_handleMutex);
+  Slot* slot = GetSlot(GetIndex(handle));
+  if (!slot || slot->present.exchange(nullptr) == nullptr) {
+    return nullptr;
+  }
+  m_readers.Synchronize();
+  return std::move(slot->value);
+}
+
+template <typename THandle, typename TStruct, HAL_HandleEnum enumValue>
+void ConcurrentUnlimitedHandleResource<THandle, TStruct,
+                                       enumValue>::ResetHandles() {
+  {
+    std::scoped_lock lock(m_handleMutex);
+    int size = m_size.load(std::memory_order_relaxed);
+    for (int i = 0; i < size; i++) {
+      GetSlot(i)->present.store(nullptr);
+    }
+    m_readers.Synchronize();
+    for (int i = 0; i < size; i++) {
+      GetSlot(i)->value.reset();
+    }
+  }
+  HandleBase::ResetHandles();
+}
+
+template <typename THandle, typename TStruct, HAL_HandleEnum enumValue>
+template <typename Functor>
+void ConcurrentUnlimitedHandleResource<THandle, TStruct, enumValue>::ForEach(
+    Functor func) {
+  std::scoped_lock lock(m_handleMutex);
+  int size = m_size.load(std::memory_order_relaxed);
+  for (int i = 0; i < size; i++) {
+    if (TStruct* structure = GetSlot(i)->present.load()) {
+      func(static_cast<THandle>(createHandle(i, enumValue, m_version)),
+           structure);
+    }
+  }
+}
+
+}  // namespace hal
@@ -19,6 +19,39 @@ HAL_Bool HALSIM_IsTimingPaused(void);
 void HALSIM_StepTiming(uint64_t delta);
 void HALSIM_StepTimingAsync(uint64_t delta);
 
+/**
+ * Enables or disables deterministic scheduling.  When enabled,
+ * HALSIM_StepTiming() stops simulated time at every notifier alarm, including
+ * alarms that are already due, and runs them in time order: alarm callbacks
+ * (see HALSIM_SetNotifierAlarmCallback()) are called, and notifier threads are
+ * woken and waited for, at each of their timeouts.  An alarm set again for a
+ * time that has already been run is run 1 microsecond later.
+ *
+ * This should be used with timing paused.
+ *
+ * @param enable true to enable deterministic scheduling
+ */
+void HALSIM_SetDeterministicScheduling(HAL_Bool enable);
+HAL_Bool HALSIM_GetDeterministicScheduling(void);
+
+/**
+ * Enables or disables batched value change notification.  When enabled,
+ * simulation value callbacks (e.g. PWM speed, encoder count) are not called
+ * when the value is set; instead each changed value is notified once, with its
+ * latest value, when the batch is flushed.  Batches are flushed at the end of
+ * HALSIM_StepTiming() and HALSIM_StepTimingAsync(), and when batching is
+ * disabled.
+ *
+ * @param enable true to enable batching
+ */
+void HALSIM_SetSimValueBatchNotify(HAL_Bool enable);
+HAL_Bool HALSIM_GetSimValueBatchNotify(void);
+
+/**
+ * Notifies all values changed since the last flush (when batching is enabled).
+ */
+void HALSIM_FlushSimValueBatchNotify(void);
+
 typedef int32_t (*HALSIM_SendErrorHandler)(
     HAL_Bool isError, int32_t errorCode, HAL_Bool isLVCode, const char* details,
     const char* location, const char* callStack, HAL_Bool printMsg);
@@ -17,6 +17,27 @@ struct HALSIM_NotifierInfo {
   HAL_Bool waitTimeValid;
 };
 
+typedef void (*HALSIM_NotifierAlarmCallback)(HAL_NotifierHandle handle,
+                                             uint64_t curTime, void* param);
+
+/**
+ * Runs a notifier's alarms as events on the thread calling
+ * HALSIM_StepTiming(), instead of waking a thread waiting in
+ * HAL_WaitForNotifierAlarm().  Simulated time stops at each alarm and the
+ * callback is called; to run periodically, the callback should call
+ * HAL_UpdateNotifierAlarm() with the next trigger time.  Alarms for the same
+ * time run in the order they were set.
+ *
+ * No thread should wait on a notifier with an alarm callback.
+ *
+ * @param handle notifier handle
+ * @param callback alarm callback, or nullptr to return to thread wakeups
+ * @param param parameter passed to the callback
+ */
+void HALSIM_SetNotifierAlarmCallback(HAL_NotifierHandle handle,
+                                     HALSIM_NotifierAlarmCallback callback,
+                                     void* param);
+
 uint64_t HALSIM_GetNextNotifierTimeout(void);
 
 int32_t HALSIM_GetNumNotifiers(void);
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 
 #include <wpi/Compiler.h>
 #include <wpi/UidVector.h>
@@ -16,6 +18,16 @@
 namespace hal {
 
 namespace impl {
+
+// Batched notification (see HALSIM_SetSimValueBatchNotify()).  Values queue
+// themselves once per batch; the dispatch function is called with the value
+// and name when the batch is flushed.
+using SimValueDispatchFunc = void (*)(SimCallbackRegistryBase* value,
+                                      const char* name);
+bool IsSimValueBatchNotify();
+void QueueSimValueNotify(SimCallbackRegistryBase* value,
+                         SimValueDispatchFunc dispatch, const char* name);
+
 template <typename T, HAL_Value (*MakeValue)(T)>
 class SimDataValueBase : protected SimCallbackRegistryBase {
  public:
@@ -23,9 +35,8 @@ class SimDataValueBase : protected SimCallbackRegistryBase {
 
   LLVM_ATTRIBUTE_ALWAYS_INLINE void CancelCallback(int32_t uid) { Cancel(uid); }
 
-  T Get() const {
-    std::scoped_lock lock(m_mutex);
-    return m_value;
+  LLVM_ATTRIBUTE_ALWAYS_INLINE T Get() const {
+    return m_value.load(std::memory_order_acquire);
   }
 
   LLVM_ATTRIBUTE_ALWAYS_INLINE operator T() const { return Get(); }  // NOLINT
@@ -33,7 +44,7 @@ class SimDataValueBase : protected SimCallbackRegistryBase {
   void Reset(T value) {
     std::scoped_lock lock(m_mutex);
     DoReset();
-    m_value = value;
+    m_value.store(value, std::memory_order_release);
   }
 
   wpi::recursive_spinlock& GetMutex() { return m_mutex; }
@@ -48,7 +59,7 @@ class SimDataValueBase : protected SimCallbackRegistryBase {
     }
     if (initialNotify) {
       // We know that the callback is not null because of earlier null check
-      HAL_Value value = MakeValue(m_value);
+      HAL_Value value = MakeValue(m_value.load(std::memory_order_relaxed));
       lock.unlock();
       callback(name, param, &value);
     }
@@ -56,20 +67,49 @@ class SimDataValueBase : protected SimCallbackRegistryBase {
   }
 
   void DoSet(T value, const char* name) {
-    std::scoped_lock lock(this->m_mutex);
-    if (m_value != value) {
-      m_value = value;
-      if (m_callbacks) {
-        HAL_Value halValue = MakeValue(value);
-        for (auto&& cb : *m_callbacks) {
-          reinterpret_cast<HAL_NotifyCallback>(cb.callback)(name, cb.param,
-                                                            &halValue);
-        }
+    // Readers don't take the lock.  Writers and callbacks run under it, so
+    // callbacks see values in the order they were set, and a callback can't
+    // be running once Cancel() returns.
+    std::scoped_lock lock(m_mutex);
+    if (m_value.load(std::memory_order_relaxed) == value) {
+      return;
+    }
+    m_value.store(value, std::memory_order_release);
+    if (!m_callbacks || m_callbacks->empty()) {
+      return;
+    }
+    if (IsSimValueBatchNotify()) {
+      if (!m_batchPending.exchange(true)) {
+        QueueSimValueNotify(this, &DispatchBatch, name);
       }
+      return;
+    }
+    Dispatch(name, MakeValue(value));
+  }
+
+  std::atomic<T> m_value;
+
+ private:
+  // Must be called with m_mutex held.
+  void Dispatch(const char* name, HAL_Value value) {
+    for (auto&& cb : *m_callbacks) {
+      reinterpret_cast<HAL_NotifyCallback>(cb.callback)(name, cb.param,
+                                                        &value);
+    }
+  }
+
+  // Notifies with the latest value when a batch is flushed.
+  static void DispatchBatch(SimCallbackRegistryBase* base, const char* name) {
+    auto self = static_cast<SimDataValueBase*>(base);
+    std::scoped_lock lock(self->m_mutex);
+    self->m_batchPending = false;
+    if (self->m_callbacks && !self->m_callbacks->empty()) {
+      self->Dispatch(name,
+                     MakeValue(self->m_value.load(std::memory_order_relaxed)));
     }
   }
 
-  T m_value;
+  std::atomic_bool m_batchPending{false};
 };
 }  // namespace impl
 
@@ -17,9 +17,9 @@
 #include "hal/AnalogTrigger.h"
 #include "hal/Errors.h"
 #include "hal/Value.h"
+#include "hal/handles/ConcurrentUnlimitedHandleResource.h"
 #include "hal/handles/HandlesInternal.h"
 #include "hal/handles/LimitedHandleResource.h"
-#include "hal/handles/UnlimitedHandleResource.h"
 #include "mockdata/AnalogInDataInternal.h"
 #include "mockdata/DIODataInternal.h"
 
@@ -61,8 +61,9 @@ static LimitedHandleResource<HAL_InterruptHandle, Interrupt, kNumInterrupts,
                              HAL_HandleEnum::Interrupt>* interruptHandles;
 
 using SynchronousWaitDataHandle = HAL_Handle;
-static UnlimitedHandleResource<SynchronousWaitDataHandle, SynchronousWaitData,
-                               HAL_HandleEnum::Vendor>*
+static ConcurrentUnlimitedHandleResource<SynchronousWaitDataHandle,
+                                         SynchronousWaitData,
+                                         HAL_HandleEnum::Vendor>*
     synchronousInterruptHandles;
 
 namespace hal::init {
@@ -71,8 +72,9 @@ void InitializeInterrupts() {
                                HAL_HandleEnum::Interrupt>
       iH;
   interruptHandles = &iH;
-  static UnlimitedHandleResource<SynchronousWaitDataHandle, SynchronousWaitData,
-                                 HAL_HandleEnum::Vendor>
+  static ConcurrentUnlimitedHandleResource<SynchronousWaitDataHandle,
+                                           SynchronousWaitData,
+                                           HAL_HandleEnum::Vendor>
       siH;
   synchronousInterruptHandles = &siH;
 }
@@ -7,13 +7,16 @@
 #include <chrono>
 #include <cstdio>
 #include <thread>
+#include <vector>
 
 #include <fmt/format.h>
+#include <wpi/mutex.h>
 #include <wpi/timestamp.h>
 
 #include "MockHooksInternal.h"
 #include "NotifierInternal.h"
 #include "hal/simulation/NotifierData.h"
+#include "hal/simulation/SimDataValue.h"
 
 static std::atomic<bool> programStarted{false};
 
@@ -21,6 +24,20 @@ static std::atomic<uint64_t> programStartTime{0};
 static std::atomic<uint64_t> programPauseTime{0};
 static std::atomic<uint64_t> programStepTime{0};
 
+namespace {
+struct PendingNotify {
+  hal::impl::SimCallbackRegistryBase* value;
+  hal::impl::SimValueDispatchFunc dispatch;
+  const char* name;
+};
+}  // namespace
+
+static std::atomic<bool> deterministicScheduling{false};
+
+static std::atomic<bool> batchNotify{false};
+static wpi::mutex batchMutex;
+static std::vector<PendingNotify> batchPending;
+
 namespace hal::init {
 void InitializeMockHooks() {
   wpi::SetNowImpl(GetFPGATime);
@@ -75,6 +92,18 @@ void SetProgramStarted() {
 bool GetProgramStarted() {
   return programStarted;
 }
+
+namespace impl {
+bool IsSimValueBatchNotify() {
+  return batchNotify.load(std::memory_order_relaxed);
+}
+
+void QueueSimValueNotify(SimCallbackRegistryBase* value,
+                         SimValueDispatchFunc dispatch, const char* name) {
+  std::scoped_lock lock(batchMutex);
+  batchPending.push_back({value, dispatch, name});
+}
+}  // namespace impl
 }  // namespace hal
 
 using namespace hal;
@@ -116,23 +145,76 @@ HAL_Bool HALSIM_IsTimingPaused(void) {
 }
 
 void HALSIM_StepTiming(uint64_t delta) {
+  bool deterministic = deterministicScheduling;
   WaitNotifiers();
 
+  // time at which alarms were last run
+  uint64_t runTime = UINT64_MAX;
   while (delta > 0) {
     int32_t status = 0;
     uint64_t curTime = HAL_GetFPGATime(&status);
     uint64_t nextTimeout = HALSIM_GetNextNotifierTimeout();
-    uint64_t step = std::min(delta, nextTimeout - curTime);
+    uint64_t step;
+    if (nextTimeout <= curTime && curTime == runTime) {
+      // an alarm was set again for a time that has already been run; move
+      // time forward so it can't hold time in place
+      step = 1;
+    } else if (deterministic && nextTimeout <= curTime) {
+      // alarms that are already due run without advancing time
+      step = 0;
+    } else {
+      step = std::min(delta, nextTimeout - curTime);
+    }
 
     StepTiming(step);
     delta -= step;
 
+    RunNotifierEvents();
     WakeupWaitNotifiers();
+    runTime = curTime + step;
   }
+
+  HALSIM_FlushSimValueBatchNotify();
 }
 
 void HALSIM_StepTimingAsync(uint64_t delta) {
   StepTiming(delta);
+  RunNotifierEvents();
   WakeupNotifiers();
+  HALSIM_FlushSimValueBatchNotify();
+}
+
+void HALSIM_SetDeterministicScheduling(HAL_Bool enable) {
+  deterministicScheduling = enable;
+}
+
+HAL_Bool HALSIM_GetDeterministicScheduling(void) {
+  return deterministicScheduling;
+}
+
+void HALSIM_SetSimValueBatchNotify(HAL_Bool enable) {
+  batchNotify = enable;
+  if (!enable) {
+    HALSIM_FlushSimValueBatchNotify();
+  }
+}
+
+HAL_Bool HALSIM_GetSimValueBatchNotify(void) {
+  return batchNotify;
+}
+
+void HALSIM_FlushSimValueBatchNotify(void) {
+  // values changed by the callbacks are queued for the next flush
+  std::vector<PendingNotify> pending;
+  {
+    std::scoped_lock lock(batchMutex);
+    if (batchPending.empty()) {
+      return;
+    }
+    pending.swap(batchPending);
+  }
+  for (auto&& notify : pending) {
+    notify.dispatch(notify.value, notify.name);
+  }
 }
 }  // extern "C"
@@ -8,7 +8,10 @@
 #include <chrono>
 #include <cstdio>
 #include <cstring>
+#include <functional>
+#include <queue>
 #include <string>
+#include <vector>
 
 #include <wpi/SmallVector.h>
 #include <wpi/condition_variable.h>
@@ -19,7 +22,7 @@
 #include "hal/Errors.h"
 #include "hal/HALBase.h"
 #include "hal/cpp/fpga_clock.h"
-#include "hal/handles/UnlimitedHandleResource.h"
+#include "hal/handles/ConcurrentUnlimitedHandleResource.h"
 #include "hal/simulation/NotifierData.h"
 
 namespace {
@@ -30,9 +33,25 @@ struct Notifier {
   bool waitTimeValid = false;    // True if waitTime is set and in the future
   bool waitingForAlarm = false;  // True if in HAL_WaitForNotifierAlarm()
   uint64_t waitCount = 0;        // Counts calls to HAL_WaitForNotifierAlarm()
+  // If set, alarms are run as events by HALSIM_StepTiming() instead of
+  // waking a thread in HAL_WaitForNotifierAlarm()
+  HALSIM_NotifierAlarmCallback callback = nullptr;
+  void* callbackParam = nullptr;
+  uint64_t eventId = 0;  // id of the queued event for the current alarm
   wpi::mutex mutex;
   wpi::condition_variable cond;
 };
+
+struct NotifierEvent {
+  uint64_t time;
+  // alarms for the same time run in the order they were set
+  uint64_t id;
+  HAL_NotifierHandle handle;
+
+  bool operator>(const NotifierEvent& rhs) const {
+    return time > rhs.time || (time == rhs.time && id > rhs.id);
+  }
+};
 }  // namespace
 
 using namespace hal;
@@ -40,9 +59,17 @@ using namespace hal;
 static wpi::mutex notifiersWaiterMutex;
 static wpi::condition_variable notifiersWaiterCond;
 
+// Events are removed lazily: an event is stale if its notifier has been
+// updated, canceled, or stopped since the event was queued.
+static wpi::mutex eventMutex;
+static std::priority_queue<NotifierEvent, std::vector<NotifierEvent>,
+                           std::greater<>>
+    events;
+static uint64_t nextEventId = 0;
+
 class NotifierHandleContainer
-    : public UnlimitedHandleResource<HAL_NotifierHandle, Notifier,
-                                     HAL_HandleEnum::Notifier> {
+    : public ConcurrentUnlimitedHandleResource<HAL_NotifierHandle, Notifier,
+                                               HAL_HandleEnum::Notifier> {
  public:
   ~NotifierHandleContainer() {
     ForEach([](HAL_NotifierHandle handle, Notifier* notifier) {
@@ -60,6 +87,13 @@ class NotifierHandleContainer
 static NotifierHandleContainer* notifierHandles;
 static std::atomic<bool> notifiersPaused{false};
 
+// Must be called with the notifier mutex held.
+static void QueueEvent(HAL_NotifierHandle handle, Notifier* notifier) {
+  std::scoped_lock lock(eventMutex);
+  notifier->eventId = ++nextEventId;
+  events.push({notifier->waitTime, notifier->eventId, handle});
+}
+
 namespace hal {
 namespace init {
 void InitializeNotifier() {
@@ -90,7 +124,8 @@ void WaitNotifiers() {
   // Wait for all Notifiers to hit HAL_WaitForNotifierAlarm()
   notifierHandles->ForEach([&](HAL_NotifierHandle handle, Notifier* notifier) {
     std::scoped_lock lock(notifier->mutex);
-    if (notifier->active && !notifier->waitingForAlarm) {
+    if (notifier->active && !notifier->waitingForAlarm &&
+        !notifier->callback) {
       waiters.emplace_back(handle);
     }
   });
@@ -101,7 +136,8 @@ void WaitNotifiers() {
       auto& it = waiters[count];
       if (auto notifier = notifierHandles->Get(it)) {
         std::scoped_lock lock(notifier->mutex);
-        if (notifier->active && !notifier->waitingForAlarm) {
+        if (notifier->active && !notifier->waitingForAlarm &&
+            !notifier->callback) {
           ++count;
           continue;
         }
@@ -128,8 +164,9 @@ void WakeupWaitNotifiers() {
     std::scoped_lock lock(notifier->mutex);
 
     // Only wait for the Notifier if it has a valid timeout that's expired
+    // (event notifiers are run by RunNotifierEvents() instead)
     if (notifier->active && notifier->waitTimeValid &&
-        curTime >= notifier->waitTime) {
+        curTime >= notifier->waitTime && !notifier->callback) {
       waiters.emplace_back(handle, notifier->waitCount);
       notifier->cond.notify_all();
     }
@@ -159,6 +196,59 @@ void WakeupWaitNotifiers() {
     notifiersWaiterCond.wait_for(ulock, std::chrono::duration<double>(1));
   }
 }
+
+void RunNotifierEvents() {
+  // Only events queued before this call are run; alarms set by the callbacks
+  // for a time that's already due are left for the next call, so a callback
+  // that sets its alarm for the current time can't run forever.
+  uint64_t lastId;
+  {
+    std::scoped_lock lock(eventMutex);
+    lastId = nextEventId;
+  }
+  wpi::SmallVector<NotifierEvent, 4> deferred;
+  for (;;) {
+    int32_t status = 0;
+    uint64_t curTime = HAL_GetFPGATime(&status);
+    NotifierEvent event;
+    {
+      std::scoped_lock lock(eventMutex);
+      if (events.empty() || events.top().time > curTime) {
+        break;
+      }
+      event = events.top();
+      events.pop();
+      if (event.id > lastId) {
+        deferred.emplace_back(event);
+        continue;
+      }
+    }
+
+    auto notifier = notifierHandles->Get(event.handle);
+    if (!notifier) {
+      continue;
+    }
+    HALSIM_NotifierAlarmCallback callback;
+    void* param;
+    {
+      std::scoped_lock lock(notifier->mutex);
+      if (!notifier->active || !notifier->waitTimeValid ||
+          !notifier->callback || notifier->eventId != event.id) {
+        continue;
+      }
+      notifier->waitTimeValid = false;
+      callback = notifier->callback;
+      param = notifier->callbackParam;
+    }
+    // the callback may update the alarm, queueing a new event
+    callback(event.handle, curTime, param);
+  }
+
+  std::scoped_lock lock(eventMutex);
+  for (auto&& event : deferred) {
+    events.push(event);
+  }
+}
 }  // namespace hal
 
 extern "C" {
@@ -229,6 +319,9 @@ void HAL_UpdateNotifierAlarm(HAL_NotifierHandle notifierHandle,
     std::scoped_lock lock(notifier->mutex);
     notifier->waitTime = triggerTime;
     notifier->waitTimeValid = (triggerTime != UINT64_MAX);
+    if (notifier->waitTimeValid && notifier->callback) {
+      QueueEvent(notifierHandle, notifier.get());
+    }
   }
 
   // We wake up any waiters to change how long they're sleeping for
@@ -283,6 +376,22 @@ uint64_t HAL_WaitForNotifierAlarm(HAL_NotifierHandle notifierHandle,
   return 0;
 }
 
+void HALSIM_SetNotifierAlarmCallback(HAL_NotifierHandle notifierHandle,
+                                     HALSIM_NotifierAlarmCallback callback,
+                                     void* param) {
+  auto notifier = notifierHandles->Get(notifierHandle);
+  if (!notifier) {
+    return;
+  }
+
+  std::scoped_lock lock(notifier->mutex);
+  notifier->callback = callback;
+  notifier->callbackParam = param;
+  if (callback && notifier->waitTimeValid) {
+    QueueEvent(notifierHandle, notifier.get());
+  }
+}
+
 uint64_t HALSIM_GetNextNotifierTimeout(void) {
   uint64_t timeout = UINT64_MAX;
   notifierHandles->ForEach([&](HAL_NotifierHandle, Notifier* notifier) {
@@ -4,10 +4,15 @@
 
 #pragma once
 
+#include <stdint.h>
+
 namespace hal {
 void PauseNotifiers();
 void ResumeNotifiers();
 void WakeupNotifiers();
 void WaitNotifiers();
 void WakeupWaitNotifiers();
+
+// Runs the alarm callbacks of notifiers whose alarm time has been reached.
+void RunNotifierEvents();
 }  // namespace hal
@@ -23,3 +23,10 @@ HAL_Bool HAL_SetCurrentThreadPriority(HAL_Bool realTime, int32_t priority,
                                       int32_t* status) {
   return true;
 }
+HAL_Bool HAL_SetThreadAffinity(NativeThreadHandle handle, int32_t cpuMask,
+                               int32_t* status) {
+  return true;
+}
+HAL_Bool HAL_SetCurrentThreadAffinity(int32_t cpuMask, int32_t* status) {
+  return true;
+}
@@ -2,14 +2,27 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "hal/HAL.h"
+#include "hal/handles/ConcurrentUnlimitedHandleResource.h"
 #include "hal/handles/IndexedClassedHandleResource.h"
+#include "hal/handles/UnlimitedHandleResource.h"
 
 #define HAL_TestHandle HAL_Handle
 
 namespace {
 class MyTestClass {};
+
+struct MyTestStruct {
+  int value = 0;
+};
 }  // namespace
 
 namespace hal {
@@ -22,4 +35,124 @@ TEST(HandleTests, ClassedHandleTest) {
   EXPECT_EQ(0, status);
 }
 
+TEST(HandleTests, ConcurrentUnlimitedHandleTest) {
+  hal::ConcurrentUnlimitedHandleResource<HAL_TestHandle, MyTestStruct,
+                                         HAL_HandleEnum::Vendor>
+      testResource;
+  std::vector<HAL_TestHandle> handles;
+  for (int i = 0; i < 100; ++i) {
+    handles.push_back(
+        testResource.Allocate(std::make_shared<MyTestStruct>(MyTestStruct{i})));
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, testResource.GetIndex(handles[i]));
+    EXPECT_EQ(i, testResource.Get(handles[i])->value);
+  }
+
+  auto freed = testResource.Free(handles[42]);
+  ASSERT_NE(nullptr, freed);
+  EXPECT_EQ(42, freed->value);
+  EXPECT_EQ(nullptr, testResource.Get(handles[42]));
+  EXPECT_EQ(nullptr, testResource.Free(handles[42]));
+
+  // freed indices are reused
+  EXPECT_EQ(handles[42],
+            testResource.Allocate(std::make_shared<MyTestStruct>()));
+
+  int count = 0;
+  testResource.ForEach([&](HAL_TestHandle, MyTestStruct*) { ++count; });
+  EXPECT_EQ(100, count);
+
+  // handles from before a reset are invalid
+  testResource.ResetHandles();
+  EXPECT_EQ(nullptr, testResource.Get(handles[0]));
+  HAL_TestHandle handle =
+      testResource.Allocate(std::make_shared<MyTestStruct>(MyTestStruct{7}));
+  EXPECT_NE(handles[0], handle);
+  EXPECT_EQ(nullptr, testResource.Get(handles[0]));
+  EXPECT_EQ(7, testResource.Get(handle)->value);
+}
+
+TEST(HandleTests, ConcurrentUnlimitedHandleFreeWhileReading) {
+  hal::ConcurrentUnlimitedHandleResource<HAL_TestHandle, MyTestStruct,
+                                         HAL_HandleEnum::Vendor>
+      testResource;
+  std::atomic_bool done{false};
+  std::vector<std::thread> readers;
+  HAL_TestHandle handle =
+      testResource.Allocate(std::make_shared<MyTestStruct>(MyTestStruct{1}));
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&] {
+      while (!done) {
+        if (auto structure = testResource.Get(handle)) {
+          EXPECT_EQ(1, structure->value);
+        }
+      }
+    });
+  }
+  for (int i = 0; i < 1000; ++i) {
+    testResource.Free(handle);
+    handle =
+        testResource.Allocate(std::make_shared<MyTestStruct>(MyTestStruct{1}));
+  }
+  done = true;
+  for (auto&& reader : readers) {
+    reader.join();
+  }
+}
+
+// Times Get() from 8 concurrent reader threads.
+template <typename Resource>
+static double TimeConcurrentGet() {
+  static constexpr int kReaders = 8;
+  static constexpr int kHandles = 16;
+  static constexpr int kIterations = 200000;
+
+  Resource resource;
+  std::vector<HAL_TestHandle> handles;
+  for (int i = 0; i < kHandles; ++i) {
+    handles.push_back(
+        resource.Allocate(std::make_shared<MyTestStruct>(MyTestStruct{i})));
+  }
+
+  std::atomic_int ready{0};
+  std::atomic_bool start{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaders; ++i) {
+    readers.emplace_back([&] {
+      ++ready;
+      while (!start) {
+        std::this_thread::yield();
+      }
+      int sum = 0;
+      for (int j = 0; j < kIterations; ++j) {
+        sum += resource.Get(handles[j % kHandles])->value;
+      }
+      EXPECT_EQ(kIterations / kHandles * (kHandles - 1) * kHandles / 2, sum);
+    });
+  }
+  while (ready != kReaders) {
+    std::this_thread::yield();
+  }
+  auto begin = std::chrono::steady_clock::now();
+  start = true;
+  for (auto&& reader : readers) {
+    reader.join();
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - begin;
+  return elapsed.count() / (kReaders * kIterations);
+}
+
+TEST(HandleTests, UnlimitedHandleBenchmark) {
+  double locked = TimeConcurrentGet<hal::UnlimitedHandleResource<
+      HAL_TestHandle, MyTestStruct, HAL_HandleEnum::Vendor>>();
+  double concurrent = TimeConcurrentGet<hal::ConcurrentUnlimitedHandleResource<
+      HAL_TestHandle, MyTestStruct, HAL_HandleEnum::Vendor>>();
+  std::cout << "Get() with 8 readers (ns/op, "
+            << std::thread::hardware_concurrency()
+            << " cores): UnlimitedHandleResource " << locked
+            << ", ConcurrentUnlimitedHandleResource " << concurrent << "\n";
+}
+
 }  // namespace hal
@@ -0,0 +1,226 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hal/HAL.h"
+#include "hal/simulation/MockHooks.h"
+#include "hal/simulation/NotifierData.h"
+
+namespace hal {
+
+namespace {
+struct PeriodicEvent {
+  HAL_NotifierHandle handle = 0;
+  uint64_t period = 0;
+  std::vector<std::pair<uint64_t, int>>* log = nullptr;
+  int id = 0;
+  int count = 0;
+};
+
+// Sets up paused, deterministic timing for the duration of a test.
+class DeterministicScheduling {
+ public:
+  DeterministicScheduling() {
+    HALSIM_PauseTiming();
+    HALSIM_SetDeterministicScheduling(true);
+  }
+  ~DeterministicScheduling() {
+    HALSIM_SetDeterministicScheduling(false);
+    HALSIM_ResumeTiming();
+  }
+};
+}  // namespace
+
+static void PeriodicAlarm(HAL_NotifierHandle handle, uint64_t curTime,
+                          void* param) {
+  auto event = static_cast<PeriodicEvent*>(param);
+  ++event->count;
+  if (event->log) {
+    event->log->emplace_back(curTime, event->id);
+  }
+  int32_t status = 0;
+  HAL_UpdateNotifierAlarm(handle, curTime + event->period, &status);
+}
+
+static void StartPeriodic(PeriodicEvent* event) {
+  int32_t status = 0;
+  event->handle = HAL_InitializeNotifier(&status);
+  HALSIM_SetNotifierAlarmCallback(event->handle, &PeriodicAlarm, event);
+  HAL_UpdateNotifierAlarm(event->handle,
+                          HAL_GetFPGATime(&status) + event->period, &status);
+}
+
+static void Clean(PeriodicEvent* event) {
+  int32_t status = 0;
+  HAL_StopNotifier(event->handle, &status);
+  HAL_CleanNotifier(event->handle, &status);
+}
+
+TEST(NotifierDataTests, DeterministicEventOrder) {
+  DeterministicScheduling scheduling;
+  int32_t status = 0;
+  uint64_t start = HAL_GetFPGATime(&status);
+
+  std::vector<std::pair<uint64_t, int>> log;
+  PeriodicEvent fast{0, 10000, &log, 1};
+  PeriodicEvent slow{0, 25000, &log, 2};
+  StartPeriodic(&fast);
+  StartPeriodic(&slow);
+
+  HALSIM_StepTiming(50000);
+  EXPECT_EQ(start + 50000, HAL_GetFPGATime(&status));
+
+  std::vector<std::pair<uint64_t, int>> expected{
+      {start + 10000, 1}, {start + 20000, 1}, {start + 25000, 2},
+      {start + 30000, 1}, {start + 40000, 1}, {start + 50000, 2},
+      {start + 50000, 1}};
+  // at 50 ms, the slow alarm was set first
+  EXPECT_EQ(expected, log);
+
+  // canceled alarms don't run
+  HAL_CancelNotifierAlarm(slow.handle, &status);
+  HALSIM_StepTiming(50000);
+  EXPECT_EQ(10, fast.count);
+  EXPECT_EQ(2, slow.count);
+
+  Clean(&fast);
+  Clean(&slow);
+}
+
+TEST(NotifierDataTests, DeterministicThreadWakeups) {
+  DeterministicScheduling scheduling;
+  int32_t status = 0;
+  uint64_t start = HAL_GetFPGATime(&status);
+
+  HAL_NotifierHandle handle = HAL_InitializeNotifier(&status);
+  HAL_UpdateNotifierAlarm(handle, start + 10000, &status);
+  std::vector<uint64_t> wakeups;
+  std::thread thread{[&] {
+    int32_t status = 0;
+    for (;;) {
+      uint64_t curTime = HAL_WaitForNotifierAlarm(handle, &status);
+      if (curTime == 0 || status != 0) {
+        break;
+      }
+      wakeups.emplace_back(curTime);
+      HAL_UpdateNotifierAlarm(handle, curTime + 10000, &status);
+    }
+  }};
+
+  // the thread is woken at each of its timeouts, not once per step
+  HALSIM_StepTiming(50000);
+  EXPECT_EQ(start + 50000, HAL_GetFPGATime(&status));
+  std::vector<uint64_t> expected{start + 10000, start + 20000, start + 30000,
+                                 start + 40000, start + 50000};
+  EXPECT_EQ(expected, wakeups);
+
+  HAL_StopNotifier(handle, &status);
+  thread.join();
+  HAL_CleanNotifier(handle, &status);
+}
+
+static void RearmAlarm(HAL_NotifierHandle handle, uint64_t curTime,
+                       void* param) {
+  ++*static_cast<int*>(param);
+  int32_t status = 0;
+  HAL_UpdateNotifierAlarm(handle, curTime, &status);
+}
+
+TEST(NotifierDataTests, DeterministicRearmAtCurrentTime) {
+  DeterministicScheduling scheduling;
+  int32_t status = 0;
+  uint64_t start = HAL_GetFPGATime(&status);
+
+  int count = 0;
+  HAL_NotifierHandle handle = HAL_InitializeNotifier(&status);
+  HALSIM_SetNotifierAlarmCallback(handle, &RearmAlarm, &count);
+  HAL_UpdateNotifierAlarm(handle, start, &status);
+
+  // the alarm runs once at each microsecond rather than holding time in place
+  HALSIM_StepTiming(100);
+  EXPECT_EQ(start + 100, HAL_GetFPGATime(&status));
+  EXPECT_EQ(101, count);
+
+  HAL_StopNotifier(handle, &status);
+  HAL_CleanNotifier(handle, &status);
+}
+
+// Reports simulated seconds per wall second for a 50 Hz and a 200 Hz periodic
+// alarm, with deterministic scheduling and with notifier threads.
+TEST(NotifierDataTests, Benchmark) {
+  using seconds = std::chrono::duration<double>;
+
+  double eventRate;
+  {
+    DeterministicScheduling scheduling;
+    constexpr uint64_t kSimTime = 600000000;  // 10 minutes
+    PeriodicEvent robot{0, 20000};
+    PeriodicEvent controller{0, 5000};
+    StartPeriodic(&robot);
+    StartPeriodic(&controller);
+
+    auto start = std::chrono::steady_clock::now();
+    // step in robot periods, as a test would
+    for (uint64_t t = 0; t < kSimTime; t += 20000) {
+      HALSIM_StepTiming(20000);
+    }
+    seconds elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(static_cast<int>(kSimTime / 20000), robot.count);
+    EXPECT_EQ(static_cast<int>(kSimTime / 5000), controller.count);
+    eventRate = kSimTime * 1e-6 / elapsed.count();
+
+    Clean(&robot);
+    Clean(&controller);
+  }
+
+  double threadRate;
+  {
+    HALSIM_PauseTiming();
+    constexpr uint64_t kSimTime = 10000000;  // 10 seconds
+    int32_t status = 0;
+    HAL_NotifierHandle handles[2];
+    std::thread threads[2];
+    uint64_t periods[2] = {20000, 5000};
+    for (int i = 0; i < 2; ++i) {
+      handles[i] = HAL_InitializeNotifier(&status);
+      HAL_UpdateNotifierAlarm(handles[i],
+                              HAL_GetFPGATime(&status) + periods[i], &status);
+      threads[i] = std::thread{[handle = handles[i], period = periods[i]] {
+        int32_t status = 0;
+        for (;;) {
+          uint64_t curTime = HAL_WaitForNotifierAlarm(handle, &status);
+          if (curTime == 0 || status != 0) {
+            break;
+          }
+          HAL_UpdateNotifierAlarm(handle, curTime + period, &status);
+        }
+      }};
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t t = 0; t < kSimTime; t += 20000) {
+      HALSIM_StepTiming(20000);
+    }
+    seconds elapsed = std::chrono::steady_clock::now() - start;
+    threadRate = kSimTime * 1e-6 / elapsed.count();
+
+    for (int i = 0; i < 2; ++i) {
+      HAL_StopNotifier(handles[i], &status);
+      threads[i].join();
+      HAL_CleanNotifier(handles[i], &status);
+    }
+    HALSIM_ResumeTiming();
+  }
+
+  std::cout << "simulated seconds per wall second: deterministic " << eventRate
+            << ", threads " << threadRate << "\n";
+}
+
+}  // namespace hal
@@ -0,0 +1,184 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "hal/HAL.h"
+#include "hal/simulation/MockHooks.h"
+#include "hal/simulation/PWMData.h"
+
+namespace hal {
+
+namespace {
+struct CallbackData {
+  int count = 0;
+  double value = 0;
+  int32_t index = 0;
+  int32_t uid = 0;
+};
+}  // namespace
+
+static void TestSpeedCallback(const char* name, void* param,
+                              const struct HAL_Value* value) {
+  auto data = static_cast<CallbackData*>(param);
+  ++data->count;
+  data->value = value->data.v_double;
+}
+
+static void TestCancelingSpeedCallback(const char* name, void* param,
+                                       const struct HAL_Value* value) {
+  auto data = static_cast<CallbackData*>(param);
+  ++data->count;
+  HALSIM_CancelPWMSpeedCallback(data->index, data->uid);
+}
+
+TEST(SimDataValueTests, BatchNotify) {
+  const int INDEX_TO_TEST = 3;
+  HALSIM_ResetPWMData(INDEX_TO_TEST);
+
+  CallbackData data;
+  int32_t uid = HALSIM_RegisterPWMSpeedCallback(
+      INDEX_TO_TEST, &TestSpeedCallback, &data, false);
+
+  HALSIM_SetSimValueBatchNotify(true);
+  HALSIM_SetPWMSpeed(INDEX_TO_TEST, 0.1);
+  HALSIM_SetPWMSpeed(INDEX_TO_TEST, 0.2);
+  HALSIM_SetPWMSpeed(INDEX_TO_TEST, 0.3);
+  // values are updated immediately, callbacks are deferred
+  EXPECT_EQ(0.3, HALSIM_GetPWMSpeed(INDEX_TO_TEST));
+  EXPECT_EQ(0, data.count);
+
+  HALSIM_FlushSimValueBatchNotify();
+  EXPECT_EQ(1, data.count);
+  EXPECT_EQ(0.3, data.value);
+
+  // nothing changed since the last flush
+  HALSIM_FlushSimValueBatchNotify();
+  EXPECT_EQ(1, data.count);
+
+  // disabling flushes pending changes
+  HALSIM_SetPWMSpeed(INDEX_TO_TEST, 0.4);
+  HALSIM_SetSimValueBatchNotify(false);
+  EXPECT_EQ(2, data.count);
+  EXPECT_EQ(0.4, data.value);
+
+  HALSIM_SetPWMSpeed(INDEX_TO_TEST, 0.5);
+  EXPECT_EQ(3, data.count);
+
+  HALSIM_CancelPWMSpeedCallback(INDEX_TO_TEST, uid);
+}
+
+TEST(SimDataValueTests, CancelFromCallback) {
+  const int INDEX_TO_TEST = 4;
+  HALSIM_ResetPWMData(INDEX_TO_TEST);
+
+  CallbackData data;
+  data.index = INDEX_TO_TEST;
+  data.uid = HALSIM_RegisterPWMSpeedCallback(
+      INDEX_TO_TEST, &TestCancelingSpeedCallback, &data, false);
+
+  HALSIM_SetPWMSpeed(INDEX_TO_TEST, 0.1);
+  HALSIM_SetPWMSpeed(INDEX_TO_TEST, 0.2);
+  EXPECT_EQ(1, data.count);
+}
+
+TEST(SimDataValueTests, ConcurrentSetOrder) {
+  const int INDEX_TO_TEST = 6;
+  constexpr int kIterations = 10000;
+  HALSIM_ResetPWMData(INDEX_TO_TEST);
+
+  CallbackData data;
+  int32_t uid = HALSIM_RegisterPWMSpeedCallback(
+      INDEX_TO_TEST, &TestSpeedCallback, &data, false);
+
+  // callbacks are called in the order values are set, so the last value
+  // delivered is the value that stuck
+  std::thread other{[&] {
+    for (int i = 0; i < kIterations; ++i) {
+      HALSIM_SetPWMSpeed(INDEX_TO_TEST, i + 1);
+    }
+  }};
+  for (int i = 0; i < kIterations; ++i) {
+    HALSIM_SetPWMSpeed(INDEX_TO_TEST, -i - 1);
+  }
+  other.join();
+
+  EXPECT_EQ(HALSIM_GetPWMSpeed(INDEX_TO_TEST), data.value);
+  HALSIM_CancelPWMSpeedCallback(INDEX_TO_TEST, uid);
+}
+
+TEST(SimDataValueTests, CancelFromOtherThread) {
+  const int INDEX_TO_TEST = 8;
+  HALSIM_ResetPWMData(INDEX_TO_TEST);
+
+  CallbackData data;
+  int32_t uid = HALSIM_RegisterPWMSpeedCallback(
+      INDEX_TO_TEST, &TestSpeedCallback, &data, false);
+
+  std::atomic_bool running{true};
+  std::thread setter{[&] {
+    for (int i = 0; running; ++i) {
+      HALSIM_SetPWMSpeed(INDEX_TO_TEST, i + 1);
+    }
+  }};
+  while (HALSIM_GetPWMSpeed(INDEX_TO_TEST) < 100) {
+    std::this_thread::yield();
+  }
+
+  // the callback isn't running once Cancel() returns
+  HALSIM_CancelPWMSpeedCallback(INDEX_TO_TEST, uid);
+  int count = data.count;
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  running = false;
+  setter.join();
+  EXPECT_EQ(count, data.count);
+}
+
+// Times value reads and writes (with a callback registered).
+TEST(SimDataValueTests, Benchmark) {
+  const int INDEX_TO_TEST = 5;
+  constexpr int kIterations = 1000000;
+  HALSIM_ResetPWMData(INDEX_TO_TEST);
+
+  CallbackData data;
+  int32_t uid = HALSIM_RegisterPWMSpeedCallback(
+      INDEX_TO_TEST, &TestSpeedCallback, &data, false);
+
+  double sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    sum += HALSIM_GetPWMSpeed(INDEX_TO_TEST);
+  }
+  auto getTime = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    HALSIM_SetPWMSpeed(INDEX_TO_TEST, i + 1);
+  }
+  auto setTime = std::chrono::steady_clock::now() - start;
+
+  HALSIM_SetSimValueBatchNotify(true);
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    HALSIM_SetPWMSpeed(INDEX_TO_TEST, -i - 1);
+  }
+  HALSIM_FlushSimValueBatchNotify();
+  auto batchTime = std::chrono::steady_clock::now() - start;
+  HALSIM_SetSimValueBatchNotify(false);
+
+  EXPECT_EQ(kIterations + 1, data.count);
+  HALSIM_CancelPWMSpeedCallback(INDEX_TO_TEST, uid);
+
+  using ns = std::chrono::duration<double, std::nano>;
+  std::cout << "get " << ns{getTime}.count() / kIterations << " ns, set "
+            << ns{setTime}.count() / kIterations << " ns, batched set "
+            << ns{batchTime}.count() / kIterations << " ns (sum " << sum
+            << ")\n";
+}
+
+}  // namespace hal
@@ -0,0 +1,170 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wpi/Logger.h>
+#include <wpi/NetworkStream.h>
+#include <wpi/TCPConnector.h>
+
+#include "Message.h"
+#include "PendingOutgoing.h"
+#include "WireEncoder.h"
+#include "gtest/gtest.h"
+#include "ntcore_cpp.h"
+
+// Count heap allocations made by any thread while counting is enabled.  This
+// replaces the global operator new, so these tests are built as their own
+// executable.  The standard library's operator delete releases with
+// std::free, so only operator new is replaced.
+static std::atomic_bool gCountAllocs{false};
+static std::atomic<size_t> gNumAllocs{0};
+
+void* operator new(size_t size) {
+  if (gCountAllocs.load(std::memory_order_relaxed)) {
+    gNumAllocs.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+namespace nt {
+
+class EncodeAllocationTest : public ::testing::Test {
+ protected:
+  static constexpr unsigned int kNumEntries = 10;
+
+  // One dispatch cycle on a connection: queue an update for every entry,
+  // post, encode into the connection's send buffer, and recycle.
+  void Cycle() {
+    for (unsigned int id = 0; id < kNumEntries; ++id) {
+      pending.Queue(Message::EntryUpdate(id, ++seq_num, value));
+      // updates to the same entry are merged
+      pending.Queue(Message::EntryUpdate(id, ++seq_num, value));
+    }
+    auto msgs = pending.Post(false);
+    ASSERT_EQ(msgs.size(), kNumEntries);
+    encoder.Reset();
+    for (auto& msg : msgs) {
+      msg->Write(encoder);
+    }
+    ASSERT_EQ(encoder.error(), nullptr);
+    pending.Recycle(std::move(msgs));
+  }
+
+  PendingOutgoing pending;
+  WireEncoder encoder{0x0300};
+  std::shared_ptr<Value> value =
+      Value::MakeDoubleArray(std::vector<double>(16, 1.0));
+  unsigned int seq_num = 0;
+};
+
+TEST_F(EncodeAllocationTest, SteadyState) {
+  // warm up the message pool and buffers
+  for (int i = 0; i < 10; ++i) {
+    Cycle();
+  }
+
+  gNumAllocs = 0;
+  gCountAllocs = true;
+  for (int i = 0; i < 1000; ++i) {
+    Cycle();
+  }
+  gCountAllocs = false;
+  EXPECT_EQ(gNumAllocs, 0u);
+}
+
+// Sets values on a server with a connected client and waits for each update
+// to be written to the client's socket.  The client is a raw socket read on
+// its own thread, so only the server's set, dispatch and send path is
+// counted.  The values are made before counting, as creating a Value
+// allocates.
+TEST(SendAllocationTest, SetEntryValue) {
+  static constexpr int kWarmup = 50;
+  static constexpr int kUpdates = 200;
+
+  auto inst = nt::CreateInstance();
+  nt::SetNetworkIdentity(inst, "server");
+  // post each update immediately rather than on the periodic update
+  nt::SetLowLatency(inst, true, 0);
+  nt::StartServer(inst, "sendallocationtest.ini", "127.0.0.1", 10030);
+  auto entry = nt::GetEntry(inst, "value");
+  nt::SetEntryValue(entry, Value::MakeDouble(0));
+
+  wpi::Logger logger;
+  std::unique_ptr<wpi::NetworkStream> stream;
+  // the server starts listening on its own thread
+  for (int i = 0; i < 100 && !stream; ++i) {
+    stream = wpi::TCPConnector::connect("127.0.0.1", 10030, logger, 1);
+    if (!stream) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+  }
+  ASSERT_TRUE(stream);
+  {
+    WireEncoder enc{0x0300};
+    Message::ClientHello("client")->Write(enc);
+    Message::ClientHelloDone()->Write(enc);
+    wpi::NetworkStream::Error err;
+    stream->send(enc.data(), enc.size(), &err);
+  }
+
+  std::atomic<size_t> received{0};
+  std::thread reader([&] {
+    char buf[4096];
+    for (;;) {
+      wpi::NetworkStream::Error err;
+      size_t len = stream->receive(buf, sizeof(buf), &err);
+      if (len == 0) {
+        break;
+      }
+      received += len;
+    }
+  });
+
+  auto wait_for_update = [&](size_t before) {
+    auto timeout_time =
+        std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (received == before &&
+           std::chrono::steady_clock::now() < timeout_time) {
+      std::this_thread::yield();
+    }
+    return received != before;
+  };
+
+  // the server sends its entries once the handshake completes
+  ASSERT_TRUE(wait_for_update(0));
+
+  std::vector<std::shared_ptr<Value>> values;
+  for (int i = 0; i < kWarmup + kUpdates; ++i) {
+    values.emplace_back(Value::MakeDouble(i + 1));
+  }
+
+  for (int i = 0; i < kWarmup + kUpdates; ++i) {
+    if (i == kWarmup) {
+      gNumAllocs = 0;
+      gCountAllocs = true;
+    }
+    size_t before = received;
+    nt::SetEntryValue(entry, values[i]);
+    ASSERT_TRUE(wait_for_update(before));
+  }
+  gCountAllocs = false;
+  EXPECT_EQ(gNumAllocs, 0u);
+
+  // stopping the server closes the connection, which ends the reader
+  nt::DestroyInstance(inst);
+  reader.join();
+}
+
+}  // namespace nt
@@ -0,0 +1,98 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+package edu.wpi.first.networktables;
+
+/** NetworkTables Connection statistics. Counters cover the lifetime of the connection. */
+public final class ConnectionStats {
+  /** The connection. */
+  @SuppressWarnings("MemberName")
+  public final ConnectionInfo info;
+
+  /** The number of bytes written to the remote node. */
+  @SuppressWarnings("MemberName")
+  public final long bytes_sent;
+
+  /** The number of messages written to the remote node. */
+  @SuppressWarnings("MemberName")
+  public final long messages_sent;
+
+  /** The number of bytes received from the remote node. */
+  @SuppressWarnings("MemberName")
+  public final long bytes_received;
+
+  /** The number of messages received from the remote node. */
+  @SuppressWarnings("MemberName")
+  public final long messages_received;
+
+  /**
+   * The number of queued messages replaced by a later message for the same entry before being
+   * sent.
+   */
+  @SuppressWarnings("MemberName")
+  public final long messages_coalesced;
+
+  /** The largest number of messages queued between posts. */
+  @SuppressWarnings("MemberName")
+  public final long queue_high_water;
+
+  /** The number of times queued messages were posted for transmission. */
+  @SuppressWarnings("MemberName")
+  public final long flushes;
+
+  /** The duration of the last post of queued messages, in microseconds. */
+  @SuppressWarnings("MemberName")
+  public final long last_post_time;
+
+  /** The duration of the longest post of queued messages, in microseconds. */
+  @SuppressWarnings("MemberName")
+  public final long max_post_time;
+
+  /**
+   * Histogram of write latencies. Bucket i counts writes that completed in less than 10^(i+1)
+   * microseconds; the last bucket counts all longer writes.
+   */
+  @SuppressWarnings("MemberName")
+  public final long[] write_latency;
+
+  /**
+   * Constructor. This should generally only be used internally to NetworkTables.
+   *
+   * @param info Connection information
+   * @param bytesSent Bytes written
+   * @param messagesSent Messages written
+   * @param bytesReceived Bytes received
+   * @param messagesReceived Messages received
+   * @param messagesCoalesced Queued messages replaced before being sent
+   * @param queueHighWater Largest number of messages queued between posts
+   * @param flushes Number of posts
+   * @param lastPostTime Duration of the last post, in microseconds
+   * @param maxPostTime Duration of the longest post, in microseconds
+   * @param writeLatency Write latency histogram
+   */
+  public ConnectionStats(
+      ConnectionInfo info,
+      long bytesSent,
+      long messagesSent,
+      long bytesReceived,
+      long messagesReceived,
+      long messagesCoalesced,
+      long queueHighWater,
+      long flushes,
+      long lastPostTime,
+      long maxPostTime,
+      long[] writeLatency) {
+    this.info = info;
+    bytes_sent = bytesSent;
+    messages_sent = messagesSent;
+    bytes_received = bytesReceived;
+    messages_received = messagesReceived;
+    messages_coalesced = messagesCoalesced;
+    queue_high_water = queueHighWater;
+    this.flushes = flushes;
+    last_post_time = lastPostTime;
+    max_post_time = maxPostTime;
+    write_latency = writeLatency;
+  }
+}
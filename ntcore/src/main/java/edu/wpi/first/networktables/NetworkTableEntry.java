@@ -769,6 +769,15 @@ public final class NetworkTableEntry {
     NetworkTablesJNI.setEntryFlags(m_handle, getFlags() & ~flags);
   }
 
+  /**
+   * Sets the quantization step for double array updates sent with array deltas.
+   *
+   * @param quantum the quantization step (0 to send exact values)
+   */
+  public void setQuantization(double quantum) {
+    NetworkTablesJNI.setEntryQuantization(m_handle, quantum);
+  }
+
   /** Make value persistent through program restarts. */
   public void setPersistent() {
     setFlags(kPersistent);
@@ -729,6 +729,30 @@ public final class NetworkTableInstance implements AutoCloseable {
     NetworkTablesJNI.stopServer(m_handle);
   }
 
+  /**
+   * Select the server connection backend. When enabled, the server accepts and services all client
+   * connections on a single event loop thread instead of using a read and a write thread per
+   * client. This reduces thread count and context switching when many clients are connected. Takes
+   * effect the next time the server is started.
+   *
+   * @param enabled true to use the event loop backend
+   */
+  public void setEventLoopServer(boolean enabled) {
+    NetworkTablesJNI.setEventLoopServer(m_handle, enabled);
+  }
+
+  /**
+   * Select how the server saves persistent values. When enabled, the server appends changed
+   * persistent values to a journal file ("persistFilename.journal") from a background thread, and
+   * only rewrites the whole persistent file when the journal grows larger than it. Takes effect the
+   * next time the server is started.
+   *
+   * @param enabled true to journal persistent values
+   */
+  public void setPersistentJournal(boolean enabled) {
+    NetworkTablesJNI.setPersistentJournal(m_handle, enabled);
+  }
+
   /** Starts a client. Use SetServer to set the server name and port. */
   public void startClient() {
     NetworkTablesJNI.startClient(m_handle);
@@ -924,6 +948,31 @@ public final class NetworkTableInstance implements AutoCloseable {
     NetworkTablesJNI.setUpdateRate(m_handle, interval);
   }
 
+  /**
+   * Enable or disable low-latency updates. When enabled, local entry changes are sent to other
+   * nodes as soon as they are made rather than on the next periodic update. Changes made less than
+   * the minimum interval after the previous transmission to a node are coalesced and sent together
+   * once the interval has elapsed.
+   *
+   * @param enabled true to enable low-latency updates
+   * @param minIntervalUs minimum time between transmissions to a node, in microseconds (maximum 1
+   *     second)
+   */
+  public void setLowLatency(boolean enabled, int minIntervalUs) {
+    NetworkTablesJNI.setLowLatency(m_handle, enabled, minIntervalUs);
+  }
+
+  /**
+   * Enable or disable delta-encoded array updates. When enabled, this instance requests protocol
+   * revision 3.1 when operating as a client, which sends changes to boolean and double arrays as
+   * the changed elements only. Takes effect on the next connection.
+   *
+   * @param enabled true to request array deltas
+   */
+  public void setArrayDeltas(boolean enabled) {
+    NetworkTablesJNI.setArrayDeltas(m_handle, enabled);
+  }
+
   /**
    * Flushes all updated values immediately to the network. Note: This is rate-limited to protect
    * the network from flooding. This is primarily useful for synchronizing network updates with user
@@ -943,6 +992,16 @@ public final class NetworkTableInstance implements AutoCloseable {
     return NetworkTablesJNI.getConnections(m_handle);
   }
 
+  /**
+   * Gets statistics for the currently established network connections. If operating as a client,
+   * this will return either zero or one values.
+   *
+   * @return array of connection statistics
+   */
+  public ConnectionStats[] getConnectionStats() {
+    return NetworkTablesJNI.getConnectionStats(m_handle);
+  }
+
   /**
    * Return whether or not the instance is connected to another node.
    *
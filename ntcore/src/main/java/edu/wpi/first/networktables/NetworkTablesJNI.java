@@ -92,6 +92,8 @@ public final class NetworkTablesJNI {
 
   public static native boolean setStringArray(int entry, long time, String[] value, boolean force);
 
+  public static native boolean setDoubles(int[] entries, long time, double[] values);
+
   public static native NetworkTableValue getValue(int entry);
 
   public static native boolean getBoolean(int entry, boolean defaultValue);
@@ -126,6 +128,8 @@ public final class NetworkTablesJNI {
 
   public static native int getEntryFlags(int entry);
 
+  public static native void setEntryQuantization(int entry, double quantum);
+
   public static native void deleteEntry(int entry);
 
   public static native void deleteAllEntries(int inst);
@@ -214,6 +218,10 @@ public final class NetworkTablesJNI {
 
   public static native void stopServer(int inst);
 
+  public static native void setEventLoopServer(int inst, boolean enabled);
+
+  public static native void setPersistentJournal(int inst, boolean enabled);
+
   public static native void startClient(int inst);
 
   public static native void startClient(int inst, String serverName, int port);
@@ -236,10 +244,16 @@ public final class NetworkTablesJNI {
 
   public static native void setUpdateRate(int inst, double interval);
 
+  public static native void setLowLatency(int inst, boolean enabled, int minIntervalUs);
+
+  public static native void setArrayDeltas(int inst, boolean enabled);
+
   public static native void flush(int inst);
 
   public static native ConnectionInfo[] getConnections(int inst);
 
+  public static native ConnectionStats[] getConnectionStats(int inst);
+
   public static native boolean isConnected(int inst);
 
   public static native void savePersistent(int inst, String filename) throws PersistentException;
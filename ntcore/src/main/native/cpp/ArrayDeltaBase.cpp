@@ -0,0 +1,32 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ArrayDeltaBase.h"
+
+#include <utility>
+
+using namespace nt;
+
+void ArrayDeltaBase::Set(unsigned int id, std::shared_ptr<Value> value) {
+  if (id >= 0xffff) {
+    return;  // unassigned
+  }
+  // arrays are truncated to 255 elements on the wire, so longer ones can't
+  // be a base
+  if (!value ||
+      (value->type() != NT_BOOLEAN_ARRAY && value->type() != NT_DOUBLE_ARRAY) ||
+      (value->type() == NT_BOOLEAN_ARRAY &&
+       value->GetBooleanArray().size() > 0xff) ||
+      (value->type() == NT_DOUBLE_ARRAY &&
+       value->GetDoubleArray().size() > 0xff)) {
+    if (id < m_values.size()) {
+      m_values[id].reset();
+    }
+    return;
+  }
+  if (id >= m_values.size()) {
+    m_values.resize(id + 1);
+  }
+  m_values[id] = std::move(value);
+}
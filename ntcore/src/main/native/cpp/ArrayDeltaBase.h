@@ -0,0 +1,39 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef NTCORE_ARRAYDELTABASE_H_
+#define NTCORE_ARRAYDELTABASE_H_
+
+#include <memory>
+#include <vector>
+
+#include "networktables/NetworkTableValue.h"
+
+namespace nt {
+
+/* The last boolean or double array value sent (or received) on a connection
+ * for each entry id.  This is the base for delta-encoded array updates
+ * (protocol revision 3.1), so a separate instance is kept for each direction
+ * of each connection, and it must be updated for every assignment and update
+ * in the same order on both ends.
+ */
+class ArrayDeltaBase {
+ public:
+  /* Returns the base value for an id, or nullptr if there is none. */
+  const Value* Get(unsigned int id) const {
+    return id < m_values.size() ? m_values[id].get() : nullptr;
+  }
+
+  /* Sets the base value for an id.  Values of other types clear it. */
+  void Set(unsigned int id, std::shared_ptr<Value> value);
+
+  void Clear() { m_values.clear(); }
+
+ private:
+  std::vector<std::shared_ptr<Value>> m_values;
+};
+
+}  // namespace nt
+
+#endif  // NTCORE_ARRAYDELTABASE_H_
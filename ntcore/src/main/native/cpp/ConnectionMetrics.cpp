@@ -0,0 +1,33 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ConnectionMetrics.h"
+
+using namespace nt;
+
+void ConnectionMetrics::RecordWrite(uint64_t latency) {
+  // decade buckets: <10us, <100us, ... with the last one unbounded
+  int bucket = 0;
+  for (uint64_t limit = 10;
+       latency >= limit && bucket < ConnectionStats::kWriteLatencyBuckets - 1;
+       limit *= 10) {
+    ++bucket;
+  }
+  Add(m_write_latency[bucket], 1);
+}
+
+void ConnectionMetrics::GetStats(ConnectionStats* stats) const {
+  stats->bytes_sent = m_bytes_sent.load(std::memory_order_relaxed);
+  stats->messages_sent = m_messages_sent.load(std::memory_order_relaxed);
+  stats->bytes_received = m_bytes_received.load(std::memory_order_relaxed);
+  stats->messages_received =
+      m_messages_received.load(std::memory_order_relaxed);
+  stats->flushes = m_flushes.load(std::memory_order_relaxed);
+  stats->last_post_time = m_last_post_time.load(std::memory_order_relaxed);
+  stats->max_post_time = m_max_post_time.load(std::memory_order_relaxed);
+  for (int i = 0; i < ConnectionStats::kWriteLatencyBuckets; ++i) {
+    stats->write_latency[i] =
+        m_write_latency[i].load(std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,73 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef NTCORE_CONNECTIONMETRICS_H_
+#define NTCORE_CONNECTIONMETRICS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "ntcore_cpp.h"
+
+namespace nt {
+
+/* Traffic counters for a connection.  Each group of counters has a single
+ * writer (the read side, the write side, or the poster holding the pending
+ * mutex), so updates are plain relaxed stores rather than read-modify-write
+ * operations; readers may see a slightly stale but never torn snapshot.
+ */
+class ConnectionMetrics {
+ public:
+  /* Called by the writer after bytes holding messages have been written. */
+  void RecordSent(size_t bytes, size_t messages) {
+    Add(m_bytes_sent, bytes);
+    Add(m_messages_sent, messages);
+  }
+
+  /* Called by the reader for received data and decoded messages. */
+  void RecordReceived(size_t bytes, size_t messages) {
+    Add(m_bytes_received, bytes);
+    Add(m_messages_received, messages);
+  }
+
+  /* Called (with the pending mutex held) after posting queued messages. */
+  void RecordPost(uint64_t duration) {
+    Add(m_flushes, 1);
+    m_last_post_time.store(duration, std::memory_order_relaxed);
+    if (duration > m_max_post_time.load(std::memory_order_relaxed)) {
+      m_max_post_time.store(duration, std::memory_order_relaxed);
+    }
+  }
+
+  /* Called by the writer when a write completes. */
+  void RecordWrite(uint64_t latency);
+
+  /* Fills in the traffic counters of stats.  The connection info and queue
+   * counters are left to the caller.
+   */
+  void GetStats(ConnectionStats* stats) const;
+
+ private:
+  using Counter = std::atomic<uint64_t>;
+
+  static void Add(Counter& counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n,
+                  std::memory_order_relaxed);
+  }
+
+  Counter m_bytes_sent{0};
+  Counter m_messages_sent{0};
+  Counter m_bytes_received{0};
+  Counter m_messages_received{0};
+  Counter m_flushes{0};
+  Counter m_last_post_time{0};
+  Counter m_max_post_time{0};
+  Counter m_write_latency[ConnectionStats::kWriteLatencyBuckets] = {};
+};
+
+}  // namespace nt
+
+#endif  // NTCORE_CONNECTIONMETRICS_H_
@@ -5,24 +5,34 @@
 #include "Dispatcher.h"
 
 #include <algorithm>
+#include <cstdio>
 #include <iterator>
 
+#include <fmt/format.h>
+#include <wpi/EventLoopRunner.h>
 #include <wpi/SmallVector.h>
 #include <wpi/StringExtras.h>
 #include <wpi/TCPAcceptor.h>
 #include <wpi/TCPConnector.h>
+#include <wpi/fs.h>
 #include <wpi/timestamp.h>
+#include <wpi/uv/Tcp.h>
 
 #include "IConnectionNotifier.h"
 #include "IStorage.h"
 #include "Log.h"
 #include "NetworkConnection.h"
+#include "UvConnection.h"
 
 using namespace nt;
 
 void Dispatcher::StartServer(std::string_view persist_filename,
                              const char* listen_address, unsigned int port) {
   std::string listen_address_copy(wpi::trim(listen_address));
+  if (event_loop_server()) {
+    StartEventLoopServer(persist_filename, listen_address_copy, port);
+    return;
+  }
   DispatcherBase::StartServer(
       persist_filename,
       std::unique_ptr<wpi::NetworkAcceptor>(new wpi::TCPAcceptor(
@@ -94,9 +104,17 @@ void Dispatcher::ClearServerOverride() {
 
 DispatcherBase::DispatcherBase(IStorage& storage, IConnectionNotifier& notifier,
                                wpi::Logger& logger)
-    : m_storage(storage), m_notifier(notifier), m_logger(logger) {
+    : m_storage(storage),
+      m_notifier(notifier),
+      m_journal(logger),
+      m_logger(logger) {
   m_active = false;
+  m_persistent_journal = false;
   m_update_rate = 100;
+  m_low_latency = false;
+  m_min_post_interval = 1000;
+  m_array_deltas = false;
+  m_event_loop_server = false;
 }
 
 DispatcherBase::~DispatcherBase() {
@@ -119,19 +137,16 @@ void DispatcherBase::StartLocal() {
   m_storage.SetDispatcher(this, false);
 }
 
-void DispatcherBase::StartServer(
-    std::string_view persist_filename,
-    std::unique_ptr<wpi::NetworkAcceptor> acceptor) {
+bool DispatcherBase::StartServerCommon(std::string_view persist_filename) {
   {
     std::scoped_lock lock(m_user_mutex);
     if (m_active) {
-      return;
+      return false;
     }
     m_active = true;
   }
   m_networkMode = NT_NET_MODE_SERVER | NT_NET_MODE_STARTING;
   m_persist_filename = persist_filename;
-  m_server_acceptor = std::move(acceptor);
 
   // Load persistent file.  Ignore errors, but pass along warnings.
   if (!persist_filename.empty()) {
@@ -145,14 +160,84 @@ void DispatcherBase::StartServer(
           }
           WARNING("{}:{}: {}", persist_filename, line, msg);
         });
+
+    auto journal_filename = fmt::format("{}.journal", persist_filename);
+    if (m_persistent_journal) {
+      std::vector<std::pair<std::string, std::shared_ptr<Value>>> entries;
+      m_storage.StartPersistentJournal(&entries);
+      m_journal.Start(persist_filename, std::move(entries));
+    } else if (std::error_code ec; fs::exists(journal_filename, ec)) {
+      // Fold a journal left by a previous journaled run into the file, so it
+      // is not applied again over later saves.
+      if (!m_storage.SavePersistent(persist_filename, false)) {
+        std::remove(journal_filename.c_str());
+      }
+    }
   }
 
   m_storage.SetDispatcher(this, true);
+  return true;
+}
+
+void DispatcherBase::StartServer(
+    std::string_view persist_filename,
+    std::unique_ptr<wpi::NetworkAcceptor> acceptor) {
+  if (!StartServerCommon(persist_filename)) {
+    return;
+  }
+  m_server_acceptor = std::move(acceptor);
 
   m_dispatch_thread = std::thread(&Dispatcher::DispatchThreadMain, this);
   m_clientserver_thread = std::thread(&Dispatcher::ServerThreadMain, this);
 }
 
+void DispatcherBase::StartEventLoopServer(std::string_view persist_filename,
+                                          std::string_view listen_address,
+                                          unsigned int port) {
+  if (!StartServerCommon(persist_filename)) {
+    return;
+  }
+
+  // accept and service all connections on the loop thread
+  m_event_loop = std::make_unique<wpi::EventLoopRunner>();
+  m_event_loop->ExecSync([&](wpi::uv::Loop& loop) {
+    auto server = wpi::uv::Tcp::Create(loop);
+    if (!server) {
+      m_networkMode = NT_NET_MODE_SERVER | NT_NET_MODE_FAILURE;
+      return;
+    }
+    server->error.connect([this, s = server.get()](wpi::uv::Error err) {
+      ERROR("server: {}", err.str());
+      m_networkMode = NT_NET_MODE_SERVER | NT_NET_MODE_FAILURE;
+      s->Close();
+    });
+    server->connection.connect([this, s = server.get()] {
+      if (auto stream = s->Accept()) {
+        EventLoopServerAccept(std::move(stream));
+      }
+    });
+    server->Bind(listen_address, port);
+    server->Listen();
+    if ((m_networkMode & NT_NET_MODE_FAILURE) == 0) {
+      m_networkMode = NT_NET_MODE_SERVER;
+    }
+  });
+  if ((m_networkMode & NT_NET_MODE_FAILURE) != 0) {
+    // undo StartServerCommon() so the server can be started again
+    m_event_loop->Stop();
+    m_event_loop.reset();
+    m_storage.ClearDispatcher();
+    if (m_journal.IsRunning()) {
+      m_journal.Stop();
+      m_storage.StopPersistentJournal();
+    }
+    m_active = false;
+    return;
+  }
+
+  m_dispatch_thread = std::thread(&Dispatcher::DispatchThreadMain, this);
+}
+
 void DispatcherBase::StartClient() {
   {
     std::scoped_lock lock(m_user_mutex);
@@ -194,6 +279,24 @@ void DispatcherBase::Stop() {
     m_clientserver_thread.join();
   }
 
+  // journal changes since the last periodic save and wait for them to be
+  // written
+  if (m_journal.IsRunning()) {
+    std::vector<std::pair<std::string, std::shared_ptr<Value>>> changes;
+    if (m_storage.GetPersistentChanges(&changes)) {
+      m_journal.Append(std::move(changes));
+    }
+    m_journal.Stop();
+    m_storage.StopPersistentJournal();
+  }
+
+  // stopping the loop closes the server and all of its connections
+  if (m_event_loop) {
+    m_event_loop->Stop();
+    m_event_loop.reset();
+    m_networkMode = NT_NET_MODE_NONE;
+  }
+
   std::vector<std::shared_ptr<INetworkConnection>> conns;
   {
     std::scoped_lock lock(m_user_mutex);
@@ -214,6 +317,29 @@ void DispatcherBase::SetUpdateRate(double interval) {
   m_update_rate = static_cast<unsigned int>(interval * 1000);
 }
 
+void DispatcherBase::SetLowLatency(bool enabled, unsigned int min_interval_us) {
+  // don't allow minimum intervals slower than 1 second
+  if (min_interval_us > 1000000) {
+    min_interval_us = 1000000;
+  }
+  m_min_post_interval = min_interval_us;
+  m_low_latency = enabled;
+}
+
+void DispatcherBase::SetEventLoopServer(bool enabled) {
+  m_event_loop_server = enabled;
+}
+
+void DispatcherBase::SetPersistentJournal(bool enabled) {
+  m_persistent_journal = enabled;
+}
+
+void DispatcherBase::SetArrayDeltas(bool enabled) {
+  m_array_deltas = enabled;
+  std::scoped_lock lock(m_user_mutex);
+  m_reconnect_proto_rev = enabled ? 0x0301 : 0x0300;
+}
+
 void DispatcherBase::SetIdentity(std::string_view name) {
   std::scoped_lock lock(m_user_mutex);
   m_identity = name;
@@ -250,6 +376,27 @@ std::vector<ConnectionInfo> DispatcherBase::GetConnections() const {
   return conns;
 }
 
+std::vector<ConnectionStats> DispatcherBase::GetConnectionStats() const {
+  std::vector<ConnectionStats> stats;
+  if (!m_active) {
+    return stats;
+  }
+
+  std::scoped_lock lock(m_user_mutex);
+  for (auto& conn : m_connections) {
+    if (conn->state() != NetworkConnection::kActive) {
+      continue;
+    }
+    stats.emplace_back(conn->stats());
+  }
+
+  return stats;
+}
+
+PersistentSaveMetrics DispatcherBase::GetPersistentSaveMetrics() const {
+  return m_journal.GetMetrics();
+}
+
 bool DispatcherBase::IsConnected() const {
   if (!m_active) {
     return false;
@@ -324,44 +471,71 @@ void DispatcherBase::DispatchThreadMain() {
   auto next_save_time = timeout_time + save_delta_time;
 
   int count = 0;
+  bool periodic = true;
 
   while (m_active) {
     // handle loop taking too long
     auto start = std::chrono::steady_clock::now();
-    if (start > timeout_time) {
-      timeout_time = start;
+    if (periodic) {
+      if (start > timeout_time) {
+        timeout_time = start;
+      }
+      timeout_time += std::chrono::milliseconds(m_update_rate);
     }
 
-    // wait for periodic or when flushed
-    timeout_time += std::chrono::milliseconds(m_update_rate);
+    // wait for periodic, low-latency post deadline, or when flushed
     std::unique_lock<wpi::mutex> flush_lock(m_flush_mutex);
-    m_flush_cv.wait_until(flush_lock, timeout_time,
-                          [&] { return !m_active || m_do_flush; });
+    auto wakeup_time = (std::min)(timeout_time, m_post_deadline);
+    m_flush_cv.wait_until(flush_lock, wakeup_time, [&] {
+      return !m_active || m_do_flush || m_post_deadline < wakeup_time;
+    });
+    auto now = std::chrono::steady_clock::now();
+    periodic = m_do_flush || now >= timeout_time;
+    bool post_due = m_post_deadline <= now;
+    if (post_due) {
+      // re-armed below for connections that are not yet due
+      m_post_deadline = std::chrono::steady_clock::time_point::max();
+    }
     m_do_flush = false;
     flush_lock.unlock();
     if (!m_active) {
       break;  // in case we were woken up to terminate
     }
+    if (!periodic && !post_due) {
+      continue;  // an earlier post deadline was armed
+    }
 
     // perform periodic persistent save
-    if ((m_networkMode & NT_NET_MODE_SERVER) != 0 &&
+    if (periodic && (m_networkMode & NT_NET_MODE_SERVER) != 0 &&
         !m_persist_filename.empty() && start > next_save_time) {
       next_save_time += save_delta_time;
       // handle loop taking too long
       if (start > next_save_time) {
         next_save_time = start + save_delta_time;
       }
-      const char* err = m_storage.SavePersistent(m_persist_filename, true);
-      if (err) {
-        WARNING("periodic persistent save: {}", err);
+      auto save_start = wpi::Now();
+      const char* err = nullptr;
+      if (m_journal.IsRunning()) {
+        // only collect the changes; the journal writes them in the background
+        std::vector<std::pair<std::string, std::shared_ptr<Value>>> changes;
+        if (m_storage.GetPersistentChanges(&changes)) {
+          m_journal.Append(std::move(changes));
+        }
+      } else {
+        err = m_storage.SavePersistent(m_persist_filename, true);
+        if (err) {
+          WARNING("periodic persistent save: {}", err);
+        }
       }
+      m_journal.RecordDispatch(wpi::Now() - save_start, err != nullptr);
     }
 
     {
       std::scoped_lock user_lock(m_user_mutex);
       bool reconnect = false;
+      auto next_deadline = std::chrono::steady_clock::time_point::max();
 
-      if (++count > 10) {
+      if (periodic && ++count > 10) {
         DEBUG0("dispatch running {} connections", m_connections.size());
         count = 0;
       }
@@ -370,7 +544,17 @@ void DispatcherBase::DispatchThreadMain() {
         // post outgoing messages if connection is active
         // only send keep-alives on client
         if (conn->state() == NetworkConnection::kActive) {
-          conn->PostOutgoing((m_networkMode & NT_NET_MODE_CLIENT) != 0);
+          if (periodic) {
+            conn->PostOutgoing((m_networkMode & NT_NET_MODE_CLIENT) != 0);
+          } else {
+            // low-latency: only post connections whose deadline has passed
+            auto deadline = conn->post_deadline();
+            if (deadline <= now) {
+              conn->PostOutgoing(false);
+            } else if (deadline < next_deadline) {
+              next_deadline = deadline;
+            }
+          }
         }
 
         // if client, reconnect if connection died
@@ -384,6 +568,14 @@ void DispatcherBase::DispatchThreadMain() {
         m_do_reconnect = true;
         m_reconnect_cv.notify_one();
       }
+
+      // re-arm for connections that are not yet due
+      if (next_deadline != std::chrono::steady_clock::time_point::max()) {
+        std::scoped_lock lock(m_flush_mutex);
+        if (next_deadline < m_post_deadline) {
+          m_post_deadline = next_deadline;
+        }
+      }
     }
   }
 }
@@ -391,6 +583,20 @@ void DispatcherBase::DispatchThreadMain() {
 void DispatcherBase::QueueOutgoing(std::shared_ptr<Message> msg,
                                    INetworkConnection* only,
                                    INetworkConnection* except) {
+  QueueOutgoingBatch({&msg, 1}, only, except);
+}
+
+void DispatcherBase::QueueOutgoingBatch(
+    wpi::span<std::shared_ptr<Message>> msgs, INetworkConnection* only,
+    INetworkConnection* except) {
+  bool low_latency = m_low_latency;
+  auto now = std::chrono::steady_clock::time_point::min();
+  if (low_latency) {
+    now = std::chrono::steady_clock::now();
+  }
+  std::chrono::microseconds min_interval{m_min_post_interval};
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
   std::scoped_lock user_lock(m_user_mutex);
   for (auto& conn : m_connections) {
     if (conn.get() == except) {
@@ -404,7 +610,27 @@ void DispatcherBase::QueueOutgoing(std::shared_ptr<Message> msg,
         state != NetworkConnection::kActive) {
       continue;
     }
-    conn->QueueOutgoing(msg);
+    for (auto& msg : msgs) {
+      conn->QueueOutgoing(msg);
+    }
+    // arm the connection's post deadline; synchronizing connections are
+    // posted by the periodic update once they become active
+    if (low_latency && state == NetworkConnection::kActive) {
+      deadline =
+          (std::min)(deadline, conn->ArmPostDeadline(now, min_interval));
+    }
+  }
+
+  // wake up the dispatch thread if this is the earliest deadline
+  if (deadline != std::chrono::steady_clock::time_point::max()) {
+    {
+      std::scoped_lock lock(m_flush_mutex);
+      if (deadline >= m_post_deadline) {
+        return;
+      }
+      m_post_deadline = deadline;
+    }
+    m_flush_cv.notify_one();
   }
 }
 
@@ -502,7 +728,7 @@ void DispatcherBase::ClientThreadMain() {
     conn->Start();
 
     // reconnect the next time starting with latest protocol revision
-    m_reconnect_proto_rev = 0x0300;
+    m_reconnect_proto_rev = m_array_deltas ? 0x0301 : 0x0300;
 
     // block until told to reconnect
     m_do_reconnect = false;
@@ -537,6 +763,9 @@ bool DispatcherBase::ClientHandshake(
   if (msg->Is(Message::kProtoUnsup)) {
     if (msg->id() == 0x0200) {
       ClientReconnect(0x0200);
+    } else if (msg->id() == 0x0300 && conn.proto_rev() > 0x0300) {
+      // server doesn't support protocol extensions
+      ClientReconnect(0x0300);
     }
     return false;
   }
@@ -613,47 +842,22 @@ bool DispatcherBase::ServerHandshake(
     DEBUG0("{}", "server: client disconnected before sending hello");
     return false;
   }
-  if (!msg->Is(Message::kClientHello)) {
-    DEBUG0("{}", "server: client initial message was not client hello");
-    return false;
-  }
 
-  // Check that the client requested version is not too high.
-  unsigned int proto_rev = msg->id();
-  if (proto_rev > 0x0300) {
-    DEBUG0("{}", "server: client requested proto > 0x0300");
-    auto toSend = Message::ProtoUnsup();
-    send_msgs(wpi::span(&toSend, 1));
+  // Batch transmit the response
+  NetworkConnection::Outgoing outgoing;
+  bool ok = ServerHelloResponse(conn, *msg, &outgoing);
+  if (!outgoing.empty()) {
+    send_msgs(outgoing);
+  }
+  if (!ok) {
     return false;
   }
 
+  unsigned int proto_rev = conn.proto_rev();
   if (proto_rev >= 0x0300) {
     conn.set_remote_id(msg->str());
   }
 
-  // Set the proto version to the client requested version
-  DEBUG0("server: client protocol {}", proto_rev);
-  conn.set_proto_rev(proto_rev);
-
-  // Send initial set of assignments
-  NetworkConnection::Outgoing outgoing;
-
-  // Start with server hello.  TODO: initial connection flag
-  if (proto_rev >= 0x0300) {
-    std::scoped_lock lock(m_user_mutex);
-    outgoing.emplace_back(Message::ServerHello(0u, m_identity));
-  }
-
-  // Get snapshot of initial assignments
-  m_storage.GetInitialAssignments(conn, &outgoing);
-
-  // Finish with server hello done
-  outgoing.emplace_back(Message::ServerHelloDone());
-
-  // Batch transmit
-  DEBUG0("{}", "server: sending initial assignments");
-  send_msgs(outgoing);
-
   // In proto rev 3.0 and later, the handshake concludes with a client hello
   // done message, so we can batch the assigns before marking the connection
   // active.  In pre-3.0, we need to just immediately mark it active and hand
@@ -698,6 +902,120 @@ bool DispatcherBase::ServerHandshake(
   return true;
 }
 
+bool DispatcherBase::ServerHelloResponse(
+    INetworkConnection& conn, const Message& hello,
+    std::vector<std::shared_ptr<Message>>* outgoing) {
+  if (!hello.Is(Message::kClientHello)) {
+    DEBUG0("{}", "server: client initial message was not client hello");
+    return false;
+  }
+
+  // Check that the client requested version is not too high.
+  unsigned int proto_rev = hello.id();
+  if (proto_rev > 0x0301) {
+    DEBUG0("{}", "server: client requested proto > 0x0301");
+    conn.set_proto_rev(0x0301);  // reply with the highest supported
+    outgoing->emplace_back(Message::ProtoUnsup());
+    return false;
+  }
+
+  // Set the proto version to the client requested version
+  DEBUG0("server: client protocol {}", proto_rev);
+  conn.set_proto_rev(proto_rev);
+
+  // Start with server hello.  TODO: initial connection flag
+  if (proto_rev >= 0x0300) {
+    std::scoped_lock lock(m_user_mutex);
+    outgoing->emplace_back(Message::ServerHello(0u, m_identity));
+  }
+
+  // Get snapshot of initial assignments
+  m_storage.GetInitialAssignments(conn, outgoing);
+
+  // Finish with server hello done
+  outgoing->emplace_back(Message::ServerHelloDone());
+  DEBUG0("{}", "server: sending initial assignments");
+  return true;
+}
+
+void DispatcherBase::EventLoopServerAccept(
+    std::shared_ptr<wpi::uv::Tcp> stream) {
+  using namespace std::placeholders;
+  auto conn = std::make_shared<UvConnection>(
+      ++m_connections_uid, std::move(stream), m_notifier, m_logger,
+      [this, incoming = std::vector<std::shared_ptr<Message>>()](
+          UvConnection& conn, std::shared_ptr<Message> msg) mutable {
+        return EventLoopServerHandshake(conn, std::move(msg), &incoming);
+      },
+      std::bind(&IStorage::GetMessageEntryType, &m_storage, _1));  // NOLINT
+  conn->set_process_incoming(
+      std::bind(&IStorage::ProcessIncoming, &m_storage, _1, _2,  // NOLINT
+                std::weak_ptr<UvConnection>(conn)));
+  DEBUG0("server: client connection from {} port {}", conn->info().remote_ip,
+         conn->info().remote_port);
+  {
+    std::scoped_lock lock(m_user_mutex);
+    // reuse dead connection slots
+    bool placed = false;
+    for (auto& c : m_connections) {
+      if (c->state() == INetworkConnection::kDead) {
+        c = conn;
+        placed = true;
+        break;
+      }
+    }
+    if (!placed) {
+      m_connections.emplace_back(conn);
+    }
+  }
+  conn->Start();
+}
+
+UvConnection::HandshakeResult DispatcherBase::EventLoopServerHandshake(
+    UvConnection& conn, std::shared_ptr<Message> msg,
+    std::vector<std::shared_ptr<Message>>* incoming) {
+  // The first message must be the client hello; this is the same exchange as
+  // ServerHandshake(), driven one message at a time by the event loop.
+  if (conn.state() == INetworkConnection::kHandshake) {
+    NetworkConnection::Outgoing outgoing;
+    bool ok = ServerHelloResponse(conn, *msg, &outgoing);
+    if (!outgoing.empty()) {
+      conn.Send(outgoing);
+    }
+    if (!ok) {
+      return UvConnection::kHandshakeFailed;
+    }
+    if (conn.proto_rev() >= 0x0300) {
+      // wait for the client initial assignments
+      conn.set_remote_id(msg->str());
+      return UvConnection::kHandshakeContinue;
+    }
+  } else if (msg->Is(Message::kClientHelloDone)) {
+    for (auto& msg : *incoming) {
+      m_storage.ProcessIncoming(msg, &conn, std::weak_ptr<UvConnection>());
+    }
+    incoming->clear();
+  } else if (msg->Is(Message::kKeepAlive)) {
+    // shouldn't receive a keep alive, but handle gracefully
+    return UvConnection::kHandshakeContinue;
+  } else if (msg->Is(Message::kEntryAssign)) {
+    incoming->emplace_back(std::move(msg));
+    return UvConnection::kHandshakeContinue;
+  } else {
+    // unexpected message
+    DEBUG0(
+        "server: received message ({}) other than entry assignment during "
+        "initial handshake",
+        msg->type());
+    return UvConnection::kHandshakeFailed;
+  }
+
+  auto info = conn.info();
+  INFO("server: client CONNECTED: {} port {}", info.remote_ip,
+       info.remote_port);
+  return UvConnection::kHandshakeComplete;
+}
+
 void DispatcherBase::ClientReconnect(unsigned int proto_rev) {
   if ((m_networkMode & NT_NET_MODE_SERVER) != 0) {
     return;
@@ -6,6 +6,7 @@
 #define NTCORE_DISPATCHER_H_
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
@@ -20,11 +21,17 @@
 
 #include "IDispatcher.h"
 #include "INetworkConnection.h"
+#include "PersistentJournal.h"
+#include "UvConnection.h"
 
 namespace wpi {
+class EventLoopRunner;
 class Logger;
 class NetworkAcceptor;
 class NetworkStream;
+namespace uv {
+class Tcp;
+}  // namespace uv
 }  // namespace wpi
 
 namespace nt {
@@ -47,13 +54,23 @@ class DispatcherBase : public IDispatcher {
   void StartLocal();
   void StartServer(std::string_view persist_filename,
                    std::unique_ptr<wpi::NetworkAcceptor> acceptor);
+  void StartEventLoopServer(std::string_view persist_filename,
+                            std::string_view listen_address,
+                            unsigned int port);
   void StartClient();
   void Stop();
   void SetUpdateRate(double interval);
+  void SetLowLatency(bool enabled, unsigned int min_interval_us);
+  void SetEventLoopServer(bool enabled);
+  void SetPersistentJournal(bool enabled);
+  void SetArrayDeltas(bool enabled);
+  bool event_loop_server() const { return m_event_loop_server; }
   void SetIdentity(std::string_view name);
   void Flush();
   std::vector<ConnectionInfo> GetConnections() const;
+  std::vector<ConnectionStats> GetConnectionStats() const;
   bool IsConnected() const;
+  PersistentSaveMetrics GetPersistentSaveMetrics() const;
 
   unsigned int AddListener(
       std::function<void(const ConnectionNotification& event)> callback,
@@ -71,9 +88,11 @@ class DispatcherBase : public IDispatcher {
   DispatcherBase& operator=(const DispatcherBase&) = delete;
 
  private:
+  bool StartServerCommon(std::string_view persist_filename);
   void DispatchThreadMain();
   void ServerThreadMain();
   void ClientThreadMain();
+  void EventLoopServerAccept(std::shared_ptr<wpi::uv::Tcp> stream);
 
   bool ClientHandshake(
       NetworkConnection& conn,
@@ -83,20 +102,34 @@ class DispatcherBase : public IDispatcher {
       NetworkConnection& conn,
       std::function<std::shared_ptr<Message>()> get_msg,
       std::function<void(wpi::span<std::shared_ptr<Message>>)> send_msgs);
+  bool ServerHelloResponse(INetworkConnection& conn, const Message& hello,
+                           std::vector<std::shared_ptr<Message>>* outgoing);
+  UvConnection::HandshakeResult EventLoopServerHandshake(
+      UvConnection& conn, std::shared_ptr<Message> msg,
+      std::vector<std::shared_ptr<Message>>* incoming);
 
   void ClientReconnect(unsigned int proto_rev = 0x0300);
 
   void QueueOutgoing(std::shared_ptr<Message> msg, INetworkConnection* only,
                      INetworkConnection* except) override;
+  void QueueOutgoingBatch(wpi::span<std::shared_ptr<Message>> msgs,
+                          INetworkConnection* only,
+                          INetworkConnection* except) override;
 
   IStorage& m_storage;
   IConnectionNotifier& m_notifier;
   unsigned int m_networkMode = NT_NET_MODE_NONE;
   std::string m_persist_filename;
+  // Journals persistent changes when m_persistent_journal is set at startup
+  std::atomic_bool m_persistent_journal;
+  PersistentJournal m_journal;
   std::thread m_dispatch_thread;
   std::thread m_clientserver_thread;
 
   std::unique_ptr<wpi::NetworkAcceptor> m_server_acceptor;
+  // Services all server connections on one thread when set
+  std::atomic_bool m_event_loop_server;
+  std::unique_ptr<wpi::EventLoopRunner> m_event_loop;
   Connector m_client_connector_override;
   Connector m_client_connector;
   uint8_t m_connections_uid = 0;
@@ -108,12 +141,18 @@ class DispatcherBase : public IDispatcher {
 
   std::atomic_bool m_active;       // set to false to terminate threads
   std::atomic_uint m_update_rate;  // periodic dispatch update rate, in ms
+  std::atomic_bool m_low_latency;  // post as soon as messages are queued
+  std::atomic_uint m_min_post_interval;  // low-latency post floor, in us
+  std::atomic_bool m_array_deltas;       // client requests protocol 3.1
 
   // Condition variable for forced dispatch wakeup (flush)
   wpi::mutex m_flush_mutex;
   wpi::condition_variable m_flush_cv;
   uint64_t m_last_flush = 0;
   bool m_do_flush = false;
+  // Earliest armed low-latency connection post deadline (uses flush mutex)
+  std::chrono::steady_clock::time_point m_post_deadline =
+      std::chrono::steady_clock::time_point::max();
 
   // Condition variable for client reconnect (uses user mutex)
   wpi::condition_variable m_reconnect_cv;
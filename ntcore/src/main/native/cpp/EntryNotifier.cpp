@@ -107,3 +107,27 @@ void EntryNotifier::NotifyEntry(unsigned int local_id, std::string_view name,
   Send(only_listener, 0, Handle(m_inst, local_id, Handle::kEntry).handle(),
        name, value, flags);
 }
+
+void EntryNotifier::NotifyEntries(wpi::span<const EntryNotifyData> data) {
+  if (data.empty()) {
+    return;
+  }
+  // queue everything with a single lock and wakeup
+  auto thr = GetThread();
+  if (!thr || thr->m_listeners.empty()) {
+    return;
+  }
+  for (auto&& item : data) {
+    if ((item.flags & NT_NOTIFY_LOCAL) != 0 && !m_local_notifiers) {
+      continue;
+    }
+    DEBUG0("notifying '{}' (local={}), flags={}", item.name, item.local_id,
+           item.flags);
+    thr->m_queue.emplace(
+        std::piecewise_construct, std::make_tuple(UINT_MAX),
+        std::forward_as_tuple(
+            0, Handle(m_inst, item.local_id, Handle::kEntry).handle(),
+            item.name, item.value, item.flags));
+  }
+  thr->m_cond.notify_one();
+}
@@ -97,6 +97,7 @@ class EntryNotifier
   void NotifyEntry(unsigned int local_id, std::string_view name,
                    std::shared_ptr<Value> value, unsigned int flags,
                    unsigned int only_listener = UINT_MAX) override;
+  void NotifyEntries(wpi::span<const EntryNotifyData> data) override;
 
  private:
   int m_inst;
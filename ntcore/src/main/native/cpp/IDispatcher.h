@@ -7,6 +7,8 @@
 
 #include <memory>
 
+#include <wpi/span.h>
+
 #include "Message.h"
 
 namespace nt {
@@ -24,6 +26,10 @@ class IDispatcher {
   virtual void QueueOutgoing(std::shared_ptr<Message> msg,
                              INetworkConnection* only,
                              INetworkConnection* except) = 0;
+  // Queues several messages at once; they are kept together and in order.
+  virtual void QueueOutgoingBatch(wpi::span<std::shared_ptr<Message>> msgs,
+                                  INetworkConnection* only,
+                                  INetworkConnection* except) = 0;
 };
 
 }  // namespace nt
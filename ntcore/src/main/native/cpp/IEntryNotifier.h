@@ -9,10 +9,20 @@
 #include <memory>
 #include <string_view>
 
+#include <wpi/span.h>
+
 #include "ntcore_cpp.h"
 
 namespace nt {
 
+// A single entry notification, used for batched notification.
+struct EntryNotifyData {
+  unsigned int local_id;
+  std::string_view name;
+  std::shared_ptr<Value> value;
+  unsigned int flags;
+};
+
 class IEntryNotifier {
  public:
   IEntryNotifier() = default;
@@ -36,6 +46,8 @@ class IEntryNotifier {
   virtual void NotifyEntry(unsigned int local_id, std::string_view name,
                            std::shared_ptr<Value> value, unsigned int flags,
                            unsigned int only_listener = UINT_MAX) = 0;
+  // Notifies all listeners of several entries at once.
+  virtual void NotifyEntries(wpi::span<const EntryNotifyData> data) = 0;
 };
 
 }  // namespace nt
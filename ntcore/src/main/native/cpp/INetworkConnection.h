@@ -5,6 +5,7 @@
 #ifndef NTCORE_INETWORKCONNECTION_H_
 #define NTCORE_INETWORKCONNECTION_H_
 
+#include <chrono>
 #include <memory>
 
 #include "Message.h"
@@ -23,9 +24,21 @@ class INetworkConnection {
 
   virtual ConnectionInfo info() const = 0;
 
+  // Returns the connection info with traffic and queue statistics.
+  virtual ConnectionStats stats() const = 0;
+
   virtual void QueueOutgoing(std::shared_ptr<Message> msg) = 0;
   virtual void PostOutgoing(bool keep_alive) = 0;
 
+  // Low-latency mode: arms a deadline for posting the pending outgoing
+  // messages, no sooner than min_interval after the previous post.  If a
+  // deadline is already armed, it is left unchanged.  Returns the deadline.
+  virtual std::chrono::steady_clock::time_point ArmPostDeadline(
+      std::chrono::steady_clock::time_point now,
+      std::chrono::microseconds min_interval) = 0;
+  // Returns the armed post deadline, or time_point::max() if not armed.
+  virtual std::chrono::steady_clock::time_point post_deadline() const = 0;
+
   virtual unsigned int proto_rev() const = 0;
   virtual void set_proto_rev(unsigned int proto_rev) = 0;
 
@@ -7,7 +7,9 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include <wpi/span.h>
@@ -55,6 +57,18 @@ class IStorage {
   virtual const char* LoadPersistent(
       std::string_view filename,
       std::function<void(size_t line, const char* msg)> warn) = 0;
+
+  // Journaled persistence.  StartPersistentJournal() gets all persistent
+  // entries and starts tracking changes to them; GetPersistentChanges() then
+  // gets the entries changed since the previous call (with a null value for
+  // entries that were deleted or are no longer persistent).
+  virtual void StartPersistentJournal(
+      std::vector<std::pair<std::string, std::shared_ptr<Value>>>*
+          entries) = 0;
+  virtual bool GetPersistentChanges(
+      std::vector<std::pair<std::string, std::shared_ptr<Value>>>*
+          changes) = 0;
+  virtual void StopPersistentJournal() = 0;
 };
 
 }  // namespace nt
@@ -6,6 +6,16 @@
 
 #include <stdint.h>
 
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <wpi/MathExtras.h>
+#include <wpi/SmallVector.h>
+#include <wpi/leb128.h>
+#include <wpi/mutex.h>
+
+#include "ArrayDeltaBase.h"
 #include "Log.h"
 #include "WireDecoder.h"
 #include "WireEncoder.h"
@@ -14,14 +24,315 @@
 
 using namespace nt;
 
+namespace {
+
+// Free list of fixed-size blocks.  At most kMaxFree blocks are retained;
+// beyond that, blocks are returned to the heap.
+template <size_t Size>
+class MessageFreeList {
+ public:
+  static MessageFreeList& GetInstance() {
+    // intentionally leaked, as messages may be freed during static destruction
+    static auto* inst = new MessageFreeList;
+    return *inst;
+  }
+
+  void* Allocate() {
+    {
+      std::scoped_lock lock(m_mutex);
+      if (!m_free.empty()) {
+        void* p = m_free.back();
+        m_free.pop_back();
+        return p;
+      }
+    }
+    return ::operator new(Size);
+  }
+
+  void Deallocate(void* p) {
+    {
+      std::scoped_lock lock(m_mutex);
+      if (m_free.size() < kMaxFree) {
+        m_free.push_back(p);
+        return;
+      }
+    }
+    ::operator delete(p);
+  }
+
+ private:
+  static constexpr size_t kMaxFree = 4096;
+
+  MessageFreeList() { m_free.reserve(kMaxFree); }
+
+  wpi::mutex m_mutex;
+  std::vector<void*> m_free;
+};
+
+// Allocator for std::allocate_shared that keeps freed messages (including
+// the shared_ptr control block) for reuse.
+template <typename T>
+struct MessageAllocator {
+  using value_type = T;
+
+  MessageAllocator() = default;
+  template <typename U>
+  MessageAllocator(const MessageAllocator<U>&) {}  // NOLINT
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(
+        MessageFreeList<sizeof(T)>::GetInstance().Allocate());
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      ::operator delete(p);
+      return;
+    }
+    MessageFreeList<sizeof(T)>::GetInstance().Deallocate(p);
+  }
+
+  template <typename U>
+  bool operator==(const MessageAllocator<U>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const MessageAllocator<U>&) const {
+    return false;
+  }
+};
+
+// Double array delta modes
+constexpr unsigned int kDeltaRaw = 0;        // changed elements as doubles
+constexpr unsigned int kDeltaQuantized = 1;  // changes in multiples of quantum
+
+// Gets the number of multiples of quantum nearest to x.  Returns false if
+// that is not representable in a delta.
+bool Quantize(double x, double quantum, int64_t* k) {
+  double q = x / quantum;
+  if (!std::isfinite(q) || std::abs(q) > (1 << 30)) {
+    return false;
+  }
+  *k = std::llround(q);
+  return true;
+}
+
+uint64_t ZigZag(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t UnZigZag(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+// Writes an entry update as an element-wise delta against the last value
+// sent for the entry.  Writes nothing and returns false if a full update
+// should be sent instead (no base, different size, or the delta would not
+// be smaller).
+bool WriteArrayDelta(WireEncoder& encoder, unsigned int id,
+                     unsigned int seq_num, const std::shared_ptr<Value>& value,
+                     double quantum) {
+  ArrayDeltaBase* delta_base = encoder.delta_base();
+  const Value* base = delta_base->Get(id);
+  if (!base || base->type() != value->type()) {
+    return false;
+  }
+
+  // changed element indices, and their zigzag multiples of quantum if
+  // quantized
+  wpi::SmallVector<std::pair<uint32_t, uint64_t>, 16> changes;
+  size_t size = 1 + 2 + 2 + 1;  // message type, id, seq num, value type
+  std::shared_ptr<Value> sent = value;
+  switch (value->type()) {
+    case NT_BOOLEAN_ARRAY: {
+      auto b = base->GetBooleanArray();
+      auto v = value->GetBooleanArray();
+      if (b.size() != v.size()) {
+        return false;
+      }
+      for (uint32_t i = 0; i < v.size(); ++i) {
+        if ((b[i] != 0) != (v[i] != 0)) {
+          changes.emplace_back(i, 0);
+          size += wpi::SizeUleb128(i);
+        }
+      }
+      break;
+    }
+    case NT_DOUBLE_ARRAY: {
+      auto b = base->GetDoubleArray();
+      auto v = value->GetDoubleArray();
+      if (b.size() != v.size()) {
+        return false;
+      }
+      size += 1;  // mode
+      if (quantum > 0) {
+        size += 8;
+        // the receiver will have the quantized values, so they become the
+        // base for the next delta
+        std::vector<double> q(b.begin(), b.end());
+        for (uint32_t i = 0; i < v.size(); ++i) {
+          int64_t kb, kv;
+          if (!Quantize(b[i], quantum, &kb) || !Quantize(v[i], quantum, &kv)) {
+            return false;
+          }
+          if (kv != kb) {
+            // kv - kb can take 32 bits, so its zigzag can take 33
+            uint64_t zz = ZigZag(kv - kb);
+            changes.emplace_back(i, zz);
+            size += wpi::SizeUleb128(i) + wpi::SizeUleb128(zz);
+            q[i] = kv * quantum;
+          }
+        }
+        sent = Value::MakeDoubleArray(std::move(q), value->time());
+      } else {
+        for (uint32_t i = 0; i < v.size(); ++i) {
+          if (wpi::DoubleToBits(b[i]) != wpi::DoubleToBits(v[i])) {
+            changes.emplace_back(i, 0);
+            size += wpi::SizeUleb128(i) + 8;
+          }
+        }
+      }
+      break;
+    }
+    default:
+      return false;
+  }
+  size += wpi::SizeUleb128(changes.size());
+  if (size >= 1 + 2 + 2 + 1 + encoder.GetValueSize(*value)) {
+    return false;
+  }
+
+  encoder.Write8(Message::kEntryDeltaUpdate);
+  encoder.Write16(id);
+  encoder.Write16(seq_num);
+  encoder.WriteType(value->type());
+  if (value->type() == NT_DOUBLE_ARRAY) {
+    encoder.Write8(quantum > 0 ? kDeltaQuantized : kDeltaRaw);
+    if (quantum > 0) {
+      encoder.WriteDouble(quantum);
+    }
+  }
+  encoder.WriteUleb128(changes.size());
+  for (auto&& [i, zz] : changes) {
+    encoder.WriteUleb128(i);
+    if (value->type() == NT_DOUBLE_ARRAY) {
+      if (quantum > 0) {
+        encoder.WriteUleb128(zz);
+      } else {
+        encoder.WriteDouble(value->GetDoubleArray()[i]);
+      }
+    }
+  }
+  delta_base->Set(id, std::move(sent));
+  return true;
+}
+
+// Reads the body of a delta-encoded array update and applies it to the last
+// value received for the entry.
+std::shared_ptr<Value> ReadArrayDelta(WireDecoder& decoder, unsigned int id,
+                                      NT_Type type) {
+  const Value* base =
+      decoder.delta_base() ? decoder.delta_base()->Get(id) : nullptr;
+  if (!base || base->type() != type) {
+    decoder.set_error("received ENTRY_DELTA_UPDATE without a matching base");
+    return nullptr;
+  }
+  unsigned int mode = kDeltaRaw;
+  double quantum = 0;
+  if (type == NT_DOUBLE_ARRAY) {
+    if (!decoder.Read8(&mode)) {
+      return nullptr;
+    }
+    if (mode == kDeltaQuantized) {
+      if (!decoder.ReadDouble(&quantum)) {
+        return nullptr;
+      }
+      if (!std::isfinite(quantum) || quantum <= 0) {
+        decoder.set_error("invalid ENTRY_DELTA_UPDATE quantum");
+        return nullptr;
+      }
+    } else if (mode != kDeltaRaw) {
+      decoder.set_error("unrecognized ENTRY_DELTA_UPDATE mode");
+      return nullptr;
+    }
+  }
+  uint64_t count;
+  if (!decoder.ReadUleb128(&count)) {
+    return nullptr;
+  }
+
+  switch (type) {
+    case NT_BOOLEAN_ARRAY: {
+      auto b = base->GetBooleanArray();
+      std::vector<int> v(b.begin(), b.end());
+      for (uint64_t n = 0; n < count; ++n) {
+        uint64_t i;
+        if (!decoder.ReadUleb128(&i)) {
+          return nullptr;
+        }
+        if (i >= v.size()) {
+          decoder.set_error("ENTRY_DELTA_UPDATE index out of range");
+          return nullptr;
+        }
+        v[i] = !v[i];
+      }
+      return Value::MakeBooleanArray(std::move(v));
+    }
+    case NT_DOUBLE_ARRAY: {
+      auto b = base->GetDoubleArray();
+      std::vector<double> v(b.begin(), b.end());
+      for (uint64_t n = 0; n < count; ++n) {
+        uint64_t i;
+        if (!decoder.ReadUleb128(&i)) {
+          return nullptr;
+        }
+        if (i >= v.size()) {
+          decoder.set_error("ENTRY_DELTA_UPDATE index out of range");
+          return nullptr;
+        }
+        if (mode == kDeltaQuantized) {
+          uint64_t zz;
+          if (!decoder.ReadUleb128(&zz)) {
+            return nullptr;
+          }
+          v[i] = (std::llround(b[i] / quantum) + UnZigZag(zz)) * quantum;
+        } else if (!decoder.ReadDouble(&v[i])) {
+          return nullptr;
+        }
+      }
+      return Value::MakeDoubleArray(std::move(v));
+    }
+    default:
+      decoder.set_error("received ENTRY_DELTA_UPDATE of non-array type");
+      return nullptr;
+  }
+}
+
+// Records a value sent or received as the delta base for an entry.
+void SetDeltaBase(ArrayDeltaBase* delta_base, unsigned int proto_rev,
+                  unsigned int id, std::shared_ptr<Value> value) {
+  if (delta_base && proto_rev >= 0x0301u) {
+    delta_base->Set(id, std::move(value));
+  }
+}
+
+}  // namespace
+
+std::shared_ptr<Message> Message::Create(MsgType type) {
+  return std::allocate_shared<Message>(MessageAllocator<Message>(), type,
+                                       private_init());
+}
+
 std::shared_ptr<Message> Message::Read(WireDecoder& decoder,
                                        GetEntryTypeFunc get_entry_type) {
   unsigned int msg_type = 0;
   if (!decoder.Read8(&msg_type)) {
     return nullptr;
   }
-  auto msg =
-      std::make_shared<Message>(static_cast<MsgType>(msg_type), private_init());
+  auto msg = Create(static_cast<MsgType>(msg_type));
   switch (msg_type) {
     case kKeepAlive:
       break;
@@ -89,6 +400,8 @@ std::shared_ptr<Message> Message::Read(WireDecoder& decoder,
       if (!msg->m_value) {
         return nullptr;
       }
+      SetDeltaBase(decoder.delta_base(), decoder.proto_rev(), msg->m_id,
+                   msg->m_value);
       break;
     }
     case kEntryUpdate: {
@@ -111,6 +424,33 @@ std::shared_ptr<Message> Message::Read(WireDecoder& decoder,
       if (!msg->m_value) {
         return nullptr;
       }
+      SetDeltaBase(decoder.delta_base(), decoder.proto_rev(), msg->m_id,
+                   msg->m_value);
+      break;
+    }
+    case kEntryDeltaUpdate: {
+      if (decoder.proto_rev() < 0x0301u) {
+        decoder.set_error("received ENTRY_DELTA_UPDATE in protocol < 3.1");
+        return nullptr;
+      }
+      if (!decoder.Read16(&msg->m_id)) {
+        return nullptr;  // id
+      }
+      if (!decoder.Read16(&msg->m_seq_num_uid)) {
+        return nullptr;  // seq num
+      }
+      NT_Type type;
+      if (!decoder.ReadType(&type)) {
+        return nullptr;
+      }
+      msg->m_value = ReadArrayDelta(decoder, msg->m_id, type);
+      if (!msg->m_value) {
+        return nullptr;
+      }
+      // from here on this is a normal update
+      msg->m_type = kEntryUpdate;
+      SetDeltaBase(decoder.delta_base(), decoder.proto_rev(), msg->m_id,
+                   msg->m_value);
       break;
     }
     case kFlagsUpdate: {
@@ -205,14 +545,14 @@ std::shared_ptr<Message> Message::Read(WireDecoder& decoder,
 }
 
 std::shared_ptr<Message> Message::ClientHello(std::string_view self_id) {
-  auto msg = std::make_shared<Message>(kClientHello, private_init());
+  auto msg = Create(kClientHello);
   msg->m_str = self_id;
   return msg;
 }
 
 std::shared_ptr<Message> Message::ServerHello(unsigned int flags,
                                               std::string_view self_id) {
-  auto msg = std::make_shared<Message>(kServerHello, private_init());
+  auto msg = Create(kServerHello);
   msg->m_str = self_id;
   msg->m_flags = flags;
   return msg;
@@ -223,7 +563,7 @@ std::shared_ptr<Message> Message::EntryAssign(std::string_view name,
                                               unsigned int seq_num,
                                               std::shared_ptr<Value> value,
                                               unsigned int flags) {
-  auto msg = std::make_shared<Message>(kEntryAssign, private_init());
+  auto msg = Create(kEntryAssign);
   msg->m_str = name;
   msg->m_value = value;
   msg->m_id = id;
@@ -234,31 +574,33 @@ std::shared_ptr<Message> Message::EntryAssign(std::string_view name,
 
 std::shared_ptr<Message> Message::EntryUpdate(unsigned int id,
                                               unsigned int seq_num,
-                                              std::shared_ptr<Value> value) {
-  auto msg = std::make_shared<Message>(kEntryUpdate, private_init());
+                                              std::shared_ptr<Value> value,
+                                              double quantum) {
+  auto msg = Create(kEntryUpdate);
   msg->m_value = value;
   msg->m_id = id;
   msg->m_seq_num_uid = seq_num;
+  msg->m_quantum = quantum;
   return msg;
 }
 
 std::shared_ptr<Message> Message::FlagsUpdate(unsigned int id,
                                               unsigned int flags) {
-  auto msg = std::make_shared<Message>(kFlagsUpdate, private_init());
+  auto msg = Create(kFlagsUpdate);
   msg->m_id = id;
   msg->m_flags = flags;
   return msg;
 }
 
 std::shared_ptr<Message> Message::EntryDelete(unsigned int id) {
-  auto msg = std::make_shared<Message>(kEntryDelete, private_init());
+  auto msg = Create(kEntryDelete);
   msg->m_id = id;
   return msg;
 }
 
 std::shared_ptr<Message> Message::ExecuteRpc(unsigned int id, unsigned int uid,
                                              std::string_view params) {
-  auto msg = std::make_shared<Message>(kExecuteRpc, private_init());
+  auto msg = Create(kExecuteRpc);
   msg->m_str = params;
   msg->m_id = id;
   msg->m_seq_num_uid = uid;
@@ -267,7 +609,7 @@ std::shared_ptr<Message> Message::ExecuteRpc(unsigned int id, unsigned int uid,
 
 std::shared_ptr<Message> Message::RpcResponse(unsigned int id, unsigned int uid,
                                               std::string_view result) {
-  auto msg = std::make_shared<Message>(kRpcResponse, private_init());
+  auto msg = Create(kRpcResponse);
   msg->m_str = result;
   msg->m_id = id;
   msg->m_seq_num_uid = uid;
@@ -318,8 +660,13 @@ void Message::Write(WireEncoder& encoder) const {
         encoder.Write8(m_flags);
       }
       encoder.WriteValue(*m_value);
+      SetDeltaBase(encoder.delta_base(), encoder.proto_rev(), m_id, m_value);
       break;
     case kEntryUpdate:
+      if (encoder.proto_rev() >= 0x0301u && encoder.delta_base() &&
+          WriteArrayDelta(encoder, m_id, m_seq_num_uid, m_value, m_quantum)) {
+        break;
+      }
       encoder.Write8(kEntryUpdate);
       encoder.Write16(m_id);
       encoder.Write16(m_seq_num_uid);
@@ -327,6 +674,7 @@ void Message::Write(WireEncoder& encoder) const {
         encoder.WriteType(m_value->type());
       }
       encoder.WriteValue(*m_value);
+      SetDeltaBase(encoder.delta_base(), encoder.proto_rev(), m_id, m_value);
       break;
     case kFlagsUpdate:
       if (encoder.proto_rev() < 0x0300u) {
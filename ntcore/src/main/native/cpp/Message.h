@@ -34,6 +34,8 @@ class Message {
     kFlagsUpdate = 0x12,
     kEntryDelete = 0x13,
     kClearEntries = 0x14,
+    // Protocol 3.1 delta-encoded array update; decoded as kEntryUpdate
+    kEntryDeltaUpdate = 0x15,
     kExecuteRpc = 0x20,
     kRpcResponse = 0x21
   };
@@ -52,6 +54,7 @@ class Message {
   unsigned int id() const { return m_id; }
   unsigned int flags() const { return m_flags; }
   unsigned int seq_num_uid() const { return m_seq_num_uid; }
+  double quantum() const { return m_quantum; }
 
   // Read and write from wire representation
   void Write(WireEncoder& encoder) const;
@@ -60,19 +63,19 @@ class Message {
 
   // Create messages without data
   static std::shared_ptr<Message> KeepAlive() {
-    return std::make_shared<Message>(kKeepAlive, private_init());
+    return Create(kKeepAlive);
   }
   static std::shared_ptr<Message> ProtoUnsup() {
-    return std::make_shared<Message>(kProtoUnsup, private_init());
+    return Create(kProtoUnsup);
   }
   static std::shared_ptr<Message> ServerHelloDone() {
-    return std::make_shared<Message>(kServerHelloDone, private_init());
+    return Create(kServerHelloDone);
   }
   static std::shared_ptr<Message> ClientHelloDone() {
-    return std::make_shared<Message>(kClientHelloDone, private_init());
+    return Create(kClientHelloDone);
   }
   static std::shared_ptr<Message> ClearEntries() {
-    return std::make_shared<Message>(kClearEntries, private_init());
+    return Create(kClearEntries);
   }
 
   // Create messages with data
@@ -84,9 +87,12 @@ class Message {
                                               unsigned int seq_num,
                                               std::shared_ptr<Value> value,
                                               unsigned int flags);
+  // If quantum is nonzero, delta-encoded double array updates are rounded
+  // to multiples of it.
   static std::shared_ptr<Message> EntryUpdate(unsigned int id,
                                               unsigned int seq_num,
-                                              std::shared_ptr<Value> value);
+                                              std::shared_ptr<Value> value,
+                                              double quantum = 0);
   static std::shared_ptr<Message> FlagsUpdate(unsigned int id,
                                               unsigned int flags);
   static std::shared_ptr<Message> EntryDelete(unsigned int id);
@@ -99,6 +105,10 @@ class Message {
   Message& operator=(const Message&) = delete;
 
  private:
+  // Allocates a message from a recycled pool, so that steady-state messaging
+  // does not allocate.
+  static std::shared_ptr<Message> Create(MsgType type);
+
   MsgType m_type{kUnknown};
 
   // Message data.  Use varies by message type.
@@ -107,6 +117,7 @@ class Message {
   unsigned int m_id{0};  // also used for proto_rev
   unsigned int m_flags{0};
   unsigned int m_seq_num_uid{0};
+  double m_quantum{0};
 };
 
 }  // namespace nt
@@ -10,6 +10,7 @@
 #include <wpi/raw_socket_istream.h>
 #include <wpi/timestamp.h>
 
+#include "ArrayDeltaBase.h"
 #include "IConnectionNotifier.h"
 #include "Log.h"
 #include "WireDecoder.h"
@@ -38,6 +39,27 @@ NetworkConnection::NetworkConnection(unsigned int uid,
   m_stream->setNoDelay();
 }
 
+bool NetworkConnection::OutgoingQueue::empty() const {
+  std::scoped_lock lock(m_mutex);
+  return m_queue.empty();
+}
+
+void NetworkConnection::OutgoingQueue::push(Outgoing&& msgs) {
+  {
+    std::scoped_lock lock(m_mutex);
+    m_queue.emplace_back(std::move(msgs));
+  }
+  m_cond.notify_one();
+}
+
+NetworkConnection::Outgoing NetworkConnection::OutgoingQueue::pop() {
+  std::unique_lock lock(m_mutex);
+  m_cond.wait(lock, [&] { return !m_queue.empty(); });
+  Outgoing msgs = std::move(m_queue.front());
+  m_queue.erase(m_queue.begin());
+  return msgs;
+}
+
 NetworkConnection::~NetworkConnection() {
   Stop();
 }
@@ -108,6 +130,16 @@ ConnectionInfo NetworkConnection::info() const {
                         m_last_update, m_proto_rev};
 }
 
+ConnectionStats NetworkConnection::stats() const {
+  ConnectionStats stats;
+  stats.info = info();
+  m_metrics.GetStats(&stats);
+  std::scoped_lock lock(m_pending_mutex);
+  stats.messages_coalesced = m_pending.coalesced();
+  stats.queue_high_water = m_pending.high_water();
+  return stats;
+}
+
 unsigned int NetworkConnection::proto_rev() const {
   return m_proto_rev;
 }
@@ -150,6 +182,9 @@ void NetworkConnection::set_remote_id(std::string_view remote_id) {
 void NetworkConnection::ReadThreadMain() {
   wpi::raw_socket_istream is(*m_stream);
   WireDecoder decoder(is, m_proto_rev, m_logger);
+  ArrayDeltaBase delta_base;
+  decoder.set_delta_base(&delta_base);
+  uint64_t bytes_read = 0;
 
   set_state(kHandshake);
   if (!m_handshake(
@@ -160,11 +195,14 @@ void NetworkConnection::ReadThreadMain() {
             if (!msg && decoder.error()) {
               DEBUG0("error reading in handshake: {}", decoder.error());
             }
+            if (msg) {
+              m_metrics.RecordReceived(decoder.bytes_read() - bytes_read, 1);
+              bytes_read = decoder.bytes_read();
+            }
             return msg;
           },
           [&](auto msgs) {
-            m_outgoing.emplace(std::vector<std::shared_ptr<Message>>(
-                msgs.begin(), msgs.end()));
+            m_outgoing.push(Outgoing(msgs.begin(), msgs.end()));
           })) {
     set_state(kDead);
     m_active = false;
@@ -189,6 +227,8 @@ void NetworkConnection::ReadThreadMain() {
       }
       break;
     }
+    m_metrics.RecordReceived(decoder.bytes_read() - bytes_read, 1);
+    bytes_read = decoder.bytes_read();
     DEBUG3("received type={} with str={} id={} seq_num={}", msg->type(),
            msg->str(), msg->id(), msg->seq_num_uid());
     m_last_update = Now();
@@ -210,6 +250,8 @@ done:
 
 void NetworkConnection::WriteThreadMain() {
   WireEncoder encoder(m_proto_rev);
+  ArrayDeltaBase delta_base;
+  encoder.set_delta_base(&delta_base);
 
   while (m_active) {
     auto msgs = m_outgoing.pop();
@@ -220,11 +262,13 @@ void NetworkConnection::WriteThreadMain() {
     encoder.set_proto_rev(m_proto_rev);
     encoder.Reset();
     DEBUG3("sending {} messages", msgs.size());
+    size_t count = 0;
     for (auto& msg : msgs) {
       if (msg) {
         DEBUG3("sending type={} with str={} id={} seq_num={}", msg->type(),
                msg->str(), msg->id(), msg->seq_num_uid());
         msg->Write(encoder);
+        ++count;
       }
     }
     wpi::NetworkStream::Error err;
@@ -234,10 +278,18 @@ void NetworkConnection::WriteThreadMain() {
     if (encoder.size() == 0) {
       continue;
     }
+    auto start = wpi::Now();
     if (m_stream->send(encoder.data(), encoder.size(), &err) == 0) {
       break;
     }
+    m_metrics.RecordWrite(wpi::Now() - start);
+    m_metrics.RecordSent(encoder.size(), count);
     DEBUG4("sent {} bytes", encoder.size());
+
+    // release the messages outside the lock, then reuse the storage
+    msgs.clear();
+    std::scoped_lock lock(m_pending_mutex);
+    m_pending.Recycle(std::move(msgs));
   }
   DEBUG2("write thread died ({})", fmt::ptr(this));
   set_state(kDead);
@@ -256,123 +308,28 @@ void NetworkConnection::WriteThreadMain() {
 
 void NetworkConnection::QueueOutgoing(std::shared_ptr<Message> msg) {
   std::scoped_lock lock(m_pending_mutex);
-
-  // Merge with previous.  One case we don't combine: delete/assign loop.
-  switch (msg->type()) {
-    case Message::kEntryAssign:
-    case Message::kEntryUpdate: {
-      // don't do this for unassigned id's
-      unsigned int id = msg->id();
-      if (id == 0xffff) {
-        m_pending_outgoing.push_back(msg);
-        break;
-      }
-      if (id < m_pending_update.size() && m_pending_update[id].first != 0) {
-        // overwrite the previous one for this id
-        auto& oldmsg = m_pending_outgoing[m_pending_update[id].first - 1];
-        if (oldmsg && oldmsg->Is(Message::kEntryAssign) &&
-            msg->Is(Message::kEntryUpdate)) {
-          // need to update assignment with new seq_num and value
-          oldmsg = Message::EntryAssign(oldmsg->str(), id, msg->seq_num_uid(),
-                                        msg->value(), oldmsg->flags());
-        } else {
-          oldmsg = msg;  // easy update
-        }
-      } else {
-        // new, but remember it
-        size_t pos = m_pending_outgoing.size();
-        m_pending_outgoing.push_back(msg);
-        if (id >= m_pending_update.size()) {
-          m_pending_update.resize(id + 1);
-        }
-        m_pending_update[id].first = pos + 1;
-      }
-      break;
-    }
-    case Message::kEntryDelete: {
-      // don't do this for unassigned id's
-      unsigned int id = msg->id();
-      if (id == 0xffff) {
-        m_pending_outgoing.push_back(msg);
-        break;
-      }
-
-      // clear previous updates
-      if (id < m_pending_update.size()) {
-        if (m_pending_update[id].first != 0) {
-          m_pending_outgoing[m_pending_update[id].first - 1].reset();
-          m_pending_update[id].first = 0;
-        }
-        if (m_pending_update[id].second != 0) {
-          m_pending_outgoing[m_pending_update[id].second - 1].reset();
-          m_pending_update[id].second = 0;
-        }
-      }
-
-      // add deletion
-      m_pending_outgoing.push_back(msg);
-      break;
-    }
-    case Message::kFlagsUpdate: {
-      // don't do this for unassigned id's
-      unsigned int id = msg->id();
-      if (id == 0xffff) {
-        m_pending_outgoing.push_back(msg);
-        break;
-      }
-      if (id < m_pending_update.size() && m_pending_update[id].second != 0) {
-        // overwrite the previous one for this id
-        m_pending_outgoing[m_pending_update[id].second - 1] = msg;
-      } else {
-        // new, but remember it
-        size_t pos = m_pending_outgoing.size();
-        m_pending_outgoing.push_back(msg);
-        if (id >= m_pending_update.size()) {
-          m_pending_update.resize(id + 1);
-        }
-        m_pending_update[id].second = pos + 1;
-      }
-      break;
-    }
-    case Message::kClearEntries: {
-      // knock out all previous assigns/updates!
-      for (auto& i : m_pending_outgoing) {
-        if (!i) {
-          continue;
-        }
-        auto t = i->type();
-        if (t == Message::kEntryAssign || t == Message::kEntryUpdate ||
-            t == Message::kFlagsUpdate || t == Message::kEntryDelete ||
-            t == Message::kClearEntries) {
-          i.reset();
-        }
-      }
-      m_pending_update.resize(0);
-      m_pending_outgoing.push_back(msg);
-      break;
-    }
-    default:
-      m_pending_outgoing.push_back(msg);
-      break;
-  }
+  m_pending.Queue(std::move(msg));
 }
 
 void NetworkConnection::PostOutgoing(bool keep_alive) {
+  auto start = wpi::Now();
   std::scoped_lock lock(m_pending_mutex);
-  auto now = std::chrono::steady_clock::now();
-  if (m_pending_outgoing.empty()) {
-    if (!keep_alive) {
-      return;
-    }
-    // send keep-alives once a second (if no other messages have been sent)
-    if ((now - m_last_post) < std::chrono::seconds(1)) {
-      return;
-    }
-    m_outgoing.emplace(Outgoing{Message::KeepAlive()});
-  } else {
-    m_outgoing.emplace(std::move(m_pending_outgoing));
-    m_pending_outgoing.resize(0);
-    m_pending_update.resize(0);
+  auto msgs = m_pending.Post(keep_alive);
+  if (!msgs.empty()) {
+    m_outgoing.push(std::move(msgs));
+    m_metrics.RecordPost(wpi::Now() - start);
   }
-  m_last_post = now;
-}  // NOLINT
+}
+
+std::chrono::steady_clock::time_point NetworkConnection::ArmPostDeadline(
+    std::chrono::steady_clock::time_point now,
+    std::chrono::microseconds min_interval) {
+  std::scoped_lock lock(m_pending_mutex);
+  return m_pending.ArmDeadline(now, min_interval);
+}
+
+std::chrono::steady_clock::time_point NetworkConnection::post_deadline()
+    const {
+  std::scoped_lock lock(m_pending_mutex);
+  return m_pending.deadline();
+}
@@ -16,13 +16,14 @@
 #include <utility>
 #include <vector>
 
-#include <wpi/ConcurrentQueue.h>
 #include <wpi/condition_variable.h>
 #include <wpi/mutex.h>
 #include <wpi/span.h>
 
+#include "ConnectionMetrics.h"
 #include "INetworkConnection.h"
 #include "Message.h"
+#include "PendingOutgoing.h"
 #include "ntcore_cpp.h"
 
 namespace wpi {
@@ -43,7 +44,21 @@ class NetworkConnection : public INetworkConnection {
   using ProcessIncomingFunc =
       std::function<void(std::shared_ptr<Message>, NetworkConnection*)>;
   using Outgoing = std::vector<std::shared_ptr<Message>>;
-  using OutgoingQueue = wpi::ConcurrentQueue<Outgoing>;
+
+  // Batches posted for the write thread.  Unlike wpi::ConcurrentQueue, whose
+  // std::deque allocates as batches cycle through it, the storage is reused.
+  class OutgoingQueue {
+   public:
+    bool empty() const;
+    void push(Outgoing&& msgs);
+    // Blocks until a batch is available.
+    Outgoing pop();
+
+   private:
+    mutable wpi::mutex m_mutex;
+    wpi::condition_variable m_cond;
+    std::vector<Outgoing> m_queue;
+  };
 
   NetworkConnection(unsigned int uid,
                     std::unique_ptr<wpi::NetworkStream> stream,
@@ -61,12 +76,17 @@ class NetworkConnection : public INetworkConnection {
   void Stop();
 
   ConnectionInfo info() const final;
+  ConnectionStats stats() const final;
 
   bool active() const { return m_active; }
   wpi::NetworkStream& stream() { return *m_stream; }
 
   void QueueOutgoing(std::shared_ptr<Message> msg) final;
   void PostOutgoing(bool keep_alive) override;
+  std::chrono::steady_clock::time_point ArmPostDeadline(
+      std::chrono::steady_clock::time_point now,
+      std::chrono::microseconds min_interval) final;
+  std::chrono::steady_clock::time_point post_deadline() const final;
 
   unsigned int uid() const { return m_uid; }
 
@@ -105,11 +125,11 @@ class NetworkConnection : public INetworkConnection {
   mutable wpi::mutex m_remote_id_mutex;
   std::string m_remote_id;
   std::atomic_ullong m_last_update;
-  std::chrono::steady_clock::time_point m_last_post;
 
-  wpi::mutex m_pending_mutex;
-  Outgoing m_pending_outgoing;
-  std::vector<std::pair<size_t, size_t>> m_pending_update;
+  ConnectionMetrics m_metrics;
+
+  mutable wpi::mutex m_pending_mutex;
+  PendingOutgoing m_pending;
 
   // Condition variables for shutdown
   wpi::mutex m_shutdown_mutex;
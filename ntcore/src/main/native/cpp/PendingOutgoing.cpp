@@ -0,0 +1,173 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "PendingOutgoing.h"
+
+#include <algorithm>
+
+using namespace nt;
+
+PendingOutgoing::PendingOutgoing() {
+  m_outgoing.reserve(kInitialCapacity);
+  m_spares.resize(kMaxSpares);
+  for (auto& spare : m_spares) {
+    spare.reserve(kInitialCapacity);
+  }
+}
+
+void PendingOutgoing::Queue(std::shared_ptr<Message> msg) {
+  // Merge with previous.  One case we don't combine: delete/assign loop.
+  switch (msg->type()) {
+    case Message::kEntryAssign:
+    case Message::kEntryUpdate: {
+      // don't do this for unassigned id's
+      unsigned int id = msg->id();
+      if (id == 0xffff) {
+        m_outgoing.push_back(msg);
+        break;
+      }
+      if (id < m_update.size() && m_update[id].first != 0) {
+        // overwrite the previous one for this id
+        ++m_coalesced;
+        auto& oldmsg = m_outgoing[m_update[id].first - 1];
+        if (oldmsg && oldmsg->Is(Message::kEntryAssign) &&
+            msg->Is(Message::kEntryUpdate)) {
+          // need to update assignment with new seq_num and value
+          oldmsg = Message::EntryAssign(oldmsg->str(), id, msg->seq_num_uid(),
+                                        msg->value(), oldmsg->flags());
+        } else {
+          oldmsg = msg;  // easy update
+        }
+      } else {
+        // new, but remember it
+        size_t pos = m_outgoing.size();
+        m_outgoing.push_back(msg);
+        if (id >= m_update.size()) {
+          m_update.resize(id + 1);
+        }
+        m_update[id].first = pos + 1;
+      }
+      break;
+    }
+    case Message::kEntryDelete: {
+      // don't do this for unassigned id's
+      unsigned int id = msg->id();
+      if (id == 0xffff) {
+        m_outgoing.push_back(msg);
+        break;
+      }
+
+      // clear previous updates
+      if (id < m_update.size()) {
+        if (m_update[id].first != 0) {
+          ++m_coalesced;
+          m_outgoing[m_update[id].first - 1].reset();
+          m_update[id].first = 0;
+        }
+        if (m_update[id].second != 0) {
+          ++m_coalesced;
+          m_outgoing[m_update[id].second - 1].reset();
+          m_update[id].second = 0;
+        }
+      }
+
+      // add deletion
+      m_outgoing.push_back(msg);
+      break;
+    }
+    case Message::kFlagsUpdate: {
+      // don't do this for unassigned id's
+      unsigned int id = msg->id();
+      if (id == 0xffff) {
+        m_outgoing.push_back(msg);
+        break;
+      }
+      if (id < m_update.size() && m_update[id].second != 0) {
+        // overwrite the previous one for this id
+        ++m_coalesced;
+        m_outgoing[m_update[id].second - 1] = msg;
+      } else {
+        // new, but remember it
+        size_t pos = m_outgoing.size();
+        m_outgoing.push_back(msg);
+        if (id >= m_update.size()) {
+          m_update.resize(id + 1);
+        }
+        m_update[id].second = pos + 1;
+      }
+      break;
+    }
+    case Message::kClearEntries: {
+      // knock out all previous assigns/updates!
+      for (auto& i : m_outgoing) {
+        if (!i) {
+          continue;
+        }
+        auto t = i->type();
+        if (t == Message::kEntryAssign || t == Message::kEntryUpdate ||
+            t == Message::kFlagsUpdate || t == Message::kEntryDelete ||
+            t == Message::kClearEntries) {
+          ++m_coalesced;
+          i.reset();
+        }
+      }
+      m_update.resize(0);
+      m_outgoing.push_back(msg);
+      break;
+    }
+    default:
+      m_outgoing.push_back(msg);
+      break;
+  }
+  m_high_water = (std::max)(m_high_water, m_outgoing.size());
+}
+
+PendingOutgoing::Outgoing PendingOutgoing::Post(bool keep_alive) {
+  m_deadline = std::chrono::steady_clock::time_point::max();
+  auto now = std::chrono::steady_clock::now();
+  Outgoing msgs;
+  if (m_outgoing.empty()) {
+    if (!keep_alive) {
+      return msgs;
+    }
+    // send keep-alives once a second (if no other messages have been sent)
+    if ((now - m_last_post) < std::chrono::seconds(1)) {
+      return msgs;
+    }
+    msgs = TakeSpare();
+    msgs.emplace_back(Message::KeepAlive());
+  } else {
+    msgs.swap(m_outgoing);
+    m_outgoing = TakeSpare();
+    m_update.resize(0);
+  }
+  m_last_post = now;
+  return msgs;
+}
+
+void PendingOutgoing::Recycle(Outgoing&& msgs) {
+  msgs.clear();
+  if (msgs.capacity() != 0 && m_spares.size() < kMaxSpares) {
+    m_spares.emplace_back(std::move(msgs));
+  }
+}
+
+PendingOutgoing::Outgoing PendingOutgoing::TakeSpare() {
+  Outgoing msgs;
+  if (!m_spares.empty()) {
+    msgs.swap(m_spares.back());
+    m_spares.pop_back();
+  }
+  return msgs;
+}
+
+std::chrono::steady_clock::time_point PendingOutgoing::ArmDeadline(
+    std::chrono::steady_clock::time_point now,
+    std::chrono::microseconds min_interval) {
+  if (m_deadline == std::chrono::steady_clock::time_point::max()) {
+    // coalesce with anything else queued within min_interval of the last post
+    m_deadline = (std::max)(now, m_last_post + min_interval);
+  }
+  return m_deadline;
+}
@@ -0,0 +1,76 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef NTCORE_PENDINGOUTGOING_H_
+#define NTCORE_PENDINGOUTGOING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Message.h"
+
+namespace nt {
+
+/* Outgoing messages queued on a connection but not yet posted for
+ * transmission.  Messages for the same entry id are merged so only the latest
+ * value is sent.  Not thread-safe; the owning connection provides locking.
+ */
+class PendingOutgoing {
+ public:
+  using Outgoing = std::vector<std::shared_ptr<Message>>;
+
+  PendingOutgoing();
+
+  void Queue(std::shared_ptr<Message> msg);
+
+  // Takes the pending messages for transmission and disarms the post
+  // deadline.  If nothing is pending and keep_alive is set, a keep-alive is
+  // returned if nothing has been posted in the last second.  Returns an empty
+  // set if there is nothing to send.
+  Outgoing Post(bool keep_alive);
+
+  // Returns a set previously returned by Post() once it has been sent, so
+  // its storage can be reused by a later Post() instead of reallocated.
+  void Recycle(Outgoing&& msgs);
+
+  // Arms the post deadline no sooner than min_interval after the previous
+  // post.  If a deadline is already armed, it is left unchanged.
+  std::chrono::steady_clock::time_point ArmDeadline(
+      std::chrono::steady_clock::time_point now,
+      std::chrono::microseconds min_interval);
+  std::chrono::steady_clock::time_point deadline() const { return m_deadline; }
+
+  // Number of queued messages replaced or dropped by a later message for the
+  // same entry.
+  uint64_t coalesced() const { return m_coalesced; }
+
+  // Largest number of messages queued between posts.
+  size_t high_water() const { return m_high_water; }
+
+ private:
+  Outgoing TakeSpare();
+
+  // Enough for the batches usually in flight between Post() and Recycle();
+  // they're allocated up front so a slow Recycle() doesn't cost a regrow.
+  static constexpr size_t kMaxSpares = 4;
+  static constexpr size_t kInitialCapacity = 16;
+
+  Outgoing m_outgoing;
+  std::vector<Outgoing> m_spares;
+  std::vector<std::pair<size_t, size_t>> m_update;
+  std::chrono::steady_clock::time_point m_last_post;
+  std::chrono::steady_clock::time_point m_deadline =
+      std::chrono::steady_clock::time_point::max();
+  uint64_t m_coalesced = 0;
+  size_t m_high_water = 0;
+};
+
+}  // namespace nt
+
+#endif  // NTCORE_PENDINGOUTGOING_H_
@@ -0,0 +1,236 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "PersistentJournal.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+#include <fmt/format.h>
+#include <wpi/SmallString.h>
+#include <wpi/StringMap.h>
+#include <wpi/fs.h>
+#include <wpi/raw_ostream.h>
+#include <wpi/timestamp.h>
+
+#include "Storage.h"
+
+using namespace nt;
+
+// Don't compact a journal smaller than this, even if the file is smaller
+static constexpr uint64_t kMinCompactSize = 16384;
+
+class PersistentJournal::Thread : public wpi::SafeThread {
+ public:
+  Thread(PersistentJournal& journal, std::string_view filename,
+         std::vector<Entry> entries, wpi::Logger& logger);
+
+  void Main() override;
+
+  // changes waiting to be written (protected by m_mutex)
+  std::vector<Entry> m_pending;
+
+ private:
+  bool WriteJournal(wpi::span<const Entry> changes);
+  void Compact();
+
+  PersistentJournal& m_journal;
+  std::string m_filename;
+  std::string m_journal_filename;
+
+  // current persistent entries, as of the last changes written
+  wpi::StringMap<std::shared_ptr<Value>> m_entries;
+
+  uint64_t m_file_size = 0;
+  uint64_t m_journal_size = 0;
+  bool m_compact = false;
+
+  wpi::Logger& m_logger;
+};
+
+PersistentJournal::Thread::Thread(PersistentJournal& journal,
+                                  std::string_view filename,
+                                  std::vector<Entry> entries,
+                                  wpi::Logger& logger)
+    : m_journal(journal),
+      m_filename(filename),
+      m_journal_filename(fmt::format("{}.journal", filename)),
+      m_logger(logger) {
+  for (auto& entry : entries) {
+    m_entries[entry.first] = std::move(entry.second);
+  }
+
+  // append to any existing journal until the first compaction replaces it
+  std::error_code ec;
+  m_journal_size = fs::file_size(m_journal_filename, ec);
+  if (ec) {
+    m_journal_size = 0;
+  }
+}
+
+void PersistentJournal::Thread::Main() {
+  // rewrite the file when journaling starts, so the journal only holds
+  // changes made from here on
+  Compact();
+
+  std::vector<Entry> changes;
+  std::unique_lock lock(m_mutex);
+  for (;;) {
+    m_cond.wait(lock,
+                [&] { return !m_active || !m_pending.empty() || m_compact; });
+    bool active = m_active;
+    changes.swap(m_pending);
+    lock.unlock();
+
+    if (!changes.empty()) {
+      for (auto& change : changes) {
+        if (change.second) {
+          m_entries[change.first] = change.second;
+        } else {
+          m_entries.erase(change.first);
+        }
+      }
+      if (!WriteJournal(changes)) {
+        m_compact = true;  // a full write replaces the journal
+      }
+      changes.clear();
+    }
+
+    if (m_compact ||
+        m_journal_size > (std::max)(m_file_size, kMinCompactSize)) {
+      // on failure, retry on the next change (the journal is still valid)
+      Compact();
+      m_compact = false;
+    }
+
+    lock.lock();
+    if (!active && m_pending.empty()) {
+      break;
+    }
+  }
+}
+
+bool PersistentJournal::Thread::WriteJournal(wpi::span<const Entry> changes) {
+  auto start = wpi::Now();
+
+  wpi::SmallString<1024> buf;
+  wpi::raw_svector_ostream oss{buf};
+  Storage::SavePersistentJournal(oss, changes, m_journal_size == 0);
+
+  const char* err = nullptr;
+  {
+    std::error_code ec;
+    wpi::raw_fd_ostream os(m_journal_filename, ec, fs::F_Append | fs::F_Text);
+    if (ec.value() != 0) {
+      err = "could not open journal";
+    } else {
+      os << buf.str();
+      os.close();
+      if (os.has_error()) {
+        err = "error writing journal";
+      }
+    }
+  }
+  if (err) {
+    WARNING("persistent journal: {}", err);
+  } else {
+    m_journal_size += buf.size();
+  }
+
+  auto duration = wpi::Now() - start;
+  std::scoped_lock lock(m_journal.m_metrics_mutex);
+  auto& metrics = m_journal.m_metrics;
+  if (err) {
+    ++metrics.errors;
+  } else {
+    ++metrics.journal_writes;
+    metrics.journal_records += changes.size();
+    metrics.journal_size = m_journal_size;
+  }
+  metrics.last_journal_time = duration;
+  metrics.max_journal_time = (std::max)(metrics.max_journal_time, duration);
+  return err == nullptr;
+}
+
+void PersistentJournal::Thread::Compact() {
+  auto start = wpi::Now();
+
+  std::vector<Entry> entries;
+  entries.reserve(m_entries.size());
+  for (auto& i : m_entries) {
+    entries.emplace_back(i.getKey(), i.getValue());
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.first < b.first; });
+
+  const char* err = Storage::SavePersistentFile(m_filename, entries);
+  if (err) {
+    WARNING("persistent journal compaction: {}", err);
+  } else {
+    // the file now includes everything in the journal
+    std::remove(m_journal_filename.c_str());
+    m_journal_size = 0;
+    std::error_code ec;
+    m_file_size = fs::file_size(m_filename, ec);
+    if (ec) {
+      m_file_size = 0;
+    }
+  }
+
+  auto duration = wpi::Now() - start;
+  std::scoped_lock lock(m_journal.m_metrics_mutex);
+  auto& metrics = m_journal.m_metrics;
+  if (err) {
+    ++metrics.errors;
+  } else {
+    ++metrics.saves;
+    metrics.journal_size = 0;
+  }
+  metrics.last_save_time = duration;
+  metrics.max_save_time = (std::max)(metrics.max_save_time, duration);
+}
+
+void PersistentJournal::Start(std::string_view filename,
+                              std::vector<Entry> entries) {
+  m_owner.Start(*this, filename, std::move(entries), m_logger);
+}
+
+void PersistentJournal::Stop() {
+  // wait for queued changes to be written
+  m_owner.Join();
+}
+
+void PersistentJournal::Append(std::vector<Entry> changes) {
+  if (changes.empty()) {
+    return;
+  }
+  auto thr = m_owner.GetThread();
+  if (!thr) {
+    return;
+  }
+  if (thr->m_pending.empty()) {
+    thr->m_pending.swap(changes);
+  } else {
+    thr->m_pending.insert(thr->m_pending.end(),
+                          std::make_move_iterator(changes.begin()),
+                          std::make_move_iterator(changes.end()));
+  }
+  thr->m_cond.notify_one();
+}
+
+void PersistentJournal::RecordDispatch(uint64_t duration, bool error) {
+  std::scoped_lock lock(m_metrics_mutex);
+  if (error) {
+    ++m_metrics.errors;
+  }
+  m_metrics.last_dispatch_time = duration;
+  m_metrics.max_dispatch_time =
+      (std::max)(m_metrics.max_dispatch_time, duration);
+}
+
+PersistentSaveMetrics PersistentJournal::GetMetrics() const {
+  std::scoped_lock lock(m_metrics_mutex);
+  return m_metrics;
+}
@@ -0,0 +1,75 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef NTCORE_PERSISTENTJOURNAL_H_
+#define NTCORE_PERSISTENTJOURNAL_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <wpi/SafeThread.h>
+#include <wpi/mutex.h>
+
+#include "Log.h"
+#include "ntcore_cpp.h"
+
+namespace nt {
+
+/* Journaled persistent file writer.  Changed persistent entries are appended
+ * to "<filename>.journal" on a background thread, and the full file is only
+ * rewritten (compacting the journal) once the journal grows larger than the
+ * file.  Storage::LoadPersistent() replays the journal over the file.
+ *
+ * Append() only queues the changes, so callers (the dispatch thread) never
+ * wait on file I/O.
+ */
+class PersistentJournal {
+ public:
+  using Entry = std::pair<std::string, std::shared_ptr<Value>>;
+
+  explicit PersistentJournal(wpi::Logger& logger) : m_logger(logger) {}
+  ~PersistentJournal() { Stop(); }
+
+  PersistentJournal(const PersistentJournal&) = delete;
+  PersistentJournal& operator=(const PersistentJournal&) = delete;
+
+  /* Starts journaling to filename.  entries must be all current persistent
+   * entries; the file is immediately rewritten from them (in the background)
+   * and any previous journal is discarded.
+   */
+  void Start(std::string_view filename, std::vector<Entry> entries);
+
+  /* Writes any queued changes and stops the background thread. */
+  void Stop();
+
+  bool IsRunning() const { return static_cast<bool>(m_owner); }
+
+  /* Queues changes (from Storage::GetPersistentChanges()) to be journaled. */
+  void Append(std::vector<Entry> changes);
+
+  /* Records the time (in microseconds) the dispatch thread spent on a
+   * periodic save, and whether it failed.  This is included in GetMetrics().
+   */
+  void RecordDispatch(uint64_t duration, bool error);
+
+  PersistentSaveMetrics GetMetrics() const;
+
+ private:
+  class Thread;
+  wpi::SafeThreadOwner<Thread> m_owner;
+
+  mutable wpi::mutex m_metrics_mutex;
+  PersistentSaveMetrics m_metrics;
+
+  wpi::Logger& m_logger;
+};
+
+}  // namespace nt
+
+#endif  // NTCORE_PERSISTENTJOURNAL_H_
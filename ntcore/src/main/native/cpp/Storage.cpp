@@ -139,7 +139,7 @@ void Storage::ProcessIncomingEntryAssign(std::shared_ptr<Message> msg,
       if (!entry->value) {
         // didn't exist at all (rather than just being a response to a
         // id assignment request)
-        entry->value = msg->value();
+        std::atomic_store(&entry->value, msg->value());
         entry->flags = msg->flags();
         entry->seq_num = seq_num;
 
@@ -190,7 +190,7 @@ void Storage::ProcessIncomingEntryAssign(std::shared_ptr<Message> msg,
   if (!may_need_update && conn->proto_rev() >= 0x0300) {
     // update persistent dirty flag if persistent flag changed
     if ((entry->flags & NT_PERSISTENT) != (msg->flags() & NT_PERSISTENT)) {
-      m_persistent_dirty = true;
+      MarkPersistentDirty(entry);
     }
     if (entry->flags != msg->flags()) {
       notify_flags |= NT_NOTIFY_FLAGS;
@@ -200,11 +200,11 @@ void Storage::ProcessIncomingEntryAssign(std::shared_ptr<Message> msg,
 
   // update persistent dirty flag if the value changed and it's persistent
   if (entry->IsPersistent() && *entry->value != *msg->value()) {
-    m_persistent_dirty = true;
+    MarkPersistentDirty(entry);
   }
 
   // update local
-  entry->value = msg->value();
+  std::atomic_store(&entry->value, msg->value());
   entry->seq_num = seq_num;
 
   // notify
@@ -241,12 +241,12 @@ void Storage::ProcessIncomingEntryUpdate(std::shared_ptr<Message> msg,
   }
 
   // update local
-  entry->value = msg->value();
+  std::atomic_store(&entry->value, msg->value());
   entry->seq_num = seq_num;
 
   // update persistent dirty flag if it's a persistent value
   if (entry->IsPersistent()) {
-    m_persistent_dirty = true;
+    MarkPersistentDirty(entry);
   }
 
   // notify
@@ -450,7 +450,7 @@ void Storage::ApplyInitialAssignments(
     entry->id = id;
     if (!entry->value) {
       // doesn't currently exist
-      entry->value = msg->value();
+      std::atomic_store(&entry->value, msg->value());
       entry->flags = msg->flags();
       // notify
       m_notifier.NotifyEntry(entry->local_id, name, entry->value,
@@ -464,7 +464,7 @@ void Storage::ApplyInitialAssignments(
         update_msgs.emplace_back(Message::EntryUpdate(
             entry->id, entry->seq_num.value(), entry->value));
       } else {
-        entry->value = msg->value();
+        std::atomic_store(&entry->value, msg->value());
         unsigned int notify_flags = NT_NOTIFY_UPDATE;
         // don't update flags from a <3.0 remote (not part of message)
         if (conn.proto_rev() >= 0x0300) {
@@ -520,11 +520,11 @@ std::shared_ptr<Value> Storage::GetEntryValue(std::string_view name) const {
 }
 
 std::shared_ptr<Value> Storage::GetEntryValue(unsigned int local_id) const {
-  std::scoped_lock lock(m_mutex);
+  // lock-free
   if (local_id >= m_localmap.size()) {
     return nullptr;
   }
-  return m_localmap[local_id]->value;
+  return std::atomic_load(&m_localmap[local_id]->value);
 }
 
 bool Storage::SetDefaultEntryValue(std::string_view name,
@@ -556,7 +556,7 @@ bool Storage::SetDefaultEntryValue(unsigned int local_id,
   if (local_id >= m_localmap.size()) {
     return false;
   }
-  Entry* entry = m_localmap[local_id].get();
+  Entry* entry = m_localmap[local_id];
 
   // we return early if value already exists; if types match return true
   if (entry->value) {
@@ -595,7 +595,7 @@ bool Storage::SetEntryValue(unsigned int local_id,
   if (local_id >= m_localmap.size()) {
     return true;
   }
-  Entry* entry = m_localmap[local_id].get();
+  Entry* entry = m_localmap[local_id];
 
   if (entry->value && entry->value->type() != value->type()) {
     return false;  // error on type mismatch
@@ -605,14 +605,86 @@ bool Storage::SetEntryValue(unsigned int local_id,
   return true;
 }
 
+bool Storage::SetEntryValue(unsigned int local_id, NT_Type type,
+                            wpi::function_ref<bool(const Value& value)> equal,
+                            wpi::function_ref<std::shared_ptr<Value>()> make) {
+  if (local_id >= m_localmap.size()) {
+    return true;
+  }
+  Entry* entry = m_localmap[local_id];
+
+  // lock-free check for an unchanged value; the first local write still takes
+  // the slow path so the entry is marked as written locally
+  if (auto value = std::atomic_load(&entry->value)) {
+    if (value->type() != type) {
+      return false;  // error on type mismatch
+    }
+    if (entry->local_write && equal(*value)) {
+      return true;
+    }
+  }
+
+  auto value = make();
+  std::unique_lock lock(m_mutex);
+  if (entry->value && entry->value->type() != type) {
+    return false;  // error on type mismatch
+  }
+
+  SetEntryValueImpl(entry, std::move(value), lock, true);
+  return true;
+}
+
+bool Storage::SetEntryValues(
+    wpi::span<const std::pair<unsigned int, std::shared_ptr<Value>>> values) {
+  bool ok = true;
+  std::vector<EntryNotifyData> notifications;
+  std::vector<std::shared_ptr<Message>> msgs;
+  notifications.reserve(values.size());
+  msgs.reserve(values.size());
+
+  std::unique_lock lock(m_mutex);
+  for (auto&& [local_id, value] : values) {
+    if (!value || local_id >= m_localmap.size()) {
+      continue;
+    }
+    Entry* entry = m_localmap[local_id];
+    if (entry->value && entry->value->type() != value->type()) {
+      ok = false;  // error on type mismatch
+      continue;
+    }
+    if (auto msg = UpdateEntryValue(entry, value, true, &notifications)) {
+      msgs.emplace_back(std::move(msg));
+    }
+  }
+  auto dispatcher = m_dispatcher;
+  lock.unlock();
+
+  m_notifier.NotifyEntries(notifications);
+  if (dispatcher && !msgs.empty()) {
+    dispatcher->QueueOutgoingBatch(msgs, nullptr, nullptr);
+  }
+  return ok;
+}
+
 void Storage::SetEntryValueImpl(Entry* entry, std::shared_ptr<Value> value,
                                 std::unique_lock<wpi::mutex>& lock,
                                 bool local) {
+  auto msg = UpdateEntryValue(entry, std::move(value), local, nullptr);
+  if (msg) {
+    auto dispatcher = m_dispatcher;
+    lock.unlock();
+    dispatcher->QueueOutgoing(msg, nullptr, nullptr);
+  }
+}
+
+std::shared_ptr<Message> Storage::UpdateEntryValue(
+    Entry* entry, std::shared_ptr<Value> value, bool local,
+    std::vector<EntryNotifyData>* notifications) {
   if (!value) {
-    return;
+    return nullptr;
   }
   auto old_value = entry->value;
-  entry->value = value;
+  std::atomic_store(&entry->value, value);
 
   // if we're the server, assign an id if it doesn't have one
   if (m_server && entry->id == 0xffff) {
@@ -623,16 +695,24 @@ void Storage::SetEntryValueImpl(Entry* entry, std::shared_ptr<Value> value,
 
   // update persistent dirty flag if value changed and it's persistent
   if (entry->IsPersistent() && (!old_value || *old_value != *value)) {
-    m_persistent_dirty = true;
+    MarkPersistentDirty(entry);
   }
 
   // notify
+  unsigned int notify_flags = 0;
   if (!old_value) {
-    m_notifier.NotifyEntry(entry->local_id, entry->name, value,
-                           NT_NOTIFY_NEW | (local ? NT_NOTIFY_LOCAL : 0));
+    notify_flags = NT_NOTIFY_NEW | (local ? NT_NOTIFY_LOCAL : 0);
   } else if (*old_value != *value) {
-    m_notifier.NotifyEntry(entry->local_id, entry->name, value,
-                           NT_NOTIFY_UPDATE | (local ? NT_NOTIFY_LOCAL : 0));
+    notify_flags = NT_NOTIFY_UPDATE | (local ? NT_NOTIFY_LOCAL : 0);
+  }
+  if (notify_flags != 0) {
+    if (notifications) {
+      notifications->push_back(
+          {entry->local_id, entry->name, value, notify_flags});
+    } else {
+      m_notifier.NotifyEntry(entry->local_id, entry->name, value,
+                             notify_flags);
+    }
   }
 
   // remember local changes
@@ -642,28 +722,25 @@ void Storage::SetEntryValueImpl(Entry* entry, std::shared_ptr<Value> value,
 
   // generate message
   if (!m_dispatcher || (!local && !m_server)) {
-    return;
+    return nullptr;
   }
-  auto dispatcher = m_dispatcher;
   if (!old_value || old_value->type() != value->type()) {
     if (local) {
       ++entry->seq_num;
     }
-    auto msg = Message::EntryAssign(
-        entry->name, entry->id, entry->seq_num.value(), value, entry->flags);
-    lock.unlock();
-    dispatcher->QueueOutgoing(msg, nullptr, nullptr);
+    return Message::EntryAssign(entry->name, entry->id, entry->seq_num.value(),
+                                value, entry->flags);
   } else if (*old_value != *value) {
     if (local) {
       ++entry->seq_num;
     }
     // don't send an update if we don't have an assigned id yet
     if (entry->id != 0xffff) {
-      auto msg = Message::EntryUpdate(entry->id, entry->seq_num.value(), value);
-      lock.unlock();
-      dispatcher->QueueOutgoing(msg, nullptr, nullptr);
+      return Message::EntryUpdate(entry->id, entry->seq_num.value(), value,
+                                  entry->quantum);
     }
   }
+  return nullptr;
 }
 
 void Storage::SetEntryTypeValue(std::string_view name,
@@ -689,7 +766,7 @@ void Storage::SetEntryTypeValue(unsigned int local_id,
   if (local_id >= m_localmap.size()) {
     return;
   }
-  Entry* entry = m_localmap[local_id].get();
+  Entry* entry = m_localmap[local_id];
   if (!entry) {
     return;
   }
@@ -714,7 +791,15 @@ void Storage::SetEntryFlags(unsigned int id_local, unsigned int flags) {
   if (id_local >= m_localmap.size()) {
     return;
   }
-  SetEntryFlagsImpl(m_localmap[id_local].get(), flags, lock, true);
+  SetEntryFlagsImpl(m_localmap[id_local], flags, lock, true);
+}
+
+void Storage::SetEntryQuantization(unsigned int local_id, double quantum) {
+  std::scoped_lock lock(m_mutex);
+  if (local_id >= m_localmap.size()) {
+    return;
+  }
+  m_localmap[local_id]->quantum = quantum > 0 ? quantum : 0;
 }
 
 void Storage::SetEntryFlagsImpl(Entry* entry, unsigned int flags,
@@ -726,7 +811,7 @@ void Storage::SetEntryFlagsImpl(Entry* entry, unsigned int flags,
 
   // update persistent dirty flag if persistent flag changed
   if ((entry->flags & NT_PERSISTENT) != (flags & NT_PERSISTENT)) {
-    m_persistent_dirty = true;
+    MarkPersistentDirty(entry);
   }
 
   entry->flags = flags;
@@ -759,7 +844,7 @@ unsigned int Storage::GetEntryFlags(std::string_view name) const {
 }
 
 unsigned int Storage::GetEntryFlags(unsigned int local_id) const {
-  std::scoped_lock lock(m_mutex);
+  // lock-free
   if (local_id >= m_localmap.size()) {
     return 0;
   }
@@ -780,7 +865,7 @@ void Storage::DeleteEntry(unsigned int local_id) {
   if (local_id >= m_localmap.size()) {
     return;
   }
-  DeleteEntryImpl(m_localmap[local_id].get(), lock, true);
+  DeleteEntryImpl(m_localmap[local_id], lock, true);
 }
 
 void Storage::DeleteEntryImpl(Entry* entry, std::unique_lock<wpi::mutex>& lock,
@@ -793,8 +878,8 @@ void Storage::DeleteEntryImpl(Entry* entry, std::unique_lock<wpi::mutex>& lock,
   }
 
   // empty the value and reset id and local_write flag
-  std::shared_ptr<Value> old_value;
-  old_value.swap(entry->value);
+  auto old_value =
+      std::atomic_exchange(&entry->value, std::shared_ptr<Value>());
   entry->id = 0xffff;
   entry->local_write = false;
 
@@ -806,7 +891,7 @@ void Storage::DeleteEntryImpl(Entry* entry, std::unique_lock<wpi::mutex>& lock,
 
   // update persistent dirty flag if it's a persistent value
   if (entry->IsPersistent()) {
-    m_persistent_dirty = true;
+    MarkPersistentDirty(entry);
   }
 
   // reset flags
@@ -846,7 +931,7 @@ void Storage::DeleteAllEntriesImpl(bool local, F should_delete) {
       }
       entry->id = 0xffff;
       entry->local_write = false;
-      entry->value.reset();
+      std::atomic_store(&entry->value, std::shared_ptr<Value>());
       continue;
     }
   }
@@ -875,12 +960,36 @@ void Storage::DeleteAllEntries() {
   dispatcher->QueueOutgoing(Message::ClearEntries(), nullptr, nullptr);
 }
 
+Storage::Entry* Storage::LocalMap::emplace_back(std::string_view name) {
+  size_t i = m_size.load(std::memory_order_relaxed);
+  size_t chunk = i / kChunkSize;
+  if (chunk == m_chunks.size()) {
+    m_chunks.emplace_back(std::make_unique<Chunk>(kChunkSize));
+    if (chunk < m_table_size) {
+      // readers don't look at this slot until the new size is published
+      m_tables.back()[chunk] = m_chunks.back().get();
+    } else {
+      m_table_size = m_table_size == 0 ? kInitialTableSize : m_table_size * 2;
+      auto table = std::make_unique<std::unique_ptr<Entry>*[]>(m_table_size);
+      for (size_t j = 0; j < m_chunks.size(); ++j) {
+        table[j] = m_chunks[j].get();
+      }
+      m_table.store(table.get(), std::memory_order_release);
+      m_tables.emplace_back(std::move(table));
+    }
+  }
+  auto& entry = m_chunks[chunk][i % kChunkSize];
+  entry = std::make_unique<Entry>(name);
+  entry->local_id = i;
+  // publish to lock-free readers
+  m_size.store(i + 1, std::memory_order_release);
+  return entry.get();
+}
+
 Storage::Entry* Storage::GetOrNew(std::string_view name) {
   auto& entry = m_entries[name];
   if (!entry) {
-    m_localmap.emplace_back(new Entry(name));
-    entry = m_localmap.back().get();
-    entry->local_id = m_localmap.size() - 1;
+    entry = m_localmap.emplace_back(name);
   }
   return entry;
 }
@@ -922,7 +1031,7 @@ EntryInfo Storage::GetEntryInfo(int inst, unsigned int local_id) const {
   if (local_id >= m_localmap.size()) {
     return info;
   }
-  Entry* entry = m_localmap[local_id].get();
+  Entry* entry = m_localmap[local_id];
   if (!entry->value) {
     return info;
   }
@@ -936,7 +1045,7 @@ EntryInfo Storage::GetEntryInfo(int inst, unsigned int local_id) const {
 }
 
 std::string Storage::GetEntryName(unsigned int local_id) const {
-  std::unique_lock lock(m_mutex);
+  // lock-free (the name never changes)
   if (local_id >= m_localmap.size()) {
     return {};
   }
@@ -944,27 +1053,19 @@ std::string Storage::GetEntryName(unsigned int local_id) const {
 }
 
 NT_Type Storage::GetEntryType(unsigned int local_id) const {
-  std::unique_lock lock(m_mutex);
-  if (local_id >= m_localmap.size()) {
-    return NT_UNASSIGNED;
-  }
-  Entry* entry = m_localmap[local_id].get();
-  if (!entry->value) {
+  auto value = GetEntryValue(local_id);
+  if (!value) {
     return NT_UNASSIGNED;
   }
-  return entry->value->type();
+  return value->type();
 }
 
 uint64_t Storage::GetEntryLastChange(unsigned int local_id) const {
-  std::unique_lock lock(m_mutex);
-  if (local_id >= m_localmap.size()) {
-    return 0;
-  }
-  Entry* entry = m_localmap[local_id].get();
-  if (!entry->value) {
+  auto value = GetEntryValue(local_id);
+  if (!value) {
     return 0;
   }
-  return entry->value->last_change();
+  return value->last_change();
 }
 
 std::vector<EntryInfo> Storage::GetEntryInfo(int inst, std::string_view prefix,
@@ -1020,7 +1121,7 @@ unsigned int Storage::AddListener(
   // perform immediate notifications
   if ((flags & NT_NOTIFY_IMMEDIATE) != 0 && (flags & NT_NOTIFY_NEW) != 0 &&
       local_id < m_localmap.size()) {
-    Entry* entry = m_localmap[local_id].get();
+    Entry* entry = m_localmap[local_id];
     if (entry->value) {
       m_notifier.NotifyEntry(local_id, entry->name, entry->value,
                              NT_NOTIFY_IMMEDIATE | NT_NOTIFY_NEW, uid);
@@ -1059,7 +1160,7 @@ unsigned int Storage::AddPolledListener(unsigned int poller,
   // perform immediate notifications
   if ((flags & NT_NOTIFY_IMMEDIATE) != 0 && (flags & NT_NOTIFY_NEW) != 0 &&
       local_id < m_localmap.size()) {
-    Entry* entry = m_localmap[local_id].get();
+    Entry* entry = m_localmap[local_id];
     // if no value, don't notify
     if (entry->value) {
       m_notifier.NotifyEntry(local_id, entry->name, entry->value,
@@ -1101,6 +1202,71 @@ bool Storage::GetPersistentEntries(
   return true;
 }
 
+void Storage::MarkPersistentDirty(Entry* entry) {
+  m_persistent_dirty = true;
+  if (m_persistent_journal && !entry->persistent_changed) {
+    entry->persistent_changed = true;
+    m_persistent_changes.push_back(entry);
+  }
+}
+
+void Storage::StartPersistentJournal(
+    std::vector<std::pair<std::string, std::shared_ptr<Value>>>* entries) {
+  {
+    std::scoped_lock lock(m_mutex);
+    StopPersistentJournalImpl();
+    m_persistent_journal = true;
+    m_persistent_dirty = false;
+    entries->reserve(m_entries.size());
+    for (auto& i : m_entries) {
+      Entry* entry = i.getValue();
+      if (entry->value && entry->IsPersistent()) {
+        entries->emplace_back(i.getKey(), entry->value);
+      }
+    }
+  }
+
+  std::sort(entries->begin(), entries->end(),
+            [](const std::pair<std::string, std::shared_ptr<Value>>& a,
+               const std::pair<std::string, std::shared_ptr<Value>>& b) {
+              return a.first < b.first;
+            });
+}
+
+bool Storage::GetPersistentChanges(
+    std::vector<std::pair<std::string, std::shared_ptr<Value>>>* changes) {
+  std::scoped_lock lock(m_mutex);
+  if (m_persistent_changes.empty()) {
+    return false;
+  }
+  m_persistent_dirty = false;
+  changes->reserve(changes->size() + m_persistent_changes.size());
+  for (Entry* entry : m_persistent_changes) {
+    entry->persistent_changed = false;
+    // entries that were deleted or are no longer persistent are removed
+    if (entry->value && entry->IsPersistent()) {
+      changes->emplace_back(entry->name, entry->value);
+    } else {
+      changes->emplace_back(entry->name, nullptr);
+    }
+  }
+  m_persistent_changes.clear();
+  return true;
+}
+
+void Storage::StopPersistentJournal() {
+  std::scoped_lock lock(m_mutex);
+  StopPersistentJournalImpl();
+}
+
+void Storage::StopPersistentJournalImpl() {
+  for (Entry* entry : m_persistent_changes) {
+    entry->persistent_changed = false;
+  }
+  m_persistent_changes.clear();
+  m_persistent_journal = false;
+}
+
 bool Storage::GetEntries(
     std::string_view prefix,
     std::vector<std::pair<std::string, std::shared_ptr<Value>>>* entries)
@@ -1134,11 +1300,11 @@ void Storage::CreateRpc(unsigned int local_id, std::string_view def,
   if (local_id >= m_localmap.size()) {
     return;
   }
-  Entry* entry = m_localmap[local_id].get();
+  Entry* entry = m_localmap[local_id];
 
   auto old_value = entry->value;
   auto value = Value::MakeRpc(def);
-  entry->value = value;
+  std::atomic_store(&entry->value, value);
 
   // set up the RPC info
   entry->rpc_uid = rpc_uid;
@@ -1178,7 +1344,7 @@ unsigned int Storage::CallRpc(unsigned int local_id, std::string_view params) {
   if (local_id >= m_localmap.size()) {
     return 0;
   }
-  Entry* entry = m_localmap[local_id].get();
+  Entry* entry = m_localmap[local_id];
 
   if (!entry->value || !entry->value->IsRpc()) {
     return 0;
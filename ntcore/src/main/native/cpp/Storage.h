@@ -20,9 +20,11 @@
 #include <wpi/SmallSet.h>
 #include <wpi/StringMap.h>
 #include <wpi/condition_variable.h>
+#include <wpi/function_ref.h>
 #include <wpi/mutex.h>
 #include <wpi/span.h>
 
+#include "IEntryNotifier.h"
 #include "IStorage.h"
 #include "Message.h"
 #include "SequenceNumber.h"
@@ -36,7 +38,6 @@ class raw_ostream;
 
 namespace nt {
 
-class IEntryNotifier;
 class INetworkConnection;
 class IRpcServer;
 class IStorageTest;
@@ -73,7 +74,9 @@ class Storage : public IStorage {
       std::vector<std::shared_ptr<Message>>* out_msgs) override;
 
   // User functions.  These are the actual implementations of the corresponding
-  // user API functions in ntcore_cpp.
+  // user API functions in ntcore_cpp.  Reads by local id (value, flags, type,
+  // name, and last change) do not take the mutex, so they never block on
+  // writers or incoming network traffic.
   std::shared_ptr<Value> GetEntryValue(std::string_view name) const;
   std::shared_ptr<Value> GetEntryValue(unsigned int local_id) const;
 
@@ -85,12 +88,27 @@ class Storage : public IStorage {
   bool SetEntryValue(std::string_view name, std::shared_ptr<Value> value);
   bool SetEntryValue(unsigned int local_id, std::shared_ptr<Value> value);
 
+  // Sets a value by local id, only creating it (with make) if equal returns
+  // false for the current value.  The comparison does not take the mutex, so
+  // setting an unchanged value neither locks nor allocates.
+  bool SetEntryValue(unsigned int local_id, NT_Type type,
+                     wpi::function_ref<bool(const Value& value)> equal,
+                     wpi::function_ref<std::shared_ptr<Value>()> make);
+
+  // Sets several values by local id under a single lock, with one batch of
+  // notifications and outgoing messages.  Returns false if any value had a
+  // type mismatch (those values are not set).
+  bool SetEntryValues(
+      wpi::span<const std::pair<unsigned int, std::shared_ptr<Value>>> values);
+
   void SetEntryTypeValue(std::string_view name, std::shared_ptr<Value> value);
   void SetEntryTypeValue(unsigned int local_id, std::shared_ptr<Value> value);
 
   void SetEntryFlags(std::string_view name, unsigned int flags);
   void SetEntryFlags(unsigned int local_id, unsigned int flags);
 
+  void SetEntryQuantization(unsigned int local_id, double quantum);
+
   unsigned int GetEntryFlags(std::string_view name) const;
   unsigned int GetEntryFlags(unsigned int local_id) const;
 
@@ -134,6 +152,27 @@ class Storage : public IStorage {
       std::string_view filename,
       std::function<void(size_t line, const char* msg)> warn) override;
 
+  void StartPersistentJournal(
+      std::vector<std::pair<std::string, std::shared_ptr<Value>>>* entries)
+      override;
+  bool GetPersistentChanges(
+      std::vector<std::pair<std::string, std::shared_ptr<Value>>>* changes)
+      override;
+  void StopPersistentJournal() override;
+
+  // Persistent file writers that do not access storage contents; used by
+  // the persistent journal.  SavePersistentFile() atomically replaces the
+  // file.  SavePersistentJournal() writes journal records for changes (a
+  // null value records a removal); if header is true, the file header is
+  // written first.
+  static const char* SavePersistentFile(
+      std::string_view filename,
+      wpi::span<const std::pair<std::string, std::shared_ptr<Value>>> entries);
+  static void SavePersistentJournal(
+      wpi::raw_ostream& os,
+      wpi::span<const std::pair<std::string, std::shared_ptr<Value>>> changes,
+      bool header);
+
   const char* SaveEntries(std::string_view filename,
                           std::string_view prefix) const;
   const char* LoadEntries(
@@ -170,9 +209,11 @@ class Storage : public IStorage {
     // raw Entry* via the ID map.
     std::string name;
 
-    // The current value and flags.
+    // The current value and flags.  These are only modified with the mutex
+    // held, but atomically (std::atomic_store for the value) so that they can
+    // also be read by local id without the mutex.
     std::shared_ptr<Value> value;
-    unsigned int flags{0};
+    std::atomic_uint flags{0};
 
     // Unique ID for this entry as used in network messages.  The value is
     // assigned by the server, so on the client this is 0xffff until an
@@ -186,8 +227,16 @@ class Storage : public IStorage {
     SequenceNumber seq_num;
 
     // If value has been written locally.  Used during initial handshake
-    // on client to determine whether or not to accept remote changes.
-    bool local_write{false};
+    // on client to determine whether or not to accept remote changes.  Only
+    // modified with the mutex held; atomic so that setting an unchanged value
+    // can check it without the mutex.
+    std::atomic_bool local_write{false};
+
+    // Quantization step for delta-encoded double array updates (0 for none).
+    double quantum{0};
+
+    // If queued in m_persistent_changes.
+    bool persistent_changed{false};
 
     // RPC handle.
     unsigned int rpc_uid{UINT_MAX};
@@ -199,7 +248,35 @@ class Storage : public IStorage {
 
   using EntriesMap = wpi::StringMap<Entry*>;
   using IdMap = std::vector<Entry*>;
-  using LocalMap = std::vector<std::unique_ptr<Entry>>;
+
+  // Local id to entry map.  Entries are only ever appended, and are stored in
+  // fixed-size chunks that are never reallocated, so lookups by local id do
+  // not need the mutex.  Appends must be made with the mutex held.
+  class LocalMap {
+   public:
+    size_t size() const { return m_size.load(std::memory_order_acquire); }
+    Entry* operator[](size_t i) const {
+      auto table = m_table.load(std::memory_order_acquire);
+      return table[i / kChunkSize][i % kChunkSize].get();
+    }
+    Entry* emplace_back(std::string_view name);
+
+   private:
+    static constexpr size_t kChunkSize = 1024;
+    static constexpr size_t kInitialTableSize = 16;
+
+    using Chunk = std::unique_ptr<Entry>[];
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    // Tables of pointers to the chunks.  The table is replaced by a larger
+    // copy when it fills up; readers may still be using the old ones, so they
+    // are kept until the map is destroyed.
+    std::vector<std::unique_ptr<std::unique_ptr<Entry>*[]>> m_tables;
+    size_t m_table_size = 0;
+    std::atomic<std::unique_ptr<Entry>* const*> m_table{nullptr};
+    std::atomic<size_t> m_size{0};
+  };
+
   using RpcIdPair = std::pair<unsigned int, unsigned int>;
   using RpcResultMap = wpi::DenseMap<RpcIdPair, std::string>;
   using RpcBlockingCallSet = wpi::SmallSet<RpcIdPair, 12>;
@@ -212,6 +289,10 @@ class Storage : public IStorage {
   RpcBlockingCallSet m_rpc_blocking_calls;
   // If any persistent values have changed
   mutable bool m_persistent_dirty = false;
+  // Persistent entries changed since the last GetPersistentChanges() call
+  // (only tracked while journaling)
+  bool m_persistent_journal = false;
+  std::vector<Entry*> m_persistent_changes;
 
   // condition variable and termination flag for blocking on a RPC result
   std::atomic_bool m_terminating;
@@ -245,11 +326,23 @@ class Storage : public IStorage {
       bool periodic,
       std::vector<std::pair<std::string, std::shared_ptr<Value>>>* entries)
       const;
+  void SetLoadedEntries(
+      wpi::span<const std::pair<std::string, std::shared_ptr<Value>>> entries,
+      bool persistent);
+  // Must be called with m_mutex held.
+  void MarkPersistentDirty(Entry* entry);
+  void StopPersistentJournalImpl();
   bool GetEntries(std::string_view prefix,
                   std::vector<std::pair<std::string, std::shared_ptr<Value>>>*
                       entries) const;
   void SetEntryValueImpl(Entry* entry, std::shared_ptr<Value> value,
                          std::unique_lock<wpi::mutex>& lock, bool local);
+  // Must be called with m_mutex held.  Returns the message to send (if any).
+  // Notifications are appended to notifications if provided, otherwise they
+  // are sent immediately.
+  std::shared_ptr<Message> UpdateEntryValue(
+      Entry* entry, std::shared_ptr<Value> value, bool local,
+      std::vector<EntryNotifyData>* notifications);
   void SetEntryFlagsImpl(Entry* entry, unsigned int flags,
                          std::unique_lock<wpi::mutex>& lock, bool local);
   void DeleteEntryImpl(Entry* entry, std::unique_lock<wpi::mutex>& lock,
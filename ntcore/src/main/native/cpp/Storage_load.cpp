@@ -2,13 +2,16 @@
 // Open Source Software; you can modify and/or share it under the terms of
 // the WPILib BSD license file in the root directory of this project.
 
+#include <algorithm>
 #include <cctype>
 #include <string>
 #include <utility>
 
+#include <fmt/format.h>
 #include <wpi/Base64.h>
 #include <wpi/SmallString.h>
 #include <wpi/StringExtras.h>
+#include <wpi/StringMap.h>
 #include <wpi/raw_istream.h>
 
 #include "IDispatcher.h"
@@ -24,8 +27,8 @@ class LoadPersistentImpl {
   using Entry = std::pair<std::string, std::shared_ptr<Value>>;
   using WarnFunc = std::function<void(size_t, const char*)>;
 
-  LoadPersistentImpl(wpi::raw_istream& is, WarnFunc warn)
-      : m_is(is), m_warn(std::move(warn)) {}
+  LoadPersistentImpl(wpi::raw_istream& is, WarnFunc warn, bool journal = false)
+      : m_is(is), m_warn(std::move(warn)), m_journal(journal) {}
 
   bool Load(std::string_view prefix, std::vector<Entry>* entries);
 
@@ -51,6 +54,7 @@ class LoadPersistentImpl {
 
   wpi::raw_istream& m_is;
   WarnFunc m_warn;
+  bool m_journal;  // accept journal removal records
 
   std::string_view m_line;
   wpi::SmallString<128> m_line_buf;
@@ -145,6 +149,17 @@ bool LoadPersistentImpl::Load(std::string_view prefix,
   }
 
   while (ReadLine()) {
+    // journal removal record (null value)
+    if (m_journal && wpi::starts_with(m_line, "delete ")) {
+      m_line = wpi::ltrim(m_line.substr(7), " \t");
+      wpi::SmallString<128> buf;
+      std::string_view name = ReadName(buf);
+      if (!name.empty() && wpi::starts_with(name, prefix)) {
+        entries->emplace_back(name, nullptr);
+      }
+      continue;
+    }
+
     // type
     NT_Type type = ReadType();
     if (type == NT_UNASSIGNED) {
@@ -386,13 +401,20 @@ bool Storage::LoadEntries(
     return false;
   }
 
+  SetLoadedEntries(entries, persistent);
+  return true;
+}
+
+void Storage::SetLoadedEntries(
+    wpi::span<const std::pair<std::string, std::shared_ptr<Value>>> entries,
+    bool persistent) {
   // copy values into storage as quickly as possible so lock isn't held
   std::vector<std::shared_ptr<Message>> msgs;
   std::unique_lock lock(m_mutex);
   for (auto& i : entries) {
     Entry* entry = GetOrNew(i.first);
     auto old_value = entry->value;
-    entry->value = i.second;
+    std::atomic_store(&entry->value, i.second);
     bool was_persist = entry->IsPersistent();
     if (!was_persist && persistent) {
       entry->flags |= NT_PERSISTENT;
@@ -451,21 +473,53 @@ bool Storage::LoadEntries(
       dispatcher->QueueOutgoing(std::move(msg), nullptr, nullptr);
     }
   }
-
-  return true;
 }
 
 const char* Storage::LoadPersistent(
     std::string_view filename,
     std::function<void(size_t line, const char* msg)> warn) {
+  std::vector<LoadPersistentImpl::Entry> entries;
+  bool have_file = false;
+  {
+    std::error_code ec;
+    wpi::raw_fd_istream is(filename, ec);
+    if (ec.value() == 0) {
+      have_file = true;
+      if (!LoadPersistentImpl(is, warn).Load("", &entries)) {
+        return "error reading file";
+      }
+    }
+  }
+
+  // apply changes journaled since the file was last written; there's no file
+  // if the program stopped before its first full save
   std::error_code ec;
-  wpi::raw_fd_istream is(filename, ec);
+  wpi::raw_fd_istream is(fmt::format("{}.journal", filename), ec);
   if (ec.value() != 0) {
-    return "could not open file";
-  }
-  if (!LoadEntries(is, "", true, warn)) {
-    return "error reading file";
+    if (!have_file) {
+      return "could not open file";
+    }
+  } else {
+    std::vector<LoadPersistentImpl::Entry> changes;
+    LoadPersistentImpl(is, warn, true).Load("", &changes);
+    wpi::StringMap<size_t> index;
+    for (size_t i = 0; i < entries.size(); ++i) {
+      index[entries[i].first] = i;
+    }
+    for (auto& change : changes) {
+      auto [it, inserted] = index.try_emplace(change.first, entries.size());
+      if (inserted) {
+        entries.emplace_back(std::move(change));
+      } else {
+        entries[it->second].second = std::move(change.second);
+      }
+    }
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const auto& e) { return !e.second; }),
+                  entries.end());
   }
+
+  SetLoadedEntries(entries, true);
   return nullptr;
 }
 
@@ -26,6 +26,7 @@ class SavePersistentImpl {
   explicit SavePersistentImpl(wpi::raw_ostream& os) : m_os(os) {}
 
   void Save(wpi::span<const Entry> entries);
+  void SaveJournal(wpi::span<const Entry> changes, bool header);
 
  private:
   void WriteString(std::string_view str);
@@ -38,6 +39,37 @@ class SavePersistentImpl {
   wpi::raw_ostream& m_os;
 };
 
+// Writes entries to a temporary file and then moves it to the real file.
+const char* SaveFile(std::string_view filename,
+                     wpi::span<const SavePersistentImpl::Entry> entries) {
+  std::string fn{filename};
+  auto tmp = fmt::format("{}.tmp", filename);
+  auto bak = fmt::format("{}.bak", filename);
+
+  // start by writing to temporary file
+  std::error_code ec;
+  wpi::raw_fd_ostream os(tmp, ec, fs::F_Text);
+  if (ec.value() != 0) {
+    return "could not open file";
+  }
+  SavePersistentImpl(os).Save(entries);
+  os.close();
+  if (os.has_error()) {
+    std::remove(tmp.c_str());
+    return "error saving file";
+  }
+
+  // Safely move to real file.  We ignore any failures related to the backup.
+  std::remove(bak.c_str());
+  std::rename(fn.c_str(), bak.c_str());
+  if (std::rename(tmp.c_str(), fn.c_str()) != 0) {
+    std::rename(bak.c_str(), fn.c_str());  // attempt to restore backup
+    return "could not rename temp file to real file";
+  }
+
+  return nullptr;
+}
+
 }  // namespace
 
 /* Escapes and writes a string, including start and end double quotes */
@@ -77,6 +109,22 @@ void SavePersistentImpl::Save(wpi::span<const Entry> entries) {
   WriteEntries(entries);
 }
 
+void SavePersistentImpl::SaveJournal(wpi::span<const Entry> changes,
+                                     bool header) {
+  if (header) {
+    WriteHeader();
+  }
+  for (auto& i : changes) {
+    if (i.second) {
+      WriteEntry(i.first, *i.second);
+    } else {
+      m_os << "delete ";
+      WriteString(i.first);
+      m_os << '\n';
+    }
+  }
+}
+
 void SavePersistentImpl::WriteHeader() {
   m_os << "[NetworkTables Storage 3.0]\n";
 }
@@ -192,44 +240,15 @@ void Storage::SavePersistent(wpi::raw_ostream& os, bool periodic) const {
 
 const char* Storage::SavePersistent(std::string_view filename,
                                     bool periodic) const {
-  std::string fn{filename};
-  auto tmp = fmt::format("{}.tmp", filename);
-  auto bak = fmt::format("{}.bak", filename);
-
   // Get entries before creating file
   std::vector<SavePersistentImpl::Entry> entries;
   if (!GetPersistentEntries(periodic, &entries)) {
     return nullptr;
   }
 
-  const char* err = nullptr;
-
-  // start by writing to temporary file
-  std::error_code ec;
-  wpi::raw_fd_ostream os(tmp, ec, fs::F_Text);
-  if (ec.value() != 0) {
-    err = "could not open file";
-    goto done;
-  }
   DEBUG0("saving persistent file '{}'", filename);
-  SavePersistentImpl(os).Save(entries);
-  os.close();
-  if (os.has_error()) {
-    std::remove(tmp.c_str());
-    err = "error saving file";
-    goto done;
-  }
+  const char* err = SaveFile(filename, entries);
 
-  // Safely move to real file.  We ignore any failures related to the backup.
-  std::remove(bak.c_str());
-  std::rename(fn.c_str(), bak.c_str());
-  if (std::rename(tmp.c_str(), fn.c_str()) != 0) {
-    std::rename(bak.c_str(), fn.c_str());  // attempt to restore backup
-    err = "could not rename temp file to real file";
-    goto done;
-  }
-
-done:
   // try again if there was an error
   if (err && periodic) {
     m_persistent_dirty = true;
@@ -237,6 +256,19 @@ done:
   return err;
 }
 
+const char* Storage::SavePersistentFile(
+    std::string_view filename,
+    wpi::span<const std::pair<std::string, std::shared_ptr<Value>>> entries) {
+  return SaveFile(filename, entries);
+}
+
+void Storage::SavePersistentJournal(
+    wpi::raw_ostream& os,
+    wpi::span<const std::pair<std::string, std::shared_ptr<Value>>> changes,
+    bool header) {
+  SavePersistentImpl(os).SaveJournal(changes, header);
+}
+
 void Storage::SaveEntries(wpi::raw_ostream& os, std::string_view prefix) const {
   std::vector<SavePersistentImpl::Entry> entries;
   if (!GetEntries(prefix, &entries)) {
@@ -247,37 +279,12 @@ void Storage::SaveEntries(wpi::raw_ostream& os, std::string_view prefix) const {
 
 const char* Storage::SaveEntries(std::string_view filename,
                                  std::string_view prefix) const {
-  std::string fn{filename};
-  auto tmp = fmt::format("{}.tmp", filename);
-  auto bak = fmt::format("{}.bak", filename);
-
   // Get entries before creating file
   std::vector<SavePersistentImpl::Entry> entries;
   if (!GetEntries(prefix, &entries)) {
     return nullptr;
   }
 
-  // start by writing to temporary file
-  std::error_code ec;
-  wpi::raw_fd_ostream os(tmp, ec, fs::F_Text);
-  if (ec.value() != 0) {
-    return "could not open file";
-  }
   DEBUG0("saving file '{}'", filename);
-  SavePersistentImpl(os).Save(entries);
-  os.close();
-  if (os.has_error()) {
-    std::remove(tmp.c_str());
-    return "error saving file";
-  }
-
-  // Safely move to real file.  We ignore any failures related to the backup.
-  std::remove(bak.c_str());
-  std::rename(fn.c_str(), bak.c_str());
-  if (std::rename(tmp.c_str(), fn.c_str()) != 0) {
-    std::rename(bak.c_str(), fn.c_str());  // attempt to restore backup
-    return "could not rename temp file to real file";
-  }
-
-  return nullptr;
+  return SaveFile(filename, entries);
 }
@@ -0,0 +1,337 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "UvConnection.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <wpi/SmallVector.h>
+#include <wpi/raw_istream.h>
+#include <wpi/timestamp.h>
+#include <wpi/uv/Async.h>
+#include <wpi/uv/Tcp.h>
+#include <wpi/uv/util.h>
+
+#include "IConnectionNotifier.h"
+#include "Log.h"
+#include "WireDecoder.h"
+
+using namespace nt;
+namespace uv = wpi::uv;
+
+UvConnection::UvConnection(unsigned int uid, std::shared_ptr<uv::Tcp> stream,
+                           IConnectionNotifier& notifier, wpi::Logger& logger,
+                           HandshakeFunc handshake,
+                           Message::GetEntryTypeFunc get_entry_type)
+    : m_uid(uid),
+      m_stream(std::move(stream)),
+      m_notifier(notifier),
+      m_logger(logger),
+      m_handshake(std::move(handshake)),
+      m_get_entry_type(std::move(get_entry_type)),
+      m_state(kCreated),
+      m_encoder(0x0300) {
+  m_active = false;
+  m_proto_rev = 0x0300;
+  m_last_update = 0;
+  m_encoder.set_delta_base(&m_write_delta_base);
+
+  // turn off Nagle algorithm; we bundle packets for transmission
+  m_stream->SetNoDelay(true);
+  uv::AddrToName(m_stream->GetPeer(), &m_peer_ip, &m_peer_port);
+}
+
+UvConnection::~UvConnection() {
+  // the handles are closed by Stop() or when the loop is stopped
+  set_state(kDead);
+  m_active = false;
+}
+
+void UvConnection::Start() {
+  if (m_active) {
+    return;
+  }
+  m_active = true;
+  set_state(kInit);
+
+  {
+    std::scoped_lock lock(m_pending_mutex);
+    m_posted_async = uv::Async<>::Create(m_stream->GetLoopRef());
+    if (!m_posted_async) {
+      m_active = false;
+      set_state(kDead);
+      m_stream->Close();
+      return;
+    }
+    m_posted_async->wakeup.connect([weak = weak_from_this()] {
+      if (auto self = weak.lock()) {
+        self->WritePosted();
+      }
+    });
+  }
+
+  m_stream->data.connect(
+      [weak = weak_from_this()](uv::Buffer& buf, size_t len) {
+        if (auto self = weak.lock()) {
+          self->ProcessData(buf.base, len);
+        }
+      });
+  m_stream->end.connect([this, weak = weak_from_this()] {
+    if (auto self = weak.lock()) {
+      DEBUG2("connection closed by remote ({})", fmt::ptr(this));
+      Stop();
+    }
+  });
+  m_stream->error.connect([this, weak = weak_from_this()](uv::Error err) {
+    if (auto self = weak.lock()) {
+      DEBUG2("connection error: {} ({})", err.str(), fmt::ptr(this));
+      Stop();
+    }
+  });
+
+  set_state(kHandshake);
+  m_stream->StartRead();
+}
+
+void UvConnection::Stop() {
+  DEBUG2("UvConnection stopping ({})", fmt::ptr(this));
+  set_state(kDead);
+  m_active = false;
+  m_stream->Close();
+  std::scoped_lock lock(m_pending_mutex);
+  if (m_posted_async) {
+    m_posted_async->Close();
+    m_posted_async.reset();
+  }
+  m_posted.clear();
+}
+
+ConnectionInfo UvConnection::info() const {
+  return ConnectionInfo{remote_id(), m_peer_ip, m_peer_port, m_last_update,
+                        m_proto_rev};
+}
+
+ConnectionStats UvConnection::stats() const {
+  ConnectionStats stats;
+  stats.info = info();
+  m_metrics.GetStats(&stats);
+  std::scoped_lock lock(m_pending_mutex);
+  stats.messages_coalesced = m_pending.coalesced();
+  stats.queue_high_water = m_pending.high_water();
+  return stats;
+}
+
+unsigned int UvConnection::proto_rev() const {
+  return m_proto_rev;
+}
+
+void UvConnection::set_proto_rev(unsigned int proto_rev) {
+  m_proto_rev = proto_rev;
+}
+
+UvConnection::State UvConnection::state() const {
+  std::scoped_lock lock(m_state_mutex);
+  return m_state;
+}
+
+void UvConnection::set_state(State state) {
+  std::scoped_lock lock(m_state_mutex);
+  // Don't update state any more once we've died
+  if (m_state == kDead) {
+    return;
+  }
+  // One-shot notify state changes
+  if (m_state != kActive && state == kActive) {
+    m_notifier.NotifyConnection(true, info());
+  }
+  if (m_state != kDead && state == kDead) {
+    m_notifier.NotifyConnection(false, info());
+  }
+  m_state = state;
+}
+
+std::string UvConnection::remote_id() const {
+  std::scoped_lock lock(m_remote_id_mutex);
+  return m_remote_id;
+}
+
+void UvConnection::set_remote_id(std::string_view remote_id) {
+  std::scoped_lock lock(m_remote_id_mutex);
+  m_remote_id = remote_id;
+}
+
+void UvConnection::ProcessData(const char* data, size_t len) {
+  // decode directly from the received data unless a partial message was left
+  // over from the previous read
+  std::string_view buf{data, len};
+  if (!m_read_buf.empty()) {
+    m_read_buf.append(data, len);
+    buf = m_read_buf;
+  }
+
+  wpi::raw_mem_istream is(buf.data(), buf.size());
+  WireDecoder decoder(is, m_proto_rev, m_logger);
+  decoder.set_delta_base(&m_read_delta_base);
+  size_t consumed = 0;
+  size_t count = 0;
+  while (m_active) {
+    decoder.set_proto_rev(m_proto_rev);
+    decoder.Reset();
+    auto msg = Message::Read(decoder, m_get_entry_type);
+    if (!msg) {
+      if (decoder.error()) {
+        // terminate connection on bad message
+        INFO("read error: {}", decoder.error());
+        Stop();
+        return;
+      }
+      break;  // incomplete message; wait for more data
+    }
+    consumed = buf.size() - is.in_avail();
+    ++count;
+
+    if (m_handshake) {
+      switch (m_handshake(*this, std::move(msg))) {
+        case kHandshakeFailed:
+          Stop();
+          return;
+        case kHandshakeComplete:
+          m_handshake = nullptr;
+          set_state(kActive);
+          break;
+        default:
+          break;
+      }
+      continue;
+    }
+
+    DEBUG3("received type={} with str={} id={} seq_num={}", msg->type(),
+           msg->str(), msg->id(), msg->seq_num_uid());
+    m_last_update = Now();
+    m_process_incoming(std::move(msg), this);
+  }
+
+  m_metrics.RecordReceived(len, count);
+
+  // keep any partial message for the next read
+  if (buf.data() == m_read_buf.data()) {
+    m_read_buf.erase(0, consumed);
+  } else {
+    m_read_buf.assign(data + consumed, len - consumed);
+  }
+}
+
+void UvConnection::Send(wpi::span<std::shared_ptr<Message>> msgs) {
+  m_encoder.set_proto_rev(m_proto_rev);
+  m_encoder.Reset();
+  size_t count = 0;
+  for (auto& msg : msgs) {
+    if (msg) {
+      msg->Write(m_encoder);
+      ++count;
+    }
+  }
+  WriteEncoded(count);
+}
+
+void UvConnection::WriteEncoded(size_t count) {
+  if (m_encoder.size() == 0 || !m_active) {
+    return;
+  }
+
+  // copy into pooled buffers, as the encoder is reused before the write
+  // completes
+  wpi::SmallVector<uv::Buffer, 4> bufs;
+  std::string_view data = m_encoder.ToStringView();
+  while (!data.empty()) {
+    auto buf = m_write_pool.Allocate();
+    buf.len = (std::min)(buf.len, data.size());
+    std::memcpy(buf.base, data.data(), buf.len);
+    data.remove_prefix(buf.len);
+    bufs.emplace_back(buf);
+  }
+  m_stream->Write(bufs, [this, weak = weak_from_this(), count,
+                         size = m_encoder.size(),
+                         start = wpi::Now()](auto bufs, uv::Error err) {
+    auto self = weak.lock();
+    if (!self) {
+      for (auto buf : bufs) {
+        buf.Deallocate();
+      }
+      return;
+    }
+    m_write_pool.Release(bufs);
+    if (err) {
+      DEBUG2("write error: {} ({})", err.str(), fmt::ptr(this));
+      Stop();
+      return;
+    }
+    m_metrics.RecordWrite(wpi::Now() - start);
+    m_metrics.RecordSent(size, count);
+  });
+  DEBUG4("sent {} bytes", m_encoder.size());
+}
+
+void UvConnection::WritePosted() {
+  {
+    std::scoped_lock lock(m_pending_mutex);
+    m_write_posted.swap(m_posted);
+  }
+
+  // coalesce everything posted since the last wakeup into a single write
+  m_encoder.set_proto_rev(m_proto_rev);
+  m_encoder.Reset();
+  size_t count = 0;
+  for (auto& batch : m_write_posted) {
+    DEBUG3("sending {} messages", batch.size());
+    for (auto& msg : batch) {
+      if (msg) {
+        msg->Write(m_encoder);
+        ++count;
+      }
+    }
+  }
+  WriteEncoded(count);
+
+  // release the messages outside the lock, then reuse the storage
+  for (auto& batch : m_write_posted) {
+    batch.clear();
+  }
+  std::scoped_lock lock(m_pending_mutex);
+  for (auto& batch : m_write_posted) {
+    m_pending.Recycle(std::move(batch));
+  }
+  m_write_posted.clear();
+}
+
+void UvConnection::QueueOutgoing(std::shared_ptr<Message> msg) {
+  std::scoped_lock lock(m_pending_mutex);
+  m_pending.Queue(std::move(msg));
+}
+
+void UvConnection::PostOutgoing(bool keep_alive) {
+  auto start = wpi::Now();
+  std::scoped_lock lock(m_pending_mutex);
+  auto msgs = m_pending.Post(keep_alive);
+  if (msgs.empty() || !m_posted_async) {
+    return;
+  }
+  m_posted.emplace_back(std::move(msgs));
+  m_posted_async->Send();
+  m_metrics.RecordPost(wpi::Now() - start);
+}
+
+std::chrono::steady_clock::time_point UvConnection::ArmPostDeadline(
+    std::chrono::steady_clock::time_point now,
+    std::chrono::microseconds min_interval) {
+  std::scoped_lock lock(m_pending_mutex);
+  return m_pending.ArmDeadline(now, min_interval);
+}
+
+std::chrono::steady_clock::time_point UvConnection::post_deadline() const {
+  std::scoped_lock lock(m_pending_mutex);
+  return m_pending.deadline();
+}
@@ -0,0 +1,156 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef NTCORE_UVCONNECTION_H_
+#define NTCORE_UVCONNECTION_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <wpi/mutex.h>
+#include <wpi/span.h>
+#include <wpi/uv/Buffer.h>
+
+#include "ArrayDeltaBase.h"
+#include "ConnectionMetrics.h"
+#include "INetworkConnection.h"
+#include "Message.h"
+#include "PendingOutgoing.h"
+#include "WireEncoder.h"
+#include "ntcore_cpp.h"
+
+namespace wpi {
+class Logger;
+namespace uv {
+template <typename... T>
+class Async;
+class Tcp;
+}  // namespace uv
+}  // namespace wpi
+
+namespace nt {
+
+class IConnectionNotifier;
+
+/* A network connection serviced by a wpi::uv event loop.  Unlike
+ * NetworkConnection, which uses a read and a write thread per connection, all
+ * reads and writes happen on the loop thread, so a single thread can service
+ * any number of connections.  Outgoing messages are queued and posted from
+ * any thread; posting wakes the loop to encode and write them.
+ */
+class UvConnection : public INetworkConnection,
+                     public std::enable_shared_from_this<UvConnection> {
+ public:
+  enum HandshakeResult {
+    kHandshakeFailed,
+    kHandshakeContinue,
+    kHandshakeComplete
+  };
+
+  // Called on the loop thread with each message received before the
+  // handshake completes.  Handshake responses are sent with Send().
+  using HandshakeFunc = std::function<HandshakeResult(
+      UvConnection& conn, std::shared_ptr<Message> msg)>;
+  using ProcessIncomingFunc =
+      std::function<void(std::shared_ptr<Message>, UvConnection*)>;
+  using Outgoing = std::vector<std::shared_ptr<Message>>;
+
+  UvConnection(unsigned int uid, std::shared_ptr<wpi::uv::Tcp> stream,
+               IConnectionNotifier& notifier, wpi::Logger& logger,
+               HandshakeFunc handshake,
+               Message::GetEntryTypeFunc get_entry_type);
+  ~UvConnection() override;
+
+  // Set the input processor function.  This must be called before Start().
+  void set_process_incoming(ProcessIncomingFunc func) {
+    m_process_incoming = func;
+  }
+
+  // Start and Stop must be called from the loop thread.
+  void Start();
+  void Stop();
+
+  ConnectionInfo info() const final;
+  ConnectionStats stats() const final;
+
+  bool active() const { return m_active; }
+
+  void QueueOutgoing(std::shared_ptr<Message> msg) final;
+  void PostOutgoing(bool keep_alive) final;
+  std::chrono::steady_clock::time_point ArmPostDeadline(
+      std::chrono::steady_clock::time_point now,
+      std::chrono::microseconds min_interval) final;
+  std::chrono::steady_clock::time_point post_deadline() const final;
+
+  // Immediately writes messages, bypassing the outgoing queue.  This must be
+  // called from the loop thread.
+  void Send(wpi::span<std::shared_ptr<Message>> msgs);
+
+  unsigned int uid() const { return m_uid; }
+
+  unsigned int proto_rev() const final;
+  void set_proto_rev(unsigned int proto_rev) final;
+
+  State state() const final;
+  void set_state(State state) final;
+
+  std::string remote_id() const;
+  void set_remote_id(std::string_view remote_id);
+
+  uint64_t last_update() const { return m_last_update; }
+
+  UvConnection(const UvConnection&) = delete;
+  UvConnection& operator=(const UvConnection&) = delete;
+
+ private:
+  void ProcessData(const char* data, size_t len);
+  void WriteEncoded(size_t count);
+  void WritePosted();
+
+  unsigned int m_uid;
+  std::shared_ptr<wpi::uv::Tcp> m_stream;
+  std::string m_peer_ip;
+  unsigned int m_peer_port = 0;
+  IConnectionNotifier& m_notifier;
+  wpi::Logger& m_logger;
+  HandshakeFunc m_handshake;
+  Message::GetEntryTypeFunc m_get_entry_type;
+  ProcessIncomingFunc m_process_incoming;
+  std::atomic_bool m_active;
+  std::atomic_uint m_proto_rev;
+  mutable wpi::mutex m_state_mutex;
+  State m_state;
+  mutable wpi::mutex m_remote_id_mutex;
+  std::string m_remote_id;
+  std::atomic_ullong m_last_update;
+
+  // Received data not yet decoded into a complete message (loop thread only)
+  std::string m_read_buf;
+  ArrayDeltaBase m_read_delta_base;
+  WireEncoder m_encoder;
+  ArrayDeltaBase m_write_delta_base;
+  // Write buffers, reused once each write completes (loop thread only)
+  wpi::uv::SimpleBufferPool<4> m_write_pool;
+  // Batches being written by WritePosted (loop thread only)
+  std::vector<Outgoing> m_write_posted;
+
+  ConnectionMetrics m_metrics;
+
+  mutable wpi::mutex m_pending_mutex;
+  PendingOutgoing m_pending;
+  // Posted for transmission, written by the loop (uses pending mutex)
+  std::vector<Outgoing> m_posted;
+  std::shared_ptr<wpi::uv::Async<>> m_posted_async;
+};
+
+}  // namespace nt
+
+#endif  // NTCORE_UVCONNECTION_H_
@@ -68,6 +68,22 @@ bool WireDecoder::ReadDouble(double* val) {
   return true;
 }
 
+bool WireDecoder::ReadUleb128(uint64_t* val) {
+  // read a byte at a time through Read() so the bytes are counted
+  uint64_t result = 0;
+  int shift = 0;
+  unsigned int byte;
+  do {
+    if (!Read8(&byte)) {
+      return false;
+    }
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  *val = result;
+  return true;
+}
+
 void WireDecoder::Realloc(size_t len) {
   // Double current buffer size until we have enough space.
   if (m_allocated >= len) {
@@ -11,7 +11,6 @@
 #include <memory>
 #include <string>
 
-#include <wpi/leb128.h>
 #include <wpi/raw_istream.h>
 
 #include "Log.h"
@@ -19,6 +18,8 @@
 
 namespace nt {
 
+class ArrayDeltaBase;
+
 /* Decodes network data into native representation.
  * This class is designed to read from a raw_istream, which provides a blocking
  * read interface.  There are no provisions in this class for resuming a read
@@ -37,6 +38,15 @@ class WireDecoder {
   /* Get the active protocol revision. */
   unsigned int proto_rev() const { return m_proto_rev; }
 
+  /* Set the last array values received, used to decode delta-encoded array
+   * updates in protocol 3.1.  This must persist across decoders for the
+   * same connection.
+   */
+  void set_delta_base(ArrayDeltaBase* base) { m_delta_base = base; }
+
+  /* Get the last array values received, or nullptr if not set. */
+  ArrayDeltaBase* delta_base() const { return m_delta_base; }
+
   /* Get the logger. */
   wpi::Logger& logger() const { return m_logger; }
 
@@ -50,6 +60,9 @@ class WireDecoder {
 
   void set_error(const char* error) { m_error = error; }
 
+  /* Get the total number of bytes read from the stream. */
+  uint64_t bytes_read() const { return m_bytes_read; }
+
   /* Reads the specified number of bytes.
    * @param buf pointer to read data (output parameter)
    * @param len number of bytes to read
@@ -61,6 +74,7 @@ class WireDecoder {
     }
     *buf = m_buf;
     m_is.read(m_buf, len);
+    m_bytes_read += m_is.read_count();
 #if 0
     if (m_logger.min_level() <= NT_LOG_DEBUG4 && m_logger.HasLogger()) {
       std::ostringstream oss;
@@ -125,7 +139,7 @@ class WireDecoder {
   bool ReadDouble(double* val);
 
   /* Reads an ULEB128-encoded unsigned integer. */
-  bool ReadUleb128(uint64_t* val) { return wpi::ReadUleb128(m_is, val); }
+  bool ReadUleb128(uint64_t* val);
 
   bool ReadType(NT_Type* type);
   bool ReadString(std::string* str);
@@ -141,6 +155,9 @@ class WireDecoder {
   /* Error indicator. */
   const char* m_error;
 
+  /* Delta decoding base (not owned). */
+  ArrayDeltaBase* m_delta_base = nullptr;
+
  private:
   /* Reallocate temporary buffer to specified length. */
   void Realloc(size_t len);
@@ -156,6 +173,9 @@ class WireDecoder {
 
   /* allocated size of temporary buffer */
   size_t m_allocated;
+
+  /* total bytes read */
+  uint64_t m_bytes_read = 0;
 };
 
 }  // namespace nt
@@ -17,6 +17,8 @@
 
 namespace nt {
 
+class ArrayDeltaBase;
+
 /* Encodes native data for network transmission.
  * This class maintains an internal memory buffer for written data so that
  * it can be efficiently bursted to the network after a number of writes
@@ -32,6 +34,14 @@ class WireEncoder {
   /* Get the active protocol revision. */
   unsigned int proto_rev() const { return m_proto_rev; }
 
+  /* Set the last array values sent, used to delta-encode array updates in
+   * protocol 3.1.  If not set, array updates are always sent in full.
+   */
+  void set_delta_base(ArrayDeltaBase* base) { m_delta_base = base; }
+
+  /* Get the last array values sent, or nullptr if not set. */
+  ArrayDeltaBase* delta_base() const { return m_delta_base; }
+
   /* Clears buffer and error indicator. */
   void Reset() {
     m_data.clear();
@@ -76,7 +86,7 @@ class WireEncoder {
   void WriteDouble(double val);
 
   /* Writes an ULEB128-encoded unsigned integer. */
-  void WriteUleb128(uint32_t val);
+  void WriteUleb128(uint64_t val);
 
   void WriteType(NT_Type type);
   void WriteValue(const Value& value);
@@ -99,6 +109,9 @@ class WireEncoder {
   /* Error indicator. */
   const char* m_error;
 
+  /* Delta encoding base (not owned). */
+  ArrayDeltaBase* m_delta_base = nullptr;
+
  private:
   wpi::SmallVector<char, 256> m_data;
 };
@@ -27,6 +27,7 @@ using namespace wpi::java;
 static JavaVM* jvm = nullptr;
 static JClass booleanCls;
 static JClass connectionInfoCls;
+static JClass connectionStatsCls;
 static JClass connectionNotificationCls;
 static JClass doubleCls;
 static JClass entryInfoCls;
@@ -42,6 +43,7 @@ static JException persistentEx;
 static const JClassInit classes[] = {
     {"java/lang/Boolean", &booleanCls},
     {"edu/wpi/first/networktables/ConnectionInfo", &connectionInfoCls},
+    {"edu/wpi/first/networktables/ConnectionStats", &connectionStatsCls},
     {"edu/wpi/first/networktables/ConnectionNotification",
      &connectionNotificationCls},
     {"java/lang/Double", &doubleCls},
@@ -133,18 +135,26 @@ inline std::shared_ptr<nt::Value> FromJavaRpc(JNIEnv* env, jbyteArray jarr,
   return nt::Value::MakeRpc(ref.str(), time);
 }
 
-std::shared_ptr<nt::Value> FromJavaBooleanArray(JNIEnv* env, jbooleanArray jarr,
-                                                jlong time) {
+bool FromJavaBooleanArray(JNIEnv* env, jbooleanArray jarr,
+                          std::vector<int>* arr) {
   CriticalJBooleanArrayRef ref{env, jarr};
   if (!ref) {
-    return nullptr;
+    return false;
   }
   wpi::span<const jboolean> elements{ref};
   size_t len = elements.size();
-  std::vector<int> arr;
-  arr.reserve(len);
+  arr->reserve(len);
   for (size_t i = 0; i < len; ++i) {
-    arr.push_back(elements[i]);
+    arr->push_back(elements[i]);
+  }
+  return true;
+}
+
+std::shared_ptr<nt::Value> FromJavaBooleanArray(JNIEnv* env, jbooleanArray jarr,
+                                                jlong time) {
+  std::vector<int> arr;
+  if (!FromJavaBooleanArray(env, jarr, &arr)) {
+    return nullptr;
   }
   return nt::Value::MakeBooleanArray(arr, time);
 }
@@ -158,18 +168,26 @@ std::shared_ptr<nt::Value> FromJavaDoubleArray(JNIEnv* env, jdoubleArray jarr,
   return nt::Value::MakeDoubleArray(ref, time);
 }
 
-std::shared_ptr<nt::Value> FromJavaStringArray(JNIEnv* env, jobjectArray jarr,
-                                               jlong time) {
+bool FromJavaStringArray(JNIEnv* env, jobjectArray jarr,
+                         std::vector<std::string>* arr) {
   size_t len = env->GetArrayLength(jarr);
-  std::vector<std::string> arr;
-  arr.reserve(len);
+  arr->reserve(len);
   for (size_t i = 0; i < len; ++i) {
     JLocal<jstring> elem{
         env, static_cast<jstring>(env->GetObjectArrayElement(jarr, i))};
     if (!elem) {
-      return nullptr;
+      return false;
     }
-    arr.emplace_back(JStringRef{env, elem}.str());
+    arr->emplace_back(JStringRef{env, elem}.str());
+  }
+  return true;
+}
+
+std::shared_ptr<nt::Value> FromJavaStringArray(JNIEnv* env, jobjectArray jarr,
+                                               jlong time) {
+  std::vector<std::string> arr;
+  if (!FromJavaStringArray(env, jarr, &arr)) {
+    return nullptr;
   }
   return nt::Value::MakeStringArray(std::move(arr), time);
 }
@@ -237,6 +255,34 @@ static jobject MakeJObject(JNIEnv* env, const nt::ConnectionInfo& info) {
                         static_cast<jint>(info.protocol_version));
 }
 
+static jobject MakeJObject(JNIEnv* env, const nt::ConnectionStats& stats) {
+  static jmethodID constructor = env->GetMethodID(
+      connectionStatsCls, "<init>",
+      "(Ledu/wpi/first/networktables/ConnectionInfo;JJJJJJJJJ[J)V");
+  JLocal<jobject> info{env, MakeJObject(env, stats.info)};
+  constexpr int kBuckets = nt::ConnectionStats::kWriteLatencyBuckets;
+  jlong latency[kBuckets];
+  for (int i = 0; i < kBuckets; ++i) {
+    latency[i] = static_cast<jlong>(stats.write_latency[i]);
+  }
+  JLocal<jlongArray> write_latency{env, env->NewLongArray(kBuckets)};
+  if (!write_latency) {
+    return nullptr;
+  }
+  env->SetLongArrayRegion(write_latency, 0, kBuckets, latency);
+  return env->NewObject(
+      connectionStatsCls, constructor, info.obj(),
+      static_cast<jlong>(stats.bytes_sent),
+      static_cast<jlong>(stats.messages_sent),
+      static_cast<jlong>(stats.bytes_received),
+      static_cast<jlong>(stats.messages_received),
+      static_cast<jlong>(stats.messages_coalesced),
+      static_cast<jlong>(stats.queue_high_water),
+      static_cast<jlong>(stats.flushes),
+      static_cast<jlong>(stats.last_post_time),
+      static_cast<jlong>(stats.max_post_time), write_latency.obj());
+}
+
 static jobject MakeJObject(JNIEnv* env, jobject inst,
                            const nt::ConnectionNotification& notification) {
   static jmethodID constructor = env->GetMethodID(
@@ -494,8 +540,7 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_setBoolean
                           nt::Value::MakeBoolean(value != JNI_FALSE, time));
     return JNI_TRUE;
   }
-  return nt::SetEntryValue(entry,
-                           nt::Value::MakeBoolean(value != JNI_FALSE, time));
+  return nt::SetEntryBoolean(entry, value != JNI_FALSE, time);
 }
 
 /*
@@ -511,7 +556,7 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_setDouble
     nt::SetEntryTypeValue(entry, nt::Value::MakeDouble(value, time));
     return JNI_TRUE;
   }
-  return nt::SetEntryValue(entry, nt::Value::MakeDouble(value, time));
+  return nt::SetEntryDouble(entry, value, time);
 }
 
 /*
@@ -532,8 +577,7 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_setString
         entry, nt::Value::MakeString(JStringRef{env, value}.str(), time));
     return JNI_TRUE;
   }
-  return nt::SetEntryValue(
-      entry, nt::Value::MakeString(JStringRef{env, value}.str(), time));
+  return nt::SetEntryString(entry, JStringRef{env, value}.str(), time);
 }
 
 /*
@@ -550,15 +594,19 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_setRaw__IJ_3BZ
     nullPointerEx.Throw(env, "value cannot be null");
     return false;
   }
+  if (!force) {
+    JByteArrayRef ref{env, value};
+    if (!ref) {
+      return false;
+    }
+    return nt::SetEntryRaw(entry, ref.str(), time);
+  }
   auto v = FromJavaRaw(env, value, time);
   if (!v) {
     return false;
   }
-  if (force) {
-    nt::SetEntryTypeValue(entry, v);
-    return JNI_TRUE;
-  }
-  return nt::SetEntryValue(entry, v);
+  nt::SetEntryTypeValue(entry, v);
+  return JNI_TRUE;
 }
 
 /*
@@ -575,15 +623,19 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_setRaw__IJLjava_nio_ByteBuffer
     nullPointerEx.Throw(env, "value cannot be null");
     return false;
   }
+  if (!force) {
+    JByteArrayRef ref{env, value, len};
+    if (!ref) {
+      return false;
+    }
+    return nt::SetEntryRaw(entry, ref.str(), time);
+  }
   auto v = FromJavaRawBB(env, value, len, time);
   if (!v) {
     return false;
   }
-  if (force) {
-    nt::SetEntryTypeValue(entry, v);
-    return JNI_TRUE;
-  }
-  return nt::SetEntryValue(entry, v);
+  nt::SetEntryTypeValue(entry, v);
+  return JNI_TRUE;
 }
 
 /*
@@ -600,15 +652,19 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_setBooleanArray
     nullPointerEx.Throw(env, "value cannot be null");
     return false;
   }
+  if (!force) {
+    std::vector<int> arr;
+    if (!FromJavaBooleanArray(env, value, &arr)) {
+      return false;
+    }
+    return nt::SetEntryBooleanArray(entry, arr, time);
+  }
   auto v = FromJavaBooleanArray(env, value, time);
   if (!v) {
     return false;
   }
-  if (force) {
-    nt::SetEntryTypeValue(entry, v);
-    return JNI_TRUE;
-  }
-  return nt::SetEntryValue(entry, v);
+  nt::SetEntryTypeValue(entry, v);
+  return JNI_TRUE;
 }
 
 /*
@@ -625,15 +681,51 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_setDoubleArray
     nullPointerEx.Throw(env, "value cannot be null");
     return false;
   }
+  if (!force) {
+    return nt::SetEntryDoubleArray(entry, JDoubleArrayRef{env, value}, time);
+  }
   auto v = FromJavaDoubleArray(env, value, time);
   if (!v) {
     return false;
   }
-  if (force) {
-    nt::SetEntryTypeValue(entry, v);
-    return JNI_TRUE;
+  nt::SetEntryTypeValue(entry, v);
+  return JNI_TRUE;
+}
+
+/*
+ * Class:     edu_wpi_first_networktables_NetworkTablesJNI
+ * Method:    setDoubles
+ * Signature: ([IJ[D)Z
+ */
+JNIEXPORT jboolean JNICALL
+Java_edu_wpi_first_networktables_NetworkTablesJNI_setDoubles
+  (JNIEnv* env, jclass, jintArray entries, jlong time, jdoubleArray values)
+{
+  if (!entries) {
+    nullPointerEx.Throw(env, "entries cannot be null");
+    return false;
+  }
+  if (!values) {
+    nullPointerEx.Throw(env, "values cannot be null");
+    return false;
+  }
+  int len = env->GetArrayLength(entries);
+  if (len != env->GetArrayLength(values)) {
+    illegalArgEx.Throw(env, "entries and values arrays must be the same size");
+    return false;
+  }
+  std::vector<std::pair<NT_Entry, std::shared_ptr<nt::Value>>> v;
+  v.reserve(len);
+  {
+    CriticalJIntArrayRef entriesRef{env, entries};
+    CriticalJDoubleArrayRef valuesRef{env, values};
+    auto e = entriesRef.array();
+    auto d = valuesRef.array();
+    for (int i = 0; i < len; ++i) {
+      v.emplace_back(e[i], nt::Value::MakeDouble(d[i], time));
+    }
   }
-  return nt::SetEntryValue(entry, v);
+  return nt::SetEntryValues(v);
 }
 
 /*
@@ -650,15 +742,19 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_setStringArray
     nullPointerEx.Throw(env, "value cannot be null");
     return false;
   }
+  if (!force) {
+    std::vector<std::string> arr;
+    if (!FromJavaStringArray(env, value, &arr)) {
+      return false;
+    }
+    return nt::SetEntryStringArray(entry, arr, time);
+  }
   auto v = FromJavaStringArray(env, value, time);
   if (!v) {
     return false;
   }
-  if (force) {
-    nt::SetEntryTypeValue(entry, v);
-    return JNI_TRUE;
-  }
-  return nt::SetEntryValue(entry, v);
+  nt::SetEntryTypeValue(entry, v);
+  return JNI_TRUE;
 }
 
 /*
@@ -921,6 +1017,18 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_getEntryFlags
   return nt::GetEntryFlags(entry);
 }
 
+/*
+ * Class:     edu_wpi_first_networktables_NetworkTablesJNI
+ * Method:    setEntryQuantization
+ * Signature: (ID)V
+ */
+JNIEXPORT void JNICALL
+Java_edu_wpi_first_networktables_NetworkTablesJNI_setEntryQuantization
+  (JNIEnv*, jclass, jint entry, jdouble quantum)
+{
+  nt::SetEntryQuantization(entry, quantum);
+}
+
 /*
  * Class:     edu_wpi_first_networktables_NetworkTablesJNI
  * Method:    deleteEntry
@@ -1492,6 +1600,30 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_stopServer
   nt::StopServer(inst);
 }
 
+/*
+ * Class:     edu_wpi_first_networktables_NetworkTablesJNI
+ * Method:    setEventLoopServer
+ * Signature: (IZ)V
+ */
+JNIEXPORT void JNICALL
+Java_edu_wpi_first_networktables_NetworkTablesJNI_setEventLoopServer
+  (JNIEnv*, jclass, jint inst, jboolean enabled)
+{
+  nt::SetEventLoopServer(inst, enabled);
+}
+
+/*
+ * Class:     edu_wpi_first_networktables_NetworkTablesJNI
+ * Method:    setPersistentJournal
+ * Signature: (IZ)V
+ */
+JNIEXPORT void JNICALL
+Java_edu_wpi_first_networktables_NetworkTablesJNI_setPersistentJournal
+  (JNIEnv*, jclass, jint inst, jboolean enabled)
+{
+  nt::SetPersistentJournal(inst, enabled);
+}
+
 /*
  * Class:     edu_wpi_first_networktables_NetworkTablesJNI
  * Method:    startClient
@@ -1702,6 +1834,30 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_setUpdateRate
   nt::SetUpdateRate(inst, interval);
 }
 
+/*
+ * Class:     edu_wpi_first_networktables_NetworkTablesJNI
+ * Method:    setLowLatency
+ * Signature: (IZI)V
+ */
+JNIEXPORT void JNICALL
+Java_edu_wpi_first_networktables_NetworkTablesJNI_setLowLatency
+  (JNIEnv*, jclass, jint inst, jboolean enabled, jint minIntervalUs)
+{
+  nt::SetLowLatency(inst, enabled, minIntervalUs);
+}
+
+/*
+ * Class:     edu_wpi_first_networktables_NetworkTablesJNI
+ * Method:    setArrayDeltas
+ * Signature: (IZ)V
+ */
+JNIEXPORT void JNICALL
+Java_edu_wpi_first_networktables_NetworkTablesJNI_setArrayDeltas
+  (JNIEnv*, jclass, jint inst, jboolean enabled)
+{
+  nt::SetArrayDeltas(inst, enabled);
+}
+
 /*
  * Class:     edu_wpi_first_networktables_NetworkTablesJNI
  * Method:    flush
@@ -1736,6 +1892,28 @@ Java_edu_wpi_first_networktables_NetworkTablesJNI_getConnections
   return jarr;
 }
 
+/*
+ * Class:     edu_wpi_first_networktables_NetworkTablesJNI
+ * Method:    getConnectionStats
+ * Signature: (I)[Ljava/lang/Object;
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_edu_wpi_first_networktables_NetworkTablesJNI_getConnectionStats
+  (JNIEnv* env, jclass, jint inst)
+{
+  auto arr = nt::GetConnectionStats(inst);
+  jobjectArray jarr =
+      env->NewObjectArray(arr.size(), connectionStatsCls, nullptr);
+  if (!jarr) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < arr.size(); ++i) {
+    JLocal<jobject> jelem{env, MakeJObject(env, arr[i])};
+    env->SetObjectArrayElement(jarr, i, jelem);
+  }
+  return jarr;
+}
+
 /*
  * Class:     edu_wpi_first_networktables_NetworkTablesJNI
  * Method:    isConnected
@@ -4,9 +4,11 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
+#include <iterator>
 #include <string_view>
 
 #include <wpi/MemAlloc.h>
@@ -41,6 +43,23 @@ static void ConvertToC(const ConnectionInfo& in, NT_ConnectionInfo* out) {
   out->protocol_version = in.protocol_version;
 }
 
+static void ConvertToC(const ConnectionStats& in, NT_ConnectionStats* out) {
+  ConvertToC(in.info, &out->info);
+  out->bytes_sent = in.bytes_sent;
+  out->messages_sent = in.messages_sent;
+  out->bytes_received = in.bytes_received;
+  out->messages_received = in.messages_received;
+  out->messages_coalesced = in.messages_coalesced;
+  out->queue_high_water = in.queue_high_water;
+  out->flushes = in.flushes;
+  out->last_post_time = in.last_post_time;
+  out->max_post_time = in.max_post_time;
+  static_assert(ConnectionStats::kWriteLatencyBuckets ==
+                NT_WRITE_LATENCY_BUCKETS);
+  std::copy(std::begin(in.write_latency), std::end(in.write_latency),
+            out->write_latency);
+}
+
 static void ConvertToC(const RpcParamDef& in, NT_RpcParamDef* out) {
   ConvertToC(in.name, &out->name);
   ConvertToC(*in.def_value, &out->def_value);
@@ -245,6 +264,16 @@ int NT_SetEntryValue(NT_Entry entry, const struct NT_Value* value) {
   return nt::SetEntryValue(entry, ConvertFromC(*value));
 }
 
+int NT_SetEntryValues(const NT_Entry* entries, const struct NT_Value* values,
+                      size_t count) {
+  std::vector<std::pair<NT_Entry, std::shared_ptr<Value>>> v;
+  v.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    v.emplace_back(entries[i], ConvertFromC(values[i]));
+  }
+  return nt::SetEntryValues(v);
+}
+
 void NT_SetEntryTypeValue(NT_Entry entry, const struct NT_Value* value) {
   nt::SetEntryTypeValue(entry, ConvertFromC(*value));
 }
@@ -257,6 +286,10 @@ unsigned int NT_GetEntryFlags(NT_Entry entry) {
   return nt::GetEntryFlags(entry);
 }
 
+void NT_SetEntryQuantization(NT_Entry entry, double quantum) {
+  nt::SetEntryQuantization(entry, quantum);
+}
+
 void NT_DeleteEntry(NT_Entry entry) {
   nt::DeleteEntry(entry);
 }
@@ -595,6 +628,14 @@ void NT_StopServer(NT_Inst inst) {
   nt::StopServer(inst);
 }
 
+void NT_SetEventLoopServer(NT_Inst inst, NT_Bool enabled) {
+  nt::SetEventLoopServer(inst, enabled);
+}
+
+void NT_SetPersistentJournal(NT_Inst inst, NT_Bool enabled) {
+  nt::SetPersistentJournal(inst, enabled);
+}
+
 void NT_StartClientNone(NT_Inst inst) {
   nt::StartClient(inst);
 }
@@ -651,6 +692,15 @@ void NT_SetUpdateRate(NT_Inst inst, double interval) {
   nt::SetUpdateRate(inst, interval);
 }
 
+void NT_SetLowLatency(NT_Inst inst, NT_Bool enabled,
+                      unsigned int min_interval_us) {
+  nt::SetLowLatency(inst, enabled, min_interval_us);
+}
+
+void NT_SetArrayDeltas(NT_Inst inst, NT_Bool enabled) {
+  nt::SetArrayDeltas(inst, enabled);
+}
+
 void NT_Flush(NT_Inst inst) {
   nt::Flush(inst);
 }
@@ -659,11 +709,32 @@ NT_Bool NT_IsConnected(NT_Inst inst) {
   return nt::IsConnected(inst);
 }
 
+void NT_GetPersistentSaveMetrics(NT_Inst inst,
+                                 struct NT_PersistentSaveMetrics* metrics) {
+  auto m = nt::GetPersistentSaveMetrics(inst);
+  metrics->saves = m.saves;
+  metrics->journal_writes = m.journal_writes;
+  metrics->journal_records = m.journal_records;
+  metrics->journal_size = m.journal_size;
+  metrics->errors = m.errors;
+  metrics->last_save_time = m.last_save_time;
+  metrics->max_save_time = m.max_save_time;
+  metrics->last_journal_time = m.last_journal_time;
+  metrics->max_journal_time = m.max_journal_time;
+  metrics->last_dispatch_time = m.last_dispatch_time;
+  metrics->max_dispatch_time = m.max_dispatch_time;
+}
+
 struct NT_ConnectionInfo* NT_GetConnections(NT_Inst inst, size_t* count) {
   auto conn_v = nt::GetConnections(inst);
   return ConvertToC<NT_ConnectionInfo>(conn_v, count);
 }
 
+struct NT_ConnectionStats* NT_GetConnectionStats(NT_Inst inst, size_t* count) {
+  auto stats_v = nt::GetConnectionStats(inst);
+  return ConvertToC<NT_ConnectionStats>(stats_v, count);
+}
+
 /*
  * File Save/Load Functions
  */
@@ -805,6 +876,13 @@ void NT_DisposeConnectionInfoArray(NT_ConnectionInfo* arr, size_t count) {
   std::free(arr);
 }
 
+void NT_DisposeConnectionStatsArray(NT_ConnectionStats* arr, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    DisposeConnectionInfo(&arr[i].info);
+  }
+  std::free(arr);
+}
+
 void NT_DisposeEntryInfoArray(NT_EntryInfo* arr, size_t count) {
   for (size_t i = 0; i < count; i++) {
     DisposeEntryInfo(&arr[i]);
@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
@@ -149,6 +150,108 @@ bool SetEntryValue(NT_Entry entry, std::shared_ptr<Value> value) {
   return ii->storage.SetEntryValue(id, value);
 }
 
+bool SetEntryValues(
+    wpi::span<const std::pair<NT_Entry, std::shared_ptr<Value>>> values) {
+  bool ok = true;
+  // batch consecutive entries from the same instance
+  std::vector<std::pair<unsigned int, std::shared_ptr<Value>>> batch;
+  batch.reserve(values.size());
+  int batch_inst = -1;
+  auto flush = [&] {
+    if (!batch.empty()) {
+      if (!InstanceImpl::Get(batch_inst)->storage.SetEntryValues(batch)) {
+        ok = false;
+      }
+      batch.clear();
+    }
+  };
+
+  for (auto&& [entry, value] : values) {
+    Handle handle{entry};
+    int id = handle.GetTypedIndex(Handle::kEntry);
+    int inst = handle.GetInst();
+    if (id < 0 || !InstanceImpl::Get(inst)) {
+      ok = false;
+      continue;
+    }
+    if (inst != batch_inst) {
+      flush();
+      batch_inst = inst;
+    }
+    batch.emplace_back(id, value);
+  }
+  flush();
+  return ok;
+}
+
+static bool SetEntryValueIfChanged(
+    NT_Entry entry, NT_Type type,
+    wpi::function_ref<bool(const Value& value)> equal,
+    wpi::function_ref<std::shared_ptr<Value>()> make) {
+  Handle handle{entry};
+  int id = handle.GetTypedIndex(Handle::kEntry);
+  auto ii = InstanceImpl::Get(handle.GetInst());
+  if (id < 0 || !ii) {
+    return false;
+  }
+
+  return ii->storage.SetEntryValue(id, type, equal, make);
+}
+
+bool SetEntryBoolean(NT_Entry entry, bool value, uint64_t time) {
+  return SetEntryValueIfChanged(
+      entry, NT_BOOLEAN,
+      [&](const Value& v) { return v.GetBoolean() == value; },
+      [&] { return Value::MakeBoolean(value, time); });
+}
+
+bool SetEntryDouble(NT_Entry entry, double value, uint64_t time) {
+  return SetEntryValueIfChanged(
+      entry, NT_DOUBLE, [&](const Value& v) { return v.GetDouble() == value; },
+      [&] { return Value::MakeDouble(value, time); });
+}
+
+bool SetEntryString(NT_Entry entry, std::string_view value, uint64_t time) {
+  return SetEntryValueIfChanged(
+      entry, NT_STRING, [&](const Value& v) { return v.GetString() == value; },
+      [&] { return Value::MakeString(value, time); });
+}
+
+bool SetEntryRaw(NT_Entry entry, std::string_view value, uint64_t time) {
+  return SetEntryValueIfChanged(
+      entry, NT_RAW, [&](const Value& v) { return v.GetRaw() == value; },
+      [&] { return Value::MakeRaw(value, time); });
+}
+
+template <typename T>
+static bool SpanEqual(wpi::span<const T> a, wpi::span<const T> b) {
+  return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+bool SetEntryBooleanArray(NT_Entry entry, wpi::span<const int> value,
+                          uint64_t time) {
+  return SetEntryValueIfChanged(
+      entry, NT_BOOLEAN_ARRAY,
+      [&](const Value& v) { return SpanEqual(v.GetBooleanArray(), value); },
+      [&] { return Value::MakeBooleanArray(value, time); });
+}
+
+bool SetEntryDoubleArray(NT_Entry entry, wpi::span<const double> value,
+                         uint64_t time) {
+  return SetEntryValueIfChanged(
+      entry, NT_DOUBLE_ARRAY,
+      [&](const Value& v) { return SpanEqual(v.GetDoubleArray(), value); },
+      [&] { return Value::MakeDoubleArray(value, time); });
+}
+
+bool SetEntryStringArray(NT_Entry entry, wpi::span<const std::string> value,
+                         uint64_t time) {
+  return SetEntryValueIfChanged(
+      entry, NT_STRING_ARRAY,
+      [&](const Value& v) { return SpanEqual(v.GetStringArray(), value); },
+      [&] { return Value::MakeStringArray(value, time); });
+}
+
 void SetEntryTypeValue(NT_Entry entry, std::shared_ptr<Value> value) {
   Handle handle{entry};
   int id = handle.GetTypedIndex(Handle::kEntry);
@@ -182,6 +285,17 @@ unsigned int GetEntryFlags(NT_Entry entry) {
   return ii->storage.GetEntryFlags(id);
 }
 
+void SetEntryQuantization(NT_Entry entry, double quantum) {
+  Handle handle{entry};
+  int id = handle.GetTypedIndex(Handle::kEntry);
+  auto ii = InstanceImpl::Get(handle.GetInst());
+  if (id < 0 || !ii) {
+    return;
+  }
+
+  ii->storage.SetEntryQuantization(id, quantum);
+}
+
 void DeleteEntry(NT_Entry entry) {
   Handle handle{entry};
   int id = handle.GetTypedIndex(Handle::kEntry);
@@ -879,6 +993,24 @@ void StopServer(NT_Inst inst) {
   ii->dispatcher.Stop();
 }
 
+void SetEventLoopServer(NT_Inst inst, bool enabled) {
+  auto ii = InstanceImpl::Get(Handle{inst}.GetTypedInst(Handle::kInstance));
+  if (!ii) {
+    return;
+  }
+
+  ii->dispatcher.SetEventLoopServer(enabled);
+}
+
+void SetPersistentJournal(NT_Inst inst, bool enabled) {
+  auto ii = InstanceImpl::Get(Handle{inst}.GetTypedInst(Handle::kInstance));
+  if (!ii) {
+    return;
+  }
+
+  ii->dispatcher.SetPersistentJournal(enabled);
+}
+
 void StartClient(NT_Inst inst) {
   auto ii = InstanceImpl::Get(Handle{inst}.GetTypedInst(Handle::kInstance));
   if (!ii) {
@@ -985,6 +1117,24 @@ void SetUpdateRate(NT_Inst inst, double interval) {
   ii->dispatcher.SetUpdateRate(interval);
 }
 
+void SetLowLatency(NT_Inst inst, bool enabled, unsigned int min_interval_us) {
+  auto ii = InstanceImpl::Get(Handle{inst}.GetTypedInst(Handle::kInstance));
+  if (!ii) {
+    return;
+  }
+
+  ii->dispatcher.SetLowLatency(enabled, min_interval_us);
+}
+
+void SetArrayDeltas(NT_Inst inst, bool enabled) {
+  auto ii = InstanceImpl::Get(Handle{inst}.GetTypedInst(Handle::kInstance));
+  if (!ii) {
+    return;
+  }
+
+  ii->dispatcher.SetArrayDeltas(enabled);
+}
+
 void Flush(NT_Inst inst) {
   auto ii = InstanceImpl::Get(Handle{inst}.GetTypedInst(Handle::kInstance));
   if (!ii) {
@@ -1012,6 +1162,24 @@ bool IsConnected(NT_Inst inst) {
   return ii->dispatcher.IsConnected();
 }
 
+PersistentSaveMetrics GetPersistentSaveMetrics(NT_Inst inst) {
+  auto ii = InstanceImpl::Get(Handle{inst}.GetTypedInst(Handle::kInstance));
+  if (!ii) {
+    return {};
+  }
+
+  return ii->dispatcher.GetPersistentSaveMetrics();
+}
+
+std::vector<ConnectionStats> GetConnectionStats(NT_Inst inst) {
+  auto ii = InstanceImpl::Get(Handle{inst}.GetTypedInst(Handle::kInstance));
+  if (!ii) {
+    return {};
+  }
+
+  return ii->dispatcher.GetConnectionStats();
+}
+
 /*
  * Persistent Functions
  */
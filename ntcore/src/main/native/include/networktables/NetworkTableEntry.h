@@ -549,6 +549,14 @@ class NetworkTableEntry final {
    */
   void ClearFlags(unsigned int flags);
 
+  /**
+   * Sets the quantization step for double array updates sent with array
+   * deltas.
+   *
+   * @param quantum the quantization step (0 to send exact values)
+   */
+  void SetQuantization(double quantum);
+
   /**
    * Make value persistent through program restarts.
    */
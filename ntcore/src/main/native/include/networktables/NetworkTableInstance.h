@@ -322,6 +322,28 @@ class NetworkTableInstance final {
    */
   void StopServer();
 
+  /**
+   * Select the server connection backend.
+   * When enabled, the server accepts and services all client connections on
+   * a single event loop thread instead of using a read and a write thread per
+   * client.  This reduces thread count and context switching when many
+   * clients are connected.  Takes effect the next time the server is started.
+   *
+   * @param enabled true to use the event loop backend
+   */
+  void SetEventLoopServer(bool enabled);
+
+  /**
+   * Select how the server saves persistent values.
+   * When enabled, the server appends changed persistent values to a journal
+   * file ("<persist_filename>.journal") from a background thread, and only
+   * rewrites the whole persistent file when the journal grows larger than it.
+   * Takes effect the next time the server is started.
+   *
+   * @param enabled true to journal persistent values
+   */
+  void SetPersistentJournal(bool enabled);
+
   /**
    * Starts a client.  Use SetServer to set the server name and port.
    */
@@ -426,6 +448,29 @@ class NetworkTableInstance final {
    */
   void SetUpdateRate(double interval);
 
+  /**
+   * Enable or disable low-latency updates.
+   * When enabled, local entry changes are sent to other nodes as soon as they
+   * are made rather than on the next periodic update.  Changes made less than
+   * the minimum interval after the previous transmission to a node are
+   * coalesced and sent together once the interval has elapsed.
+   *
+   * @param enabled true to enable low-latency updates
+   * @param min_interval_us minimum time between transmissions to a node, in
+   *                        microseconds (maximum 1 second)
+   */
+  void SetLowLatency(bool enabled, unsigned int min_interval_us);
+
+  /**
+   * Enable or disable delta-encoded array updates.
+   * When enabled, this instance requests protocol revision 3.1 when operating
+   * as a client, which sends changes to boolean and double arrays as the
+   * changed elements only.  Takes effect on the next connection.
+   *
+   * @param enabled true to request array deltas
+   */
+  void SetArrayDeltas(bool enabled);
+
   /**
    * Flushes all updated values immediately to the network.
    * @note This is rate-limited to protect the network from flooding.
@@ -442,6 +487,14 @@ class NetworkTableInstance final {
    */
   std::vector<ConnectionInfo> GetConnections() const;
 
+  /**
+   * Get statistics for the currently established network connections.
+   * If operating as a client, this will return either zero or one values.
+   *
+   * @return array of connection statistics
+   */
+  std::vector<ConnectionStats> GetConnectionStats() const;
+
   /**
    * Return whether or not the instance is connected to another node.
    *
@@ -449,6 +502,14 @@ class NetworkTableInstance final {
    */
   bool IsConnected() const;
 
+  /**
+   * Get persistent save metrics.  These cover the periodic saves performed by
+   * the server since the instance was created.
+   *
+   * @return persistent save metrics
+   */
+  PersistentSaveMetrics GetPersistentSaveMetrics() const;
+
   /** @} */
 
   /**
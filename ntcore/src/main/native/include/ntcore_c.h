@@ -185,6 +185,85 @@ struct NT_ConnectionInfo {
   unsigned int protocol_version;
 };
 
+/**
+ * NetworkTables Persistent Save Metrics.  Times are in microseconds.
+ */
+struct NT_PersistentSaveMetrics {
+  /** The number of times the journal rewrote the persistent file. */
+  uint64_t saves;
+
+  /** The number of journal appends. */
+  uint64_t journal_writes;
+
+  /** The number of entry records appended to the journal. */
+  uint64_t journal_records;
+
+  /** The current size of the journal, in bytes. */
+  uint64_t journal_size;
+
+  /** The number of failed file or journal writes. */
+  uint64_t errors;
+
+  /** The duration of the last and longest of those rewrites. */
+  uint64_t last_save_time;
+  uint64_t max_save_time;
+
+  /** The duration of the last and longest journal appends. */
+  uint64_t last_journal_time;
+  uint64_t max_journal_time;
+
+  /**
+   * The last and longest time the dispatch thread spent on a periodic save.
+   * Without journaling, this is the full file write; with journaling, it only
+   * includes collecting the changed entries.
+   */
+  uint64_t last_dispatch_time;
+  uint64_t max_dispatch_time;
+};
+
+/** The number of NT_ConnectionStats write latency histogram buckets. */
+#define NT_WRITE_LATENCY_BUCKETS 7
+
+/**
+ * NetworkTables Connection Statistics.  Counters cover the lifetime of the
+ * connection; times are in microseconds.
+ */
+struct NT_ConnectionStats {
+  /** The connection. */
+  struct NT_ConnectionInfo info;
+
+  /** The number of bytes and messages written to the remote node. */
+  uint64_t bytes_sent;
+  uint64_t messages_sent;
+
+  /** The number of bytes and messages received from the remote node. */
+  uint64_t bytes_received;
+  uint64_t messages_received;
+
+  /**
+   * The number of queued messages replaced by a later message for the same
+   * entry before being sent.
+   */
+  uint64_t messages_coalesced;
+
+  /** The largest number of messages queued between posts. */
+  uint64_t queue_high_water;
+
+  /** The number of times queued messages were posted for transmission. */
+  uint64_t flushes;
+
+  /** The duration of the last and longest post of queued messages. */
+  uint64_t last_post_time;
+  uint64_t max_post_time;
+
+  /**
+   * Histogram of write latencies.  Bucket i counts writes that completed in
+   * less than 10^(i+1) microseconds; the last bucket counts all longer
+   * writes.
+   */
+  uint64_t write_latency[NT_WRITE_LATENCY_BUCKETS];
+};
+
 /** NetworkTables RPC Version 1 Definition Parameter */
 struct NT_RpcParamDef {
   struct NT_String name;
@@ -405,6 +484,22 @@ NT_Bool NT_SetDefaultEntryValue(NT_Entry entry,
  */
 NT_Bool NT_SetEntryValue(NT_Entry entry, const struct NT_Value* value);
 
+/**
+ * Set Entry Values.
+ *
+ * Sets several entry values at once.  The values are applied together,
+ * listeners are notified as one batch, and the updates are sent together on
+ * the wire.  A value whose type differs from the type of the currently
+ * stored entry is not set.
+ *
+ * @param entries   array of entry handles
+ * @param values    array of new entry values (same length as entries)
+ * @param count     number of entries
+ * @return 0 if any value was not set (error), 1 on success
+ */
+NT_Bool NT_SetEntryValues(const NT_Entry* entries,
+                          const struct NT_Value* values, size_t count);
+
 /**
  * Set Entry Type and Value.
  *
@@ -436,6 +531,18 @@ void NT_SetEntryFlags(NT_Entry entry, unsigned int flags);
  */
 unsigned int NT_GetEntryFlags(NT_Entry entry);
 
+/**
+ * Set Entry Quantization.
+ *
+ * Sets the step size used to quantize double array updates sent to nodes
+ * that negotiated array deltas (see NT_SetArrayDeltas()).  Zero (the default)
+ * sends exact values.
+ *
+ * @param entry     entry handle
+ * @param quantum   quantization step (0 to disable)
+ */
+void NT_SetEntryQuantization(NT_Entry entry, double quantum);
+
 /**
  * Delete Entry.
  *
@@ -1068,6 +1175,30 @@ void NT_StartServer(NT_Inst inst, const char* persist_filename,
  */
 void NT_StopServer(NT_Inst inst);
 
+/**
+ * Select the server connection backend.
+ * When enabled, the server accepts and services all client connections on a
+ * single event loop thread instead of using a read and a write thread per
+ * client.  This reduces thread count and context switching when many clients
+ * are connected.  Takes effect the next time the server is started.
+ *
+ * @param inst     instance handle
+ * @param enabled  true to use the event loop backend
+ */
+void NT_SetEventLoopServer(NT_Inst inst, NT_Bool enabled);
+
+/**
+ * Select how the server saves persistent values.
+ * When enabled, the server appends changed persistent values to a journal
+ * file ("<persist_filename>.journal") from a background thread, and only
+ * rewrites the whole persistent file when the journal grows larger than it.
+ * Takes effect the next time the server is started.
+ *
+ * @param inst     instance handle
+ * @param enabled  true to journal persistent values
+ */
+void NT_SetPersistentJournal(NT_Inst inst, NT_Bool enabled);
+
 /**
  * Starts a client.  Use NT_SetServer to set the server name and port.
  *
@@ -1171,6 +1302,32 @@ void NT_StopDSClient(NT_Inst inst);
  */
 void NT_SetUpdateRate(NT_Inst inst, double interval);
 
+/**
+ * Enable or disable low-latency updates.
+ * When enabled, local entry changes are sent to other nodes as soon as they
+ * are made rather than on the next periodic update (see NT_SetUpdateRate()).
+ * Changes made less than the minimum interval after the previous transmission
+ * to a node are coalesced and sent together once the interval has elapsed.
+ *
+ * @param inst             instance handle
+ * @param enabled          true to enable low-latency updates
+ * @param min_interval_us  minimum time between transmissions to a node, in
+ *                         microseconds (maximum 1 second)
+ */
+void NT_SetLowLatency(NT_Inst inst, NT_Bool enabled,
+                      unsigned int min_interval_us);
+
+/**
+ * Enable or disable delta-encoded array updates.
+ * When enabled, clients request protocol revision 3.1, which sends changes to
+ * boolean and double arrays as the changed elements only.  Takes effect on
+ * the next connection.
+ *
+ * @param inst      instance handle
+ * @param enabled   true to request array deltas
+ */
+void NT_SetArrayDeltas(NT_Inst inst, NT_Bool enabled);
+
 /**
  * Flush Entries.
  *
@@ -1207,6 +1364,29 @@ struct NT_ConnectionInfo* NT_GetConnections(NT_Inst inst, size_t* count);
  */
 NT_Bool NT_IsConnected(NT_Inst inst);
 
+/**
+ * Get persistent save metrics.  These cover the periodic saves performed by
+ * the server since the instance was created.
+ *
+ * @param inst     instance handle
+ * @param metrics  returns the persistent save metrics
+ */
+void NT_GetPersistentSaveMetrics(NT_Inst inst,
+                                 struct NT_PersistentSaveMetrics* metrics);
+
+/**
+ * Get statistics for the currently established network connections.
+ * If operating as a client, this will return either zero or one values.
+ *
+ * @param inst  instance handle
+ * @param count returns the number of elements in the array
+ * @return      array of connection statistics
+ *
+ * It is the caller's responsibility to free the array. The
+ * NT_DisposeConnectionStatsArray function is useful for this purpose.
+ */
+struct NT_ConnectionStats* NT_GetConnectionStats(NT_Inst inst, size_t* count);
+
 /** @} */
 
 /**
@@ -1319,6 +1499,15 @@ void NT_DisposeEntryArray(NT_Entry* arr, size_t count);
  */
 void NT_DisposeConnectionInfoArray(struct NT_ConnectionInfo* arr, size_t count);
 
+/**
+ * Disposes a connection statistics array.
+ *
+ * @param arr   pointer to the array to dispose
+ * @param count number of elements in the array
+ */
+void NT_DisposeConnectionStatsArray(struct NT_ConnectionStats* arr,
+                                    size_t count);
+
 /**
  * Disposes an entry info array.
  *
@@ -94,6 +94,85 @@ struct ConnectionInfo {
   }
 };
 
+/**
+ * NetworkTables Persistent Save Metrics.  Times are in microseconds.
+ */
+struct PersistentSaveMetrics {
+  /** The number of times the journal rewrote the persistent file. */
+  uint64_t saves{0};
+
+  /** The number of journal appends. */
+  uint64_t journal_writes{0};
+
+  /** The number of entry records appended to the journal. */
+  uint64_t journal_records{0};
+
+  /** The current size of the journal, in bytes. */
+  uint64_t journal_size{0};
+
+  /** The number of failed file or journal writes. */
+  uint64_t errors{0};
+
+  /** The duration of the last and longest of those rewrites. */
+  uint64_t last_save_time{0};
+  uint64_t max_save_time{0};
+
+  /** The duration of the last and longest journal appends. */
+  uint64_t last_journal_time{0};
+  uint64_t max_journal_time{0};
+
+  /**
+   * The last and longest time the dispatch thread spent on a periodic save.
+   * Without journaling, this is the full file write; with journaling, it only
+   * includes collecting the changed entries.
+   */
+  uint64_t last_dispatch_time{0};
+  uint64_t max_dispatch_time{0};
+};
+
+/**
+ * NetworkTables Connection Statistics.  Counters cover the lifetime of the
+ * connection; times are in microseconds.
+ */
+struct ConnectionStats {
+  /** The number of write latency histogram buckets. */
+  static constexpr int kWriteLatencyBuckets = 7;
+
+  /** The connection. */
+  ConnectionInfo info;
+
+  /** The number of bytes and messages written to the remote node. */
+  uint64_t bytes_sent{0};
+  uint64_t messages_sent{0};
+
+  /** The number of bytes and messages received from the remote node. */
+  uint64_t bytes_received{0};
+  uint64_t messages_received{0};
+
+  /**
+   * The number of queued messages replaced by a later message for the same
+   * entry before being sent.
+   */
+  uint64_t messages_coalesced{0};
+
+  /** The largest number of messages queued between posts. */
+  uint64_t queue_high_water{0};
+
+  /** The number of times queued messages were posted for transmission. */
+  uint64_t flushes{0};
+
+  /** The duration of the last and longest post of queued messages. */
+  uint64_t last_post_time{0};
+  uint64_t max_post_time{0};
+
+  /**
+   * Histogram of write latencies.  Bucket i counts writes that completed in
+   * less than 10^(i+1) microseconds; the last bucket counts all longer
+   * writes.
+   */
+  uint64_t write_latency[kWriteLatencyBuckets]{};
+};
+
 /** NetworkTables RPC Version 1 Definition Parameter */
 struct RpcParamDef {
   RpcParamDef() = default;
@@ -407,6 +486,48 @@ bool SetDefaultEntryValue(NT_Entry entry, std::shared_ptr<Value> value);
  */
 bool SetEntryValue(NT_Entry entry, std::shared_ptr<Value> value);
 
+/**
+ * Set Entry Values.
+ *
+ * Sets several entry values at once, e.g. a whole loop's worth of telemetry.
+ * The values are applied together under a single storage lock, listeners
+ * are notified as one batch, and the updates are sent together on the wire.
+ * As with SetEntryValue(), a value whose type differs from the type of the
+ * currently stored entry is not set.
+ *
+ * @param values    entry handles and new entry values
+ * @return False if any value was not set (error), True on success
+ */
+bool SetEntryValues(
+    wpi::span<const std::pair<NT_Entry, std::shared_ptr<Value>>> values);
+
+/**
+ * @{
+ * @name Typed Entry Setters
+ *
+ * Typed versions of SetEntryValue().  The new value is compared with the
+ * currently stored value first, and a Value is only created if it differs, so
+ * setting an unchanged value does not allocate or take the storage lock.
+ * As with SetEntryValue(), if the type of the new value differs from the type
+ * of the currently stored entry, returns error and does not update value.
+ *
+ * @param entry     entry handle
+ * @param value     new entry value
+ * @param time      time stamp for the new value (0 for now)
+ * @return False on error (type mismatch), True on success
+ */
+bool SetEntryBoolean(NT_Entry entry, bool value, uint64_t time = 0);
+bool SetEntryDouble(NT_Entry entry, double value, uint64_t time = 0);
+bool SetEntryString(NT_Entry entry, std::string_view value, uint64_t time = 0);
+bool SetEntryRaw(NT_Entry entry, std::string_view value, uint64_t time = 0);
+bool SetEntryBooleanArray(NT_Entry entry, wpi::span<const int> value,
+                          uint64_t time = 0);
+bool SetEntryDoubleArray(NT_Entry entry, wpi::span<const double> value,
+                         uint64_t time = 0);
+bool SetEntryStringArray(NT_Entry entry, wpi::span<const std::string> value,
+                         uint64_t time = 0);
+/** @} */
+
 /**
  * Set Entry Type and Value.
  *
@@ -438,6 +559,19 @@ void SetEntryFlags(NT_Entry entry, unsigned int flags);
  */
 unsigned int GetEntryFlags(NT_Entry entry);
 
+/**
+ * Set Entry Quantization.
+ *
+ * Sets the step size used to quantize double array updates sent to nodes
+ * that negotiated array deltas (see SetArrayDeltas()).  Changed elements are
+ * sent as integer multiples of the quantum, so remote nodes see values
+ * rounded to the nearest multiple.  Zero (the default) sends exact values.
+ *
+ * @param entry     entry handle
+ * @param quantum   quantization step (0 to disable)
+ */
+void SetEntryQuantization(NT_Entry entry, double quantum);
+
 /**
  * Delete Entry.
  *
@@ -1025,6 +1159,31 @@ void StartServer(NT_Inst inst, std::string_view persist_filename,
  */
 void StopServer(NT_Inst inst);
 
+/**
+ * Select the server connection backend.
+ * When enabled, the server accepts and services all client connections on a
+ * single event loop thread instead of using a read and a write thread per
+ * client.  This reduces thread count and context switching when many clients
+ * are connected.  Takes effect the next time the server is started.
+ *
+ * @param inst     instance handle
+ * @param enabled  true to use the event loop backend
+ */
+void SetEventLoopServer(NT_Inst inst, bool enabled);
+
+/**
+ * Select how the server saves persistent values.
+ * When enabled, the server appends changed persistent values to a journal
+ * file ("<persist_filename>.journal") from a background thread, and only
+ * rewrites the whole persistent file when the journal grows larger than it.
+ * The journal is applied when the persistent file is next loaded.  Takes
+ * effect the next time the server is started.
+ *
+ * @param inst     instance handle
+ * @param enabled  true to journal persistent values
+ */
+void SetPersistentJournal(NT_Inst inst, bool enabled);
+
 /**
  * Starts a client.  Use SetServer to set the server name and port.
  *
@@ -1125,6 +1284,33 @@ void StopDSClient(NT_Inst inst);
  */
 void SetUpdateRate(NT_Inst inst, double interval);
 
+/**
+ * Enable or disable low-latency updates.
+ * When enabled, local entry changes are sent to other nodes as soon as they
+ * are made rather than on the next periodic update (see SetUpdateRate()).
+ * Changes made less than the minimum interval after the previous transmission
+ * to a node are coalesced and sent together once the interval has elapsed.
+ *
+ * @param inst             instance handle
+ * @param enabled          true to enable low-latency updates
+ * @param min_interval_us  minimum time between transmissions to a node, in
+ *                         microseconds (maximum 1 second)
+ */
+void SetLowLatency(NT_Inst inst, bool enabled, unsigned int min_interval_us);
+
+/**
+ * Enable or disable delta-encoded array updates.
+ * When enabled, clients request protocol revision 3.1, which sends changes to
+ * boolean and double arrays as the changed elements only (optionally
+ * quantized, see SetEntryQuantization()).  Servers always accept 3.1 clients;
+ * this setting only affects what a client requests.  Takes effect on the next
+ * connection.
+ *
+ * @param inst      instance handle
+ * @param enabled   true to request array deltas
+ */
+void SetArrayDeltas(NT_Inst inst, bool enabled);
+
 /**
  * Flush Entries.
  *
@@ -1157,6 +1343,24 @@ std::vector<ConnectionInfo> GetConnections(NT_Inst inst);
  */
 bool IsConnected(NT_Inst inst);
 
+/**
+ * Get persistent save metrics.  These cover the periodic saves performed by
+ * the server since the instance was created.
+ *
+ * @param inst  instance handle
+ * @return      persistent save metrics
+ */
+PersistentSaveMetrics GetPersistentSaveMetrics(NT_Inst inst);
+
+/**
+ * Get statistics for the currently established network connections.
+ * If operating as a client, this will return either zero or one values.
+ *
+ * @param inst  instance handle
+ * @return      array of connection statistics
+ */
+std::vector<ConnectionStats> GetConnectionStats(NT_Inst inst);
+
 /** @} */
 
 /**
@@ -0,0 +1,211 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <wpi/MathExtras.h>
+#include <wpi/raw_istream.h>
+
+#include "ArrayDeltaBase.h"
+#include "Log.h"
+#include "Message.h"
+#include "TestPrinters.h"
+#include "WireDecoder.h"
+#include "WireEncoder.h"
+#include "gtest/gtest.h"
+
+namespace nt {
+
+// Encodes messages through one delta base and decodes them through another,
+// as the two ends of a connection do.
+class ArrayDeltaTest : public ::testing::Test {
+ protected:
+  explicit ArrayDeltaTest(unsigned int proto_rev = 0x0301u)
+      : encoder(proto_rev), proto_rev(proto_rev) {
+    encoder.set_delta_base(&send_base);
+  }
+
+  std::shared_ptr<Message> RoundTrip(std::shared_ptr<Message> msg) {
+    encoder.Reset();
+    msg->Write(encoder);
+    EXPECT_EQ(nullptr, encoder.error());
+    wire.assign(encoder.data(), encoder.data() + encoder.size());
+
+    const char* error = nullptr;
+    auto out = Decode(&error);
+    EXPECT_EQ(nullptr, error);
+    return out;
+  }
+
+  // Decodes the message in wire.
+  std::shared_ptr<Message> Decode(const char** error) {
+    wpi::raw_mem_istream is(wire.data(), wire.size());
+    wpi::Logger logger;
+    WireDecoder decoder(is, proto_rev, logger);
+    decoder.set_delta_base(&recv_base);
+    auto out = Message::Read(decoder, [&](unsigned int) { return type; });
+    *error = decoder.error();
+    return out;
+  }
+
+  WireEncoder encoder;
+  unsigned int proto_rev;
+  ArrayDeltaBase send_base;
+  ArrayDeltaBase recv_base;
+  std::vector<char> wire;
+  NT_Type type = NT_UNASSIGNED;
+};
+
+TEST_F(ArrayDeltaTest, DoubleArrayChangedElement) {
+  std::vector<double> arr(32, 1.5);
+  type = NT_DOUBLE_ARRAY;
+  RoundTrip(Message::EntryAssign("a", 1, 1, Value::MakeDoubleArray(arr), 0));
+
+  arr[7] = 2.25;
+  auto value = Value::MakeDoubleArray(arr);
+  auto out = RoundTrip(Message::EntryUpdate(1, 2, value));
+  ASSERT_TRUE(out);
+  EXPECT_EQ(Message::kEntryDeltaUpdate, static_cast<unsigned char>(wire[0]));
+  EXPECT_LT(wire.size(), 1u + 2 + 2 + 1 + encoder.GetValueSize(*value));
+  EXPECT_EQ(Message::kEntryUpdate, out->type());
+  EXPECT_EQ(1u, out->id());
+  EXPECT_EQ(2u, out->seq_num_uid());
+  ASSERT_TRUE(out->value());
+  EXPECT_EQ(*value, *out->value());
+
+  // the next delta is relative to the update
+  arr[0] = -3.0;
+  value = Value::MakeDoubleArray(arr);
+  out = RoundTrip(Message::EntryUpdate(1, 3, value));
+  ASSERT_TRUE(out);
+  EXPECT_EQ(Message::kEntryDeltaUpdate, static_cast<unsigned char>(wire[0]));
+  EXPECT_EQ(*value, *out->value());
+}
+
+TEST_F(ArrayDeltaTest, DoubleArrayQuantized) {
+  std::vector<double> arr(16, 0.0);
+  type = NT_DOUBLE_ARRAY;
+  RoundTrip(Message::EntryAssign("a", 1, 1, Value::MakeDoubleArray(arr), 0));
+
+  arr[3] = 0.0104;
+  arr[9] = -0.5;
+  auto out =
+      RoundTrip(Message::EntryUpdate(1, 2, Value::MakeDoubleArray(arr), 0.01));
+  ASSERT_TRUE(out);
+  EXPECT_EQ(Message::kEntryDeltaUpdate, static_cast<unsigned char>(wire[0]));
+  auto got = out->value()->GetDoubleArray();
+  ASSERT_EQ(16u, got.size());
+  EXPECT_DOUBLE_EQ(0.01, got[3]);
+  EXPECT_DOUBLE_EQ(-0.5, got[9]);
+  EXPECT_EQ(0.0, got[0]);
+
+  // sender and receiver agree on the quantized base
+  arr[3] = 0.0201;
+  out =
+      RoundTrip(Message::EntryUpdate(1, 3, Value::MakeDoubleArray(arr), 0.01));
+  ASSERT_TRUE(out);
+  EXPECT_DOUBLE_EQ(0.02, out->value()->GetDoubleArray()[3]);
+  EXPECT_EQ(*send_base.Get(1), *recv_base.Get(1));
+}
+
+TEST_F(ArrayDeltaTest, DoubleArrayQuantizedExtremeStep) {
+  // the largest quantized magnitude each way, so the step takes 32 bits
+  std::vector<double> arr(16, 0.0);
+  arr[5] = -(1 << 30);
+  type = NT_DOUBLE_ARRAY;
+  RoundTrip(Message::EntryAssign("a", 1, 1, Value::MakeDoubleArray(arr), 0));
+
+  arr[5] = 1 << 30;
+  auto value = Value::MakeDoubleArray(arr);
+  auto out = RoundTrip(Message::EntryUpdate(1, 2, value, 1.0));
+  ASSERT_TRUE(out);
+  EXPECT_EQ(Message::kEntryDeltaUpdate, static_cast<unsigned char>(wire[0]));
+  EXPECT_EQ(*value, *out->value());
+
+  arr[5] = -(1 << 30);
+  value = Value::MakeDoubleArray(arr);
+  out = RoundTrip(Message::EntryUpdate(1, 3, value, 1.0));
+  ASSERT_TRUE(out);
+  EXPECT_EQ(*value, *out->value());
+}
+
+TEST_F(ArrayDeltaTest, DoubleArrayInvalidQuantum) {
+  std::vector<double> arr(16, 0.0);
+  type = NT_DOUBLE_ARRAY;
+  RoundTrip(Message::EntryAssign("a", 1, 1, Value::MakeDoubleArray(arr), 0));
+  arr[3] = 0.5;
+  RoundTrip(Message::EntryUpdate(1, 2, Value::MakeDoubleArray(arr), 0.01));
+  ASSERT_EQ(Message::kEntryDeltaUpdate, static_cast<unsigned char>(wire[0]));
+
+  // the quantum follows the type, id, seq num, value type and mode
+  constexpr size_t kQuantumPos = 1 + 2 + 2 + 1 + 1;
+  for (double quantum : {0.0, -0.01, std::numeric_limits<double>::infinity(),
+                         std::numeric_limits<double>::quiet_NaN()}) {
+    uint64_t bits = wpi::DoubleToBits(quantum);
+    for (int i = 0; i < 8; ++i) {
+      wire[kQuantumPos + i] = static_cast<char>(bits >> (56 - 8 * i));
+    }
+    const char* error = nullptr;
+    EXPECT_FALSE(Decode(&error)) << quantum;
+    EXPECT_NE(nullptr, error) << quantum;
+  }
+}
+
+TEST_F(ArrayDeltaTest, BooleanArrayToggle) {
+  std::vector<int> arr(64, 0);
+  type = NT_BOOLEAN_ARRAY;
+  RoundTrip(Message::EntryAssign("a", 1, 1, Value::MakeBooleanArray(arr), 0));
+
+  arr[5] = 1;
+  arr[40] = 1;
+  auto value = Value::MakeBooleanArray(arr);
+  auto out = RoundTrip(Message::EntryUpdate(1, 2, value));
+  ASSERT_TRUE(out);
+  EXPECT_EQ(Message::kEntryDeltaUpdate, static_cast<unsigned char>(wire[0]));
+  EXPECT_EQ(*value, *out->value());
+}
+
+TEST_F(ArrayDeltaTest, FullUpdateFallback) {
+  std::vector<double> arr(4, 1.0);
+  type = NT_DOUBLE_ARRAY;
+  RoundTrip(Message::EntryAssign("a", 1, 1, Value::MakeDoubleArray(arr), 0));
+
+  // every element changed: a delta would not be smaller
+  std::vector<double> changed(4, 2.0);
+  auto out =
+      RoundTrip(Message::EntryUpdate(1, 2, Value::MakeDoubleArray(changed)));
+  ASSERT_TRUE(out);
+  EXPECT_EQ(Message::kEntryUpdate, static_cast<unsigned char>(wire[0]));
+
+  // size change
+  arr.resize(8, 2.0);
+  auto value = Value::MakeDoubleArray(arr);
+  out = RoundTrip(Message::EntryUpdate(1, 3, value));
+  ASSERT_TRUE(out);
+  EXPECT_EQ(Message::kEntryUpdate, static_cast<unsigned char>(wire[0]));
+  EXPECT_EQ(*value, *out->value());
+}
+
+class ArrayDeltaTest30 : public ArrayDeltaTest {
+ protected:
+  ArrayDeltaTest30() : ArrayDeltaTest(0x0300u) {}
+};
+
+TEST_F(ArrayDeltaTest30, AlwaysFullUpdate) {
+  std::vector<double> arr(32, 1.5);
+  type = NT_DOUBLE_ARRAY;
+  RoundTrip(Message::EntryAssign("a", 1, 1, Value::MakeDoubleArray(arr), 0));
+
+  arr[7] = 2.25;
+  auto value = Value::MakeDoubleArray(arr);
+  auto out = RoundTrip(Message::EntryUpdate(1, 2, value));
+  ASSERT_TRUE(out);
+  EXPECT_EQ(Message::kEntryUpdate, static_cast<unsigned char>(wire[0]));
+  EXPECT_EQ(*value, *out->value());
+  EXPECT_EQ(nullptr, send_base.Get(1));
+}
+
+}  // namespace nt
@@ -0,0 +1,154 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ntcore_cpp.h"
+
+class ConcurrentStorageTest : public ::testing::Test {
+ public:
+  static constexpr size_t kNumEntries = 200;
+
+  ConcurrentStorageTest() : inst(nt::CreateInstance()) {
+    for (size_t i = 0; i < kNumEntries; ++i) {
+      names.emplace_back("entry" + std::to_string(i));
+      entries.emplace_back(nt::GetEntry(inst, names.back()));
+      nt::SetEntryValue(entries.back(), nt::Value::MakeDouble(0));
+    }
+  }
+
+  ~ConcurrentStorageTest() override { nt::DestroyInstance(inst); }
+
+  // Continuously updates every entry until stopped.
+  void StartWriter() {
+    writer = std::thread([this] {
+      double value = 0;
+      while (!stop) {
+        value += 1;
+        for (auto entry : entries) {
+          nt::SetEntryValue(entry, nt::Value::MakeDouble(value));
+        }
+      }
+    });
+  }
+
+  void StopWriter() {
+    stop = true;
+    writer.join();
+  }
+
+ protected:
+  NT_Inst inst;
+  std::vector<std::string> names;
+  std::vector<NT_Entry> entries;
+  std::atomic_bool stop{false};
+  std::thread writer;
+};
+
+TEST_F(ConcurrentStorageTest, ReadWhileWriting) {
+  StartWriter();
+
+  // values seen by a reader never go backwards
+  std::vector<std::thread> readers;
+  std::atomic_int errors{0};
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&] {
+      std::vector<double> last(kNumEntries, 0);
+      auto end = std::chrono::steady_clock::now() +
+                 std::chrono::milliseconds(200);
+      while (std::chrono::steady_clock::now() < end) {
+        for (size_t i = 0; i < kNumEntries; ++i) {
+          auto value = nt::GetEntryValue(entries[i]);
+          if (!value || !value->IsDouble() || value->GetDouble() < last[i] ||
+              nt::GetEntryType(entries[i]) != NT_DOUBLE) {
+            ++errors;
+            continue;
+          }
+          last[i] = value->GetDouble();
+        }
+      }
+    });
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  StopWriter();
+  EXPECT_EQ(errors, 0);
+}
+
+// The local id map grows past its initial chunk table while being read.
+TEST_F(ConcurrentStorageTest, ManyEntries) {
+  static constexpr size_t kNumMore = 40000;
+
+  std::thread reader([&] {
+    while (!stop) {
+      for (size_t i = 0; i < kNumEntries; ++i) {
+        EXPECT_EQ(nt::GetEntryName(entries[i]), names[i]);
+      }
+    }
+  });
+
+  std::vector<NT_Entry> more;
+  for (size_t i = 0; i < kNumMore; ++i) {
+    more.emplace_back(nt::GetEntry(inst, "more" + std::to_string(i)));
+    nt::SetEntryValue(more.back(), nt::Value::MakeDouble(i));
+  }
+  stop = true;
+  reader.join();
+
+  for (size_t i = 0; i < kNumMore; ++i) {
+    auto value = nt::GetEntryValue(more[i]);
+    ASSERT_TRUE(value);
+    EXPECT_EQ(value->GetDouble(), i);
+  }
+}
+
+// Takes about 2 seconds, so it's disabled by default; run it with
+// --gtest_also_run_disabled_tests.
+TEST_F(ConcurrentStorageTest, DISABLED_Benchmark) {
+  using std::chrono::steady_clock;
+
+  StartWriter();
+
+  for (bool by_name : {false, true}) {
+    for (int num_threads : {1, 2, 4, 8}) {
+      std::atomic<uint64_t> reads{0};
+      std::vector<std::thread> readers;
+      auto start = steady_clock::now();
+      for (int t = 0; t < num_threads; ++t) {
+        readers.emplace_back([&] {
+          uint64_t count = 0;
+          while (steady_clock::now() - start < std::chrono::milliseconds(250)) {
+            for (size_t i = 0; i < kNumEntries; ++i) {
+              if (by_name) {
+                nt::GetEntryValue(nt::GetEntry(inst, names[i]));
+              } else {
+                nt::GetEntryValue(entries[i]);
+              }
+            }
+            count += kNumEntries;
+          }
+          reads += count;
+        });
+      }
+      for (auto& reader : readers) {
+        reader.join();
+      }
+      double elapsed =
+          std::chrono::duration<double>(steady_clock::now() - start).count();
+      std::cout << (by_name ? "by name" : "by id") << " threads: "
+                << num_threads << " reads: " << (reads / elapsed / 1e6)
+                << " M/s\n";
+    }
+  }
+
+  StopWriter();
+}
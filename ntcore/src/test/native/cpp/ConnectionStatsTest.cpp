@@ -0,0 +1,124 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <thread>
+
+#include "Message.h"
+#include "PendingOutgoing.h"
+#include "gtest/gtest.h"
+#include "ntcore_cpp.h"
+
+// Waits up to 10 seconds for pred to become true.
+static bool WaitFor(std::function<bool()> pred) {
+  auto timeout_time =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!pred()) {
+    if (std::chrono::steady_clock::now() >= timeout_time) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+static uint64_t TotalWrites(const nt::ConnectionStats& stats) {
+  return std::accumulate(std::begin(stats.write_latency),
+                         std::end(stats.write_latency), uint64_t{0});
+}
+
+TEST(PendingOutgoingTest, Coalesced) {
+  nt::PendingOutgoing pending;
+  auto value = nt::Value::MakeDouble(1.0);
+  pending.Queue(nt::Message::EntryUpdate(1, 1, value));
+  pending.Queue(nt::Message::EntryUpdate(2, 1, value));
+  pending.Queue(nt::Message::EntryUpdate(1, 2, value));
+  pending.Queue(nt::Message::FlagsUpdate(1, 0));
+  pending.Queue(nt::Message::FlagsUpdate(1, 1));
+  EXPECT_EQ(2u, pending.coalesced());
+  EXPECT_EQ(3u, pending.high_water());
+
+  // deletion drops the update and flags update
+  pending.Queue(nt::Message::EntryDelete(1));
+  EXPECT_EQ(4u, pending.coalesced());
+  EXPECT_EQ(4u, pending.high_water());
+
+  // the high-water mark persists across posts
+  EXPECT_EQ(4u, pending.Post(false).size());
+  pending.Queue(nt::Message::EntryUpdate(1, 3, value));
+  EXPECT_EQ(4u, pending.high_water());
+}
+
+class ConnectionStatsTest : public ::testing::TestWithParam<bool> {
+ public:
+  ConnectionStatsTest()
+      : server_inst(nt::CreateInstance()), client_inst(nt::CreateInstance()) {
+    nt::SetNetworkIdentity(server_inst, "server");
+    nt::SetNetworkIdentity(client_inst, "client");
+  }
+
+  ~ConnectionStatsTest() override {
+    nt::DestroyInstance(client_inst);
+    nt::DestroyInstance(server_inst);
+  }
+
+ protected:
+  NT_Inst server_inst;
+  NT_Inst client_inst;
+};
+
+TEST_P(ConnectionStatsTest, Counters) {
+  unsigned int port = GetParam() ? 10031 : 10030;
+  nt::SetEventLoopServer(server_inst, GetParam());
+  nt::StartServer(server_inst, "connectionstatstest.ini", "127.0.0.1", port);
+  nt::StartClient(client_inst, "127.0.0.1", port);
+  ASSERT_TRUE(WaitFor([&] {
+    return nt::GetConnectionStats(server_inst).size() == 1 &&
+           nt::GetConnectionStats(client_inst).size() == 1;
+  }));
+  EXPECT_EQ("client", nt::GetConnectionStats(server_inst)[0].info.remote_id);
+
+  // rapid updates to one entry between posts are coalesced
+  nt::SetUpdateRate(server_inst, 1.0);
+  auto entry = nt::GetEntry(server_inst, "value");
+  for (int i = 0; i < 100; ++i) {
+    nt::SetEntryValue(entry, nt::Value::MakeDouble(i));
+  }
+  nt::Flush(server_inst);
+  ASSERT_TRUE(WaitFor([&] {
+    auto value = nt::GetEntryValue(nt::GetEntry(client_inst, "value"));
+    return value && value->GetDouble() == 99;
+  }));
+
+  // once idle, everything the server sent has been received by the client
+  ASSERT_TRUE(WaitFor([&] {
+    auto server = nt::GetConnectionStats(server_inst);
+    auto client = nt::GetConnectionStats(client_inst);
+    return server.size() == 1 && client.size() == 1 &&
+           server[0].bytes_sent == client[0].bytes_received &&
+           server[0].messages_sent == client[0].messages_received &&
+           client[0].bytes_sent == server[0].bytes_received &&
+           client[0].messages_sent == server[0].messages_received;
+  }));
+
+  auto stats = nt::GetConnectionStats(server_inst)[0];
+  EXPECT_GT(stats.bytes_sent, 0u);
+  EXPECT_GT(stats.messages_sent, 0u);
+  EXPECT_GT(stats.bytes_received, 0u);
+  EXPECT_GT(stats.messages_received, 0u);
+  EXPECT_GT(stats.messages_coalesced, 0u);
+  EXPECT_GT(stats.queue_high_water, 0u);
+  EXPECT_GT(stats.flushes, 0u);
+  EXPECT_GE(stats.max_post_time, stats.last_post_time);
+  EXPECT_GT(TotalWrites(stats), 0u);
+  EXPECT_LT(stats.messages_sent, 100u);
+
+  nt::StopClient(client_inst);
+  nt::StopServer(server_inst);
+}
+
+INSTANTIATE_TEST_SUITE_P(ConnectionStatsTests, ConnectionStatsTest,
+                         ::testing::Bool());
@@ -0,0 +1,222 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <wpi/EventLoopRunner.h>
+#include <wpi/uv/Tcp.h>
+
+#include "Message.h"
+#include "WireEncoder.h"
+#include "gtest/gtest.h"
+#include "ntcore_cpp.h"
+
+namespace uv = wpi::uv;
+
+// Returns a numeric field (e.g. "Threads" or "VmRSS") from the process
+// status, or 0 if not available on this platform.
+static uint64_t GetProcStatus(std::string_view field) {
+#ifdef __linux__
+  std::ifstream is("/proc/self/status");
+  std::string line;
+  while (std::getline(is, line)) {
+    if (line.size() > field.size() && line[field.size()] == ':' &&
+        line.compare(0, field.size(), field) == 0) {
+      return std::stoull(line.substr(field.size() + 1));
+    }
+  }
+#endif
+  return 0;
+}
+
+// Waits up to 10 seconds for pred to become true.
+static bool WaitFor(std::function<bool()> pred) {
+  auto timeout_time =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!pred()) {
+    if (std::chrono::steady_clock::now() >= timeout_time) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+class EventLoopServerTest : public ::testing::Test {
+ public:
+  EventLoopServerTest() : server_inst(nt::CreateInstance()) {
+    nt::SetNetworkIdentity(server_inst, "server");
+  }
+
+  ~EventLoopServerTest() override { nt::DestroyInstance(server_inst); }
+
+ protected:
+  NT_Inst server_inst;
+};
+
+TEST_F(EventLoopServerTest, ClientServer) {
+  nt::SetEventLoopServer(server_inst, true);
+  nt::StartServer(server_inst, "eventloopservertest.ini", "127.0.0.1", 10020);
+  ASSERT_EQ(nt::GetNetworkMode(server_inst), NT_NET_MODE_SERVER);
+  nt::SetEntryValue(nt::GetEntry(server_inst, "server"),
+                    nt::Value::MakeDouble(1.0));
+
+  auto client_inst = nt::CreateInstance();
+  nt::SetNetworkIdentity(client_inst, "client");
+  nt::SetEntryValue(nt::GetEntry(client_inst, "client"),
+                    nt::Value::MakeString("hello"));
+  nt::StartClient(client_inst, "127.0.0.1", 10020);
+
+  ASSERT_TRUE(
+      WaitFor([&] { return nt::GetConnections(server_inst).size() == 1; }));
+  EXPECT_EQ(nt::GetConnections(server_inst)[0].remote_id, "client");
+
+  // initial assignments in both directions
+  ASSERT_TRUE(WaitFor([&] {
+    return nt::GetEntryValue(nt::GetEntry(client_inst, "server")) &&
+           nt::GetEntryValue(nt::GetEntry(server_inst, "client"));
+  }));
+  EXPECT_EQ(*nt::GetEntryValue(nt::GetEntry(client_inst, "server")),
+            *nt::Value::MakeDouble(1.0));
+  EXPECT_EQ(*nt::GetEntryValue(nt::GetEntry(server_inst, "client")),
+            *nt::Value::MakeString("hello"));
+
+  // updates in both directions
+  nt::SetEntryValue(nt::GetEntry(server_inst, "server"),
+                    nt::Value::MakeDouble(2.0));
+  nt::SetEntryValue(nt::GetEntry(client_inst, "client"),
+                    nt::Value::MakeString("world"));
+  EXPECT_TRUE(WaitFor([&] {
+    return *nt::GetEntryValue(nt::GetEntry(client_inst, "server")) ==
+           *nt::Value::MakeDouble(2.0);
+  }));
+  EXPECT_TRUE(WaitFor([&] {
+    return *nt::GetEntryValue(nt::GetEntry(server_inst, "client")) ==
+           *nt::Value::MakeString("world");
+  }));
+
+  // disconnect is detected
+  nt::DestroyInstance(client_inst);
+  EXPECT_TRUE(
+      WaitFor([&] { return nt::GetConnections(server_inst).empty(); }));
+  nt::StopServer(server_inst);
+}
+
+// A server that fails to listen is fully stopped and can be started again.
+TEST_F(EventLoopServerTest, ListenFailure) {
+  auto other_inst = nt::CreateInstance();
+  nt::SetEventLoopServer(other_inst, true);
+  nt::StartServer(other_inst, "eventloopservertest.ini", "127.0.0.1", 10022);
+  ASSERT_EQ(nt::GetNetworkMode(other_inst), NT_NET_MODE_SERVER);
+
+  // the failed server's event loop thread is stopped
+  auto threads = GetProcStatus("Threads");
+  nt::SetEventLoopServer(server_inst, true);
+  nt::StartServer(server_inst, "eventloopservertest.ini", "127.0.0.1", 10022);
+  EXPECT_NE(nt::GetNetworkMode(server_inst) & NT_NET_MODE_FAILURE, 0u);
+  EXPECT_EQ(GetProcStatus("Threads"), threads);
+  nt::DestroyInstance(other_inst);
+
+  nt::StartServer(server_inst, "eventloopservertest.ini", "127.0.0.1", 10023);
+  EXPECT_EQ(nt::GetNetworkMode(server_inst), NT_NET_MODE_SERVER);
+  nt::StopServer(server_inst);
+}
+
+// Takes about 10 seconds, so it's disabled by default; run it with
+// --gtest_also_run_disabled_tests.
+TEST_F(EventLoopServerTest, DISABLED_Benchmark) {
+  using std::chrono::steady_clock;
+
+  static constexpr size_t kNumClients = 50;
+  static constexpr size_t kNumEntries = 100;
+
+  // Simulated clients are raw protocol connections all serviced by one
+  // event loop, so they add a single thread to the process regardless of
+  // the number of clients.
+  std::string hello;
+  {
+    nt::WireEncoder enc(0x0300);
+    nt::Message::ClientHello("bench")->Write(enc);
+    nt::Message::ClientHelloDone()->Write(enc);
+    hello = enc.ToStringView();
+  }
+
+  std::vector<NT_Entry> entries;
+  for (size_t i = 0; i < kNumEntries; ++i) {
+    entries.emplace_back(
+        nt::GetEntry(server_inst, "bench/" + std::to_string(i)));
+  }
+  std::vector<double> arr(16);
+
+  unsigned int port = 10021;
+  for (bool event_loop : {false, true}) {
+    uint64_t base_threads = GetProcStatus("Threads");
+    uint64_t base_rss = GetProcStatus("VmRSS");
+
+    nt::SetEventLoopServer(server_inst, event_loop);
+    nt::SetLowLatency(server_inst, true, 1000);
+    nt::StartServer(server_inst, "eventloopservertest.ini", "127.0.0.1",
+                    port);
+
+    std::atomic<uint64_t> received{0};
+    {
+      // connect one at a time so the threaded server's small listen backlog
+      // doesn't delay connections
+      wpi::EventLoopRunner client_loop;
+      size_t num_connected = 0;
+      std::function<void(uv::Loop&)> connect = [&](uv::Loop& loop) {
+        auto tcp = uv::Tcp::Create(loop);
+        tcp->error.connect([t = tcp.get()](uv::Error) { t->Close(); });
+        tcp->end.connect([t = tcp.get()] { t->Close(); });
+        tcp->data.connect([&](uv::Buffer&, size_t len) { received += len; });
+        tcp->Connect("127.0.0.1", port, [&, t = tcp.get()] {
+          t->StartRead();
+          t->Write({uv::Buffer{hello}}, [](auto, uv::Error) {});
+          if (++num_connected < kNumClients) {
+            connect(t->GetLoopRef());
+          }
+        });
+      };
+      client_loop.ExecSync(connect);
+      ASSERT_TRUE(WaitFor([&] {
+        return nt::GetConnections(server_inst).size() == kNumClients;
+      }));
+
+      uint64_t threads = GetProcStatus("Threads") - base_threads;
+      uint64_t rss = GetProcStatus("VmRSS") - base_rss;
+
+      // update entries as fast as possible
+      uint64_t start_received = received;
+      auto start = steady_clock::now();
+      size_t updates = 0;
+      while (steady_clock::now() - start < std::chrono::seconds(1)) {
+        arr[0] = static_cast<double>(updates);
+        nt::SetEntryValue(entries[updates % kNumEntries],
+                          nt::Value::MakeDoubleArray(arr));
+        ++updates;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      double elapsed =
+          std::chrono::duration<double>(steady_clock::now() - start).count();
+      double throughput = (received - start_received) / elapsed;
+
+      std::cout << (event_loop ? "event loop" : "threaded")
+                << " clients: " << kNumClients << " threads: " << threads
+                << " rss: " << rss << " kB throughput: " << throughput / 1e6
+                << " MB/s\n";
+    }
+
+    nt::StopServer(server_inst);
+    ++port;
+  }
+}
@@ -0,0 +1,149 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <wpi/condition_variable.h>
+#include <wpi/mutex.h>
+
+#include "gtest/gtest.h"
+#include "ntcore_cpp.h"
+
+class LowLatencyTest : public ::testing::Test {
+ public:
+  LowLatencyTest() : server_inst(nt::CreateInstance()) {
+    nt::SetNetworkIdentity(server_inst, "server");
+  }
+
+  ~LowLatencyTest() override {
+    Disconnect();
+    nt::DestroyInstance(server_inst);
+  }
+
+  // Starts the server and connects num_clients clients to it, each of which
+  // listens for updates to the "value" entry.
+  void Connect(unsigned int port, size_t num_clients);
+  void Disconnect();
+
+  // Changes the "value" entry on the server and returns the average time, in
+  // microseconds, until the update is received by each client.
+  double MeasureLatency();
+
+ protected:
+  NT_Inst server_inst;
+  std::vector<NT_Inst> client_insts;
+
+  wpi::mutex mutex;
+  wpi::condition_variable cv;
+  size_t notified = 0;
+  uint64_t total_latency = 0;
+  uint64_t set_time = 0;
+  double value = 0;
+};
+
+void LowLatencyTest::Connect(unsigned int port, size_t num_clients) {
+  nt::StartServer(server_inst, "lowlatencytest.ini", "127.0.0.1", port);
+  nt::SetEntryValue(nt::GetEntry(server_inst, "value"),
+                    nt::Value::MakeDouble(value));
+
+  for (size_t i = 0; i < num_clients; ++i) {
+    auto client_inst = nt::CreateInstance();
+    client_insts.push_back(client_inst);
+    nt::SetNetworkIdentity(client_inst, "client");
+    nt::AddEntryListener(
+        nt::GetEntry(client_inst, "value"),
+        [&](const nt::EntryNotification& event) {
+          auto now = nt::Now();
+          std::scoped_lock lock(mutex);
+          total_latency += now - set_time;
+          ++notified;
+          cv.notify_all();
+        },
+        NT_NOTIFY_UPDATE);
+    nt::StartClient(client_inst, "127.0.0.1", port);
+
+    // wait for each client to connect before starting the next, so the
+    // server's listen backlog doesn't overflow
+    auto timeout_time =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (nt::GetConnections(server_inst).size() <= i &&
+           std::chrono::steady_clock::now() < timeout_time) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  // wait for all clients to receive the initial value
+  ASSERT_EQ(nt::GetConnections(server_inst).size(), num_clients);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+}
+
+void LowLatencyTest::Disconnect() {
+  for (auto client_inst : client_insts) {
+    nt::DestroyInstance(client_inst);
+  }
+  client_insts.clear();
+  nt::StopServer(server_inst);
+}
+
+double LowLatencyTest::MeasureLatency() {
+  std::unique_lock lock(mutex);
+  notified = 0;
+  total_latency = 0;
+  set_time = nt::Now();
+  lock.unlock();
+
+  nt::SetEntryValue(nt::GetEntry(server_inst, "value"),
+                    nt::Value::MakeDouble(++value));
+
+  lock.lock();
+  cv.wait_for(lock, std::chrono::seconds(2),
+              [&] { return notified >= client_insts.size(); });
+  EXPECT_EQ(notified, client_insts.size());
+  if (notified == 0) {
+    return 0;
+  }
+  return static_cast<double>(total_latency) / notified;
+}
+
+TEST_F(LowLatencyTest, SentBeforePeriodicUpdate) {
+  nt::SetUpdateRate(server_inst, 1.0);
+  nt::SetLowLatency(server_inst, true, 1000);
+  Connect(10010, 1);
+
+  // a periodic update would arrive 500 ms later on average
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_LT(MeasureLatency(), 50000.0);
+  }
+}
+
+// Takes about 35 seconds, so it's disabled by default; run it with
+// --gtest_also_run_disabled_tests.
+TEST_F(LowLatencyTest, DISABLED_Benchmark) {
+  using std::chrono::milliseconds;
+
+  static constexpr int kIterations = 20;
+
+  unsigned int port = 10011;
+  for (size_t num_clients : {1, 10, 100}) {
+    Connect(port++, num_clients);
+
+    for (bool low_latency : {false, true}) {
+      nt::SetLowLatency(server_inst, low_latency, 1000);
+      double total = 0;
+      for (int i = 0; i < kIterations; ++i) {
+        total += MeasureLatency();
+        // spread updates across the periodic update interval
+        std::this_thread::sleep_for(milliseconds(7 * (i % 5)));
+      }
+      std::cout << (low_latency ? "low-latency" : "periodic") << " clients: "
+                << num_clients << " latency: " << (total / kIterations)
+                << " us\n";
+    }
+
+    Disconnect();
+  }
+}
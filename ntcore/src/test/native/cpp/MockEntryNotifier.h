@@ -33,6 +33,7 @@ class MockEntryNotifier : public IEntryNotifier {
                void(unsigned int local_id, std::string_view name,
                     std::shared_ptr<Value> value, unsigned int flags,
                     unsigned int only_listener));
+  MOCK_METHOD1(NotifyEntries, void(wpi::span<const EntryNotifyData> data));
 };
 
 }  // namespace nt
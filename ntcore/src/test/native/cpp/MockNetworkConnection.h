@@ -5,6 +5,7 @@
 #ifndef NTCORE_MOCKNETWORKCONNECTION_H_
 #define NTCORE_MOCKNETWORKCONNECTION_H_
 
+#include <chrono>
 #include <memory>
 
 #include "INetworkConnection.h"
@@ -15,9 +16,15 @@ namespace nt {
 class MockNetworkConnection : public INetworkConnection {
  public:
   MOCK_CONST_METHOD0(info, ConnectionInfo());
+  MOCK_CONST_METHOD0(stats, ConnectionStats());
 
   MOCK_METHOD1(QueueOutgoing, void(std::shared_ptr<Message> msg));
   MOCK_METHOD1(PostOutgoing, void(bool keep_alive));
+  MOCK_METHOD2(ArmPostDeadline,
+               std::chrono::steady_clock::time_point(
+                   std::chrono::steady_clock::time_point now,
+                   std::chrono::microseconds min_interval));
+  MOCK_CONST_METHOD0(post_deadline, std::chrono::steady_clock::time_point());
 
   MOCK_CONST_METHOD0(proto_rev, unsigned int());
   MOCK_METHOD1(set_proto_rev, void(unsigned int proto_rev));
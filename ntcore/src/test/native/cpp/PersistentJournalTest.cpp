@@ -0,0 +1,169 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <wpi/fs.h>
+#include <wpi/raw_ostream.h>
+
+#include "Log.h"
+#include "MockEntryNotifier.h"
+#include "MockRpcServer.h"
+#include "PersistentJournal.h"
+#include "Storage.h"
+#include "TestPrinters.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::Return;
+
+namespace nt {
+
+class PersistentJournalTest : public ::testing::Test {
+ protected:
+  using Entry = PersistentJournal::Entry;
+
+  PersistentJournalTest() {
+    filename = (fs::temp_directory_path() /
+                fmt::format("ntcore-{}.ini", ::testing::UnitTest::GetInstance()
+                                                 ->current_test_info()
+                                                 ->name()))
+                   .string();
+    journal_filename = filename + ".journal";
+    RemoveFiles();
+  }
+
+  ~PersistentJournalTest() override { RemoveFiles(); }
+
+  void RemoveFiles() {
+    std::remove(filename.c_str());
+    std::remove(journal_filename.c_str());
+    std::remove((filename + ".bak").c_str());
+  }
+
+  // Loads the file (and journal) into a new storage
+  std::vector<EntryInfo> Load() {
+    ::testing::NiceMock<MockEntryNotifier> notifier;
+    ::testing::NiceMock<MockRpcServer> rpc_server;
+    EXPECT_CALL(notifier, local_notifiers())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(false));
+    Storage storage(notifier, rpc_server, logger);
+    EXPECT_EQ(nullptr, storage.LoadPersistent(filename, nullptr));
+    return storage.GetEntryInfo(0, "", 0);
+  }
+
+  wpi::Logger logger;
+  std::string filename;
+  std::string journal_filename;
+};
+
+TEST_F(PersistentJournalTest, AppendAndReplay) {
+  std::vector<Entry> entries{{"a", Value::MakeDouble(1.0)},
+                             {"b", Value::MakeBoolean(true)}};
+  ASSERT_EQ(nullptr, Storage::SavePersistentFile(filename, entries));
+
+  PersistentJournal journal(logger);
+  journal.Start(filename, entries);
+  journal.Append({{"a", Value::MakeDouble(2.0)}, {"b", nullptr}});
+  journal.Append({{"c", Value::MakeString("hello")}});
+  journal.Stop();
+
+  // the changes are only in the journal
+  ASSERT_TRUE(fs::exists(journal_filename));
+  auto metrics = journal.GetMetrics();
+  EXPECT_EQ(0u, metrics.errors);
+  EXPECT_EQ(1u, metrics.saves);  // initial compaction
+  EXPECT_GE(metrics.journal_writes, 1u);
+  EXPECT_EQ(3u, metrics.journal_records);
+  EXPECT_EQ(fs::file_size(journal_filename), metrics.journal_size);
+
+  auto info = Load();
+  ASSERT_EQ(2u, info.size());
+  std::sort(info.begin(), info.end(),
+            [](const auto& a, const auto& b) { return a.name < b.name; });
+  EXPECT_EQ("a", info[0].name);
+  EXPECT_EQ(NT_DOUBLE, info[0].type);
+  EXPECT_EQ("c", info[1].name);
+  EXPECT_EQ(NT_STRING, info[1].type);
+}
+
+TEST_F(PersistentJournalTest, Compact) {
+  PersistentJournal journal(logger);
+  journal.Start(filename, {});
+
+  // keep rewriting one large value until the journal outgrows the file
+  std::string big(1024, 'x');
+  for (int i = 0; i < 64; ++i) {
+    big[0] = 'a' + (i % 26);
+    journal.Append({{"big", Value::MakeString(big)}});
+  }
+  journal.Stop();
+
+  auto metrics = journal.GetMetrics();
+  EXPECT_EQ(0u, metrics.errors);
+  EXPECT_GE(metrics.saves, 2u);
+  EXPECT_LT(metrics.journal_size, 64u * 1024u);
+  EXPECT_GE(metrics.max_save_time, metrics.last_save_time);
+
+  auto info = Load();
+  ASSERT_EQ(1u, info.size());
+  EXPECT_EQ("big", info[0].name);
+}
+
+TEST_F(PersistentJournalTest, LoadJournalDelete) {
+  {
+    std::vector<Entry> entries{{"a", Value::MakeDouble(1.0)},
+                               {"b", Value::MakeDouble(2.0)}};
+    ASSERT_EQ(nullptr, Storage::SavePersistentFile(filename, entries));
+    std::error_code ec;
+    wpi::raw_fd_ostream os(journal_filename, ec, fs::F_Text);
+    ASSERT_EQ(0, ec.value());
+    std::vector<Entry> changes{{"a", nullptr}, {"c", Value::MakeDouble(3.0)}};
+    Storage::SavePersistentJournal(os, changes, true);
+  }
+
+  auto info = Load();
+  ASSERT_EQ(2u, info.size());
+  std::sort(info.begin(), info.end(),
+            [](const auto& a, const auto& b) { return a.name < b.name; });
+  EXPECT_EQ("b", info[0].name);
+  EXPECT_EQ("c", info[1].name);
+}
+
+TEST_F(PersistentJournalTest, LoadJournalWithoutFile) {
+  // the program stopped before the first full save
+  {
+    std::error_code ec;
+    wpi::raw_fd_ostream os(journal_filename, ec, fs::F_Text);
+    ASSERT_EQ(0, ec.value());
+    std::vector<Entry> changes{{"a", Value::MakeDouble(1.0)},
+                               {"b", Value::MakeDouble(2.0)},
+                               {"a", nullptr}};
+    Storage::SavePersistentJournal(os, changes, true);
+  }
+  ASSERT_FALSE(fs::exists(filename));
+
+  auto info = Load();
+  ASSERT_EQ(1u, info.size());
+  EXPECT_EQ("b", info[0].name);
+}
+
+TEST_F(PersistentJournalTest, LoadNoFiles) {
+  ::testing::NiceMock<MockEntryNotifier> notifier;
+  ::testing::NiceMock<MockRpcServer> rpc_server;
+  Storage storage(notifier, rpc_server, logger);
+  EXPECT_STREQ("could not open file",
+               storage.LoadPersistent(filename, nullptr));
+}
+
+}  // namespace nt
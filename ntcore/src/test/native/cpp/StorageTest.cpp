@@ -19,8 +19,10 @@
 
 using ::testing::_;
 using ::testing::AnyNumber;
+using ::testing::ElementsAre;
 using ::testing::IsNull;
 using ::testing::Return;
+using ::testing::SizeIs;
 
 namespace nt {
 
@@ -274,6 +276,28 @@ TEST_P(StorageTestPopulateOne, SetEntryValueEqualValue) {
   EXPECT_EQ(value, entry->value);
 }
 
+TEST_P(StorageTestPopulateOne, SetEntryValueTypedEqualValue) {
+  // an unchanged value still marks the entry as written locally, so it's
+  // sent back to the server on reconnect
+  auto entry = GetEntry("foo");
+  auto value = entry->value;
+  entry->local_write = false;
+  int made = 0;
+  auto equal = [](const Value& v) { return v.GetBoolean(); };
+  auto make = [&] {
+    ++made;
+    return Value::MakeBoolean(true);
+  };
+  EXPECT_TRUE(storage.SetEntryValue(0, NT_BOOLEAN, equal, make));
+  EXPECT_TRUE(entry->local_write);
+  EXPECT_EQ(*value, *entry->value);
+  EXPECT_EQ(1, made);
+
+  // once written locally, unchanged values skip making a value
+  EXPECT_TRUE(storage.SetEntryValue(0, NT_BOOLEAN, equal, make));
+  EXPECT_EQ(1, made);
+}
+
 TEST_P(StorageTestPopulated, SetEntryValueDifferentValue) {
   // update with same type and different value results in value update message
   auto value = Value::MakeDouble(1.0);
@@ -299,6 +323,30 @@ TEST_P(StorageTestPopulated, SetEntryValueDifferentValue) {
   }
 }
 
+TEST_P(StorageTestPopulated, SetEntryValues) {
+  // values are set under one lock, with a single notification batch and a
+  // single outgoing message batch; type mismatches are skipped
+  auto value1 = Value::MakeDouble(1.0);
+  auto value2 = Value::MakeDouble(2.0);
+  std::pair<unsigned int, std::shared_ptr<Value>> values[] = {
+      {1, value1}, {0, Value::MakeDouble(3.0)}, {2, value2}};
+
+  // client shouldn't send updates as ids not assigned yet
+  if (GetParam()) {
+    EXPECT_CALL(dispatcher,
+                QueueOutgoingBatch(
+                    ElementsAre(MessageEq(Message::EntryUpdate(1, 2, value1)),
+                                MessageEq(Message::EntryUpdate(2, 2, value2))),
+                    IsNull(), IsNull()));
+  }
+  EXPECT_CALL(notifier, NotifyEntries(SizeIs(2)));
+
+  EXPECT_FALSE(storage.SetEntryValues(values));
+  EXPECT_EQ(value1, GetEntry("foo2")->value);
+  EXPECT_EQ(value2, GetEntry("bar")->value);
+  EXPECT_EQ(*Value::MakeBoolean(true), *GetEntry("foo")->value);
+}
+
 TEST_P(StorageTestEmpty, SetEntryValueEmptyName) {
   auto value = Value::MakeBoolean(true);
   EXPECT_TRUE(storage.SetEntryValue("", value));
@@ -508,6 +556,49 @@ TEST_P(StorageTestPopulated, DeleteAllEntriesPersistent) {
   EXPECT_NE(nullptr, entries()["foo2"]->value);
 }
 
+TEST_P(StorageTestPopulated, PersistentJournalChanges) {
+  EXPECT_CALL(dispatcher, QueueOutgoing(_, _, _)).Times(AnyNumber());
+  EXPECT_CALL(notifier, NotifyEntry(_, _, _, _, _)).Times(AnyNumber());
+  GetEntry("foo")->flags = NT_PERSISTENT;
+
+  std::vector<std::pair<std::string, std::shared_ptr<Value>>> entries;
+  storage.StartPersistentJournal(&entries);
+  ASSERT_EQ(1u, entries.size());
+  EXPECT_EQ("foo", entries[0].first);
+
+  // nothing changed yet
+  std::vector<std::pair<std::string, std::shared_ptr<Value>>> changes;
+  EXPECT_FALSE(storage.GetPersistentChanges(&changes));
+
+  // each changed entry is reported once, with its latest state
+  auto value = Value::MakeDouble(2.0);
+  storage.SetEntryFlags("foo2", NT_PERSISTENT);
+  storage.SetEntryValue("foo2", Value::MakeDouble(1.0));
+  storage.SetEntryValue("foo2", value);
+  storage.SetEntryValue("bar", Value::MakeDouble(5.0));  // not persistent
+  storage.DeleteEntry("foo");
+  ASSERT_TRUE(storage.GetPersistentChanges(&changes));
+  ASSERT_EQ(2u, changes.size());
+  EXPECT_EQ("foo2", changes[0].first);
+  EXPECT_EQ(value, changes[0].second);
+  EXPECT_EQ("foo", changes[1].first);
+  EXPECT_EQ(nullptr, changes[1].second);
+
+  changes.clear();
+  EXPECT_FALSE(storage.GetPersistentChanges(&changes));
+
+  // no longer persistent is reported as a removal; changes are not tracked
+  // once stopped
+  storage.SetEntryFlags("foo2", 0);
+  ASSERT_TRUE(storage.GetPersistentChanges(&changes));
+  ASSERT_EQ(1u, changes.size());
+  EXPECT_EQ(nullptr, changes[0].second);
+  storage.StopPersistentJournal();
+  storage.SetEntryFlags("foo2", NT_PERSISTENT);
+  changes.clear();
+  EXPECT_FALSE(storage.GetPersistentChanges(&changes));
+}
+
 TEST_P(StorageTestPopulated, GetEntryInfoAll) {
   auto info = storage.GetEntryInfo(0, "", 0u);
   ASSERT_EQ(4u, info.size());
@@ -0,0 +1,105 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ntcore_cpp.h"
+
+class TypedSetTest : public ::testing::Test {
+ public:
+  TypedSetTest() : inst(nt::CreateInstance()) {}
+  ~TypedSetTest() override { nt::DestroyInstance(inst); }
+
+ protected:
+  NT_Inst inst;
+};
+
+TEST_F(TypedSetTest, Unchanged) {
+  NT_Entry entry = nt::GetEntry(inst, "double");
+  ASSERT_TRUE(nt::SetEntryDouble(entry, 1.5));
+  auto value = nt::GetEntryValue(entry);
+  ASSERT_TRUE(value && value->IsDouble());
+  EXPECT_EQ(1.5, value->GetDouble());
+
+  // an unchanged value keeps the stored Value
+  ASSERT_TRUE(nt::SetEntryDouble(entry, 1.5));
+  EXPECT_EQ(value, nt::GetEntryValue(entry));
+
+  ASSERT_TRUE(nt::SetEntryDouble(entry, 2.5));
+  EXPECT_NE(value, nt::GetEntryValue(entry));
+  EXPECT_EQ(2.5, nt::GetEntryValue(entry)->GetDouble());
+}
+
+TEST_F(TypedSetTest, Arrays) {
+  NT_Entry entry = nt::GetEntry(inst, "array");
+  std::vector<double> values{1, 2, 3};
+  ASSERT_TRUE(nt::SetEntryDoubleArray(entry, values));
+  auto value = nt::GetEntryValue(entry);
+  ASSERT_TRUE(nt::SetEntryDoubleArray(entry, values));
+  EXPECT_EQ(value, nt::GetEntryValue(entry));
+
+  // a change in length is a change
+  values.push_back(4);
+  ASSERT_TRUE(nt::SetEntryDoubleArray(entry, values));
+  EXPECT_EQ(4u, nt::GetEntryValue(entry)->GetDoubleArray().size());
+
+  NT_Entry strings = nt::GetEntry(inst, "strings");
+  std::vector<std::string> stringValues{"a", "b"};
+  ASSERT_TRUE(nt::SetEntryStringArray(strings, stringValues));
+  value = nt::GetEntryValue(strings);
+  ASSERT_TRUE(nt::SetEntryStringArray(strings, stringValues));
+  EXPECT_EQ(value, nt::GetEntryValue(strings));
+  stringValues[1] = "c";
+  ASSERT_TRUE(nt::SetEntryStringArray(strings, stringValues));
+  EXPECT_EQ("c", nt::GetEntryValue(strings)->GetStringArray()[1]);
+}
+
+TEST_F(TypedSetTest, TypeMismatch) {
+  NT_Entry entry = nt::GetEntry(inst, "string");
+  ASSERT_TRUE(nt::SetEntryString(entry, "hello"));
+  EXPECT_FALSE(nt::SetEntryDouble(entry, 1.0));
+  EXPECT_FALSE(nt::SetEntryBoolean(entry, true));
+  EXPECT_EQ("hello", nt::GetEntryValue(entry)->GetString());
+}
+
+// Simulates a robot loop updating 60 Sendables with 4 double properties each,
+// where most values don't change from loop to loop.
+TEST_F(TypedSetTest, Benchmark) {
+  static constexpr int kEntries = 60 * 4;
+  static constexpr int kLoops = 2000;
+
+  std::vector<NT_Entry> entries;
+  for (int i = 0; i < kEntries; ++i) {
+    entries.emplace_back(nt::GetEntry(inst, "entry" + std::to_string(i)));
+    nt::SetEntryDouble(entries.back(), 0);
+  }
+
+  auto time = [&](const std::function<void(NT_Entry, double)>& set) {
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < kLoops; ++loop) {
+      for (int i = 0; i < kEntries; ++i) {
+        // one in 8 values changes each loop
+        set(entries[i], i % 8 == 0 ? loop : i);
+      }
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kLoops;
+  };
+
+  double makeValue = time([](NT_Entry entry, double value) {
+    nt::SetEntryValue(entry, nt::Value::MakeDouble(value));
+  });
+  double typed = time([](NT_Entry entry, double value) {
+    nt::SetEntryDouble(entry, value + 0.5);
+  });
+
+  std::cout << kEntries << " properties per loop (us/loop): SetEntryValue "
+            << makeValue << ", SetEntryDouble " << typed << "\n";
+}
@@ -9,6 +9,7 @@
 #include <networktables/NetworkTableInstance.h>
 
 #include "frc/Errors.h"
+#include "frc/LoopProfiler.h"
 #include "frc/livewindow/LiveWindow.h"
 #include "frc/shuffleboard/Shuffleboard.h"
 #include "frc/smartdashboard/SmartDashboard.h"
@@ -103,6 +104,12 @@ units::second_t IterativeRobotBase::GetPeriod() const {
 }
 
 void IterativeRobotBase::LoopFunc() {
+  bool profile = LoopProfiler::IsEnabled();
+  hal::fpga_clock::time_point loopStartTime;
+  if (profile) {
+    loopStartTime = hal::fpga_clock::now();
+  }
+
   m_watchdog.Reset();
 
   // Call the appropriate function depending upon the current robot mode
@@ -183,6 +190,15 @@ void IterativeRobotBase::LoopFunc() {
 
   m_watchdog.Disable();
 
+  if (profile) {
+    auto& profiler = LoopProfiler::GetInstance();
+    if (!m_loopProfile) {
+      m_loopProfile = profiler.GetEpoch("LoopFunc()");
+    }
+    profiler.Record(m_loopProfile, loopStartTime, hal::fpga_clock::now());
+    profiler.UpdateNetworkTables();
+  }
+
   // Flush NetworkTables
   if (m_ntFlushEnabled) {
     nt::NetworkTableInstance::GetDefault().Flush();
@@ -0,0 +1,278 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "frc/LoopProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <system_error>
+#include <utility>
+
+#include <fmt/format.h>
+#include <networktables/NetworkTable.h>
+#include <networktables/NetworkTableInstance.h>
+#include <wpi/MathExtras.h>
+#include <wpi/raw_ostream.h>
+
+using namespace frc;
+
+std::atomic_bool LoopProfiler::gEnabled{false};
+
+int LoopProfiler::Epoch::GetBucket(uint64_t us) {
+  if (us < kSubBuckets) {
+    return static_cast<int>(us);
+  }
+  int exponent = wpi::Log2_64(us);
+  int bucket = (exponent - kSubBucketBits + 1) * kSubBuckets +
+               ((us >> (exponent - kSubBucketBits)) & (kSubBuckets - 1));
+  return bucket < kNumBuckets ? bucket : kNumBuckets - 1;
+}
+
+uint64_t LoopProfiler::Epoch::GetBucketLowerBound(int bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  int exponent = bucket / kSubBuckets + kSubBucketBits - 1;
+  uint64_t mantissa = kSubBuckets + bucket % kSubBuckets;
+  return mantissa << (exponent - kSubBucketBits);
+}
+
+void LoopProfiler::Epoch::Record(std::chrono::nanoseconds duration) {
+  uint64_t ns = duration.count() < 0 ? 0 : duration.count();
+  m_buckets[GetBucket(ns / 1000)].fetch_add(1, std::memory_order_relaxed);
+  m_sumNs.fetch_add(ns, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  uint64_t max = m_maxNs.load(std::memory_order_relaxed);
+  while (ns > max && !m_maxNs.compare_exchange_weak(
+                         max, ns, std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t LoopProfiler::Epoch::GetPercentile(uint64_t count,
+                                            double percentile) const {
+  uint64_t rank = static_cast<uint64_t>(std::ceil(count * percentile));
+  if (rank == 0) {
+    rank = 1;
+  }
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += m_buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      uint64_t lower = GetBucketLowerBound(i);
+      if (i < kSubBuckets) {
+        return lower;
+      }
+      // report the middle of the bucket
+      return (lower + GetBucketLowerBound(i + 1)) / 2;
+    }
+  }
+  return 0;
+}
+
+LoopProfiler::EpochStats LoopProfiler::Epoch::GetStats() const {
+  using std::chrono::microseconds;
+
+  EpochStats stats;
+  stats.name = m_name;
+  // the buckets are read without synchronizing with Record(), so use their
+  // sum for percentiles rather than m_count
+  uint64_t count = 0;
+  for (auto&& bucket : m_buckets) {
+    count += bucket.load(std::memory_order_relaxed);
+  }
+  stats.count = m_count.load(std::memory_order_relaxed);
+  if (count == 0 || stats.count == 0) {
+    return stats;
+  }
+  uint64_t maxUs = m_maxNs.load(std::memory_order_relaxed) / 1000;
+  uint64_t sumNs = m_sumNs.load(std::memory_order_relaxed);
+  stats.mean = microseconds(sumNs / stats.count / 1000);
+  stats.p50 = microseconds((std::min)(GetPercentile(count, 0.5), maxUs));
+  stats.p99 = microseconds((std::min)(GetPercentile(count, 0.99), maxUs));
+  stats.max = microseconds(maxUs);
+  return stats;
+}
+
+void LoopProfiler::Epoch::Reset() {
+  for (auto&& bucket : m_buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  m_count = 0;
+  m_sumNs = 0;
+  m_maxNs = 0;
+}
+
+LoopProfiler& LoopProfiler::GetInstance() {
+  static LoopProfiler instance;
+  return instance;
+}
+
+LoopProfiler::LoopProfiler() = default;
+
+LoopProfiler::~LoopProfiler() = default;
+
+LoopProfiler::Epoch* LoopProfiler::GetEpoch(std::string_view name) {
+  std::scoped_lock lock(m_mutex);
+  auto& epoch = m_epochsByName[name];
+  if (!epoch) {
+    epoch = m_epochs.emplace_back(std::make_unique<Epoch>(name)).get();
+  }
+  return epoch;
+}
+
+void LoopProfiler::Record(Epoch* epoch, hal::fpga_clock::time_point start,
+                          hal::fpga_clock::time_point end, int track) {
+  auto duration = end - start;
+  epoch->Record(duration);
+
+  if (m_traceCapacity == 0) {
+    return;
+  }
+  // a seqlock per slot lets WriteChromeTrace() skip slots that are being
+  // overwritten
+  uint64_t index = m_traceNext.fetch_add(1, std::memory_order_relaxed);
+  auto& event = m_trace[index % m_traceCapacity];
+  event.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  event.epoch.store(epoch, std::memory_order_relaxed);
+  event.start.store(start.time_since_epoch().count(),
+                    std::memory_order_relaxed);
+  event.duration.store(duration.count(), std::memory_order_relaxed);
+  event.track.store(track, std::memory_order_relaxed);
+  event.sequence.store(index + 1, std::memory_order_release);
+}
+
+void LoopProfiler::SetTraceCapacity(size_t events) {
+  std::scoped_lock lock(m_mutex);
+  m_trace.reset(events == 0 ? nullptr : new TraceEvent[events]);
+  m_traceCapacity = events;
+  m_traceNext = 0;
+}
+
+void LoopProfiler::Reset() {
+  std::scoped_lock lock(m_mutex);
+  for (auto&& epoch : m_epochs) {
+    epoch->Reset();
+  }
+  for (size_t i = 0; i < m_traceCapacity; ++i) {
+    m_trace[i].sequence = 0;
+  }
+  m_traceNext = 0;
+}
+
+std::vector<LoopProfiler::EpochStats> LoopProfiler::GetStats() const {
+  std::vector<EpochStats> stats;
+  std::scoped_lock lock(m_mutex);
+  stats.reserve(m_epochs.size());
+  for (auto&& epoch : m_epochs) {
+    auto epochStats = epoch->GetStats();
+    if (epochStats.count != 0) {
+      stats.emplace_back(std::move(epochStats));
+    }
+  }
+  return stats;
+}
+
+void LoopProfiler::PrintStats(wpi::raw_ostream& os) const {
+  for (auto&& stats : GetStats()) {
+    os << fmt::format(
+        "\t{}: count {} mean {:.6f}s p50 {:.6f}s p99 {:.6f}s max {:.6f}s\n",
+        stats.name, stats.count, stats.mean.count() / 1.0e6,
+        stats.p50.count() / 1.0e6, stats.p99.count() / 1.0e6,
+        stats.max.count() / 1.0e6);
+  }
+}
+
+void LoopProfiler::PublishStats(nt::NetworkTable& table) const {
+  for (auto&& stats : GetStats()) {
+    auto subtable = table.GetSubTable(stats.name);
+    subtable->GetEntry("count").SetDouble(stats.count);
+    subtable->GetEntry("mean").SetDouble(stats.mean.count() / 1.0e3);
+    subtable->GetEntry("p50").SetDouble(stats.p50.count() / 1.0e3);
+    subtable->GetEntry("p99").SetDouble(stats.p99.count() / 1.0e3);
+    subtable->GetEntry("max").SetDouble(stats.max.count() / 1.0e3);
+  }
+}
+
+void LoopProfiler::UpdateNetworkTables() {
+  std::shared_ptr<nt::NetworkTable> table;
+  {
+    auto now = hal::fpga_clock::now();
+    std::scoped_lock lock(m_mutex);
+    if (now - m_lastPublishTime < kMinPublishPeriod) {
+      return;
+    }
+    m_lastPublishTime = now;
+    if (!m_table) {
+      m_table = nt::NetworkTableInstance::GetDefault().GetTable("LoopProfiler");
+    }
+    table = m_table;
+  }
+  PublishStats(*table);
+}
+
+static void WriteJsonString(wpi::raw_ostream& os, std::string_view str) {
+  os << '"';
+  for (char ch : str) {
+    switch (ch) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(ch) < 0x20) {
+          os << fmt::format("\\u{:04x}", static_cast<int>(ch));
+        } else {
+          os << ch;
+        }
+        break;
+    }
+  }
+  os << '"';
+}
+
+void LoopProfiler::WriteChromeTrace(wpi::raw_ostream& os) const {
+  std::scoped_lock lock(m_mutex);
+  os << "{\"traceEvents\":[";
+  uint64_t end = m_traceNext.load(std::memory_order_relaxed);
+  uint64_t begin = end > m_traceCapacity ? end - m_traceCapacity : 0;
+  bool first = true;
+  for (uint64_t i = begin; i < end; ++i) {
+    auto& event = m_trace[i % m_traceCapacity];
+    uint64_t sequence = event.sequence.load(std::memory_order_acquire);
+    Epoch* epoch = event.epoch.load(std::memory_order_relaxed);
+    int64_t start = event.start.load(std::memory_order_relaxed);
+    int64_t duration = event.duration.load(std::memory_order_relaxed);
+    int track = event.track.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // skip slots being written or already overwritten by a newer event
+    if (sequence != i + 1 ||
+        event.sequence.load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+    if (!first) {
+      os << ',';
+    }
+    first = false;
+    os << "\n{\"name\":";
+    WriteJsonString(os, epoch->GetName());
+    os << fmt::format(
+        ",\"cat\":\"epoch\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":1,"
+        "\"tid\":{}}}",
+        start, duration, track);
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool LoopProfiler::WriteChromeTrace(std::string_view filename) const {
+  std::error_code ec;
+  wpi::raw_fd_ostream os{filename, ec};
+  if (ec) {
+    return false;
+  }
+  WriteChromeTrace(os);
+  return true;
+}
@@ -45,4 +45,19 @@ bool SetCurrentThreadPriority(bool realTime, int priority) {
   return ret;
 }
 
+bool SetThreadAffinity(std::thread& thread, int cpuMask) {
+  int32_t status = 0;
+  auto native = thread.native_handle();
+  auto ret = HAL_SetThreadAffinity(&native, cpuMask, &status);
+  FRC_CheckErrorStatus(status, "{}", "SetThreadAffinity");
+  return ret;
+}
+
+bool SetCurrentThreadAffinity(int cpuMask) {
+  int32_t status = 0;
+  auto ret = HAL_SetCurrentThreadAffinity(cpuMask, &status);
+  FRC_CheckErrorStatus(status, "{}", "SetCurrentThreadAffinity");
+  return ret;
+}
+
 }  // namespace frc
@@ -6,13 +6,19 @@
 
 #include <stdint.h>
 
+#include <chrono>
+#include <exception>
+#include <thread>
 #include <utility>
 
+#include <fmt/format.h>
 #include <hal/DriverStation.h>
 #include <hal/FRCUsageReporting.h>
 #include <hal/Notifier.h>
+#include <hal/Threads.h>
 
 #include "frc/Errors.h"
+#include "frc/RobotController.h"
 #include "frc/Timer.h"
 
 using namespace frc;
@@ -24,6 +30,11 @@ void TimedRobot::StartCompetition() {
     SimulationInit();
   }
 
+  for (auto&& thread : m_threads) {
+    StartPeriodicThread(*thread);
+  }
+  m_threadsStarted = true;
+
   // Tell the DS that the robot is ready to be enabled
   HAL_ObserveUserProgramStarting();
 
@@ -45,19 +56,14 @@ void TimedRobot::StartCompetition() {
       break;
     }
 
-    callback.func();
-
-    callback.expirationTime += callback.period;
+    callback.Run();
     m_callbacks.push(std::move(callback));
 
     // Process all other callbacks that are ready to run
     while (static_cast<uint64_t>(m_callbacks.top().expirationTime * 1e6) <=
            curTime) {
       callback = m_callbacks.pop();
-
-      callback.func();
-
-      callback.expirationTime += callback.period;
+      callback.Run();
       m_callbacks.push(std::move(callback));
     }
   }
@@ -66,6 +72,9 @@ void TimedRobot::StartCompetition() {
 void TimedRobot::EndCompetition() {
   int32_t status = 0;
   HAL_StopNotifier(m_notifier, &status);
+  for (auto&& thread : m_threads) {
+    HAL_StopNotifier(thread->notifier, &status);
+  }
 }
 
 TimedRobot::TimedRobot(double period) : TimedRobot(units::second_t(period)) {}
@@ -90,9 +99,166 @@ TimedRobot::~TimedRobot() {
   FRC_ReportError(status, "{}", "StopNotifier");
 
   HAL_CleanNotifier(m_notifier, &status);
+
+  for (auto&& thread : m_threads) {
+    HAL_StopNotifier(thread->notifier, &status);
+    if (thread->thread.joinable()) {
+      thread->thread.join();
+    }
+    HAL_CleanNotifier(thread->notifier, &status);
+  }
 }
 
 void TimedRobot::AddPeriodic(std::function<void()> callback,
                              units::second_t period, units::second_t offset) {
-  m_callbacks.emplace(callback, m_startTime, period, offset);
+  m_callbacks.emplace(callback, m_startTime, period, offset,
+                      AddCallbackStats(period, -1));
+}
+
+int TimedRobot::AddPeriodicThread(int priority, int cpuMask) {
+  if (priority < 1 || priority > 99) {
+    throw FRC_MakeError(err::ParameterOutOfRange, "priority {} must be 1-99",
+                        priority);
+  }
+  // checked here, since the thread can only report a failure to set it
+  unsigned int numCpus = std::thread::hardware_concurrency();
+  if (cpuMask < 0 ||
+      (numCpus != 0 && numCpus < 31 && (cpuMask >> numCpus) != 0)) {
+    throw FRC_MakeError(err::ParameterOutOfRange,
+                        "cpuMask {:#x} selects a CPU past the {} available",
+                        cpuMask, numCpus);
+  }
+
+  auto thread = std::make_unique<PeriodicThread>();
+  thread->priority = priority;
+  thread->cpuMask = cpuMask;
+  int32_t status = 0;
+  thread->notifier = HAL_InitializeNotifier(&status);
+  FRC_CheckErrorStatus(status, "{}", "InitializeNotifier");
+  int index = m_threads.size();
+  HAL_SetNotifierName(thread->notifier,
+                      fmt::format("TimedRobot Thread {}", index).c_str(),
+                      &status);
+
+  if (m_threadsStarted) {
+    StartPeriodicThread(*thread);
+  }
+  m_threads.emplace_back(std::move(thread));
+  return index;
+}
+
+void TimedRobot::AddPeriodic(std::function<void()> callback,
+                             units::second_t period, units::second_t offset,
+                             int thread) {
+  if (thread < 0 || thread >= static_cast<int>(m_threads.size())) {
+    throw FRC_MakeError(err::ParameterOutOfRange, "thread {}", thread);
+  }
+  auto& periodicThread = *m_threads[thread];
+  std::scoped_lock lock(periodicThread.mutex);
+  periodicThread.callbacks.emplace(callback, m_startTime, period, offset,
+                                   AddCallbackStats(period, thread));
+  // wake the thread if the new callback is due first
+  int32_t status = 0;
+  HAL_UpdateNotifierAlarm(
+      periodicThread.notifier,
+      static_cast<uint64_t>(periodicThread.callbacks.top().expirationTime *
+                            1e6),
+      &status);
+}
+
+std::vector<TimedRobot::PeriodicStats> TimedRobot::GetPeriodicStats() const {
+  std::vector<PeriodicStats> rv;
+  rv.reserve(m_callbackStats.size());
+  for (auto&& stats : m_callbackStats) {
+    rv.push_back({stats->period, stats->thread,
+                  stats->overruns.load(std::memory_order_relaxed),
+                  stats->jitter.GetStats()});
+  }
+  return rv;
+}
+
+void TimedRobot::Callback::Run() {
+  uint64_t expiration = static_cast<uint64_t>(expirationTime * 1e6);
+  uint64_t start = RobotController::GetFPGATime();
+  func();
+  expirationTime += period;
+
+  uint64_t end = RobotController::GetFPGATime();
+  stats->jitter.Record(
+      std::chrono::microseconds(start > expiration ? start - expiration : 0));
+  if (end > static_cast<uint64_t>(expirationTime * 1e6)) {
+    stats->overruns.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void TimedRobot::RunPeriodicThread(PeriodicThread& thread) {
+  // Errors are reported rather than thrown; an exception escaping this thread
+  // would terminate the program.
+  int32_t status = 0;
+  HAL_SetCurrentThreadPriority(true, thread.priority, &status);
+  FRC_ReportError(status, "{}", "SetCurrentThreadPriority");
+  if (thread.cpuMask != 0) {
+    status = 0;
+    HAL_SetCurrentThreadAffinity(thread.cpuMask, &status);
+    FRC_ReportError(status, "{}", "SetCurrentThreadAffinity");
+  }
+
+  std::unique_lock lock(thread.mutex);
+  for (;;) {
+    status = 0;
+    if (thread.callbacks.empty()) {
+      HAL_CancelNotifierAlarm(thread.notifier, &status);
+    } else {
+      HAL_UpdateNotifierAlarm(
+          thread.notifier,
+          static_cast<uint64_t>(thread.callbacks.top().expirationTime * 1e6),
+          &status);
+    }
+
+    lock.unlock();
+    uint64_t curTime = HAL_WaitForNotifierAlarm(thread.notifier, &status);
+    if (curTime == 0 || status != 0) {
+      break;
+    }
+    lock.lock();
+
+    // Process all callbacks that are ready to run
+    while (!thread.callbacks.empty() &&
+           static_cast<uint64_t>(thread.callbacks.top().expirationTime * 1e6) <=
+               curTime) {
+      auto callback = thread.callbacks.pop();
+      lock.unlock();
+      bool ok = false;
+      try {
+        callback.Run();
+        ok = true;
+      } catch (const RuntimeError& e) {
+        e.Report();
+      } catch (const std::exception& e) {
+        HAL_SendError(1, err::Error, 0, e.what(), "", "", 1);
+      } catch (...) {
+      }
+      if (!ok) {
+        FRC_ReportError(err::Error, "{}",
+                        "A TimedRobot thread callback threw an exception;"
+                        " stopping the robot program.");
+        EndCompetition();
+        return;
+      }
+      lock.lock();
+      thread.callbacks.push(std::move(callback));
+    }
+  }
+}
+
+void TimedRobot::StartPeriodicThread(PeriodicThread& thread) {
+  thread.thread = std::thread([this, &thread] { RunPeriodicThread(thread); });
+}
+
+std::shared_ptr<TimedRobot::CallbackStats> TimedRobot::AddCallbackStats(
+    units::second_t period, int thread) {
+  auto stats = std::make_shared<CallbackStats>(
+      fmt::format("Callback {}", m_callbackStats.size()), period, thread);
+  m_callbackStats.emplace_back(stats);
+  return stats;
 }
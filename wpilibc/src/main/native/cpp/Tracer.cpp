@@ -4,6 +4,8 @@
 
 #include "frc/Tracer.h"
 
+#include <atomic>
+
 #include <fmt/format.h>
 #include <wpi/SmallString.h>
 #include <wpi/raw_ostream.h>
@@ -12,7 +14,10 @@
 
 using namespace frc;
 
-Tracer::Tracer() {
+// track 0 is used by IterativeRobotBase for the whole loop
+static std::atomic_int gNextTrack{1};
+
+Tracer::Tracer() : m_track{gNextTrack++} {
   ResetTimer();
 }
 
@@ -22,12 +27,23 @@ void Tracer::ResetTimer() {
 
 void Tracer::ClearEpochs() {
   ResetTimer();
-  m_epochs.clear();
+  for (auto&& epoch : m_epochs) {
+    epoch.getValue().active = false;
+  }
 }
 
 void Tracer::AddEpoch(std::string_view epochName) {
   auto currentTime = hal::fpga_clock::now();
-  m_epochs[epochName] = currentTime - m_startTime;
+  auto& epoch = m_epochs[epochName];
+  epoch.duration = currentTime - m_startTime;
+  epoch.active = true;
+  if (LoopProfiler::IsEnabled()) {
+    auto& profiler = LoopProfiler::GetInstance();
+    if (!epoch.profile) {
+      epoch.profile = profiler.GetEpoch(epochName);
+    }
+    profiler.Record(epoch.profile, m_startTime, currentTime, m_track);
+  }
   m_startTime = currentTime;
 }
 
@@ -48,9 +64,13 @@ void Tracer::PrintEpochs(wpi::raw_ostream& os) {
   if (now - m_lastEpochsPrintTime > kMinPrintPeriod) {
     m_lastEpochsPrintTime = now;
     for (const auto& epoch : m_epochs) {
+      if (!epoch.getValue().active) {
+        continue;
+      }
       os << fmt::format(
           "\t{}: {:.6f}s\n", epoch.getKey(),
-          duration_cast<microseconds>(epoch.getValue()).count() / 1.0e6);
+          duration_cast<microseconds>(epoch.getValue().duration).count() /
+              1.0e6);
     }
   }
 }
@@ -48,4 +48,16 @@ void StepTimingAsync(units::second_t delta) {
   HALSIM_StepTimingAsync(static_cast<uint64_t>(delta.to<double>() * 1e6));
 }
 
+void SetValueBatchNotify(bool enable) {
+  HALSIM_SetSimValueBatchNotify(enable);
+}
+
+bool GetValueBatchNotify() {
+  return HALSIM_GetSimValueBatchNotify();
+}
+
+void FlushValueBatchNotify() {
+  HALSIM_FlushSimValueBatchNotify();
+}
+
 }  // namespace frc::sim
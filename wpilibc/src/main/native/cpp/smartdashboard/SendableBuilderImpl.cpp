@@ -104,7 +104,7 @@ void SendableBuilderImpl::AddBooleanProperty(std::string_view key,
   if (getter) {
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
-      entry.SetValue(nt::Value::MakeBoolean(getter(), time));
+      nt::SetEntryBoolean(entry.GetHandle(), getter(), time);
     };
   }
   if (setter) {
@@ -130,7 +130,7 @@ void SendableBuilderImpl::AddDoubleProperty(
   if (getter) {
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
-      entry.SetValue(nt::Value::MakeDouble(getter(), time));
+      nt::SetEntryDouble(entry.GetHandle(), getter(), time);
     };
   }
   if (setter) {
@@ -156,7 +156,7 @@ void SendableBuilderImpl::AddStringProperty(
   if (getter) {
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
-      entry.SetValue(nt::Value::MakeString(getter(), time));
+      nt::SetEntryString(entry.GetHandle(), getter(), time);
     };
   }
   if (setter) {
@@ -182,7 +182,7 @@ void SendableBuilderImpl::AddBooleanArrayProperty(
   if (getter) {
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
-      entry.SetValue(nt::Value::MakeBooleanArray(getter(), time));
+      nt::SetEntryBooleanArray(entry.GetHandle(), getter(), time);
     };
   }
   if (setter) {
@@ -208,7 +208,7 @@ void SendableBuilderImpl::AddDoubleArrayProperty(
   if (getter) {
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
-      entry.SetValue(nt::Value::MakeDoubleArray(getter(), time));
+      nt::SetEntryDoubleArray(entry.GetHandle(), getter(), time);
     };
   }
   if (setter) {
@@ -234,7 +234,7 @@ void SendableBuilderImpl::AddStringArrayProperty(
   if (getter) {
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
-      entry.SetValue(nt::Value::MakeStringArray(getter(), time));
+      nt::SetEntryStringArray(entry.GetHandle(), getter(), time);
     };
   }
   if (setter) {
@@ -260,7 +260,7 @@ void SendableBuilderImpl::AddRawProperty(
   if (getter) {
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
-      entry.SetValue(nt::Value::MakeRaw(getter(), time));
+      nt::SetEntryRaw(entry.GetHandle(), getter(), time);
     };
   }
   if (setter) {
@@ -310,7 +310,7 @@ void SendableBuilderImpl::AddSmallStringProperty(
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
       wpi::SmallString<128> buf;
-      entry.SetValue(nt::Value::MakeString(getter(buf), time));
+      nt::SetEntryString(entry.GetHandle(), getter(buf), time);
     };
   }
   if (setter) {
@@ -338,7 +338,7 @@ void SendableBuilderImpl::AddSmallBooleanArrayProperty(
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
       wpi::SmallVector<int, 16> buf;
-      entry.SetValue(nt::Value::MakeBooleanArray(getter(buf), time));
+      nt::SetEntryBooleanArray(entry.GetHandle(), getter(buf), time);
     };
   }
   if (setter) {
@@ -367,7 +367,7 @@ void SendableBuilderImpl::AddSmallDoubleArrayProperty(
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
       wpi::SmallVector<double, 16> buf;
-      entry.SetValue(nt::Value::MakeDoubleArray(getter(buf), time));
+      nt::SetEntryDoubleArray(entry.GetHandle(), getter(buf), time);
     };
   }
   if (setter) {
@@ -397,7 +397,7 @@ void SendableBuilderImpl::AddSmallStringArrayProperty(
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
       wpi::SmallVector<std::string, 16> buf;
-      entry.SetValue(nt::Value::MakeStringArray(getter(buf), time));
+      nt::SetEntryStringArray(entry.GetHandle(), getter(buf), time);
     };
   }
   if (setter) {
@@ -425,7 +425,7 @@ void SendableBuilderImpl::AddSmallRawProperty(
     m_properties.back().update = [=](nt::NetworkTableEntry entry,
                                      uint64_t time) {
       wpi::SmallVector<char, 128> buf;
-      entry.SetValue(nt::Value::MakeRaw(getter(buf), time));
+      nt::SetEntryRaw(entry.GetHandle(), getter(buf), time);
     };
   }
   if (setter) {
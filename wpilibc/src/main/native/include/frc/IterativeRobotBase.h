@@ -7,6 +7,7 @@
 #include <units/time.h>
 #include <wpi/deprecated.h>
 
+#include "frc/LoopProfiler.h"
 #include "frc/RobotBase.h"
 #include "frc/Watchdog.h"
 
@@ -198,6 +199,7 @@ class IterativeRobotBase : public RobotBase {
   units::second_t m_period;
   Watchdog m_watchdog;
   bool m_ntFlushEnabled = false;
+  LoopProfiler::Epoch* m_loopProfile = nullptr;
 
   void PrintLoopOverrunMessage();
 };
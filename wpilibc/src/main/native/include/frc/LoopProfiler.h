@@ -0,0 +1,262 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <hal/cpp/fpga_clock.h>
+#include <wpi/StringMap.h>
+#include <wpi/mutex.h>
+
+namespace wpi {
+class raw_ostream;
+}  // namespace wpi
+
+namespace nt {
+class NetworkTable;
+}  // namespace nt
+
+namespace frc {
+
+/**
+ * Collects latency histograms for Tracer epochs over the lifetime of the
+ * program, for continuous profiling of robot loops.
+ *
+ * When enabled, every Tracer (including the ones in Watchdog, and therefore
+ * in TimedRobot, IterativeRobotBase, and the command-based CommandScheduler)
+ * records each epoch's duration into a per-epoch histogram. Recording is
+ * lock-free and allocation-free after the first time an epoch name is seen,
+ * so profiling can be left on during matches.
+ *
+ * Histograms use logarithmic buckets with 1 microsecond resolution below 8
+ * microseconds and 8 buckets per power of two above that, so reported
+ * percentiles are within 6.25% of the recorded value. The maximum is exact.
+ *
+ * The most recent epochs may also be kept in a fixed-size ring buffer and
+ * written out in the Chrome trace event format, which can be viewed in
+ * chrome://tracing or https://ui.perfetto.dev.
+ */
+class LoopProfiler {
+ public:
+  /**
+   * Summary statistics for a single epoch.
+   */
+  struct EpochStats {
+    /** Epoch name. */
+    std::string name;
+
+    /** Number of times the epoch was recorded. */
+    uint64_t count = 0;
+
+    /** Mean duration. */
+    std::chrono::microseconds mean{0};
+
+    /** Median duration. */
+    std::chrono::microseconds p50{0};
+
+    /** 99th percentile duration. */
+    std::chrono::microseconds p99{0};
+
+    /** Maximum duration. */
+    std::chrono::microseconds max{0};
+  };
+
+  class Epoch;
+
+  /**
+   * Gets the global profiler instance.
+   */
+  static LoopProfiler& GetInstance();
+
+  /**
+   * Enables or disables recording. By default, recording is disabled.
+   *
+   * @param enabled True to enable, false to disable
+   */
+  static void SetEnabled(bool enabled) {
+    gEnabled.store(enabled, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns true if recording is enabled.
+   */
+  static bool IsEnabled() { return gEnabled.load(std::memory_order_relaxed); }
+
+  LoopProfiler();
+  ~LoopProfiler();
+  LoopProfiler(const LoopProfiler&) = delete;
+  LoopProfiler& operator=(const LoopProfiler&) = delete;
+
+  /**
+   * Gets the histogram for an epoch name, creating it if necessary. The
+   * returned pointer is valid for the lifetime of the profiler, so callers
+   * should look it up once and cache it.
+   *
+   * @param name epoch name
+   * @return epoch
+   */
+  Epoch* GetEpoch(std::string_view name);
+
+  /**
+   * Records a single epoch. Lock-free; may be called concurrently from
+   * multiple threads.
+   *
+   * @param epoch epoch returned by GetEpoch()
+   * @param start time the epoch started
+   * @param end time the epoch ended
+   * @param track identifies the loop the epoch was recorded in; epochs with
+   *              the same track are drawn on the same row of the trace
+   */
+  void Record(Epoch* epoch, hal::fpga_clock::time_point start,
+              hal::fpga_clock::time_point end, int track = 0);
+
+  /**
+   * Sets the number of most recent epochs kept for WriteChromeTrace(). Set to
+   * 0 (the default) to only keep histograms. Clears previously kept epochs.
+   * Not safe to call concurrently with Record().
+   *
+   * @param events number of epochs to keep
+   */
+  void SetTraceCapacity(size_t events);
+
+  /**
+   * Clears all histograms and trace events.
+   */
+  void Reset();
+
+  /**
+   * Gets statistics for all epochs recorded at least once, in the order they
+   * were first seen.
+   */
+  std::vector<EpochStats> GetStats() const;
+
+  /**
+   * Prints statistics for all epochs to a stream.
+   *
+   * @param os output stream
+   */
+  void PrintStats(wpi::raw_ostream& os) const;
+
+  /**
+   * Publishes statistics to a NetworkTables table. Each epoch gets a subtable
+   * with "count", "mean", "p50", "p99", and "max" entries, with durations in
+   * milliseconds. Unchanged values are not republished.
+   *
+   * @param table table to publish to
+   */
+  void PublishStats(nt::NetworkTable& table) const;
+
+  /**
+   * Publishes statistics to the "LoopProfiler" NetworkTables table at most
+   * once per second. Called by IterativeRobotBase every loop while recording
+   * is enabled.
+   */
+  void UpdateNetworkTables();
+
+  /**
+   * Writes the kept trace events to a stream in the Chrome trace event JSON
+   * format.
+   *
+   * @param os output stream
+   */
+  void WriteChromeTrace(wpi::raw_ostream& os) const;
+
+  /**
+   * Writes the kept trace events to a file in the Chrome trace event JSON
+   * format.
+   *
+   * @param filename file name
+   * @return False if the file could not be opened
+   */
+  bool WriteChromeTrace(std::string_view filename) const;
+
+ private:
+  static constexpr std::chrono::milliseconds kMinPublishPeriod{1000};
+
+  static std::atomic_bool gEnabled;
+
+  struct TraceEvent {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<Epoch*> epoch{nullptr};
+    std::atomic<int64_t> start{0};
+    std::atomic<int64_t> duration{0};
+    std::atomic_int track{0};
+  };
+
+  mutable wpi::mutex m_mutex;
+  wpi::StringMap<Epoch*> m_epochsByName;
+  std::deque<std::unique_ptr<Epoch>> m_epochs;
+
+  std::unique_ptr<TraceEvent[]> m_trace;
+  size_t m_traceCapacity = 0;
+  std::atomic<uint64_t> m_traceNext{0};
+
+  std::shared_ptr<nt::NetworkTable> m_table;
+  hal::fpga_clock::time_point m_lastPublishTime = hal::fpga_clock::epoch();
+};
+
+/**
+ * Latency histogram for a single epoch name.
+ */
+class LoopProfiler::Epoch {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  // up to 2^27 us (134 s)
+  static constexpr int kNumBuckets = (27 - kSubBucketBits + 1) * kSubBuckets;
+
+  explicit Epoch(std::string_view name) : m_name{name} {}
+
+  /**
+   * Returns the epoch name.
+   */
+  const std::string& GetName() const { return m_name; }
+
+  /**
+   * Records a duration.
+   *
+   * @param duration duration
+   */
+  void Record(std::chrono::nanoseconds duration);
+
+  /**
+   * Gets summary statistics.
+   */
+  EpochStats GetStats() const;
+
+  /**
+   * Clears the histogram.
+   */
+  void Reset();
+
+  /**
+   * Gets the index of the bucket holding a duration in microseconds.
+   */
+  static int GetBucket(uint64_t us);
+
+  /**
+   * Gets the smallest duration in microseconds held by a bucket.
+   */
+  static uint64_t GetBucketLowerBound(int bucket);
+
+ private:
+  uint64_t GetPercentile(uint64_t count, double percentile) const;
+
+  std::string m_name;
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<uint64_t> m_sumNs{0};
+  std::atomic<uint64_t> m_maxNs{0};
+  std::atomic<uint32_t> m_buckets[kNumBuckets] = {};
+};
+
+}  // namespace frc
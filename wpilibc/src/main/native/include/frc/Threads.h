@@ -54,4 +54,21 @@ bool SetThreadPriority(std::thread& thread, bool realTime, int priority);
  */
 bool SetCurrentThreadPriority(bool realTime, int priority);
 
+/**
+ * Sets the CPUs the specified thread is allowed to run on.
+ *
+ * @param thread  Reference to the thread to set the affinity of.
+ * @param cpuMask Bit mask of allowed CPUs; bit 0 is CPU 0. Must not be 0.
+ * @return        True on success.
+ */
+bool SetThreadAffinity(std::thread& thread, int cpuMask);
+
+/**
+ * Sets the CPUs the current thread is allowed to run on.
+ *
+ * @param cpuMask Bit mask of allowed CPUs; bit 0 is CPU 0. Must not be 0.
+ * @return        True on success.
+ */
+bool SetCurrentThreadAffinity(int cpuMask);
+
 }  // namespace frc
@@ -4,7 +4,13 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -12,9 +18,11 @@
 #include <units/math.h>
 #include <units/time.h>
 #include <wpi/deprecated.h>
+#include <wpi/mutex.h>
 #include <wpi/priority_queue.h>
 
 #include "frc/IterativeRobotBase.h"
+#include "frc/LoopProfiler.h"
 #include "frc/Timer.h"
 
 namespace frc {
@@ -27,6 +35,10 @@ namespace frc {
  *
  * Periodic() functions from the base class are called on an interval by a
  * Notifier instance.
+ *
+ * Additional periodic callbacks may run on the same Notifier, or on one of a
+ * small number of real-time threads added with AddPeriodicThread(), so that
+ * fast control loops aren't delayed by slow callbacks on other threads.
  */
 class TimedRobot : public IterativeRobotBase {
  public:
@@ -80,12 +92,84 @@ class TimedRobot : public IterativeRobotBase {
   void AddPeriodic(std::function<void()> callback, units::second_t period,
                    units::second_t offset = 0_s);
 
+  /**
+   * Adds a real-time thread for running periodic callbacks. Callbacks added to
+   * the thread with AddPeriodic() run in the order they're due, and are
+   * isolated from callbacks on TimedRobot's Notifier and on other threads.
+   *
+   * Threads start running callbacks when StartCompetition() is called, or
+   * immediately if it has already been called.
+   *
+   * @param priority Real-time priority of the thread, 1-99 with 99 being
+   *                 highest. The main robot thread's priority is 0.
+   * @param cpuMask  Bit mask of CPUs the thread may run on (bit 0 is CPU 0),
+   *                 or 0 to not restrict it. Only CPUs that exist may be
+   *                 selected.
+   * @return The thread index to pass to AddPeriodic().
+   */
+  int AddPeriodicThread(int priority, int cpuMask = 0);
+
+  /**
+   * Add a callback to run at a specific period with a starting time offset on
+   * a thread added with AddPeriodicThread().
+   *
+   * The callback runs asynchronously to TimedRobot, so any state shared with
+   * the robot program must be synchronized.
+   *
+   * @param callback The callback to run.
+   * @param period   The period at which to run the callback.
+   * @param offset   The offset from the common starting time.
+   * @param thread   The thread index returned by AddPeriodicThread().
+   */
+  void AddPeriodic(std::function<void()> callback, units::second_t period,
+                   units::second_t offset, int thread);
+
+  /**
+   * Timing statistics for a periodic callback.
+   */
+  struct PeriodicStats {
+    /** The period at which the callback runs. */
+    units::second_t period;
+
+    /** The callback's thread index, or -1 for TimedRobot's Notifier. */
+    int thread;
+
+    /** Number of times the callback finished after its next start time. */
+    uint64_t overruns;
+
+    /**
+     * Delay from each scheduled start time to when the callback was called;
+     * count is the number of times the callback has run.
+     */
+    LoopProfiler::EpochStats jitter;
+  };
+
+  /**
+   * Gets timing statistics for each callback, in the order they were added.
+   * The first callback is the one that calls the mode-specific periodic
+   * functions.
+   *
+   * Must not be called concurrently with AddPeriodic().
+   */
+  std::vector<PeriodicStats> GetPeriodicStats() const;
+
  private:
+  struct CallbackStats {
+    CallbackStats(std::string_view name, units::second_t period, int thread)
+        : period{period}, thread{thread}, jitter{name} {}
+
+    units::second_t period;
+    int thread;
+    std::atomic<uint64_t> overruns{0};
+    LoopProfiler::Epoch jitter;
+  };
+
   class Callback {
    public:
     std::function<void()> func;
     units::second_t period;
     units::second_t expirationTime;
+    std::shared_ptr<CallbackStats> stats;
 
     /**
      * Construct a callback container.
@@ -96,25 +180,53 @@ class TimedRobot : public IterativeRobotBase {
      * @param offset    The offset from the common starting time.
      */
     Callback(std::function<void()> func, units::second_t startTime,
-             units::second_t period, units::second_t offset)
+             units::second_t period, units::second_t offset,
+             std::shared_ptr<CallbackStats> stats)
         : func{std::move(func)},
           period{period},
           expirationTime{startTime + offset +
                          units::math::floor(
                              (Timer::GetFPGATimestamp() - startTime) / period) *
                              period +
-                         period} {}
+                         period},
+          stats{std::move(stats)} {}
+
+    /**
+     * Runs the callback, records its timing, and advances its expiration
+     * time by one period.
+     */
+    void Run();
 
     bool operator>(const Callback& rhs) const {
       return expirationTime > rhs.expirationTime;
     }
   };
 
+  using CallbackQueue = wpi::priority_queue<Callback, std::vector<Callback>,
+                                            std::greater<Callback>>;
+
+  struct PeriodicThread {
+    int priority;
+    int cpuMask;
+    hal::Handle<HAL_NotifierHandle> notifier;
+    wpi::mutex mutex;
+    CallbackQueue callbacks;
+    std::thread thread;
+  };
+
+  void RunPeriodicThread(PeriodicThread& thread);
+  void StartPeriodicThread(PeriodicThread& thread);
+  std::shared_ptr<CallbackStats> AddCallbackStats(units::second_t period,
+                                                  int thread);
+
   hal::Handle<HAL_NotifierHandle> m_notifier;
   units::second_t m_startTime;
 
-  wpi::priority_queue<Callback, std::vector<Callback>, std::greater<Callback>>
-      m_callbacks;
+  CallbackQueue m_callbacks;
+
+  std::vector<std::unique_ptr<PeriodicThread>> m_threads;
+  bool m_threadsStarted = false;
+  std::vector<std::shared_ptr<CallbackStats>> m_callbackStats;
 };
 
 }  // namespace frc
@@ -10,6 +10,8 @@
 #include <hal/cpp/fpga_clock.h>
 #include <wpi/StringMap.h>
 
+#include "frc/LoopProfiler.h"
+
 namespace wpi {
 class raw_ostream;
 }  // namespace wpi
@@ -22,6 +24,9 @@ namespace frc {
  *
  * Epochs are a way to partition the time elapsed so that when overruns occur,
  * one can determine which parts of an operation consumed the most time.
+ *
+ * While LoopProfiler recording is enabled, each epoch is also recorded into
+ * the LoopProfiler histogram of the same name.
  */
 class Tracer {
  public:
@@ -65,9 +70,18 @@ class Tracer {
  private:
   static constexpr std::chrono::milliseconds kMinPrintPeriod{1000};
 
+  struct Epoch {
+    std::chrono::nanoseconds duration{0};
+    // false if cleared since last added; entries are kept so the map doesn't
+    // reallocate every loop and the profiler epoch lookup is cached
+    bool active = false;
+    LoopProfiler::Epoch* profile = nullptr;
+  };
+
   hal::fpga_clock::time_point m_startTime;
   hal::fpga_clock::time_point m_lastEpochsPrintTime = hal::fpga_clock::epoch();
+  int m_track;
 
-  wpi::StringMap<std::chrono::nanoseconds> m_epochs;
+  wpi::StringMap<Epoch> m_epochs;
 };
 }  // namespace frc
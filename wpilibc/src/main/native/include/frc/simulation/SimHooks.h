@@ -60,4 +60,25 @@ void StepTiming(units::second_t delta);
  */
 void StepTimingAsync(units::second_t delta);
 
+/**
+ * Enable or disable batched value change notification.  When enabled, each
+ * simulation value callback is called once per StepTiming() with the latest
+ * value instead of on every change.
+ *
+ * @param enable true to enable batching
+ */
+void SetValueBatchNotify(bool enable);
+
+/**
+ * Check if batched value change notification is enabled.
+ *
+ * @return true if enabled
+ */
+bool GetValueBatchNotify();
+
+/**
+ * Notify all values changed since the last batch.
+ */
+void FlushValueBatchNotify();
+
 }  // namespace frc::sim
@@ -0,0 +1,182 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include <networktables/NetworkTableInstance.h>
+#include <wpi/SmallString.h>
+#include <wpi/raw_ostream.h>
+
+#include "frc/LoopProfiler.h"
+#include "frc/Tracer.h"
+#include "frc/simulation/SimHooks.h"
+#include "gtest/gtest.h"
+
+using namespace frc;
+using std::chrono::microseconds;
+
+namespace {
+class LoopProfilerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    LoopProfiler::GetInstance().Reset();
+    LoopProfiler::SetEnabled(true);
+    frc::sim::PauseTiming();
+  }
+
+  void TearDown() override {
+    frc::sim::ResumeTiming();
+    LoopProfiler::SetEnabled(false);
+    LoopProfiler::GetInstance().SetTraceCapacity(0);
+    LoopProfiler::GetInstance().Reset();
+  }
+};
+
+const LoopProfiler::EpochStats* FindStats(
+    const std::vector<LoopProfiler::EpochStats>& stats, std::string_view name) {
+  for (auto&& epochStats : stats) {
+    if (epochStats.name == name) {
+      return &epochStats;
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
+TEST(LoopProfilerEpochTest, Buckets) {
+  using Epoch = LoopProfiler::Epoch;
+  int last = -1;
+  for (uint64_t us = 0; us < (1u << 20); us += 1 + us / 64) {
+    int bucket = Epoch::GetBucket(us);
+    EXPECT_GE(bucket, last);
+    EXPECT_LE(Epoch::GetBucketLowerBound(bucket), us);
+    EXPECT_GT(Epoch::GetBucketLowerBound(bucket + 1), us);
+    last = bucket;
+  }
+  EXPECT_EQ(Epoch::kNumBuckets - 1, Epoch::GetBucket(UINT64_MAX / 2));
+}
+
+TEST(LoopProfilerEpochTest, Percentiles) {
+  LoopProfiler::Epoch epoch{"test"};
+  for (int i = 1; i <= 1000; ++i) {
+    epoch.Record(microseconds(i));
+  }
+  auto stats = epoch.GetStats();
+  EXPECT_EQ("test", stats.name);
+  EXPECT_EQ(1000u, stats.count);
+  EXPECT_EQ(500, stats.mean.count());
+  EXPECT_NEAR(500, stats.p50.count(), 500 * 0.0625);
+  EXPECT_NEAR(990, stats.p99.count(), 990 * 0.0625);
+  EXPECT_EQ(1000, stats.max.count());
+
+  epoch.Reset();
+  EXPECT_EQ(0u, epoch.GetStats().count);
+}
+
+TEST_F(LoopProfilerTest, Tracer) {
+  Tracer tracer;
+  for (int i = 0; i < 100; ++i) {
+    tracer.ClearEpochs();
+    frc::sim::StepTiming(1_ms);
+    tracer.AddEpoch("LoopProfilerTest.Fast");
+    frc::sim::StepTiming(i == 50 ? 20_ms : 5_ms);
+    tracer.AddEpoch("LoopProfilerTest.Slow");
+  }
+
+  auto stats = LoopProfiler::GetInstance().GetStats();
+  auto fast = FindStats(stats, "LoopProfilerTest.Fast");
+  ASSERT_TRUE(fast);
+  EXPECT_EQ(100u, fast->count);
+  EXPECT_NEAR(1000, fast->p50.count(), 1000 * 0.0625);
+  EXPECT_EQ(1000, fast->max.count());
+
+  auto slow = FindStats(stats, "LoopProfilerTest.Slow");
+  ASSERT_TRUE(slow);
+  EXPECT_NEAR(5000, slow->p50.count(), 5000 * 0.0625);
+  EXPECT_NEAR(5000, slow->p99.count(), 5000 * 0.0625);
+  EXPECT_EQ(20000, slow->max.count());
+
+  // disabled recording doesn't change the histograms
+  LoopProfiler::SetEnabled(false);
+  tracer.AddEpoch("LoopProfilerTest.Fast");
+  stats = LoopProfiler::GetInstance().GetStats();
+  EXPECT_EQ(100u, FindStats(stats, "LoopProfilerTest.Fast")->count);
+}
+
+TEST_F(LoopProfilerTest, ChromeTrace) {
+  auto& profiler = LoopProfiler::GetInstance();
+  profiler.SetTraceCapacity(4);
+  auto epoch = profiler.GetEpoch("Trace \"quoted\"");
+  auto start = hal::fpga_clock::time_point(microseconds(1000));
+  for (int i = 0; i < 6; ++i) {
+    profiler.Record(epoch, start + microseconds(100 * i),
+                    start + microseconds(100 * i + 10 + i), 3);
+  }
+
+  wpi::SmallString<512> buf;
+  wpi::raw_svector_ostream os(buf);
+  profiler.WriteChromeTrace(os);
+  std::string_view out = os.str();
+
+  EXPECT_EQ(0u, out.find("{\"traceEvents\":["));
+  EXPECT_NE(std::string_view::npos, out.find("\"Trace \\\"quoted\\\"\""));
+  // only the last 4 events are kept
+  EXPECT_EQ(std::string_view::npos, out.find("\"ts\":1100,"));
+  EXPECT_NE(std::string_view::npos, out.find("\"ts\":1200,\"dur\":12,"));
+  EXPECT_NE(std::string_view::npos, out.find("\"ts\":1500,\"dur\":15,"));
+  EXPECT_NE(std::string_view::npos, out.find("\"tid\":3}"));
+}
+
+TEST_F(LoopProfilerTest, PublishStats) {
+  auto inst = nt::NetworkTableInstance::Create();
+  auto table = inst.GetTable("LoopProfiler");
+
+  auto& profiler = LoopProfiler::GetInstance();
+  auto epoch = profiler.GetEpoch("LoopProfilerTest.Publish");
+  auto start = hal::fpga_clock::time_point(microseconds(0));
+  profiler.Record(epoch, start, start + microseconds(2500));
+  profiler.PublishStats(*table);
+
+  auto subtable = table->GetSubTable("LoopProfilerTest.Publish");
+  EXPECT_EQ(1.0, subtable->GetEntry("count").GetDouble(0));
+  EXPECT_EQ(2.5, subtable->GetEntry("max").GetDouble(0));
+  EXPECT_NEAR(2.5, subtable->GetEntry("p99").GetDouble(0), 2.5 * 0.0625);
+
+  nt::NetworkTableInstance::Destroy(inst);
+}
+
+// Reports the cost of adding a Tracer epoch with and without profiling, for
+// a loop of 10 epochs.
+TEST_F(LoopProfilerTest, Benchmark) {
+  static constexpr int kLoops = 100000;
+  static constexpr const char* kNames[] = {
+      "Benchmark0", "Benchmark1", "Benchmark2", "Benchmark3", "Benchmark4",
+      "Benchmark5", "Benchmark6", "Benchmark7", "Benchmark8", "Benchmark9"};
+
+  auto time = [](bool enabled) {
+    LoopProfiler::SetEnabled(enabled);
+    Tracer tracer;
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < kLoops; ++loop) {
+      tracer.ClearEpochs();
+      for (auto name : kNames) {
+        tracer.AddEpoch(name);
+      }
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kLoops / 10;
+  };
+
+  double disabled = time(false);
+  double enabled = time(true);
+  LoopProfiler::GetInstance().SetTraceCapacity(65536);
+  double traced = time(true);
+
+  std::cout << "AddEpoch (ns): disabled " << disabled << ", histograms "
+            << enabled << ", histograms and trace " << traced << "\n";
+}
@@ -7,6 +7,7 @@
 #include <stdint.h>
 
 #include <atomic>
+#include <stdexcept>
 #include <thread>
 
 #include "frc/simulation/DriverStationSim.h"
@@ -389,3 +390,59 @@ TEST_F(TimedRobotTest, AddPeriodicWithOffset) {
   robot.EndCompetition();
   robotThread.join();
 }
+
+TEST_F(TimedRobotTest, AddPeriodicThread) {
+  MockRobot robot;
+
+  std::atomic<uint32_t> callbackCount{0};
+  int thread = robot.AddPeriodicThread(50);
+  EXPECT_EQ(0, thread);
+  robot.AddPeriodic([&] { callbackCount++; }, 5_ms, 0_ms, thread);
+  EXPECT_THROW(robot.AddPeriodic([] {}, 5_ms, 0_ms, 1), std::runtime_error);
+  EXPECT_THROW(robot.AddPeriodicThread(0), std::runtime_error);
+  EXPECT_THROW(robot.AddPeriodicThread(50, -1), std::runtime_error);
+
+  std::thread robotThread{[&] { robot.StartCompetition(); }};
+
+  frc::sim::DriverStationSim::SetEnabled(false);
+  frc::sim::DriverStationSim::NotifyNewData();
+  frc::sim::StepTiming(0_ms);  // Wait for Notifiers
+
+  EXPECT_EQ(0u, robot.m_disabledPeriodicCount);
+  EXPECT_EQ(0u, callbackCount);
+
+  frc::sim::StepTiming(20_ms);
+
+  EXPECT_EQ(1u, robot.m_disabledPeriodicCount);
+  EXPECT_EQ(4u, callbackCount);
+
+  auto stats = robot.GetPeriodicStats();
+  ASSERT_EQ(2u, stats.size());
+  EXPECT_EQ(-1, stats[0].thread);
+  EXPECT_EQ(1u, stats[0].jitter.count);
+  EXPECT_EQ(0, stats[1].thread);
+  EXPECT_EQ(5_ms, stats[1].period);
+  EXPECT_EQ(4u, stats[1].jitter.count);
+  EXPECT_EQ(0u, stats[1].overruns);
+
+  robot.EndCompetition();
+  robotThread.join();
+}
+
+TEST_F(TimedRobotTest, AddPeriodicThreadException) {
+  MockRobot robot;
+
+  int thread = robot.AddPeriodicThread(50);
+  robot.AddPeriodic([] { throw std::runtime_error("callback error"); }, 5_ms,
+                    0_ms, thread);
+
+  std::thread robotThread{[&] { robot.StartCompetition(); }};
+
+  frc::sim::DriverStationSim::SetEnabled(false);
+  frc::sim::DriverStationSim::NotifyNewData();
+  frc::sim::StepTiming(0_ms);  // Wait for Notifiers
+
+  // The exception ends the robot program instead of terminating the process
+  frc::sim::StepTiming(5_ms);
+  robotThread.join();
+}
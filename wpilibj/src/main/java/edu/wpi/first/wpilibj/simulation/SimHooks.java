@@ -71,4 +71,28 @@ public final class SimHooks {
   public static void stepTimingAsync(double deltaSeconds) {
     SimulatorJNI.stepTimingAsync((long) (deltaSeconds * 1e6));
   }
+
+  /**
+   * Enable or disable batched value change notification. When enabled, each simulation value
+   * callback is called once per stepTiming() with the latest value instead of on every change.
+   *
+   * @param enable true to enable batching
+   */
+  public static void setValueBatchNotify(boolean enable) {
+    SimulatorJNI.setSimValueBatchNotify(enable);
+  }
+
+  /**
+   * Check if batched value change notification is enabled.
+   *
+   * @return true if enabled
+   */
+  public static boolean getValueBatchNotify() {
+    return SimulatorJNI.getSimValueBatchNotify();
+  }
+
+  /** Notify all values changed since the last batch. */
+  public static void flushValueBatchNotify() {
+    SimulatorJNI.flushSimValueBatchNotify();
+  }
 }
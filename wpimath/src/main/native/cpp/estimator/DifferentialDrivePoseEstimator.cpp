@@ -31,12 +31,13 @@ DifferentialDrivePoseEstimator::DifferentialDrivePoseEstimator(
 
   // Create correction mechanism for vision measurements.
   m_visionCorrect = [&](const Eigen::Matrix<double, 3, 1>& u,
-                        const Eigen::Matrix<double, 3, 1>& y) {
+                        const Eigen::Matrix<double, 3, 1>& y,
+                        const Eigen::Matrix<double, 3, 3>& R) {
     m_observer.Correct<3>(
         u, y,
         [](const Eigen::Matrix<double, 5, 1>& x,
            const Eigen::Matrix<double, 3, 1>&) { return x.block<3, 1>(0, 0); },
-        m_visionContR, frc::AngleMean<3, 5>(2), frc::AngleResidual<3>(2),
+        R, frc::AngleMean<3, 5>(2), frc::AngleResidual<3>(2),
         frc::AngleResidual<5>(2), frc::AngleAdd<5>(2));
   };
 
@@ -71,11 +72,22 @@ Pose2d DifferentialDrivePoseEstimator::GetEstimatedPosition() const {
 
 void DifferentialDrivePoseEstimator::AddVisionMeasurement(
     const Pose2d& visionRobotPose, units::second_t timestamp) {
-  m_latencyCompensator.ApplyPastGlobalMeasurement<3>(
-      &m_observer, m_nominalDt, PoseTo3dVector(visionRobotPose),
+  m_latencyCompensator.ApplyPastGlobalMeasurement(
+      &m_observer, m_nominalDt, PoseTo3dVector(visionRobotPose), m_visionContR,
       m_visionCorrect, timestamp);
 }
 
+void DifferentialDrivePoseEstimator::AddVisionMeasurements(
+    wpi::span<const std::pair<Pose2d, units::second_t>> visionMeasurements) {
+  wpi::SmallVector<decltype(m_latencyCompensator)::GlobalMeasurement, 4>
+      measurements;
+  for (auto&& [pose, timestamp] : visionMeasurements) {
+    measurements.push_back({PoseTo3dVector(pose), timestamp});
+  }
+  m_latencyCompensator.ApplyPastGlobalMeasurements(
+      &m_observer, m_nominalDt, measurements, m_visionContR, m_visionCorrect);
+}
+
 Pose2d DifferentialDrivePoseEstimator::Update(
     const Rotation2d& gyroAngle,
     const DifferentialDriveWheelSpeeds& wheelSpeeds,
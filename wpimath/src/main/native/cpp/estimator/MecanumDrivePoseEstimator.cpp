@@ -33,12 +33,13 @@ frc::MecanumDrivePoseEstimator::MecanumDrivePoseEstimator(
 
   // Create vision correction mechanism.
   m_visionCorrect = [&](const Eigen::Matrix<double, 3, 1>& u,
-                        const Eigen::Matrix<double, 3, 1>& y) {
+                        const Eigen::Matrix<double, 3, 1>& y,
+                        const Eigen::Matrix<double, 3, 3>& R) {
     m_observer.Correct<3>(
         u, y,
         [](const Eigen::Matrix<double, 3, 1>& x,
            const Eigen::Matrix<double, 3, 1>&) { return x; },
-        m_visionContR, frc::AngleMean<3, 3>(2), frc::AngleResidual<3>(2),
+        R, frc::AngleMean<3, 3>(2), frc::AngleResidual<3>(2),
         frc::AngleResidual<3>(2), frc::AngleAdd<3>(2));
   };
 
@@ -75,11 +76,22 @@ Pose2d frc::MecanumDrivePoseEstimator::GetEstimatedPosition() const {
 
 void frc::MecanumDrivePoseEstimator::AddVisionMeasurement(
     const Pose2d& visionRobotPose, units::second_t timestamp) {
-  m_latencyCompensator.ApplyPastGlobalMeasurement<3>(
-      &m_observer, m_nominalDt, PoseTo3dVector(visionRobotPose),
+  m_latencyCompensator.ApplyPastGlobalMeasurement(
+      &m_observer, m_nominalDt, PoseTo3dVector(visionRobotPose), m_visionContR,
       m_visionCorrect, timestamp);
 }
 
+void MecanumDrivePoseEstimator::AddVisionMeasurements(
+    wpi::span<const std::pair<Pose2d, units::second_t>> visionMeasurements) {
+  wpi::SmallVector<decltype(m_latencyCompensator)::GlobalMeasurement, 4>
+      measurements;
+  for (auto&& [pose, timestamp] : visionMeasurements) {
+    measurements.push_back({PoseTo3dVector(pose), timestamp});
+  }
+  m_latencyCompensator.ApplyPastGlobalMeasurements(
+      &m_observer, m_nominalDt, measurements, m_visionContR, m_visionCorrect);
+}
+
 Pose2d frc::MecanumDrivePoseEstimator::Update(
     const Rotation2d& gyroAngle, const MecanumDriveWheelSpeeds& wheelSpeeds) {
   return UpdateWithTime(units::microsecond_t(wpi::Now()), gyroAngle,
@@ -0,0 +1,104 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "frc/trajectory/IncrementalTrajectoryGenerator.h"
+
+#include <utility>
+
+#include "frc/spline/SplineHelper.h"
+#include "frc/spline/SplineParameterizer.h"
+#include "frc/trajectory/TrajectoryGenerator.h"
+
+using namespace frc;
+
+// Compares exactly, rather than with Pose2d's tolerance, so that a series of
+// small changes to a waypoint is never ignored.
+static bool IsSameWaypoint(const Pose2d& a, const Pose2d& b) {
+  return a.X() == b.X() && a.Y() == b.Y() &&
+         a.Rotation().Radians() == b.Rotation().Radians();
+}
+
+IncrementalTrajectoryGenerator::IncrementalTrajectoryGenerator(
+    TrajectoryConfig config)
+    : m_config(std::move(config)) {}
+
+Trajectory IncrementalTrajectoryGenerator::GenerateTrajectory(
+    const std::vector<Pose2d>& waypoints) {
+  auto newWaypoints = waypoints;
+  const Transform2d flip{Translation2d(), Rotation2d(180_deg)};
+  if (m_config.IsReversed()) {
+    for (auto& waypoint : newWaypoints) {
+      waypoint = waypoint + flip;
+    }
+  }
+
+  // Only parameterize the splines with a changed waypoint.
+  auto splines = SplineHelper::QuinticSplinesFromWaypoints(newWaypoints);
+  size_t firstChanged = splines.size();
+  m_splinePoints.resize(splines.size());
+  try {
+    for (size_t i = 0; i < splines.size(); ++i) {
+      if (i + 1 < m_waypoints.size() &&
+          IsSameWaypoint(newWaypoints[i], m_waypoints[i]) &&
+          IsSameWaypoint(newWaypoints[i + 1], m_waypoints[i + 1])) {
+        continue;
+      }
+      if (firstChanged == splines.size()) {
+        firstChanged = i;
+      }
+      m_splinePoints[i].clear();
+      SplineParameterizer::Parameterize(splines[i], &m_splinePoints[i]);
+    }
+  } catch (SplineParameterizer::MalformedSplineException& e) {
+    Reset();
+    TrajectoryGenerator::ReportError(e.what());
+    return TrajectoryGenerator::kDoNothingTrajectory;
+  }
+
+  // Rebuild the points from the first changed spline on. After trajectory
+  // generation, flip theta back so it's relative to the field. Also fix
+  // curvature.
+  size_t start = 0;
+  if (firstChanged == 0) {
+    m_points.clear();
+    m_points.push_back(splines.front().GetPoint(0.0));
+    if (m_config.IsReversed()) {
+      m_points[0] = {m_points[0].first + flip, -m_points[0].second};
+    }
+  } else {
+    start = 1;
+    for (size_t i = 0; i < firstChanged; ++i) {
+      start += m_splinePoints[i].size();
+    }
+    m_points.resize(start);
+  }
+  for (size_t i = firstChanged; i < splines.size(); ++i) {
+    for (auto& point : m_splinePoints[i]) {
+      if (m_config.IsReversed()) {
+        m_points.emplace_back(point.first + flip, -point.second);
+      } else {
+        m_points.emplace_back(point);
+      }
+    }
+  }
+
+  // If time parameterization throws, don't reuse any of it next time.
+  m_waypoints.clear();
+  TrajectoryParameterizer::ForwardPass(
+      m_points, m_config.Constraints(), m_config.StartVelocity(),
+      m_config.MaxVelocity(), m_config.MaxAcceleration(),
+      m_config.IsReversed(), start, &m_forwardStates);
+  m_waypoints = std::move(newWaypoints);
+
+  return TrajectoryParameterizer::BackwardPass(
+      m_forwardStates, m_config.Constraints(), m_config.EndVelocity(),
+      m_config.MaxAcceleration(), m_config.IsReversed());
+}
+
+void IncrementalTrajectoryGenerator::Reset() {
+  m_waypoints.clear();
+  m_splinePoints.clear();
+  m_points.clear();
+  m_forwardStates.clear();
+}
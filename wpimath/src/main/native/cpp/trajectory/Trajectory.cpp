@@ -5,6 +5,7 @@
 #include "frc/trajectory/Trajectory.h"
 
 #include <algorithm>
+#include <stdexcept>
 
 #include <wpi/json.h>
 
@@ -24,46 +25,70 @@ bool Trajectory::State::operator!=(const Trajectory::State& other) const {
 
 Trajectory::State Trajectory::State::Interpolate(State endValue,
                                                  double i) const {
-  // Find the new [t] value.
-  const auto newT = Lerp(t, endValue.t, i);
-
-  // Find the delta time between the current state and the interpolated state.
-  const auto deltaT = newT - t;
-
   // If delta time is negative, flip the order of interpolation.
-  if (deltaT < 0_s) {
+  if (Lerp(t, endValue.t, i) < t) {
     return endValue.Interpolate(*this, 1.0 - i);
   }
+  return Trajectory::Interpolate(
+      *this, endValue, i,
+      endValue.pose.Translation().Distance(pose.Translation()),
+      endValue.pose - pose);
+}
+
+Trajectory::State Trajectory::Interpolate(const State& start, const State& end,
+                                          double i, units::meter_t distance,
+                                          const Transform2d& poseDelta) {
+  // Find the new [t] value.
+  const auto newT = Lerp(start.t, end.t, i);
+
+  // Find the delta time between the current state and the interpolated state.
+  const auto deltaT = newT - start.t;
 
   // Check whether the robot is reversing at this stage.
   const auto reversing =
-      velocity < 0_mps ||
-      (units::math::abs(velocity) < 1E-9_mps && acceleration < 0_mps_sq);
+      start.velocity < 0_mps || (units::math::abs(start.velocity) < 1E-9_mps &&
+                                 start.acceleration < 0_mps_sq);
 
   // Calculate the new velocity.
   // v = v_0 + at
-  const units::meters_per_second_t newV = velocity + (acceleration * deltaT);
+  const units::meters_per_second_t newV =
+      start.velocity + (start.acceleration * deltaT);
 
   // Calculate the change in position.
   // delta_s = v_0 t + 0.5 at^2
-  const units::meter_t newS =
-      (velocity * deltaT + 0.5 * acceleration * deltaT * deltaT) *
-      (reversing ? -1.0 : 1.0);
+  const units::meter_t newS = (start.velocity * deltaT +
+                               0.5 * start.acceleration * deltaT * deltaT) *
+                              (reversing ? -1.0 : 1.0);
 
   // Return the new state. To find the new position for the new state, we need
   // to interpolate between the two endpoint poses. The fraction for
   // interpolation is the change in position (delta s) divided by the total
   // distance between the two endpoints.
-  const double interpolationFrac =
-      newS / endValue.pose.Translation().Distance(pose.Translation());
+  const double interpolationFrac = newS / distance;
 
-  return {newT, newV, acceleration,
-          Lerp(pose, endValue.pose, interpolationFrac),
-          Lerp(curvature, endValue.curvature, interpolationFrac)};
+  return {newT, newV, start.acceleration,
+          start.pose + poseDelta * interpolationFrac,
+          Lerp(start.curvature, end.curvature, interpolationFrac)};
 }
 
 Trajectory::Trajectory(const std::vector<State>& states) : m_states(states) {
   m_totalTime = states.back().t;
+
+  // Everything State::Interpolate() computes from just the two endpoint
+  // states is computed once per pair of states here.
+  m_times.reserve(states.size());
+  m_distances.reserve(states.size());
+  m_poseDeltas.reserve(states.size());
+  m_times.push_back(states.front().t.to<double>());
+  m_distances.emplace_back(0_m);
+  m_poseDeltas.emplace_back();
+  for (size_t i = 1; i < states.size(); ++i) {
+    auto& pose = states[i].pose;
+    auto& prevPose = states[i - 1].pose;
+    m_times.push_back(states[i].t.to<double>());
+    m_distances.push_back(pose.Translation().Distance(prevPose.Translation()));
+    m_poseDeltas.push_back(pose - prevPose);
+  }
 }
 
 Trajectory::State Trajectory::Sample(units::second_t t) const {
@@ -78,10 +103,68 @@ Trajectory::State Trajectory::Sample(units::second_t t) const {
   // requested timestamp. This starts at 1 because we use the previous state
   // later on for interpolation.
   auto sample =
-      std::lower_bound(m_states.cbegin() + 1, m_states.cend(), t,
-                       [](const auto& a, const auto& b) { return a.t < b; });
+      std::lower_bound(m_times.cbegin() + 1, m_times.cend(), t.to<double>());
+  return SampleBefore(t, sample - m_times.cbegin());
+}
+
+void Trajectory::SampleMany(wpi::span<const units::second_t> times,
+                            wpi::span<State> states) const {
+  if (states.size() < times.size()) {
+    throw std::invalid_argument(
+        "SampleMany() states must be at least as large as times");
+  }
+  size_t hint = 1;
+  for (size_t i = 0; i < times.size(); ++i) {
+    auto t = times[i];
+    if (t <= m_states.front().t) {
+      states[i] = m_states.front();
+    } else if (t >= m_totalTime) {
+      states[i] = m_states.back();
+    } else {
+      hint = FindState(t, hint);
+      states[i] = SampleBefore(t, hint);
+    }
+  }
+}
+
+std::vector<Trajectory::State> Trajectory::SampleMany(
+    wpi::span<const units::second_t> times) const {
+  std::vector<State> states(times.size());
+  SampleMany(times, states);
+  return states;
+}
+
+size_t Trajectory::FindState(units::second_t t, size_t hint) const {
+  double time = t.to<double>();
+  // Search backwards from the hint's state for the first state no earlier
+  // than t, or forwards in steps of increasing size; for points in increasing
+  // order this is usually only a step or two.
+  size_t low = 1;
+  size_t high = m_times.size();
+  if (m_times[hint] < time) {
+    low = hint + 1;
+    for (size_t step = 1; low < high; step *= 2) {
+      size_t probe = std::min(hint + step, high - 1);
+      if (m_times[probe] >= time) {
+        high = probe;
+        break;
+      }
+      low = probe + 1;
+    }
+  } else if (m_times[hint - 1] < time) {
+    return hint;
+  } else {
+    high = hint;
+  }
+  return std::lower_bound(m_times.cbegin() + low, m_times.cbegin() + high,
+                          time) -
+         m_times.cbegin();
+}
 
-  auto prevSample = sample - 1;
+Trajectory::State Trajectory::SampleBefore(units::second_t t,
+                                           size_t index) const {
+  auto& sample = m_states[index];
+  auto& prevSample = m_states[index - 1];
 
   // The sample's timestamp is now greater than or equal to the requested
   // timestamp. If it is greater, we need to interpolate between the
@@ -89,12 +172,13 @@ Trajectory::State Trajectory::Sample(units::second_t t) const {
   // want.
 
   // If the difference in states is negligible, then we are spot on!
-  if (units::math::abs(sample->t - prevSample->t) < 1E-9_s) {
-    return *sample;
+  if (units::math::abs(sample.t - prevSample.t) < 1E-9_s) {
+    return sample;
   }
   // Interpolate between the two states for the state that we want.
-  return prevSample->Interpolate(
-      *sample, (t - prevSample->t) / (sample->t - prevSample->t));
+  return Interpolate(prevSample, sample,
+                     (t - prevSample.t) / (sample.t - prevSample.t),
+                     m_distances[index], m_poseDeltas[index]);
 }
 
 Trajectory Trajectory::TransformBy(const Transform2d& transform) {
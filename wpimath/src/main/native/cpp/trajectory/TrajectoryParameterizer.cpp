@@ -28,6 +28,8 @@
 
 #include "frc/trajectory/TrajectoryParameterizer.h"
 
+#include <utility>
+
 #include <fmt/format.h>
 
 #include "units/math.h"
@@ -41,15 +43,34 @@ Trajectory TrajectoryParameterizer::TimeParameterizeTrajectory(
     units::meters_per_second_t endVelocity,
     units::meters_per_second_t maxVelocity,
     units::meters_per_second_squared_t maxAcceleration, bool reversed) {
-  std::vector<ConstrainedState> constrainedStates(points.size());
+  std::vector<ConstrainedState> constrainedStates;
+  ForwardPass(points, constraints, startVelocity, maxVelocity, maxAcceleration,
+              reversed, 0, &constrainedStates);
+  return BackwardPass(std::move(constrainedStates), constraints, endVelocity,
+                      maxAcceleration, reversed);
+}
+
+void TrajectoryParameterizer::ForwardPass(
+    const std::vector<PoseWithCurvature>& points,
+    const std::vector<std::unique_ptr<TrajectoryConstraint>>& constraints,
+    units::meters_per_second_t startVelocity,
+    units::meters_per_second_t maxVelocity,
+    units::meters_per_second_squared_t maxAcceleration, bool reversed,
+    size_t start, std::vector<ConstrainedState>* states) {
+  auto& constrainedStates = *states;
+  constrainedStates.resize(points.size());
 
+  // Each state only depends on the states before it, so the pass can resume
+  // from any state whose predecessors are already computed.
   ConstrainedState predecessor{points.front(), 0_m, startVelocity,
                                -maxAcceleration, maxAcceleration};
+  if (start > 0) {
+    predecessor = constrainedStates[start - 1];
+  } else {
+    constrainedStates[0] = predecessor;
+  }
 
-  constrainedStates[0] = predecessor;
-
-  // Forward pass
-  for (unsigned int i = 0; i < points.size(); i++) {
+  for (size_t i = start; i < points.size(); i++) {
     auto& constrainedState = constrainedStates[i];
     constrainedState.pose = points[i];
 
@@ -114,12 +135,18 @@ Trajectory TrajectoryParameterizer::TimeParameterizeTrajectory(
     }
     predecessor = constrainedState;
   }
+}
 
-  ConstrainedState successor{points.back(), constrainedStates.back().distance,
-                             endVelocity, -maxAcceleration, maxAcceleration};
+Trajectory TrajectoryParameterizer::BackwardPass(
+    std::vector<ConstrainedState> constrainedStates,
+    const std::vector<std::unique_ptr<TrajectoryConstraint>>& constraints,
+    units::meters_per_second_t endVelocity,
+    units::meters_per_second_squared_t maxAcceleration, bool reversed) {
+  ConstrainedState successor{constrainedStates.back().pose,
+                             constrainedStates.back().distance, endVelocity,
+                             -maxAcceleration, maxAcceleration};
 
-  // Backward pass
-  for (int i = points.size() - 1; i >= 0; i--) {
+  for (int i = constrainedStates.size() - 1; i >= 0; i--) {
     auto& constrainedState = constrainedStates[i];
     units::meter_t ds =
         constrainedState.distance - successor.distance;  // negative
@@ -165,7 +192,7 @@ Trajectory TrajectoryParameterizer::TimeParameterizeTrajectory(
   // Now we can integrate the constrained states forward in time to obtain our
   // trajectory states.
 
-  std::vector<Trajectory::State> states(points.size());
+  std::vector<Trajectory::State> states(constrainedStates.size());
   units::second_t t = 0_s;
   units::meter_t s = 0_m;
   units::meters_per_second_t v = 0_mps;
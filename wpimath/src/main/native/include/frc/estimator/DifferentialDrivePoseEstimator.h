@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <utility>
+
+#include <wpi/SmallVector.h>
 #include <wpi/array.h>
+#include <wpi/span.h>
 
 #include "Eigen/Core"
 #include "frc/estimator/KalmanFilterLatencyCompensator.h"
@@ -173,6 +177,20 @@ class DifferentialDrivePoseEstimator {
     AddVisionMeasurement(visionRobotPose, timestamp);
   }
 
+  /**
+   * Adds several vision measurements, such as from multiple cameras, to the
+   * Unscented Kalman Filter at once. The measurements may be in any order.
+   * This is cheaper than calling AddVisionMeasurement() for each one, since
+   * past observer states are replayed to the present only once, from the
+   * oldest measurement.
+   *
+   * @param visionMeasurements Pairs of robot poses as measured by vision
+   *                           cameras and their timestamps in seconds. See
+   *                           AddVisionMeasurement() for the timestamp epoch.
+   */
+  void AddVisionMeasurements(
+      wpi::span<const std::pair<Pose2d, units::second_t>> visionMeasurements);
+
   /**
    * Updates the Unscented Kalman Filter using only wheel encoder information.
    * Note that this should be called every loop iteration.
@@ -206,11 +224,9 @@ class DifferentialDrivePoseEstimator {
 
  private:
   UnscentedKalmanFilter<5, 3, 3> m_observer;
-  KalmanFilterLatencyCompensator<5, 3, 3, UnscentedKalmanFilter<5, 3, 3>>
+  KalmanFilterLatencyCompensator<5, 3, 3, 3, UnscentedKalmanFilter<5, 3, 3>>
       m_latencyCompensator;
-  std::function<void(const Eigen::Matrix<double, 3, 1>& u,
-                     const Eigen::Matrix<double, 3, 1>& y)>
-      m_visionCorrect;
+  decltype(m_latencyCompensator)::GlobalMeasurementCorrect m_visionCorrect;
 
   Eigen::Matrix<double, 3, 3> m_visionContR;
 
@@ -8,23 +8,53 @@
 #include <array>
 #include <functional>
 #include <utility>
-#include <vector>
+
+#include <wpi/SmallVector.h>
+#include <wpi/circular_buffer.h>
+#include <wpi/span.h>
 
 #include "Eigen/Core"
+#include "frc/system/Discretization.h"
 #include "units/math.h"
 #include "units/time.h"
 
 namespace frc {
 
-template <int States, int Inputs, int Outputs, typename KalmanFilterType>
+template <int States, int Inputs, int Outputs, int GlobalRows,
+          typename KalmanFilterType>
 class KalmanFilterLatencyCompensator {
  public:
+  /**
+   * The most global measurements kept for each snapshot.
+   */
+  static constexpr size_t kMaxGlobalMeasurements = 4;
+
+  /**
+   * A global measurement applied after a step, with the discrete-time
+   * measurement noise covariance it was applied with.
+   */
+  struct AppliedMeasurement {
+    Eigen::Matrix<double, GlobalRows, 1> y;
+    Eigen::Matrix<double, GlobalRows, GlobalRows> discR;
+  };
+
   struct ObserverSnapshot {
     Eigen::Matrix<double, States, 1> xHat;
     Eigen::Matrix<double, States, States> errorCovariances;
     Eigen::Matrix<double, Inputs, 1> inputs;
     Eigen::Matrix<double, Outputs, 1> localMeasurements;
 
+    // Global measurements applied after the step, kept so that replaying the
+    // step applies them again.
+    std::array<AppliedMeasurement, kMaxGlobalMeasurements> globalMeasurements;
+    size_t numGlobalMeasurements = 0;
+
+    ObserverSnapshot()
+        : xHat(Eigen::Matrix<double, States, 1>::Zero()),
+          errorCovariances(Eigen::Matrix<double, States, States>::Zero()),
+          inputs(Eigen::Matrix<double, Inputs, 1>::Zero()),
+          localMeasurements(Eigen::Matrix<double, Outputs, 1>::Zero()) {}
+
     ObserverSnapshot(const KalmanFilterType& observer,
                      const Eigen::Matrix<double, Inputs, 1>& u,
                      const Eigen::Matrix<double, Outputs, 1>& localY)
@@ -34,10 +64,27 @@ class KalmanFilterLatencyCompensator {
           localMeasurements(localY) {}
   };
 
+  /**
+   * A global measurement and the time at which it was captured.
+   */
+  struct GlobalMeasurement {
+    Eigen::Matrix<double, GlobalRows, 1> y;
+    units::second_t timestamp;
+  };
+
+  /**
+   * The function that calls correct() on the observer with a global
+   * measurement and its continuous-time measurement noise covariance.
+   */
+  using GlobalMeasurementCorrect = std::function<void(
+      const Eigen::Matrix<double, Inputs, 1>& u,
+      const Eigen::Matrix<double, GlobalRows, 1>& y,
+      const Eigen::Matrix<double, GlobalRows, GlobalRows>& R)>;
+
   /**
    * Clears the observer snapshot buffer.
    */
-  void Reset() { m_pastObserverSnapshots.clear(); }
+  void Reset() { m_pastObserverSnapshots.reset(); }
 
   /**
    * Add past observer states to the observer snapshots list.
@@ -51,14 +98,10 @@ class KalmanFilterLatencyCompensator {
                         Eigen::Matrix<double, Inputs, 1> u,
                         Eigen::Matrix<double, Outputs, 1> localY,
                         units::second_t timestamp) {
-    // Add the new state into the vector.
+    // Add the new state into the buffer, overwriting the oldest snapshot if
+    // the buffer is full.
     m_pastObserverSnapshots.emplace_back(timestamp,
                                          ObserverSnapshot{observer, u, localY});
-
-    // Remove the oldest snapshot if the vector exceeds our maximum size.
-    if (m_pastObserverSnapshots.size() > kMaxPastObserverStates) {
-      m_pastObserverSnapshots.erase(m_pastObserverSnapshots.begin());
-    }
   }
 
   /**
@@ -68,83 +111,165 @@ class KalmanFilterLatencyCompensator {
    *                                 measurement.
    * @param nominalDt                The nominal timestep.
    * @param y                        The measurement.
+   * @param R                        The continuous-time measurement noise
+   *                                 covariance of the measurement.
    * @param globalMeasurementCorrect The function take calls correct() on the
    *                                 observer.
    * @param timestamp                The timestamp of the measurement.
    */
-  template <int Rows>
   void ApplyPastGlobalMeasurement(
       KalmanFilterType* observer, units::second_t nominalDt,
-      Eigen::Matrix<double, Rows, 1> y,
-      std::function<void(const Eigen::Matrix<double, Inputs, 1>& u,
-                         const Eigen::Matrix<double, Rows, 1>& y)>
-          globalMeasurementCorrect,
+      const Eigen::Matrix<double, GlobalRows, 1>& y,
+      const Eigen::Matrix<double, GlobalRows, GlobalRows>& R,
+      const GlobalMeasurementCorrect& globalMeasurementCorrect,
       units::second_t timestamp) {
-    if (m_pastObserverSnapshots.size() == 0) {
+    GlobalMeasurement measurement{y, timestamp};
+    ApplyPastGlobalMeasurements(observer, nominalDt, wpi::span{&measurement, 1},
+                                R, globalMeasurementCorrect);
+  }
+
+  /**
+   * Add a batch of past global measurements (such as from multiple cameras)
+   * to the estimator. The measurements may be in any order; they're all
+   * fused in a single replay from the oldest one to the present, which is
+   * much cheaper than applying them one at a time.
+   *
+   * Each measurement is kept with the snapshot it was applied at, along with
+   * its noise covariance, so that later replays through that snapshot apply it
+   * again. Up to kMaxGlobalMeasurements are kept per snapshot; measurements
+   * past that still correct the present estimate, but aren't applied again by
+   * later replays.
+   *
+   * @param observer                 The observer to apply the past global
+   *                                 measurements.
+   * @param nominalDt                The nominal timestep.
+   * @param measurements             The measurements.
+   * @param R                        The continuous-time measurement noise
+   *                                 covariance of the measurements.
+   * @param globalMeasurementCorrect The function take calls correct() on the
+   *                                 observer.
+   */
+  void ApplyPastGlobalMeasurements(
+      KalmanFilterType* observer, units::second_t nominalDt,
+      wpi::span<const GlobalMeasurement> measurements,
+      const Eigen::Matrix<double, GlobalRows, GlobalRows>& R,
+      const GlobalMeasurementCorrect& globalMeasurementCorrect) {
+    if (m_pastObserverSnapshots.size() == 0 || measurements.empty()) {
       // State map was empty, which means that we got a measurement right at
       // startup. The only thing we can do is ignore the measurement.
       return;
     }
 
-    // We will perform a binary search to find the index of the element in the
-    // vector that has a timestamp that is equal to or greater than the vision
-    // measurement timestamp.
-    auto lowerBoundIter = std::lower_bound(
-        m_pastObserverSnapshots.cbegin(), m_pastObserverSnapshots.cend(),
-        timestamp,
-        [](const auto& entry, const auto& ts) { return entry.first < ts; });
-    int index = std::distance(m_pastObserverSnapshots.cbegin(), lowerBoundIter);
-
-    // High and Low should be the same. The sampled timestamp is greater than or
-    // equal to the vision pose timestamp. We will now find the entry which is
-    // closest in time to the requested timestamp.
-
-    size_t indexOfClosestEntry =
-        units::math::abs(
-            timestamp - m_pastObserverSnapshots[std::max(index - 1, 0)].first) <
-                units::math::abs(timestamp -
-                                 m_pastObserverSnapshots[index].first)
-            ? index - 1
-            : index;
+    // Match each measurement with the snapshot closest to it in time, then
+    // order them by snapshot (and by timestamp within a snapshot) so they can
+    // all be applied in one pass.
+    using Match = std::pair<size_t, const GlobalMeasurement*>;
+    wpi::SmallVector<Match, 16> matches;
+    for (auto&& measurement : measurements) {
+      matches.emplace_back(GetClosestSnapshotIndex(measurement.timestamp),
+                           &measurement);
+    }
+    std::stable_sort(matches.begin(), matches.end(),
+                     [](const Match& lhs, const Match& rhs) {
+                       return lhs.first < rhs.first ||
+                              (lhs.first == rhs.first &&
+                               lhs.second->timestamp < rhs.second->timestamp);
+                     });
 
+    size_t indexOfClosestEntry = matches.front().first;
     units::second_t lastTimestamp =
         m_pastObserverSnapshots[indexOfClosestEntry].first - nominalDt;
 
     // We will now go back in time to the state of the system at the time when
-    // the measurement was captured. We will reset the observer to that state,
-    // and apply correction based on the measurement. Then, we will go back
-    // through all observer states until the present and apply past inputs to
-    // get the present estimated state.
+    // the oldest measurement was captured. We will reset the observer to that
+    // state, and apply correction based on the measurement. Then, we will go
+    // back through all observer states until the present, applying past
+    // inputs and any newer measurements along the way to get the present
+    // estimated state. Measurements applied by earlier calls are applied again
+    // at their steps, so they aren't lost.
+    auto match = matches.begin();
     for (size_t i = indexOfClosestEntry; i < m_pastObserverSnapshots.size();
          ++i) {
       auto& [key, snapshot] = m_pastObserverSnapshots[i];
 
+      // Snapshots hold the observer state from before the step at their
+      // timestamp, so later replays start from the right state.
       if (i == indexOfClosestEntry) {
         observer->SetP(snapshot.errorCovariances);
         observer->SetXhat(snapshot.xHat);
+      } else {
+        snapshot.xHat = observer->Xhat();
+        snapshot.errorCovariances = observer->P();
       }
 
-      observer->Predict(snapshot.inputs, key - lastTimestamp);
+      units::second_t dt = key - lastTimestamp;
+      observer->Predict(snapshot.inputs, dt);
       observer->Correct(snapshot.inputs, snapshot.localMeasurements);
 
-      if (i == indexOfClosestEntry) {
-        // Note that the measurement is at a timestep close but probably not
-        // exactly equal to the timestep for which we called predict. This makes
-        // the assumption that the dt is small enough that the difference
-        // between the measurement time and the time that the inputs were
-        // captured at is very small.
-        globalMeasurementCorrect(snapshot.inputs, y);
+      // Note that the measurement is at a timestep close but probably not
+      // exactly equal to the timestep for which we called predict. This makes
+      // the assumption that the dt is small enough that the difference
+      // between the measurement time and the time that the inputs were
+      // captured at is very small.
+      //
+      // The observer discretizes R with the timestep of the last Predict(),
+      // which can differ from the one the measurement was first applied with,
+      // so kept measurements are applied with the continuous-time equivalent
+      // of their discrete R for this timestep.
+      for (size_t j = 0; j < snapshot.numGlobalMeasurements; ++j) {
+        auto& applied = snapshot.globalMeasurements[j];
+        globalMeasurementCorrect(snapshot.inputs, applied.y,
+                                 applied.discR * dt.to<double>());
+      }
+      for (; match != matches.end() && match->first == i; ++match) {
+        globalMeasurementCorrect(snapshot.inputs, match->second->y, R);
+        if (snapshot.numGlobalMeasurements < kMaxGlobalMeasurements) {
+          snapshot.globalMeasurements[snapshot.numGlobalMeasurements++] = {
+              match->second->y, DiscretizeR<GlobalRows>(R, dt)};
+        }
       }
 
       lastTimestamp = key;
-      snapshot = ObserverSnapshot{*observer, snapshot.inputs,
-                                  snapshot.localMeasurements};
     }
   }
 
  private:
   static constexpr size_t kMaxPastObserverStates = 300;
-  std::vector<std::pair<units::second_t, ObserverSnapshot>>
-      m_pastObserverSnapshots;
+
+  /**
+   * Returns the index of the snapshot closest in time to the timestamp.
+   * The buffer must not be empty.
+   */
+  size_t GetClosestSnapshotIndex(units::second_t timestamp) const {
+    // We will perform a binary search to find the index of the element in the
+    // buffer that has a timestamp that is equal to or greater than the vision
+    // measurement timestamp.
+    size_t low = 0;
+    size_t high = m_pastObserverSnapshots.size();
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      if (m_pastObserverSnapshots[mid].first < timestamp) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+
+    // The sampled timestamp is greater than or equal to the vision pose
+    // timestamp. We will now find the entry which is closest in time to the
+    // requested timestamp.
+    if (low == m_pastObserverSnapshots.size()) {
+      return low - 1;
+    }
+    if (low > 0 &&
+        units::math::abs(timestamp - m_pastObserverSnapshots[low - 1].first) <
+            units::math::abs(timestamp - m_pastObserverSnapshots[low].first)) {
+      return low - 1;
+    }
+    return low;
+  }
+
+  wpi::circular_buffer<std::pair<units::second_t, ObserverSnapshot>>
+      m_pastObserverSnapshots{kMaxPastObserverStates};
 };
 }  // namespace frc
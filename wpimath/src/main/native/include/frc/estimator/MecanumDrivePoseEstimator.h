@@ -5,8 +5,11 @@
 #pragma once
 
 #include <functional>
+#include <utility>
 
+#include <wpi/SmallVector.h>
 #include <wpi/array.h>
+#include <wpi/span.h>
 
 #include "Eigen/Core"
 #include "frc/estimator/KalmanFilterLatencyCompensator.h"
@@ -173,6 +176,20 @@ class MecanumDrivePoseEstimator {
     AddVisionMeasurement(visionRobotPose, timestamp);
   }
 
+  /**
+   * Adds several vision measurements, such as from multiple cameras, to the
+   * Unscented Kalman Filter at once. The measurements may be in any order.
+   * This is cheaper than calling AddVisionMeasurement() for each one, since
+   * past observer states are replayed to the present only once, from the
+   * oldest measurement.
+   *
+   * @param visionMeasurements Pairs of robot poses as measured by vision
+   *                           cameras and their timestamps in seconds. See
+   *                           AddVisionMeasurement() for the timestamp epoch.
+   */
+  void AddVisionMeasurements(
+      wpi::span<const std::pair<Pose2d, units::second_t>> visionMeasurements);
+
   /**
    * Updates the the Unscented Kalman Filter using only wheel encoder
    * information. This should be called every loop, and the correct loop period
@@ -202,11 +219,9 @@ class MecanumDrivePoseEstimator {
  private:
   UnscentedKalmanFilter<3, 3, 1> m_observer;
   MecanumDriveKinematics m_kinematics;
-  KalmanFilterLatencyCompensator<3, 3, 1, UnscentedKalmanFilter<3, 3, 1>>
+  KalmanFilterLatencyCompensator<3, 3, 1, 3, UnscentedKalmanFilter<3, 3, 1>>
       m_latencyCompensator;
-  std::function<void(const Eigen::Matrix<double, 3, 1>& u,
-                     const Eigen::Matrix<double, 3, 1>& y)>
-      m_visionCorrect;
+  decltype(m_latencyCompensator)::GlobalMeasurementCorrect m_visionCorrect;
 
   Eigen::Matrix3d m_visionContR;
 
@@ -5,8 +5,11 @@
 #pragma once
 
 #include <limits>
+#include <utility>
 
+#include <wpi/SmallVector.h>
 #include <wpi/array.h>
+#include <wpi/span.h>
 #include <wpi/timestamp.h>
 
 #include "Eigen/Core"
@@ -96,12 +99,13 @@ class SwerveDrivePoseEstimator {
 
     // Create correction mechanism for vision measurements.
     m_visionCorrect = [&](const Eigen::Matrix<double, 3, 1>& u,
-                          const Eigen::Matrix<double, 3, 1>& y) {
+                          const Eigen::Matrix<double, 3, 1>& y,
+                          const Eigen::Matrix<double, 3, 3>& R) {
       m_observer.Correct<3>(
           u, y,
           [](const Eigen::Matrix<double, 3, 1>& x,
              const Eigen::Matrix<double, 3, 1>& u) { return x; },
-          m_visionContR, frc::AngleMean<3, 3>(2), frc::AngleResidual<3>(2),
+          R, frc::AngleMean<3, 3>(2), frc::AngleResidual<3>(2),
           frc::AngleResidual<3>(2), frc::AngleAdd<3>(2));
     };
 
@@ -184,9 +188,9 @@ class SwerveDrivePoseEstimator {
    */
   void AddVisionMeasurement(const Pose2d& visionRobotPose,
                             units::second_t timestamp) {
-    m_latencyCompensator.ApplyPastGlobalMeasurement<3>(
+    m_latencyCompensator.ApplyPastGlobalMeasurement(
         &m_observer, m_nominalDt, PoseTo3dVector(visionRobotPose),
-        m_visionCorrect, timestamp);
+        m_visionContR, m_visionCorrect, timestamp);
   }
 
   /**
@@ -227,6 +231,30 @@ class SwerveDrivePoseEstimator {
     AddVisionMeasurement(visionRobotPose, timestamp);
   }
 
+  /**
+   * Adds several vision measurements, such as from multiple cameras, to the
+   * Unscented Kalman Filter at once. The measurements may be in any order.
+   * This is cheaper than calling AddVisionMeasurement() for each one, since
+   * past observer states are replayed to the present only once, from the
+   * oldest measurement.
+   *
+   * @param visionMeasurements Pairs of robot poses as measured by vision
+   *                           cameras and their timestamps in seconds. See
+   *                           AddVisionMeasurement() for the timestamp epoch.
+   */
+  void AddVisionMeasurements(
+      wpi::span<const std::pair<Pose2d, units::second_t>> visionMeasurements) {
+    wpi::SmallVector<typename decltype(m_latencyCompensator)::GlobalMeasurement,
+                     4>
+        measurements;
+    for (auto&& [pose, timestamp] : visionMeasurements) {
+      measurements.push_back({PoseTo3dVector(pose), timestamp});
+    }
+    m_latencyCompensator.ApplyPastGlobalMeasurements(
+        &m_observer, m_nominalDt, measurements, m_visionContR,
+        m_visionCorrect);
+  }
+
   /**
    * Updates the the Unscented Kalman Filter using only wheel encoder
    * information. This should be called every loop, and the correct loop period
@@ -288,10 +316,9 @@ class SwerveDrivePoseEstimator {
  private:
   UnscentedKalmanFilter<3, 3, 1> m_observer;
   SwerveDriveKinematics<NumModules>& m_kinematics;
-  KalmanFilterLatencyCompensator<3, 3, 1, UnscentedKalmanFilter<3, 3, 1>>
+  KalmanFilterLatencyCompensator<3, 3, 1, 3, UnscentedKalmanFilter<3, 3, 1>>
       m_latencyCompensator;
-  std::function<void(const Eigen::Matrix<double, 3, 1>& u,
-                     const Eigen::Matrix<double, 3, 1>& y)>
+  typename decltype(m_latencyCompensator)::GlobalMeasurementCorrect
       m_visionCorrect;
 
   Eigen::Matrix3d m_visionContR;
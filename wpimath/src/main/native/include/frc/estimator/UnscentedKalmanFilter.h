@@ -5,6 +5,9 @@
 #pragma once
 
 #include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include <wpi/array.h>
 
@@ -20,7 +23,73 @@
 
 namespace frc {
 
-template <int States, int Inputs, int Outputs>
+/**
+ * Wraps a dynamics or measurement function so UnscentedKalmanFilter evaluates
+ * it once for all of the sigma points instead of once per sigma point.
+ *
+ * The function is called with x as either a state vector or a matrix whose
+ * columns are states, and returns a vector or a matrix with the corresponding
+ * columns. Generic lambdas written with Eigen's block, row, and array
+ * operations usually work for both.
+ *
+ * <pre>
+ * auto observer = frc::MakeUnscentedKalmanFilter<2, 1, 1>(
+ *     frc::BatchFunction{[](const auto& x, const auto& u) {
+ *       std::decay_t<decltype(x)> xdot;
+ *       xdot.row(0) = x.row(1);
+ *       xdot.row(1) = (u(0) - x.row(1).array()).matrix();
+ *       return xdot;
+ *     }},
+ *     ...);
+ * </pre>
+ */
+template <typename Func>
+class BatchFunction {
+ public:
+  explicit BatchFunction(Func func) : m_func(std::move(func)) {}
+
+  template <typename X, typename U>
+  auto operator()(const X& x, const U& u) const {
+    return m_func(x, u);
+  }
+
+ private:
+  Func m_func;
+};
+
+/**
+ * True if Func is a BatchFunction.
+ */
+template <typename Func>
+inline constexpr bool kIsBatchFunction = false;
+
+template <typename Func>
+inline constexpr bool kIsBatchFunction<BatchFunction<Func>> = true;
+
+/**
+ * A Kalman filter that propagates sigma points through nonlinear dynamics and
+ * measurement models.
+ *
+ * F and H are the types of the dynamics and measurement functions. They
+ * default to std::function, but a filter made with MakeUnscentedKalmanFilter()
+ * stores the lambdas or function objects it's given, so they can be inlined
+ * into the 2 * States + 1 sigma point evaluations of each Predict() and
+ * Correct(). Wrapping them in BatchFunction evaluates all the sigma points at
+ * once.
+ *
+ * @tparam States  Number of states.
+ * @tparam Inputs  Number of inputs.
+ * @tparam Outputs Number of outputs.
+ * @tparam F       Type of the dynamics function.
+ * @tparam H       Type of the measurement function.
+ */
+template <int States, int Inputs, int Outputs,
+          typename F = std::function<Eigen::Matrix<double, States, 1>(
+              const Eigen::Matrix<double, States, 1>&,
+              const Eigen::Matrix<double, Inputs, 1>&)>,
+          typename H = std::function<Eigen::Matrix<double, Outputs, 1>(
+              const Eigen::Matrix<double, States, 1>&,
+              const Eigen::Matrix<double, Inputs, 1>&)>>
 class UnscentedKalmanFilter {
  public:
   /**
@@ -34,36 +103,13 @@ class UnscentedKalmanFilter {
    * @param measurementStdDevs Standard deviations of measurements.
    * @param dt                 Nominal discretization timestep.
    */
-  UnscentedKalmanFilter(std::function<Eigen::Matrix<double, States, 1>(
-                            const Eigen::Matrix<double, States, 1>&,
-                            const Eigen::Matrix<double, Inputs, 1>&)>
-                            f,
-                        std::function<Eigen::Matrix<double, Outputs, 1>(
-                            const Eigen::Matrix<double, States, 1>&,
-                            const Eigen::Matrix<double, Inputs, 1>&)>
-                            h,
+  UnscentedKalmanFilter(F f, H h,
                         const wpi::array<double, States>& stateStdDevs,
                         const wpi::array<double, Outputs>& measurementStdDevs,
                         units::second_t dt)
-      : m_f(f), m_h(h) {
+      : m_f(std::move(f)), m_h(std::move(h)) {
     m_contQ = MakeCovMatrix(stateStdDevs);
     m_contR = MakeCovMatrix(measurementStdDevs);
-    m_meanFuncX = [](auto sigmas, auto Wm) -> Eigen::Matrix<double, States, 1> {
-      return sigmas * Wm;
-    };
-    m_meanFuncY = [](auto sigmas,
-                     auto Wc) -> Eigen::Matrix<double, Outputs, 1> {
-      return sigmas * Wc;
-    };
-    m_residualFuncX = [](auto a, auto b) -> Eigen::Matrix<double, States, 1> {
-      return a - b;
-    };
-    m_residualFuncY = [](auto a, auto b) -> Eigen::Matrix<double, Outputs, 1> {
-      return a - b;
-    };
-    m_addFuncX = [](auto a, auto b) -> Eigen::Matrix<double, States, 1> {
-      return a + b;
-    };
     m_dt = dt;
 
     Reset();
@@ -94,15 +140,7 @@ class UnscentedKalmanFilter {
    * @param dt                 Nominal discretization timestep.
    */
   UnscentedKalmanFilter(
-      std::function<Eigen::Matrix<double, States, 1>(
-          const Eigen::Matrix<double, States, 1>&,
-          const Eigen::Matrix<double, Inputs, 1>&)>
-          f,
-      std::function<Eigen::Matrix<double, Outputs, 1>(
-          const Eigen::Matrix<double, States, 1>&,
-          const Eigen::Matrix<double, Inputs, 1>&)>
-          h,
-      const wpi::array<double, States>& stateStdDevs,
+      F f, H h, const wpi::array<double, States>& stateStdDevs,
       const wpi::array<double, Outputs>& measurementStdDevs,
       std::function<Eigen::Matrix<double, States, 1>(
           const Eigen::Matrix<double, States, 2 * States + 1>&,
@@ -125,8 +163,8 @@ class UnscentedKalmanFilter {
           const Eigen::Matrix<double, States, 1>&)>
           addFuncX,
       units::second_t dt)
-      : m_f(f),
-        m_h(h),
+      : m_f(std::move(f)),
+        m_h(std::move(h)),
         m_meanFuncX(meanFuncX),
         m_meanFuncY(meanFuncY),
         m_residualFuncX(residualFuncX),
@@ -204,9 +242,15 @@ class UnscentedKalmanFilter {
   void Predict(const Eigen::Matrix<double, Inputs, 1>& u, units::second_t dt) {
     m_dt = dt;
 
+    // RK4() passes Eigen expressions, so give f matrices and evaluate its
+    // result
+    auto f = [&](const Eigen::Matrix<double, States, 1>& x,
+                 const Eigen::Matrix<double, Inputs, 1>& input)
+        -> Eigen::Matrix<double, States, 1> { return m_f(x, input); };
+
     // Discretize Q before projecting mean and covariance forward
     Eigen::Matrix<double, States, States> contA =
-        NumericalJacobianX<States, States, Inputs>(m_f, m_xHat, u);
+        NumericalJacobianX<States, States, Inputs>(f, m_xHat, u);
     Eigen::Matrix<double, States, States> discA;
     Eigen::Matrix<double, States, States> discQ;
     DiscretizeAQTaylor<States>(contA, m_contQ, dt, &discA, &discQ);
@@ -214,16 +258,33 @@ class UnscentedKalmanFilter {
     Eigen::Matrix<double, States, 2 * States + 1> sigmas =
         m_pts.SigmaPoints(m_xHat, m_P);
 
-    for (int i = 0; i < m_pts.NumSigmas(); ++i) {
-      Eigen::Matrix<double, States, 1> x =
-          sigmas.template block<States, 1>(0, i);
-      m_sigmasF.template block<States, 1>(0, i) = RK4(m_f, x, u, dt);
+    if constexpr (kIsBatchFunction<F>) {
+      m_sigmasF = RK4(
+          [&](const Eigen::Matrix<double, States, 2 * States + 1>& x,
+              const Eigen::Matrix<double, Inputs, 1>& input)
+              -> Eigen::Matrix<double, States, 2 * States + 1> {
+            return m_f(x, input);
+          },
+          sigmas, u, dt);
+    } else {
+      for (int i = 0; i < m_pts.NumSigmas(); ++i) {
+        Eigen::Matrix<double, States, 1> x =
+            sigmas.template block<States, 1>(0, i);
+        m_sigmasF.template block<States, 1>(0, i) = RK4(f, x, u, dt);
+      }
     }
 
-    auto ret = UnscentedTransform<States, States>(
-        m_sigmasF, m_pts.Wm(), m_pts.Wc(), m_meanFuncX, m_residualFuncX);
-    m_xHat = std::get<0>(ret);
-    m_P = std::get<1>(ret);
+    if (m_meanFuncX) {
+      std::tie(m_xHat, m_P) = UnscentedTransform<States, States>(
+          m_sigmasF, m_pts.Wm(), m_pts.Wc(), m_meanFuncX, m_residualFuncX);
+    } else {
+      std::tie(m_xHat, m_P) = UnscentedTransform<States, States>(
+          m_sigmasF, m_pts.Wm(), m_pts.Wc(),
+          [](const auto& sigmasX, const auto& Wm)
+              -> Eigen::Matrix<double, States, 1> { return sigmasX * Wm; },
+          [](const auto& a, const auto& b)
+              -> Eigen::Matrix<double, States, 1> { return a - b; });
+    }
 
     m_P += discQ;
   }
@@ -236,8 +297,12 @@ class UnscentedKalmanFilter {
    */
   void Correct(const Eigen::Matrix<double, Inputs, 1>& u,
                const Eigen::Matrix<double, Outputs, 1>& y) {
-    Correct<Outputs>(u, y, m_h, m_contR, m_meanFuncY, m_residualFuncY,
-                     m_residualFuncX, m_addFuncX);
+    if (m_meanFuncY) {
+      Correct<Outputs>(u, y, m_h, m_contR, m_meanFuncY, m_residualFuncY,
+                       m_residualFuncX, m_addFuncX);
+    } else {
+      Correct<Outputs>(u, y, m_h, m_contR);
+    }
   }
 
   /**
@@ -253,26 +318,25 @@ class UnscentedKalmanFilter {
    *          vector.
    * @param R Measurement noise covariance matrix (continuous-time).
    */
-  template <int Rows>
+  template <int Rows, typename HFunc>
   void Correct(const Eigen::Matrix<double, Inputs, 1>& u,
-               const Eigen::Matrix<double, Rows, 1>& y,
-               std::function<Eigen::Matrix<double, Rows, 1>(
-                   const Eigen::Matrix<double, States, 1>&,
-                   const Eigen::Matrix<double, Inputs, 1>&)>
-                   h,
+               const Eigen::Matrix<double, Rows, 1>& y, HFunc&& h,
                const Eigen::Matrix<double, Rows, Rows>& R) {
-    auto meanFuncY = [](auto sigmas,
-                        auto Wc) -> Eigen::Matrix<double, Rows, 1> {
+    auto meanFuncY = [](const auto& sigmas,
+                        const auto& Wc) -> Eigen::Matrix<double, Rows, 1> {
       return sigmas * Wc;
     };
-    auto residualFuncX = [](auto a,
-                            auto b) -> Eigen::Matrix<double, States, 1> {
+    auto residualFuncX =
+        [](const auto& a,
+           const auto& b) -> Eigen::Matrix<double, States, 1> {
       return a - b;
     };
-    auto residualFuncY = [](auto a, auto b) -> Eigen::Matrix<double, Rows, 1> {
+    auto residualFuncY = [](const auto& a,
+                            const auto& b) -> Eigen::Matrix<double, Rows, 1> {
       return a - b;
     };
-    auto addFuncX = [](auto a, auto b) -> Eigen::Matrix<double, States, 1> {
+    auto addFuncX = [](const auto& a,
+                       const auto& b) -> Eigen::Matrix<double, States, 1> {
       return a + b;
     };
     Correct<Rows>(u, y, h, R, meanFuncY, residualFuncY, residualFuncX,
@@ -299,39 +363,27 @@ class UnscentedKalmanFilter {
    *                      vectors (i.e. it subtracts them.)
    * @param addFuncX      A function that adds two state vectors.
    */
-  template <int Rows>
+  template <int Rows, typename HFunc, typename MeanFuncY,
+            typename ResidualFuncY, typename ResidualFuncX, typename AddFuncX>
   void Correct(const Eigen::Matrix<double, Inputs, 1>& u,
-               const Eigen::Matrix<double, Rows, 1>& y,
-               std::function<Eigen::Matrix<double, Rows, 1>(
-                   const Eigen::Matrix<double, States, 1>&,
-                   const Eigen::Matrix<double, Inputs, 1>&)>
-                   h,
+               const Eigen::Matrix<double, Rows, 1>& y, HFunc&& h,
                const Eigen::Matrix<double, Rows, Rows>& R,
-               std::function<Eigen::Matrix<double, Rows, 1>(
-                   const Eigen::Matrix<double, Rows, 2 * States + 1>&,
-                   const Eigen::Matrix<double, 2 * States + 1, 1>&)>
-                   meanFuncY,
-               std::function<Eigen::Matrix<double, Rows, 1>(
-                   const Eigen::Matrix<double, Rows, 1>&,
-                   const Eigen::Matrix<double, Rows, 1>&)>
-                   residualFuncY,
-               std::function<Eigen::Matrix<double, States, 1>(
-                   const Eigen::Matrix<double, States, 1>&,
-                   const Eigen::Matrix<double, States, 1>&)>
-                   residualFuncX,
-               std::function<Eigen::Matrix<double, States, 1>(
-                   const Eigen::Matrix<double, States, 1>&,
-                   const Eigen::Matrix<double, States, 1>)>
-                   addFuncX) {
+               MeanFuncY&& meanFuncY, ResidualFuncY&& residualFuncY,
+               ResidualFuncX&& residualFuncX, AddFuncX&& addFuncX) {
     const Eigen::Matrix<double, Rows, Rows> discR = DiscretizeR<Rows>(R, m_dt);
 
     // Transform sigma points into measurement space
     Eigen::Matrix<double, Rows, 2 * States + 1> sigmasH;
     Eigen::Matrix<double, States, 2 * States + 1> sigmas =
         m_pts.SigmaPoints(m_xHat, m_P);
-    for (int i = 0; i < m_pts.NumSigmas(); ++i) {
-      sigmasH.template block<Rows, 1>(0, i) =
-          h(sigmas.template block<States, 1>(0, i), u);
+    if constexpr (kIsBatchFunction<std::decay_t<HFunc>>) {
+      sigmasH = h(sigmas, u);
+    } else {
+      for (int i = 0; i < m_pts.NumSigmas(); ++i) {
+        Eigen::Matrix<double, States, 1> x =
+            sigmas.template block<States, 1>(0, i);
+        sigmasH.template block<Rows, 1>(0, i) = h(x, u);
+      }
     }
 
     // Mean and covariance of prediction passed through UT
@@ -363,14 +415,11 @@ class UnscentedKalmanFilter {
   }
 
  private:
-  std::function<Eigen::Matrix<double, States, 1>(
-      const Eigen::Matrix<double, States, 1>&,
-      const Eigen::Matrix<double, Inputs, 1>&)>
-      m_f;
-  std::function<Eigen::Matrix<double, Outputs, 1>(
-      const Eigen::Matrix<double, States, 1>&,
-      const Eigen::Matrix<double, Inputs, 1>&)>
-      m_h;
+  F m_f;
+  H m_h;
+
+  // The mean, residual, and add functions are empty unless custom ones were
+  // given to the constructor; ordinary arithmetic is used in their place
   std::function<Eigen::Matrix<double, States, 1>(
       const Eigen::Matrix<double, States, 2 * States + 1>&,
       const Eigen::Matrix<double, 2 * States + 1, 1>&)>
@@ -401,4 +450,76 @@ class UnscentedKalmanFilter {
   MerweScaledSigmaPoints<States> m_pts;
 };
 
+/**
+ * Makes an unscented Kalman filter that stores f and h as their own types
+ * instead of std::function.
+ *
+ * @param f                  A vector-valued function of x and u that returns
+ *                           the derivative of the state vector.
+ * @param h                  A vector-valued function of x and u that returns
+ *                           the measurement vector.
+ * @param stateStdDevs       Standard deviations of model states.
+ * @param measurementStdDevs Standard deviations of measurements.
+ * @param dt                 Nominal discretization timestep.
+ */
+template <int States, int Inputs, int Outputs, typename F, typename H>
+UnscentedKalmanFilter<States, Inputs, Outputs, F, H> MakeUnscentedKalmanFilter(
+    F f, H h, const wpi::array<double, States>& stateStdDevs,
+    const wpi::array<double, Outputs>& measurementStdDevs,
+    units::second_t dt) {
+  return {std::move(f), std::move(h), stateStdDevs, measurementStdDevs, dt};
+}
+
+/**
+ * Makes an unscented Kalman filter with custom mean, residual, and addition
+ * functions that stores f and h as their own types instead of std::function.
+ *
+ * @param f                  A vector-valued function of x and u that returns
+ *                           the derivative of the state vector.
+ * @param h                  A vector-valued function of x and u that returns
+ *                           the measurement vector.
+ * @param stateStdDevs       Standard deviations of model states.
+ * @param measurementStdDevs Standard deviations of measurements.
+ * @param meanFuncX          A function that computes the mean of 2 * States +
+ *                           1 state vectors using a given set of weights.
+ * @param meanFuncY          A function that computes the mean of 2 * States +
+ *                           1 measurement vectors using a given set of
+ *                           weights.
+ * @param residualFuncX      A function that computes the residual of two
+ *                           state vectors (i.e. it subtracts them.)
+ * @param residualFuncY      A function that computes the residual of two
+ *                           measurement vectors (i.e. it subtracts them.)
+ * @param addFuncX           A function that adds two state vectors.
+ * @param dt                 Nominal discretization timestep.
+ */
+template <int States, int Inputs, int Outputs, typename F, typename H>
+UnscentedKalmanFilter<States, Inputs, Outputs, F, H> MakeUnscentedKalmanFilter(
+    F f, H h, const wpi::array<double, States>& stateStdDevs,
+    const wpi::array<double, Outputs>& measurementStdDevs,
+    std::function<Eigen::Matrix<double, States, 1>(
+        const Eigen::Matrix<double, States, 2 * States + 1>&,
+        const Eigen::Matrix<double, 2 * States + 1, 1>&)>
+        meanFuncX,
+    std::function<Eigen::Matrix<double, Outputs, 1>(
+        const Eigen::Matrix<double, Outputs, 2 * States + 1>&,
+        const Eigen::Matrix<double, 2 * States + 1, 1>&)>
+        meanFuncY,
+    std::function<Eigen::Matrix<double, States, 1>(
+        const Eigen::Matrix<double, States, 1>&,
+        const Eigen::Matrix<double, States, 1>&)>
+        residualFuncX,
+    std::function<Eigen::Matrix<double, Outputs, 1>(
+        const Eigen::Matrix<double, Outputs, 1>&,
+        const Eigen::Matrix<double, Outputs, 1>&)>
+        residualFuncY,
+    std::function<Eigen::Matrix<double, States, 1>(
+        const Eigen::Matrix<double, States, 1>&,
+        const Eigen::Matrix<double, States, 1>&)>
+        addFuncX,
+    units::second_t dt) {
+  return {std::move(f), std::move(h), stateStdDevs,  measurementStdDevs,
+          meanFuncX,    meanFuncY,    residualFuncX, residualFuncY,
+          addFuncX,     dt};
+}
+
 }  // namespace frc
@@ -16,30 +16,27 @@ namespace frc {
  *
  * This works in conjunction with the UnscentedKalmanFilter class.
  *
- * @tparam States  Number of states.
- * @tparam CovDim  Dimension of covariance of sigma points after passing through
- *                 the transform.
- * @param sigmas   List of sigma points.
- * @param Wm       Weights for the mean.
- * @param Wc       Weights for the covariance.
+ * @tparam States     Number of states.
+ * @tparam CovDim     Dimension of covariance of sigma points after passing
+ *                    through the transform.
+ * @param sigmas       List of sigma points.
+ * @param Wm           Weights for the mean.
+ * @param Wc           Weights for the covariance.
+ * @param meanFunc     A function that computes the mean of the sigma points
+ *                     using a given set of weights.
+ * @param residualFunc A function that computes the residual of two vectors
+ *                     (i.e. it subtracts them.)
  *
  * @return Tuple of x, mean of sigma points; P, covariance of sigma points after
  *         passing through the transform.
  */
-template <int States, int CovDim>
+template <int States, int CovDim, typename MeanFunc, typename ResidualFunc>
 std::tuple<Eigen::Matrix<double, CovDim, 1>,
            Eigen::Matrix<double, CovDim, CovDim>>
 UnscentedTransform(const Eigen::Matrix<double, CovDim, 2 * States + 1>& sigmas,
                    const Eigen::Matrix<double, 2 * States + 1, 1>& Wm,
                    const Eigen::Matrix<double, 2 * States + 1, 1>& Wc,
-                   std::function<Eigen::Matrix<double, CovDim, 1>(
-                       const Eigen::Matrix<double, CovDim, 2 * States + 1>&,
-                       const Eigen::Matrix<double, 2 * States + 1, 1>&)>
-                       meanFunc,
-                   std::function<Eigen::Matrix<double, CovDim, 1>(
-                       const Eigen::Matrix<double, CovDim, 1>&,
-                       const Eigen::Matrix<double, CovDim, 1>&)>
-                       residualFunc) {
+                   MeanFunc&& meanFunc, ResidualFunc&& residualFunc) {
   // New mean is usually just the sum of the sigmas * weight:
   // dot = \Sigma^n_1 (W[k]*Xi[k])
   Eigen::Matrix<double, CovDim, 1> x = meanFunc(sigmas, Wm);
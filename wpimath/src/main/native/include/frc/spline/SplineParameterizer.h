@@ -28,11 +28,12 @@
 
 #pragma once
 
-#include <stack>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <wpi/SmallVector.h>
+
 #include "frc/spline/Spline.h"
 #include "units/angle.h"
 #include "units/curvature.h"
@@ -75,31 +76,52 @@ class SplineParameterizer {
     // The parameterization does not add the initial point. Let's add that.
     splinePoints.push_back(spline.GetPoint(t0));
 
-    // We use an "explicit stack" to simulate recursion, instead of a recursive
-    // function call This give us greater control, instead of a stack overflow
-    std::stack<StackContents> stack;
-    stack.emplace(StackContents{t0, t1});
+    Parameterize(spline, &splinePoints, t0, t1);
+    return splinePoints;
+  }
 
-    StackContents current;
-    PoseWithCurvature start;
-    PoseWithCurvature end;
+  /**
+   * Parameterizes the spline, appending the points to an existing vector.
+   * Unlike the other overload, the point at t0 is not added, so the splines
+   * of a path can be parameterized into one vector without repeating the
+   * points where they join.
+   *
+   * @param spline The spline to parameterize.
+   * @param splinePoints The vector to append the points to.
+   * @param t0 Starting internal spline parameter. It is recommended to leave
+   * this as default.
+   * @param t1 Ending internal spline parameter. It is recommended to leave this
+   * as default.
+   */
+  template <int Dim>
+  static void Parameterize(const Spline<Dim>& spline,
+                           std::vector<PoseWithCurvature>* splinePoints,
+                           double t0 = 0.0, double t1 = 1.0) {
+    // We use an "explicit stack" to simulate recursion, instead of a recursive
+    // function call This give us greater control, instead of a stack overflow.
+    // Each entry is the end of an arc; the arc starts at the last point added,
+    // so every point is only evaluated once.
+    wpi::SmallVector<StackContents, 32> stack;
+    stack.emplace_back(StackContents{t1, spline.GetPoint(t1)});
+
+    double startT = t0;
+    PoseWithCurvature start = spline.GetPoint(t0);
     int iterations = 0;
 
     while (!stack.empty()) {
-      current = stack.top();
-      stack.pop();
-      start = spline.GetPoint(current.t0);
-      end = spline.GetPoint(current.t1);
-
-      const auto twist = start.first.Log(end.first);
+      const auto& end = stack.back();
+      const auto twist = start.first.Log(end.point.first);
 
       if (units::math::abs(twist.dy) > kMaxDy ||
           units::math::abs(twist.dx) > kMaxDx ||
           units::math::abs(twist.dtheta) > kMaxDtheta) {
-        stack.emplace(StackContents{(current.t0 + current.t1) / 2, current.t1});
-        stack.emplace(StackContents{current.t0, (current.t0 + current.t1) / 2});
+        double t = (startT + end.t) / 2;
+        stack.emplace_back(StackContents{t, spline.GetPoint(t)});
       } else {
-        splinePoints.push_back(spline.GetPoint(current.t1));
+        splinePoints->push_back(end.point);
+        startT = end.t;
+        start = end.point;
+        stack.pop_back();
       }
 
       if (iterations++ >= kMaxIterations) {
@@ -110,8 +132,6 @@ class SplineParameterizer {
             "in opposing directions.");
       }
     }
-
-    return splinePoints;
   }
 
  private:
@@ -121,8 +141,8 @@ class SplineParameterizer {
   static constexpr units::radian_t kMaxDtheta = 0.0872_rad;
 
   struct StackContents {
-    double t0;
-    double t1;
+    double t;
+    PoseWithCurvature point;
   };
 
   /**
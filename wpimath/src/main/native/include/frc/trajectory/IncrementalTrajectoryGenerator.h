@@ -0,0 +1,75 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "frc/geometry/Pose2d.h"
+#include "frc/trajectory/Trajectory.h"
+#include "frc/trajectory/TrajectoryConfig.h"
+#include "frc/trajectory/TrajectoryParameterizer.h"
+
+namespace frc {
+/**
+ * Generates trajectories through a list of waypoints like
+ * TrajectoryGenerator, but reuses the work done for the previous list of
+ * waypoints. This is meant for paths that are regenerated often, such as when
+ * replanning on the fly.
+ *
+ * Each quintic spline between two waypoints is only parameterized again if
+ * one of those waypoints changed, and time parameterization resumes from the
+ * first changed spline. The generated trajectories are identical to the ones
+ * from TrajectoryGenerator::GenerateTrajectory().
+ */
+class IncrementalTrajectoryGenerator {
+ public:
+  using PoseWithCurvature = std::pair<Pose2d, units::curvature_t>;
+
+  /**
+   * Constructs an IncrementalTrajectoryGenerator.
+   *
+   * @param config The configuration used for every generated trajectory.
+   */
+  explicit IncrementalTrajectoryGenerator(TrajectoryConfig config);
+
+  /**
+   * Generates a trajectory from the given waypoints. This method uses quintic
+   * hermite splines -- therefore, all points must be represented by Pose2d
+   * objects. Continuous curvature is guaranteed in this method.
+   *
+   * @param waypoints List of waypoints.
+   * @return The generated trajectory.
+   */
+  Trajectory GenerateTrajectory(const std::vector<Pose2d>& waypoints);
+
+  /**
+   * Discards the work saved from previous calls.
+   */
+  void Reset();
+
+  /**
+   * Returns the configuration used for every generated trajectory.
+   */
+  const TrajectoryConfig& GetConfig() const { return m_config; }
+
+ private:
+  TrajectoryConfig m_config;
+
+  // Waypoints of the last generated trajectory, after flipping them for a
+  // reversed config.
+  std::vector<Pose2d> m_waypoints;
+
+  // Points of each spline, excluding its first point. The vectors are reused
+  // between calls so regenerating a path usually doesn't allocate.
+  std::vector<std::vector<PoseWithCurvature>> m_splinePoints;
+
+  // All points of the last generated trajectory.
+  std::vector<PoseWithCurvature> m_points;
+
+  // States from the forward pass of time parameterization for m_points.
+  std::vector<TrajectoryParameterizer::ConstrainedState> m_forwardStates;
+};
+}  // namespace frc
@@ -6,6 +6,8 @@
 
 #include <vector>
 
+#include <wpi/span.h>
+
 #include "frc/geometry/Pose2d.h"
 #include "frc/geometry/Transform2d.h"
 #include "units/acceleration.h"
@@ -98,6 +100,31 @@ class Trajectory {
    */
   State Sample(units::second_t t) const;
 
+  /**
+   * Sample the trajectory at several points in time. This returns the same
+   * states as calling Sample() for each point, but is much faster for points
+   * in increasing order (such as when drawing or scoring a trajectory), as
+   * each lookup continues from where the previous one left off instead of
+   * searching the whole trajectory.
+   *
+   * @param times The points in time since the beginning of the trajectory to
+   *              sample.
+   * @param states Output for the state at each point in time. Must be at least
+   *               as large as times.
+   * @throws std::invalid_argument if states is smaller than times.
+   */
+  void SampleMany(wpi::span<const units::second_t> times,
+                  wpi::span<State> states) const;
+
+  /**
+   * Sample the trajectory at several points in time.
+   *
+   * @param times The points in time since the beginning of the trajectory to
+   *              sample.
+   * @return The state at each point in time.
+   */
+  std::vector<State> SampleMany(wpi::span<const units::second_t> times) const;
+
   /**
    * Transforms all poses in the trajectory by the given transform. This is
    * useful for converting a robot-relative trajectory into a field-relative
@@ -154,8 +181,21 @@ class Trajectory {
 
  private:
   std::vector<State> m_states;
+  // Per-state data used by Sample(), stored as separate arrays so searching
+  // only touches contiguous timestamps. Element i describes the segment from
+  // state i - 1 to state i: the distance and transform between their poses.
+  std::vector<double> m_times;
+  std::vector<units::meter_t> m_distances;
+  std::vector<Transform2d> m_poseDeltas;
   units::second_t m_totalTime = 0_s;
 
+  size_t FindState(units::second_t t, size_t hint) const;
+  State SampleBefore(units::second_t t, size_t index) const;
+
+  static State Interpolate(const State& start, const State& end, double i,
+                           units::meter_t distance,
+                           const Transform2d& poseDelta);
+
   /**
    * Linearly interpolates between two values.
    *
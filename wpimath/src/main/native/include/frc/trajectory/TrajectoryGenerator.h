@@ -99,15 +99,12 @@ class TrajectoryGenerator {
     // Add the first point to the vector.
     splinePoints.push_back(splines.front().GetPoint(0.0));
 
-    // Iterate through the vector and parameterize each spline, adding the
-    // parameterized points to the final vector.
+    // Iterate through the vector and parameterize each spline, appending the
+    // parameterized points to the final vector. The first point of each
+    // spline isn't added because it's a duplicate of the last point from the
+    // previous spline.
     for (auto&& spline : splines) {
-      auto points = SplineParameterizer::Parameterize(spline);
-      // Append the array of poses to the vector. We are removing the first
-      // point because it's a duplicate of the last point from the previous
-      // spline.
-      splinePoints.insert(std::end(splinePoints), std::begin(points) + 1,
-                          std::end(points));
+      SplineParameterizer::Parameterize(spline, &splinePoints);
     }
     return splinePoints;
   }
@@ -126,5 +123,7 @@ class TrajectoryGenerator {
 
   static const Trajectory kDoNothingTrajectory;
   static std::function<void(const char*)> s_errorFunc;
+
+  friend class IncrementalTrajectoryGenerator;
 };
 }  // namespace frc
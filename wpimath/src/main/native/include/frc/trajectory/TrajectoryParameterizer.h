@@ -86,6 +86,48 @@ class TrajectoryParameterizer {
     units::meters_per_second_squared_t maxAcceleration = 0_mps_sq;
   };
 
+  /**
+   * Makes the forward pass of time parameterization, which limits each
+   * state's velocity and acceleration based on the states before it.
+   *
+   * @param points Reference to the spline points.
+   * @param constraints A vector of various velocity and acceleration
+   * constraints.
+   * @param startVelocity The start velocity for the trajectory.
+   * @param maxVelocity The max velocity for the trajectory.
+   * @param maxAcceleration The max acceleration for the trajectory.
+   * @param reversed Whether the robot should move backwards.
+   * @param start Index of the first state to compute. States before it must
+   * already be computed from the same points and parameters.
+   * @param states The constrained states. Resized to the number of points.
+   */
+  static void ForwardPass(
+      const std::vector<PoseWithCurvature>& points,
+      const std::vector<std::unique_ptr<TrajectoryConstraint>>& constraints,
+      units::meters_per_second_t startVelocity,
+      units::meters_per_second_t maxVelocity,
+      units::meters_per_second_squared_t maxAcceleration, bool reversed,
+      size_t start, std::vector<ConstrainedState>* states);
+
+  /**
+   * Makes the backward pass of time parameterization on the states from the
+   * forward pass, then integrates them forward in time.
+   *
+   * @param constrainedStates The states from the forward pass.
+   * @param constraints A vector of various velocity and acceleration
+   * constraints.
+   * @param endVelocity The end velocity for the trajectory.
+   * @param maxAcceleration The max acceleration for the trajectory.
+   * @param reversed Whether the robot should move backwards.
+   *
+   * @return The trajectory.
+   */
+  static Trajectory BackwardPass(
+      std::vector<ConstrainedState> constrainedStates,
+      const std::vector<std::unique_ptr<TrajectoryConstraint>>& constraints,
+      units::meters_per_second_t endVelocity,
+      units::meters_per_second_squared_t maxAcceleration, bool reversed);
+
   /**
    * Enforces acceleration limits as defined by the constraints. This function
    * is used when time parameterizing a trajectory.
@@ -100,5 +142,7 @@ class TrajectoryParameterizer {
       bool reverse,
       const std::vector<std::unique_ptr<TrajectoryConstraint>>& constraints,
       ConstrainedState* state);
+
+  friend class IncrementalTrajectoryGenerator;
 };
 }  // namespace frc
@@ -0,0 +1,110 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+
+#include "frc/trajectory/constraint/TrajectoryConstraint.h"
+#include "units/math.h"
+
+namespace frc {
+/**
+ * Enforces several constraints as one.
+ *
+ * The constraint types are known at compile time, so the trajectory
+ * parameterizer makes one virtual call per point for the whole set instead of
+ * one per constraint, and the constraints' own functions are called directly
+ * and can be inlined. Adding a set to a TrajectoryConfig gives the same
+ * trajectory as adding each of its constraints in order.
+ *
+ * <pre>
+ * config.AddConstraint(TrajectoryConstraintSet{
+ *     SwerveDriveKinematicsConstraint{kinematics, 4_mps},
+ *     CentripetalAccelerationConstraint{3_mps_sq},
+ *     RectangularRegionConstraint{bottomLeft, topRight,
+ *                                 MaxVelocityConstraint{1_mps}}});
+ * </pre>
+ */
+template <typename... Constraints>
+class TrajectoryConstraintSet : public TrajectoryConstraint {
+  static_assert(
+      (std::is_base_of_v<TrajectoryConstraint, Constraints> && ...),
+      "All constraints must derive from TrajectoryConstraint");
+
+ public:
+  /**
+   * Constructs a new TrajectoryConstraintSet.
+   *
+   * @param constraints The constraints to enforce.
+   */
+  explicit TrajectoryConstraintSet(const Constraints&... constraints)
+      : m_constraints(constraints...) {}
+
+  /**
+   * Returns the smallest max velocity of all constraints. Like the trajectory
+   * parameterizer, each constraint is given the max velocity from the ones
+   * before it.
+   */
+  units::meters_per_second_t MaxVelocity(
+      const Pose2d& pose, units::curvature_t curvature,
+      units::meters_per_second_t velocity) const override {
+    std::apply(
+        [&](const auto&... constraints) {
+          ((velocity = units::math::min(
+                velocity, MaxVelocityOf(constraints, pose, curvature,
+                                        velocity))),
+           ...);
+        },
+        m_constraints);
+    return velocity;
+  }
+
+  /**
+   * Returns the intersection of all constraints' acceleration bounds. If the
+   * bounds don't overlap, the minimum is greater than the maximum, which the
+   * trajectory parameterizer reports as an error.
+   */
+  MinMax MinMaxAcceleration(const Pose2d& pose, units::curvature_t curvature,
+                            units::meters_per_second_t speed) const override {
+    MinMax minMax;
+    std::apply(
+        [&](const auto&... constraints) {
+          (Intersect(&minMax,
+                     MinMaxAccelerationOf(constraints, pose, curvature, speed)),
+           ...);
+        },
+        m_constraints);
+    return minMax;
+  }
+
+ private:
+  // Qualified calls bypass the vtable, since each constraint is stored by
+  // value and its type is known.
+  template <typename Constraint>
+  static units::meters_per_second_t MaxVelocityOf(
+      const Constraint& constraint, const Pose2d& pose,
+      units::curvature_t curvature, units::meters_per_second_t velocity) {
+    return constraint.Constraint::MaxVelocity(pose, curvature, velocity);
+  }
+
+  template <typename Constraint>
+  static MinMax MinMaxAccelerationOf(const Constraint& constraint,
+                                     const Pose2d& pose,
+                                     units::curvature_t curvature,
+                                     units::meters_per_second_t speed) {
+    return constraint.Constraint::MinMaxAcceleration(pose, curvature, speed);
+  }
+
+  static void Intersect(MinMax* minMax, const MinMax& other) {
+    minMax->minAcceleration =
+        units::math::max(minMax->minAcceleration, other.minAcceleration);
+    minMax->maxAcceleration =
+        units::math::min(minMax->maxAcceleration, other.maxAcceleration);
+  }
+
+  std::tuple<Constraints...> m_constraints;
+};
+}  // namespace frc
@@ -0,0 +1,207 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "frc/estimator/SwerveDrivePoseEstimator.h"
+#include "frc/geometry/Pose2d.h"
+#include "frc/kinematics/SwerveDriveKinematics.h"
+#include "gtest/gtest.h"
+
+namespace {
+class KalmanFilterLatencyCompensatorTest : public ::testing::Test {
+ protected:
+  frc::SwerveDrivePoseEstimator<4> MakeEstimator() {
+    return {frc::Rotation2d(), frc::Pose2d(), kinematics,
+            {0.1, 0.1, 0.1},   {0.05},        {0.1, 0.1, 0.1}};
+  }
+
+  // Drives in a slow arc, returning the true pose at time t.
+  frc::Pose2d Update(frc::SwerveDrivePoseEstimator<4>& estimator,
+                     units::second_t t) {
+    auto moduleStates =
+        kinematics.ToSwerveModuleStates({1_mps, 0_mps, 0.25_rad_per_s});
+    frc::Rotation2d heading{0.25_rad_per_s * t};
+    estimator.UpdateWithTime(t, heading, moduleStates[0], moduleStates[1],
+                             moduleStates[2], moduleStates[3]);
+    return frc::Pose2d{frc::Translation2d{4_m * heading.Sin(),
+                                          4_m * (1 - heading.Cos())},
+                       heading};
+  }
+
+  frc::SwerveDriveKinematics<4> kinematics{
+      frc::Translation2d{1_m, 1_m}, frc::Translation2d{1_m, -1_m},
+      frc::Translation2d{-1_m, -1_m}, frc::Translation2d{-1_m, 1_m}};
+};
+
+frc::Pose2d Offset(const frc::Pose2d& pose, double offset) {
+  return pose +
+         frc::Transform2d{frc::Translation2d{offset * 1_m, 0.5 * offset * 1_m},
+                          frc::Rotation2d{offset * 0.1_rad}};
+}
+}  // namespace
+
+// Applying measurements as a batch, in any order, is the same as applying them
+// one at a time from oldest to newest.
+TEST_F(KalmanFilterLatencyCompensatorTest, BatchMatchesSequential) {
+  auto sequential = MakeEstimator();
+  auto batched = MakeEstimator();
+
+  units::second_t dt = 0.02_s;
+  std::vector<frc::Pose2d> poses;
+  for (int i = 0; i < 200; ++i) {
+    units::second_t t = i * dt;
+    poses.emplace_back(Update(sequential, t));
+    Update(batched, t);
+
+    if (i % 5 == 0 && i >= 10) {
+      std::pair<frc::Pose2d, units::second_t> measurements[] = {
+          {Offset(poses[i - 2], 0.1), t - 2 * dt},
+          {Offset(poses[i - 8], -0.2), t - 8 * dt},
+          {Offset(poses[i - 5], 0.05), t - 5 * dt}};
+      sequential.AddVisionMeasurement(measurements[1].first,
+                                      measurements[1].second);
+      sequential.AddVisionMeasurement(measurements[2].first,
+                                      measurements[2].second);
+      sequential.AddVisionMeasurement(measurements[0].first,
+                                      measurements[0].second);
+      batched.AddVisionMeasurements(measurements);
+
+      auto expected = sequential.GetEstimatedPosition();
+      auto actual = batched.GetEstimatedPosition();
+      EXPECT_NEAR(expected.X().to<double>(), actual.X().to<double>(), 1e-9);
+      EXPECT_NEAR(expected.Y().to<double>(), actual.Y().to<double>(), 1e-9);
+      EXPECT_NEAR(expected.Rotation().Radians().to<double>(),
+                  actual.Rotation().Radians().to<double>(), 1e-9);
+    }
+  }
+}
+
+// A measurement that maps to the same stored state as an earlier one is
+// applied on top of it rather than replacing it.
+TEST_F(KalmanFilterLatencyCompensatorTest, SameTimestamp) {
+  auto sequential = MakeEstimator();
+  auto batched = MakeEstimator();
+  auto second = MakeEstimator();
+
+  units::second_t dt = 0.02_s;
+  std::vector<frc::Pose2d> poses;
+  for (int i = 0; i < 50; ++i) {
+    poses.emplace_back(Update(sequential, i * dt));
+    Update(batched, i * dt);
+    Update(second, i * dt);
+  }
+
+  units::second_t timestamp = 45 * dt;
+  std::pair<frc::Pose2d, units::second_t> measurements[] = {
+      {Offset(poses[45], 0.2), timestamp}, {Offset(poses[45], 0.1), timestamp}};
+  sequential.AddVisionMeasurement(measurements[0].first, timestamp);
+  sequential.AddVisionMeasurement(measurements[1].first, timestamp);
+  batched.AddVisionMeasurements(measurements);
+  second.AddVisionMeasurement(measurements[1].first, timestamp);
+
+  auto expected = batched.GetEstimatedPosition();
+  auto actual = sequential.GetEstimatedPosition();
+  EXPECT_NEAR(expected.X().to<double>(), actual.X().to<double>(), 1e-9);
+  EXPECT_NEAR(expected.Y().to<double>(), actual.Y().to<double>(), 1e-9);
+  EXPECT_NEAR(expected.Rotation().Radians().to<double>(),
+              actual.Rotation().Radians().to<double>(), 1e-9);
+
+  // the first measurement still counts
+  EXPECT_GT(std::abs(actual.X().to<double>() -
+                     second.GetEstimatedPosition().X().to<double>()),
+            1e-3);
+}
+
+// Replaying a measurement applies it with the standard deviations it was added
+// with, not the latest ones.
+TEST_F(KalmanFilterLatencyCompensatorTest, ReplayKeepsStdDevs) {
+  auto inOrder = MakeEstimator();
+  auto outOfOrder = MakeEstimator();
+
+  units::second_t dt = 0.02_s;
+  std::vector<frc::Pose2d> poses;
+  for (int i = 0; i < 50; ++i) {
+    poses.emplace_back(Update(inOrder, i * dt));
+    Update(outOfOrder, i * dt);
+  }
+
+  auto older = Offset(poses[40], 0.3);
+  auto newer = Offset(poses[45], -0.2);
+  inOrder.AddVisionMeasurement(older, 40 * dt, {1.0, 1.0, 1.0});
+  inOrder.AddVisionMeasurement(newer, 45 * dt, {0.01, 0.01, 0.01});
+  // the newer measurement is applied again when the older one is added
+  outOfOrder.AddVisionMeasurement(newer, 45 * dt, {0.01, 0.01, 0.01});
+  outOfOrder.AddVisionMeasurement(older, 40 * dt, {1.0, 1.0, 1.0});
+
+  auto expected = inOrder.GetEstimatedPosition();
+  auto actual = outOfOrder.GetEstimatedPosition();
+  EXPECT_NEAR(expected.X().to<double>(), actual.X().to<double>(), 1e-9);
+  EXPECT_NEAR(expected.Y().to<double>(), actual.Y().to<double>(), 1e-9);
+  EXPECT_NEAR(expected.Rotation().Radians().to<double>(),
+              actual.Rotation().Radians().to<double>(), 1e-9);
+}
+
+// Measurements older or newer than all stored states use the closest one.
+TEST_F(KalmanFilterLatencyCompensatorTest, OutOfRangeTimestamps) {
+  auto estimator = MakeEstimator();
+  frc::Pose2d pose;
+  for (int i = 0; i < 400; ++i) {
+    pose = Update(estimator, i * 0.02_s);
+  }
+  estimator.AddVisionMeasurement(pose, 0_s);
+  estimator.AddVisionMeasurement(pose, 100_s);
+  auto estimate = estimator.GetEstimatedPosition();
+  EXPECT_TRUE(std::isfinite(estimate.X().to<double>()));
+  EXPECT_TRUE(std::isfinite(estimate.Y().to<double>()));
+  EXPECT_LT(estimate.Translation().Distance(pose.Translation()).to<double>(),
+            0.5);
+}
+
+// Reports the cost per vision update of three cameras with 40-160 ms of
+// latency each robot loop, applied one at a time and as a batch.
+TEST_F(KalmanFilterLatencyCompensatorTest, Benchmark) {
+  static constexpr int kLoops = 1000;
+  units::second_t dt = 0.02_s;
+
+  auto time = [&](bool batch) {
+    auto estimator = MakeEstimator();
+    std::vector<frc::Pose2d> poses;
+    // fill the snapshot buffer first
+    for (int i = 0; i < 300; ++i) {
+      poses.emplace_back(Update(estimator, i * dt));
+    }
+
+    std::chrono::duration<double, std::micro> elapsed{0};
+    for (int i = 300; i < 300 + kLoops; ++i) {
+      units::second_t t = i * dt;
+      poses.emplace_back(Update(estimator, t));
+
+      std::pair<frc::Pose2d, units::second_t> measurements[] = {
+          {Offset(poses[i - 2], 0.01), t - 2 * dt},
+          {Offset(poses[i - 5], -0.01), t - 5 * dt},
+          {Offset(poses[i - 8], 0.02), t - 8 * dt}};
+      auto start = std::chrono::steady_clock::now();
+      if (batch) {
+        estimator.AddVisionMeasurements(measurements);
+      } else {
+        for (auto&& [pose, timestamp] : measurements) {
+          estimator.AddVisionMeasurement(pose, timestamp);
+        }
+      }
+      elapsed += std::chrono::steady_clock::now() - start;
+    }
+    return elapsed.count() / (kLoops * 3);
+  };
+
+  double sequential = time(false);
+  double batched = time(true);
+
+  std::cout << "us per vision update: sequential " << sequential
+            << ", batched " << batched << "\n";
+}
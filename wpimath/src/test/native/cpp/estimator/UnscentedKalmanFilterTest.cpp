@@ -5,7 +5,10 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <chrono>
 #include <cmath>
+#include <iostream>
+#include <vector>
 
 #include "Eigen/Core"
 #include "Eigen/QR"
@@ -73,6 +76,101 @@ Eigen::Matrix<double, 5, 1> GlobalMeasurementModel(
   y << x(0), x(1), x(2), x(3), x(4);
   return y;
 }
+
+// Dynamics() written with array operations, so x can be a state vector or a
+// matrix of states in its columns.
+class BatchDynamics {
+ public:
+  BatchDynamics() {
+    auto motors = frc::DCMotor::CIM(2);
+
+    constexpr double Ghigh = 7.08;   // High gear ratio
+    constexpr auto r = 0.0746125_m;  // Wheel radius
+    constexpr auto m = 63.503_kg;    // Robot mass
+    constexpr auto J = 5.6_kg_sq_m;  // Robot moment of inertia
+
+    C1 = (-std::pow(Ghigh, 2) * motors.Kt /
+          (motors.Kv * motors.R * units::math::pow<2>(r)))
+             .to<double>();
+    C2 = (Ghigh * motors.Kt / (motors.R * r)).to<double>();
+    k1 = (1 / m + units::math::pow<2>(rb) / J).to<double>();
+    k2 = (1 / m - units::math::pow<2>(rb) / J).to<double>();
+  }
+
+  template <int Cols>
+  Eigen::Matrix<double, 5, Cols> operator()(
+      const Eigen::Matrix<double, 5, Cols>& x,
+      const Eigen::Matrix<double, 2, 1>& u) const {
+    auto vl = x.row(3).array();
+    auto vr = x.row(4).array();
+
+    Eigen::Matrix<double, 5, Cols> result;
+    auto v = 0.5 * (vl + vr);
+    result.row(0) = (v * x.row(2).array().cos()).matrix();
+    result.row(1) = (v * x.row(2).array().sin()).matrix();
+    result.row(2) = ((vr - vl) / (2.0 * rb.to<double>())).matrix();
+    result.row(3) = (k1 * (C1 * vl + C2 * u(0)) + k2 * (C1 * vr + C2 * u(1)))
+                        .matrix();
+    result.row(4) = (k2 * (C1 * vl + C2 * u(0)) + k1 * (C1 * vr + C2 * u(1)))
+                        .matrix();
+    return result;
+  }
+
+ private:
+  static constexpr auto rb = 0.8382_m / 2.0;  // Robot radius
+
+  double C1;
+  double C2;
+  double k1;
+  double k2;
+};
+
+// LocalMeasurementModel() for a state vector or a matrix of states.
+struct BatchLocalMeasurementModel {
+  template <int Cols>
+  Eigen::Matrix<double, 3, Cols> operator()(
+      const Eigen::Matrix<double, 5, Cols>& x,
+      const Eigen::Matrix<double, 2, 1>&) const {
+    return x.template bottomRows<3>();
+  }
+};
+
+struct Step {
+  Eigen::Matrix<double, 2, 1> u;
+  Eigen::Matrix<double, 5, 1> x;
+};
+
+constexpr auto kDt = 0.00505_s;
+
+// Returns the inputs and true states of a robot weaving along a path.
+std::vector<Step> MakeSteps(int count) {
+  std::vector<Step> steps;
+  Eigen::Matrix<double, 5, 1> x =
+      frc::MakeMatrix<5, 1>(2.75, 22.5, 0.0, 0.0, 0.0);
+  for (int i = 0; i < count; ++i) {
+    auto u = frc::MakeMatrix<2, 1>(6.0 + std::sin(0.01 * i),
+                                   6.0 + std::cos(0.01 * i));
+    x = frc::RK4(Dynamics, x, u, kDt);
+    steps.push_back({u, x});
+  }
+  return steps;
+}
+
+// Runs the filter over the steps with noiseless measurements.
+template <typename Filter>
+void Simulate(Filter& observer, const std::vector<Step>& steps) {
+  auto R = frc::MakeCovMatrix(0.01, 0.01, 0.0001, 0.01, 0.01);
+  observer.SetXhat(frc::MakeMatrix<5, 1>(2.75, 22.5, 0.0, 0.0, 0.0));
+  for (size_t i = 0; i < steps.size(); ++i) {
+    auto& [u, x] = steps[i];
+    observer.Predict(u, kDt);
+    observer.Correct(u, LocalMeasurementModel(x, u));
+    if (i % 10 == 0) {
+      observer.template Correct<5>(u, GlobalMeasurementModel(x, u),
+                                   GlobalMeasurementModel, R);
+    }
+  }
+}
 }  // namespace
 
 TEST(UnscentedKalmanFilterTest, Init) {
@@ -178,3 +276,68 @@ TEST(UnscentedKalmanFilterTest, Convergence) {
   ASSERT_NEAR(0.0, observer.Xhat(3), 1.0);
   ASSERT_NEAR(0.0, observer.Xhat(4), 1.0);
 }
+
+// Storing f and h as their own types, and evaluating them for all sigma points
+// at once, doesn't change the estimate.
+TEST(UnscentedKalmanFilterTest, MatchesStdFunction) {
+  wpi::array<double, 5> stateStdDevs{0.5, 0.5, 10.0, 1.0, 1.0};
+  wpi::array<double, 3> measurementStdDevs{0.0001, 0.5, 0.5};
+  auto steps = MakeSteps(500);
+
+  frc::UnscentedKalmanFilter<5, 2, 3> expected{
+      BatchDynamics{}, BatchLocalMeasurementModel{}, stateStdDevs,
+      measurementStdDevs, kDt};
+  auto inlined = frc::MakeUnscentedKalmanFilter<5, 2, 3>(
+      BatchDynamics{}, BatchLocalMeasurementModel{}, stateStdDevs,
+      measurementStdDevs, kDt);
+  auto batched = frc::MakeUnscentedKalmanFilter<5, 2, 3>(
+      frc::BatchFunction{BatchDynamics{}},
+      frc::BatchFunction{BatchLocalMeasurementModel{}}, stateStdDevs,
+      measurementStdDevs, kDt);
+
+  Simulate(expected, steps);
+  Simulate(inlined, steps);
+  Simulate(batched, steps);
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_NEAR(expected.Xhat(i), inlined.Xhat(i), 1e-9);
+    EXPECT_NEAR(expected.Xhat(i), batched.Xhat(i), 1e-9);
+    for (int j = 0; j < 5; ++j) {
+      EXPECT_NEAR(expected.P(i, j), inlined.P(i, j), 1e-9);
+      EXPECT_NEAR(expected.P(i, j), batched.P(i, j), 1e-9);
+    }
+  }
+}
+
+// Reports the time per predict and correct with f and h stored as
+// std::function, as their own types, and evaluated for all sigma points at
+// once.
+TEST(UnscentedKalmanFilterTest, Benchmark) {
+  static constexpr int kSteps = 2000;
+  wpi::array<double, 5> stateStdDevs{0.5, 0.5, 10.0, 1.0, 1.0};
+  wpi::array<double, 3> measurementStdDevs{0.0001, 0.5, 0.5};
+  auto steps = MakeSteps(kSteps);
+
+  auto time = [&](auto& observer) {
+    auto start = std::chrono::steady_clock::now();
+    Simulate(observer, steps);
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kSteps;
+  };
+
+  frc::UnscentedKalmanFilter<5, 2, 3> stdFunction{
+      BatchDynamics{}, BatchLocalMeasurementModel{}, stateStdDevs,
+      measurementStdDevs, kDt};
+  auto inlined = frc::MakeUnscentedKalmanFilter<5, 2, 3>(
+      BatchDynamics{}, BatchLocalMeasurementModel{}, stateStdDevs,
+      measurementStdDevs, kDt);
+  auto batched = frc::MakeUnscentedKalmanFilter<5, 2, 3>(
+      frc::BatchFunction{BatchDynamics{}},
+      frc::BatchFunction{BatchLocalMeasurementModel{}}, stateStdDevs,
+      measurementStdDevs, kDt);
+
+  std::cout << "us per step: std::function " << time(stdFunction)
+            << ", own types " << time(inlined) << ", batched "
+            << time(batched) << "\n";
+}
@@ -0,0 +1,124 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "frc/trajectory/IncrementalTrajectoryGenerator.h"
+#include "frc/trajectory/TrajectoryGenerator.h"
+#include "frc/trajectory/constraint/CentripetalAccelerationConstraint.h"
+#include "gtest/gtest.h"
+
+using namespace frc;
+
+namespace {
+TrajectoryConfig MakeConfig() {
+  TrajectoryConfig config{3_mps, 3_mps_sq};
+  config.AddConstraint(CentripetalAccelerationConstraint{2_mps_sq});
+  return config;
+}
+
+// A path weaving back and forth across the field.
+std::vector<Pose2d> MakeWaypoints(int count) {
+  std::vector<Pose2d> waypoints;
+  for (int i = 0; i < count; ++i) {
+    waypoints.emplace_back(1.5_m * i, 1_m * (i % 2),
+                           Rotation2d{(i % 2 == 0 ? 30_deg : -30_deg)});
+  }
+  return waypoints;
+}
+}  // namespace
+
+TEST(IncrementalTrajectoryGeneratorTest, MatchesGenerator) {
+  for (bool reversed : {false, true}) {
+    auto config = MakeConfig();
+    config.SetReversed(reversed);
+    IncrementalTrajectoryGenerator incremental{std::move(config)};
+
+    auto waypoints = MakeWaypoints(6);
+    auto check = [&] {
+      EXPECT_EQ(TrajectoryGenerator::GenerateTrajectory(
+                    waypoints, incremental.GetConfig()),
+                incremental.GenerateTrajectory(waypoints));
+    };
+
+    check();
+    // unchanged
+    check();
+    // move an interior waypoint
+    waypoints[3] = waypoints[3] + Transform2d{{0.2_m, -0.1_m}, 10_deg};
+    check();
+    // move the first and last waypoints
+    waypoints.front() = waypoints.front() + Transform2d{{0_m, 0.1_m}, 0_deg};
+    check();
+    waypoints.back() = waypoints.back() + Transform2d{{0.5_m, 0_m}, 0_deg};
+    check();
+    // add and remove waypoints
+    waypoints.emplace_back(10_m, 2_m, 45_deg);
+    check();
+    waypoints.erase(waypoints.begin() + 2);
+    check();
+    waypoints.resize(3);
+    check();
+  }
+}
+
+TEST(IncrementalTrajectoryGeneratorTest, Malformed) {
+  IncrementalTrajectoryGenerator generator{MakeConfig()};
+  generator.GenerateTrajectory(MakeWaypoints(4));
+
+  auto malformed = generator.GenerateTrajectory(
+      std::vector<Pose2d>{Pose2d(0_m, 0_m, Rotation2d(0_deg)),
+                          Pose2d(1_m, 0_m, Rotation2d(180_deg))});
+  EXPECT_EQ(1u, malformed.States().size());
+  EXPECT_EQ(0_s, malformed.TotalTime());
+
+  auto waypoints = MakeWaypoints(4);
+  EXPECT_EQ(TrajectoryGenerator::GenerateTrajectory(waypoints, MakeConfig()),
+            generator.GenerateTrajectory(waypoints));
+}
+
+// Reports the time to generate a trajectory from scratch, and to regenerate it
+// after moving an interior waypoint or the last waypoint, for several numbers
+// of waypoints.
+TEST(IncrementalTrajectoryGeneratorTest, Benchmark) {
+  static constexpr int kLoops = 20;
+  auto config = MakeConfig();
+
+  for (int count : {2, 5, 10, 20}) {
+    auto waypoints = MakeWaypoints(count);
+    auto time = [&](auto&& generate) {
+      auto start = std::chrono::steady_clock::now();
+      for (int loop = 0; loop < kLoops; ++loop) {
+        generate(loop);
+      }
+      std::chrono::duration<double, std::micro> elapsed =
+          std::chrono::steady_clock::now() - start;
+      return elapsed.count() / kLoops;
+    };
+
+    double full = time([&](int) {
+      TrajectoryGenerator::GenerateTrajectory(waypoints, config);
+    });
+
+    IncrementalTrajectoryGenerator incremental{MakeConfig()};
+    auto move = [&](size_t index) {
+      auto original = waypoints[index];
+      incremental.GenerateTrajectory(waypoints);
+      return time([&](int loop) {
+        waypoints[index] =
+            original + Transform2d{{0_m, 0.01_m * (loop % 2 + 1)}, 0_deg};
+        incremental.GenerateTrajectory(waypoints);
+      });
+    };
+    double interior = move(count / 2);
+    double last = move(count - 1);
+
+    std::cout << count << " waypoints (us): full " << full
+              << ", move interior " << interior << ", move last " << last
+              << "\n";
+  }
+}
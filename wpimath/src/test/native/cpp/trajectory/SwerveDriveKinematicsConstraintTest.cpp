@@ -0,0 +1,69 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "frc/kinematics/SwerveDriveKinematics.h"
+#include "frc/trajectory/constraint/SwerveDriveKinematicsConstraint.h"
+#include "gtest/gtest.h"
+#include "trajectory/TestTrajectory.h"
+#include "units/math.h"
+#include "units/time.h"
+
+using namespace frc;
+
+namespace {
+const SwerveDriveKinematics<4> kinematics{
+    Translation2d{12_in, 12_in}, Translation2d{12_in, -12_in},
+    Translation2d{-12_in, 12_in}, Translation2d{-12_in, -12_in}};
+}  // namespace
+
+TEST(SwerveDriveKinematicsConstraintTest, Constraint) {
+  const auto maxVelocity = 12_fps;
+
+  auto config = TrajectoryConfig(16_fps, 12_fps_sq);
+  config.AddConstraint(
+      SwerveDriveKinematicsConstraint(kinematics, maxVelocity));
+
+  auto trajectory = TestTrajectory::GetTrajectory(config);
+
+  units::second_t time = 0_s;
+  units::second_t dt = 20_ms;
+  units::second_t duration = trajectory.TotalTime();
+
+  while (time < duration) {
+    const Trajectory::State point = trajectory.Sample(time);
+    time += dt;
+
+    const ChassisSpeeds chassisSpeeds{
+        point.velocity * point.pose.Rotation().Cos(),
+        point.velocity * point.pose.Rotation().Sin(),
+        point.velocity * point.curvature};
+
+    for (auto&& module : kinematics.ToSwerveModuleStates(chassisSpeeds)) {
+      EXPECT_TRUE(module.speed < maxVelocity + 0.05_mps);
+    }
+  }
+}
+
+// The max velocity is the chassis speed after normalizing the wheel speeds.
+TEST(SwerveDriveKinematicsConstraintTest, MaxVelocity) {
+  const auto maxVelocity = 3_mps;
+  SwerveDriveKinematicsConstraint constraint{kinematics, maxVelocity};
+
+  for (auto velocity : {0_mps, 1_mps, 4_mps, -4_mps}) {
+    for (auto curvature : {0.0, 0.5, -2.0}) {
+      Pose2d pose{1_m, 2_m, 30_deg};
+      units::curvature_t k{curvature};
+
+      auto wheelSpeeds = kinematics.ToSwerveModuleStates(
+          {velocity * pose.Rotation().Cos(), velocity * pose.Rotation().Sin(),
+           velocity * k});
+      kinematics.NormalizeWheelSpeeds(&wheelSpeeds, maxVelocity);
+      auto normSpeeds = kinematics.ToChassisSpeeds(wheelSpeeds);
+
+      EXPECT_NEAR(
+          units::math::hypot(normSpeeds.vx, normSpeeds.vy).to<double>(),
+          constraint.MaxVelocity(pose, k, velocity).to<double>(), 1e-9);
+    }
+  }
+}
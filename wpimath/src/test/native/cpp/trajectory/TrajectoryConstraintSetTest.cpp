@@ -0,0 +1,162 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "frc/kinematics/SwerveDriveKinematics.h"
+#include "frc/trajectory/TrajectoryParameterizer.h"
+#include "frc/trajectory/constraint/CentripetalAccelerationConstraint.h"
+#include "frc/trajectory/constraint/EllipticalRegionConstraint.h"
+#include "frc/trajectory/constraint/MaxVelocityConstraint.h"
+#include "frc/trajectory/constraint/RectangularRegionConstraint.h"
+#include "frc/trajectory/constraint/SwerveDriveKinematicsConstraint.h"
+#include "frc/trajectory/constraint/TrajectoryConstraintSet.h"
+#include "gtest/gtest.h"
+#include "trajectory/TestTrajectory.h"
+
+using namespace frc;
+
+namespace {
+class TrajectoryConstraintSetTest : public ::testing::Test {
+ protected:
+  using PoseWithCurvature = TrajectoryParameterizer::PoseWithCurvature;
+
+  // Adds the constraints one at a time, or as a set.
+  void AddConstraints(TrajectoryConfig* config, bool set,
+                      bool withSwerve = true) {
+    SwerveDriveKinematicsConstraint swerve{kinematics, 4_mps};
+    CentripetalAccelerationConstraint centripetal{2_mps_sq};
+    RectangularRegionConstraint rectangle{Translation2d{10_m, -5_m},
+                                          Translation2d{20_m, 5_m},
+                                          MaxVelocityConstraint{1_mps}};
+    EllipticalRegionConstraint ellipse{Translation2d{50_m, 0_m}, 10_m, 4_m,
+                                       Rotation2d{},
+                                       MaxVelocityConstraint{2_mps}};
+    if (!withSwerve) {
+      if (set) {
+        config->AddConstraint(
+            TrajectoryConstraintSet{centripetal, rectangle, ellipse});
+      } else {
+        config->AddConstraint(centripetal);
+        config->AddConstraint(rectangle);
+        config->AddConstraint(ellipse);
+      }
+    } else if (set) {
+      config->AddConstraint(
+          TrajectoryConstraintSet{swerve, centripetal, rectangle, ellipse});
+    } else {
+      config->AddConstraint(swerve);
+      config->AddConstraint(centripetal);
+      config->AddConstraint(rectangle);
+      config->AddConstraint(ellipse);
+    }
+  }
+
+  // Points along a sine wave, 2 cm apart.
+  static std::vector<PoseWithCurvature> MakePoints(int count) {
+    std::vector<PoseWithCurvature> points;
+    for (int i = 0; i < count; ++i) {
+      double x = 0.02 * i;
+      double dydx = std::cos(x / 2);
+      double d2ydx2 = -0.5 * std::sin(x / 2);
+      points.emplace_back(
+          Pose2d{units::meter_t{x}, units::meter_t{2 * std::sin(x / 2)},
+                 Rotation2d{1.0, dydx}},
+          units::curvature_t{d2ydx2 / std::pow(1 + dydx * dydx, 1.5)});
+    }
+    return points;
+  }
+
+  SwerveDriveKinematics<4> kinematics{
+      Translation2d{0.3_m, 0.3_m}, Translation2d{0.3_m, -0.3_m},
+      Translation2d{-0.3_m, 0.3_m}, Translation2d{-0.3_m, -0.3_m}};
+};
+}  // namespace
+
+TEST_F(TrajectoryConstraintSetTest, MatchesIndividualConstraints) {
+  for (bool reversed : {false, true}) {
+    TrajectoryConfig config{5_mps, 3_mps_sq};
+    config.SetReversed(reversed);
+    AddConstraints(&config, false);
+    TrajectoryConfig setConfig{5_mps, 3_mps_sq};
+    setConfig.SetReversed(reversed);
+    AddConstraints(&setConfig, true);
+
+    EXPECT_EQ(TestTrajectory::GetTrajectory(config),
+              TestTrajectory::GetTrajectory(setConfig));
+
+    auto points = MakePoints(2000);
+    EXPECT_EQ(TrajectoryParameterizer::TimeParameterizeTrajectory(
+                  points, config.Constraints(), 0_mps, 0_mps, 5_mps,
+                  3_mps_sq, reversed),
+              TrajectoryParameterizer::TimeParameterizeTrajectory(
+                  points, setConfig.Constraints(), 0_mps, 0_mps, 5_mps,
+                  3_mps_sq, reversed));
+  }
+}
+
+TEST_F(TrajectoryConstraintSetTest, AccelerationBounds) {
+  struct Bounds : public TrajectoryConstraint {
+    Bounds(units::meters_per_second_squared_t min,
+           units::meters_per_second_squared_t max)
+        : min{min}, max{max} {}
+
+    units::meters_per_second_t MaxVelocity(
+        const Pose2d&, units::curvature_t,
+        units::meters_per_second_t velocity) const override {
+      return velocity;
+    }
+
+    MinMax MinMaxAcceleration(const Pose2d&, units::curvature_t,
+                              units::meters_per_second_t) const override {
+      return {min, max};
+    }
+
+    units::meters_per_second_squared_t min;
+    units::meters_per_second_squared_t max;
+  };
+
+  TrajectoryConstraintSet set{Bounds{-3_mps_sq, 2_mps_sq},
+                              Bounds{-1_mps_sq, 4_mps_sq},
+                              MaxVelocityConstraint{1_mps}};
+  units::curvature_t k{0};
+  auto minMax = set.MinMaxAcceleration(Pose2d{}, k, 0_mps);
+  EXPECT_EQ(-1_mps_sq, minMax.minAcceleration);
+  EXPECT_EQ(2_mps_sq, minMax.maxAcceleration);
+  EXPECT_EQ(1_mps, set.MaxVelocity(Pose2d{}, k, 5_mps));
+  EXPECT_EQ(0.5_mps, set.MaxVelocity(Pose2d{}, k, 0.5_mps));
+}
+
+// Reports the time to time parameterize a 5000 point trajectory with
+// constraints added one at a time and as a set, with and without a swerve
+// kinematics constraint.
+TEST_F(TrajectoryConstraintSetTest, Benchmark) {
+  static constexpr int kLoops = 20;
+  auto points = MakePoints(5000);
+
+  auto time = [&](bool set, bool swerve) {
+    TrajectoryConfig config{5_mps, 3_mps_sq};
+    AddConstraints(&config, set, swerve);
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < kLoops; ++loop) {
+      TrajectoryParameterizer::TimeParameterizeTrajectory(
+          points, config.Constraints(), 0_mps, 0_mps, 5_mps, 3_mps_sq, false);
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kLoops;
+  };
+
+  for (bool swerve : {false, true}) {
+    double individual = time(false, swerve);
+    double set = time(true, swerve);
+    std::cout << "us per 5000 point trajectory"
+              << (swerve ? " with swerve" : "") << ": individual constraints "
+              << individual << ", TrajectoryConstraintSet " << set << "\n";
+  }
+}
@@ -0,0 +1,107 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "frc/trajectory/Trajectory.h"
+#include "gtest/gtest.h"
+#include "trajectory/TestTrajectory.h"
+
+using namespace frc;
+
+namespace {
+void ExpectSampleMany(const Trajectory& trajectory,
+                      const std::vector<units::second_t>& times) {
+  auto states = trajectory.SampleMany(times);
+  ASSERT_EQ(times.size(), states.size());
+  for (size_t i = 0; i < times.size(); ++i) {
+    EXPECT_EQ(trajectory.Sample(times[i]), states[i]) << "at " << times[i].to<double>();
+  }
+}
+}  // namespace
+
+TEST(TrajectorySampleTest, SampleManyIncreasing) {
+  TrajectoryConfig config{12_fps, 12_fps_sq};
+  auto trajectory = TestTrajectory::GetTrajectory(config);
+
+  std::vector<units::second_t> times;
+  for (auto t = -0.1_s; t < trajectory.TotalTime() + 0.1_s; t += 5_ms) {
+    times.emplace_back(t);
+  }
+  // sample exactly at every state, and twice at some times
+  for (auto&& state : trajectory.States()) {
+    times.emplace_back(state.t);
+    times.emplace_back(state.t);
+  }
+  std::sort(times.begin(), times.end());
+  ExpectSampleMany(trajectory, times);
+}
+
+TEST(TrajectorySampleTest, SampleManyUnordered) {
+  TrajectoryConfig config{12_fps, 12_fps_sq};
+  auto trajectory = TestTrajectory::GetTrajectory(config);
+  auto totalTime = trajectory.TotalTime();
+
+  std::vector<units::second_t> times;
+  for (int i = 0; i < 200; ++i) {
+    // jump back and forth, with both small and large steps
+    times.emplace_back(totalTime * ((i * 37) % 101) / 100.0);
+    times.emplace_back(totalTime * ((i * 37) % 101) / 100.0 - 1_ms);
+  }
+  times.emplace_back(totalTime + 1_s);
+  times.emplace_back(-1_s);
+  ExpectSampleMany(trajectory, times);
+}
+
+TEST(TrajectorySampleTest, SampleManyEmpty) {
+  TrajectoryConfig config{12_fps, 12_fps_sq};
+  auto trajectory = TestTrajectory::GetTrajectory(config);
+  EXPECT_TRUE(trajectory.SampleMany({}).empty());
+}
+
+TEST(TrajectorySampleTest, SampleManyOutputTooSmall) {
+  TrajectoryConfig config{12_fps, 12_fps_sq};
+  auto trajectory = TestTrajectory::GetTrajectory(config);
+  std::vector<units::second_t> times{0_s, 0.5_s, 1_s};
+  std::vector<Trajectory::State> states(times.size() - 1);
+  EXPECT_THROW(trajectory.SampleMany(times, states), std::invalid_argument);
+}
+
+// Reports the cost per sample of sampling a trajectory every millisecond,
+// with Sample() in a loop and with SampleMany().
+TEST(TrajectorySampleTest, Benchmark) {
+  static constexpr int kLoops = 100;
+  TrajectoryConfig config{12_fps, 12_fps_sq};
+  auto trajectory = TestTrajectory::GetTrajectory(config);
+
+  std::vector<units::second_t> times;
+  for (auto t = 0_s; t < trajectory.TotalTime(); t += 1_ms) {
+    times.emplace_back(t);
+  }
+  std::vector<Trajectory::State> states(times.size());
+
+  auto time = [&](auto&& sample) {
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < kLoops; ++loop) {
+      sample();
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kLoops / times.size();
+  };
+
+  double loop = time([&] {
+    for (size_t i = 0; i < times.size(); ++i) {
+      states[i] = trajectory.Sample(times[i]);
+    }
+  });
+  double many = time([&] { trajectory.SampleMany(times, states); });
+
+  std::cout << "ns per sample of " << trajectory.States().size()
+            << " states: Sample " << loop << ", SampleMany " << many << "\n";
+}